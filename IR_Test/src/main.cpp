@@ -6,6 +6,8 @@
     - Sends IR commands using the IR LED
     - Commands are defined in an array for easy modification
     - Uses the IRremoteESP8266 library for IR functionality
+    - Web requests and the button only queue commands; one FreeRTOS
+      task sends them, from mark/space timings built once at startup
 */
 
 #include <Arduino.h>
@@ -13,6 +15,7 @@
 #include <WebServer.h>
 #include <IRremoteESP8266.h>
 #include <IRsend.h>
+#include <esp_timer.h>
 
 // =============== Configuration ===============
 const char* ssid = "YOUR_SSID";         // Replace with your WiFi SSID
@@ -30,40 +33,207 @@ uint32_t irCodes[] = {
 
 const char* codeNames[] = {"ON", "Dim", "Dark Blue", "OFF"};
 const int numCodes = sizeof(irCodes) / sizeof(irCodes[0]);
-int currentIndex = 0;
-bool lastButtonState = HIGH;
+
+// NEC timings in microseconds: 9 ms / 4.5 ms leader, 560 us marks,
+// 560 us (0) or 1690 us (1) spaces, one stop mark. A frame starts at most
+// every 108 ms.
+const uint16_t kNecHdrMark = 9000;
+const uint16_t kNecHdrSpace = 4500;
+const uint16_t kNecBitMark = 560;
+const uint16_t kNecOneSpace = 1690;
+const uint16_t kNecZeroSpace = 560;
+const int64_t kNecFramePeriodUs = 108000;
+const uint16_t kNecBits = 32;
+const uint16_t kNecRawLen = 2 + 2 * kNecBits + 1;
+const uint16_t kNecCarrierKhz = 38;
+
+const uint8_t kMaxMacroSteps = 16;
+const uint16_t kDefaultGapMs = 40;     // frame end to next frame start, raised to the NEC minimum
+const uint16_t kMaxGapMs = 10000;
+const uint8_t kIrQueueLength = 8;
+const uint32_t kButtonQuietUs = 30000; // line must be still this long before a press counts
+
+struct IrStep {
+  uint8_t code;                        // index into irCodes
+  uint16_t gapMs;                      // after this frame
+};
+
+// One queue item: a single command or a whole macro, sent back to back.
+struct IrJob {
+  uint8_t count;
+  IrStep steps[kMaxMacroSteps];
+};
+
+uint16_t necRaw[numCodes][kNecRawLen]; // built once in setup()
+QueueHandle_t irQueue;
+
+volatile int currentIndex = 0;         // button cycle, ISR only
+volatile uint32_t lastButtonEdgeUs = 0;
 
 IRsend irsend(kIrLedPin);
 WebServer server(80);
 
 // =============== IR Control Functions ===============
-void sendIrCommand(int index) {
-  if(index >= 0 && index < numCodes) {
-    Serial.printf("Sending command: %s (0x%08X)\n", codeNames[index], irCodes[index]);
-    irsend.sendNEC(irCodes[index], 32);
+// Same frame as irsend.sendNEC(code, 32), MSB of code first, at the nominal
+// NEC timings above.
+void buildNecRaw(uint32_t code, uint16_t* raw) {
+  uint16_t n = 0;
+  raw[n++] = kNecHdrMark;
+  raw[n++] = kNecHdrSpace;
+  for(int bit = kNecBits - 1; bit >= 0; bit--) {
+    raw[n++] = kNecBitMark;
+    raw[n++] = (code >> bit) & 1 ? kNecOneSpace : kNecZeroSpace;
   }
+  raw[n++] = kNecBitMark;
+}
+
+bool queueIrJob(const IrJob& job) {
+  return xQueueSend(irQueue, &job, 0) == pdTRUE;
 }
 
-void handleButtonPress() {
-  Serial.print("Button pressed - ");
-  sendIrCommand(currentIndex);
-  currentIndex = (currentIndex + 1) % numCodes;
+bool queueIrCommand(int index) {
+  IrJob job = {};
+  job.count = 1;
+  job.steps[0] = {(uint8_t)index, kDefaultGapMs};
+  return queueIrJob(job);
+}
+
+// Waits until esp_timer_get_time() reaches target: the scheduler for the
+// bulk, a spin for the last 2 ms.
+void waitUntilUs(int64_t target) {
+  int64_t remaining = target - esp_timer_get_time();
+  if(remaining > 2000) {
+    vTaskDelay(pdMS_TO_TICKS((remaining - 2000) / 1000));
+  }
+  while(esp_timer_get_time() < target) {
+  }
+}
+
+// The only task that touches the IR LED. Frames of one job follow each
+// other at their requested gaps; no frame starts less than one NEC period
+// after the previous one, across jobs too.
+void irTask(void* arg) {
+  IrJob job;
+  int64_t lastStartUs = -kNecFramePeriodUs;
+  int64_t nextStartUs = 0;
+
+  while(true) {
+    xQueueReceive(irQueue, &job, portMAX_DELAY);
+    for(uint8_t i = 0; i < job.count; i++) {
+      const IrStep& step = job.steps[i];
+      int64_t earliest = lastStartUs + kNecFramePeriodUs;
+      waitUntilUs(nextStartUs > earliest ? nextStartUs : earliest);
+
+      lastStartUs = esp_timer_get_time();
+      irsend.sendRaw(necRaw[step.code], kNecRawLen, kNecCarrierKhz);
+      nextStartUs = esp_timer_get_time() + (int64_t)step.gapMs * 1000;
+      Serial.printf("Sent command: %s (0x%08X)\n", codeNames[step.code], irCodes[step.code]);
+    }
+  }
+}
+
+// Edge interrupt on both edges: a falling edge after a quiet line is a
+// press, every other edge is bounce (press or release) and only restarts
+// the quiet period.
+void IRAM_ATTR onButtonEdge() {
+  uint32_t now = micros();
+  bool pressed = digitalRead(buttonPin) == LOW;
+  bool quiet = now - lastButtonEdgeUs >= kButtonQuietUs;
+  lastButtonEdgeUs = now;
+  if(!pressed || !quiet) return;
+
+  IrJob job = {};
+  job.count = 1;
+  job.steps[0] = {(uint8_t)currentIndex, kDefaultGapMs};
+  BaseType_t woken = pdFALSE;
+  if(xQueueSendFromISR(irQueue, &job, &woken) == pdTRUE) {  // a full queue drops the press
+    currentIndex = (currentIndex + 1) % numCodes;
+  }
+  if(woken) portYIELD_FROM_ISR();
+}
+
+int findCommand(const String& name) {
+  for(int i = 0; i < numCodes; i++) {
+    if(name.equalsIgnoreCase(codeNames[i])) return i;
+  }
+  return -1;
 }
 
 // =============== API Endpoints ===============
 void handleApiCommand() {
   String command = server.arg("command");
-  
-  // Find matching command
-  for(int i = 0; i < numCodes; i++) {
-    if(command.equalsIgnoreCase(codeNames[i])) {
-      sendIrCommand(i);
-      server.send(200, "text/plain", "Command executed: " + command);
+  int index = findCommand(command);
+
+  if(index < 0) {
+    server.send(404, "text/plain", "Command not found: " + command);
+  } else if(!queueIrCommand(index)) {
+    server.send(503, "text/plain", "IR queue full, try again");
+  } else {
+    server.send(202, "text/plain", "Command queued: " + command);
+  }
+}
+
+// Gap in ms: digits only, at most kMaxGapMs. toInt() would read "abc" as 0.
+bool parseGapMs(String text, uint16_t& gapMs) {
+  text.trim();
+  if(text.length() == 0) return false;
+  uint32_t value = 0;
+  for(unsigned int i = 0; i < text.length(); i++) {
+    if(!isDigit(text[i])) return false;
+    value = value * 10 + (text[i] - '0');
+    if(value > kMaxGapMs) return false;
+  }
+  gapMs = (uint16_t)value;
+  return true;
+}
+
+// POST /api/commands, seq=ON,Dim:500,Dim,OFF (form field, query or plain body).
+// Each item is a command name with an optional gap in ms before the next frame.
+void handleApiMacro() {
+  String seq = server.hasArg("seq") ? server.arg("seq") : server.arg("plain");
+  IrJob job = {};
+  int start = 0;
+
+  seq.trim();
+  while(start < (int)seq.length()) {
+    int end = seq.indexOf(',', start);
+    if(end < 0) end = seq.length();
+    String item = seq.substring(start, end);
+    start = end + 1;
+
+    uint16_t gapMs = kDefaultGapMs;
+    String gapText;
+    int colon = item.indexOf(':');
+    if(colon >= 0) {
+      gapText = item.substring(colon + 1);
+      item = item.substring(0, colon);
+    }
+    item.trim();
+    if(item.length() == 0) continue;
+
+    int index = findCommand(item);
+    if(index < 0) {
+      server.send(404, "text/plain", "Command not found: " + item);
+      return;
+    }
+    if(job.count == kMaxMacroSteps) {
+      server.send(400, "text/plain", "Too many commands, max " + String(kMaxMacroSteps));
       return;
     }
+    if(colon >= 0 && !parseGapMs(gapText, gapMs)) {
+      server.send(400, "text/plain", "Invalid gap, use 0-" + String(kMaxGapMs) + " ms: " + item + ":" + gapText);
+      return;
+    }
+    job.steps[job.count++] = {(uint8_t)index, gapMs};
+  }
+
+  if(job.count == 0) {
+    server.send(400, "text/plain", "Empty sequence, use seq=ON,Dim:500,OFF");
+  } else if(!queueIrJob(job)) {
+    server.send(503, "text/plain", "IR queue full, try again");
+  } else {
+    server.send(202, "text/plain", "Macro queued: " + String(job.count) + " commands");
   }
-  
-  server.send(404, "text/plain", "Command not found: " + command);
 }
 
 void handleApiList() {
@@ -78,9 +248,17 @@ void handleApiList() {
 void setup() {
   Serial.begin(115200);
   
-  // Initialize IR
+  // Initialize IR: cached timings, queue and the sender task
   irsend.begin();
+  for(int i = 0; i < numCodes; i++) {
+    buildNecRaw(irCodes[i], necRaw[i]);
+  }
+  irQueue = xQueueCreate(kIrQueueLength, sizeof(IrJob));
+  // Above loop() on the same core, so the web server never cuts into a frame
+  xTaskCreatePinnedToCore(irTask, "ir_tx", 4096, NULL, 3, NULL, ARDUINO_RUNNING_CORE);
+
   pinMode(buttonPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(buttonPin), onButtonEdge, CHANGE);
 
   // Connect to WiFi
   WiFi.begin(ssid, password);
@@ -95,22 +273,17 @@ void setup() {
   // Configure web server
   server.on("/api/command", HTTP_GET, handleApiCommand);
   server.on("/api/commands", HTTP_GET, handleApiList);
+  server.on("/api/commands", HTTP_POST, handleApiMacro);
   server.begin();
 
   Serial.println("HTTP server started");
   Serial.println("Use:");
   Serial.println("  /api/command?command=ON");
   Serial.println("  /api/commands - to list available commands");
+  Serial.println("  POST /api/commands seq=ON,Dim:500,OFF - to send a macro");
 }
 
 void loop() {
   server.handleClient();
-  
-  // Button handling
-  bool buttonState = digitalRead(buttonPin);
-  if(lastButtonState == HIGH && buttonState == LOW) {
-    handleButtonPress();
-    delay(300); // Debounce
-  }
-  lastButtonState = buttonState;
+  delay(1);  // let the idle task run; the button and IR sending no longer need loop()
 }
@@ -0,0 +1,184 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "spp_ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static void test_init_rejects_bad_capacity(void)
+{
+    spp_ring_t ring;
+    uint8_t    buf[16];
+    CHECK(!spp_ring_init(&ring, buf, 12));
+    CHECK(!spp_ring_init(&ring, buf, 1));
+    CHECK(!spp_ring_init(&ring, NULL, 16));
+    CHECK(spp_ring_init(&ring, buf, 16));
+    CHECK(spp_ring_used(&ring) == 0 && spp_ring_free(&ring) == 16);
+}
+
+static void test_write_wraps_and_stamps(void)
+{
+    spp_ring_t ring;
+    uint8_t    buf[16];
+    uint8_t    out[16];
+    int64_t    t;
+    spp_ring_init(&ring, buf, sizeof buf);
+
+    CHECK(spp_ring_write(&ring, "0123456789", 10, 100) == 10);
+    CHECK(spp_ring_write(&ring, "abcdefghij", 10, 200) == 6);     // full: only what fits
+    CHECK(spp_ring_free(&ring) == 0 && ring.high_water == 16);
+    CHECK(spp_ring_oldest(&ring, &t) && t == 100);
+
+    spp_ring_consume(&ring, 9);
+    CHECK(!spp_ring_pop_stamp(&ring, &t));                        // one byte of the first write left
+    spp_ring_consume(&ring, 1);
+    CHECK(spp_ring_pop_stamp(&ring, &t) && t == 100);
+    CHECK(!spp_ring_pop_stamp(&ring, &t));
+    CHECK(spp_ring_oldest(&ring, &t) && t == 200);
+
+    /* Second write lands across the end of the buffer. */
+    CHECK(spp_ring_write(&ring, "ABCDEFGH", 8, 300) == 8);
+    const uint8_t *p;
+    CHECK(spp_ring_peek(&ring, &p) == 6 && memcmp(p, "abcdef", 6) == 0);
+    CHECK(spp_ring_copy(&ring, out, sizeof out) == 14);
+    CHECK(memcmp(out, "abcdefABCDEFGH", 14) == 0);
+
+    CHECK(spp_ring_discard(&ring) == 14);
+    CHECK(spp_ring_used(&ring) == 0 && !spp_ring_pop_stamp(&ring, &t) && !spp_ring_oldest(&ring, &t));
+}
+
+static void test_zero_copy_fill(void)
+{
+    spp_ring_t ring;
+    uint8_t    buf[8];
+    uint8_t   *dst;
+    spp_ring_init(&ring, buf, sizeof buf);
+
+    spp_ring_write(&ring, "xxxxxx", 6, 1);
+    spp_ring_consume(&ring, 6);
+    CHECK(spp_ring_write_ptr(&ring, &dst) == 2 && dst == buf + 6);   // contiguous part only
+    memcpy(dst, "ab", 2);
+    spp_ring_commit(&ring, 2, 2);
+    CHECK(spp_ring_write_ptr(&ring, &dst) == 6 && dst == buf);
+    memcpy(dst, "cd", 2);
+    spp_ring_commit(&ring, 2, 3);
+
+    uint8_t out[4];
+    CHECK(spp_ring_copy(&ring, out, sizeof out) == 4 && memcmp(out, "abcd", 4) == 0);
+}
+
+static void test_stamp_fifo_full(void)
+{
+    spp_ring_t ring;
+    uint8_t    buf[256];
+    int64_t    t;
+    spp_ring_init(&ring, buf, sizeof buf);
+
+    /* One write more than there are stamps: it goes unstamped. */
+    for (int i = 0; i <= (int)SPP_RING_STAMPS; ++i) spp_ring_write(&ring, "z", 1, i);
+    spp_ring_consume(&ring, SPP_RING_STAMPS);
+    int popped = 0;
+    while (spp_ring_pop_stamp(&ring, &t)) popped++;
+    CHECK(popped == (int)SPP_RING_STAMPS && t == SPP_RING_STAMPS - 1);
+    CHECK(spp_ring_used(&ring) == 1 && !spp_ring_oldest(&ring, &t));
+
+    /* Its byte counts towards the next stamped write. */
+    spp_ring_write(&ring, "z", 1, 1000);
+    CHECK(spp_ring_oldest(&ring, &t) && t == 1000);
+    spp_ring_consume(&ring, 1);
+    CHECK(!spp_ring_pop_stamp(&ring, &t));
+    spp_ring_consume(&ring, 1);
+    CHECK(spp_ring_pop_stamp(&ring, &t) && t == 1000);
+}
+
+/* One producer and one consumer thread push a counting byte pattern through a small ring. */
+#define STRESS_BYTES 4000000U
+
+static spp_ring_t s_stress_ring;
+static uint8_t    s_stress_buf[512];
+
+static void *stress_producer(void *arg)
+{
+    (void)arg;
+    uint32_t next = 0;
+    uint8_t  chunk[97];
+    while (next < STRESS_BYTES) {
+        size_t n = next % 3 == 0 ? 97 : 1 + next % 61;
+        if (n > STRESS_BYTES - next) n = STRESS_BYTES - next;
+        if (next & 1U) {
+            uint8_t *dst;
+            size_t   room = spp_ring_write_ptr(&s_stress_ring, &dst);
+            if (n > room) n = room;
+            for (size_t i = 0; i < n; ++i) dst[i] = (uint8_t)(next + i);
+            spp_ring_commit(&s_stress_ring, n, next);
+        } else {
+            for (size_t i = 0; i < n; ++i) chunk[i] = (uint8_t)(next + i);
+            n = spp_ring_write(&s_stress_ring, chunk, n, next);
+        }
+        next += n;
+        if (n == 0) sched_yield();                 // full: let the consumer run on a single core
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    pthread_t producer;
+    uint32_t  next = 0;
+    int64_t   last_stamp = -1;
+    int64_t   t;
+    uint8_t   out[64];
+    bool      ok = true;
+
+    spp_ring_init(&s_stress_ring, s_stress_buf, sizeof s_stress_buf);
+    CHECK(pthread_create(&producer, NULL, stress_producer, NULL) == 0);
+
+    while (next < STRESS_BYTES && ok) {
+        const uint8_t *p;
+        size_t n = (next & 2U) ? spp_ring_peek(&s_stress_ring, &p) : spp_ring_copy(&s_stress_ring, out, sizeof out);
+        if (!(next & 2U)) p = out;
+        for (size_t i = 0; i < n; ++i) ok &= p[i] == (uint8_t)(next + i);
+        spp_ring_consume(&s_stress_ring, n);
+        next += n;
+        if (n == 0) sched_yield();
+        /* A stamp is the offset its write started at: increasing, and fully consumed. */
+        while (spp_ring_pop_stamp(&s_stress_ring, &t)) {
+            ok &= t > last_stamp && t < (int64_t)next;
+            last_stamp = t;
+        }
+    }
+    pthread_join(producer, NULL);
+    CHECK(ok);
+    CHECK(next == STRESS_BYTES);
+}
+
+int main(void)
+{
+    test_init_rejects_bad_capacity();
+    test_write_wraps_and_stamps();
+    test_zero_copy_fill();
+    test_stamp_fifo_full();
+    test_threads();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_spp_ring: ok\n");
+    return EXIT_SUCCESS;
+}
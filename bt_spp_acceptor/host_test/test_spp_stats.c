@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "hdr_hist.h"
+#include "spp_stats.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static hdr_hist_t s_hist;
+
+static void test_buckets_cover_every_value(void)
+{
+    uint32_t prev = 0;
+    bool     ok = true;
+
+    for (uint64_t v = 0; v <= UINT32_MAX; v += v < 4096 ? 1 : v / 512) {
+        uint32_t b = hdr_hist_bucket((uint32_t)v);
+        uint32_t lo = hdr_hist_bucket_low(b);
+        uint32_t hi = hdr_hist_bucket_high(b);
+        ok &= b >= prev && b < HDR_HIST_BUCKETS && lo <= v && v <= hi;
+        ok &= (uint64_t)(hi - lo) * 32U <= lo || b < HDR_HIST_SUB_COUNT;    // 1/32 resolution
+        prev = b;
+    }
+    CHECK(ok);
+    CHECK(hdr_hist_bucket(UINT32_MAX) == HDR_HIST_BUCKETS - 1U);
+    CHECK(hdr_hist_bucket_high(HDR_HIST_BUCKETS - 1U) == UINT32_MAX);
+    for (uint32_t b = 1; b < HDR_HIST_BUCKETS; ++b) {
+        ok &= hdr_hist_bucket_low(b) == hdr_hist_bucket_high(b - 1U) + 1U;
+    }
+    CHECK(ok);
+}
+
+static void test_percentiles(void)
+{
+    hdr_hist_reset(&s_hist);
+    CHECK(hdr_hist_percentile(&s_hist, 5000) == 0 && hdr_hist_mean(&s_hist) == 0);
+
+    /* 1..1000 us once each. */
+    for (uint32_t v = 1; v <= 1000; ++v) hdr_hist_record(&s_hist, v);
+    CHECK(s_hist.total == 1000 && s_hist.min == 1 && s_hist.max == 1000);
+    CHECK(hdr_hist_mean(&s_hist) == 500);
+
+    uint32_t p50 = hdr_hist_percentile(&s_hist, 5000);
+    uint32_t p99 = hdr_hist_percentile(&s_hist, 9900);
+    CHECK(p50 >= 500 && p50 <= 500 + 500 / 32);
+    CHECK(p99 >= 990 && p99 <= 990 + 990 / 32);
+    CHECK(hdr_hist_percentile(&s_hist, 10000) == 1000);
+    CHECK(hdr_hist_percentile(&s_hist, 0) == 1);
+
+    /* A single outlier moves the max and p99.9, not p99. */
+    hdr_hist_record(&s_hist, 250000);
+    CHECK(hdr_hist_percentile(&s_hist, 9900) == p99);
+    CHECK(hdr_hist_percentile(&s_hist, 10000) == 250000);
+}
+
+static spp_stats_t s_stats;
+
+static void test_stats_dump(void)
+{
+    spp_stats_reset(&s_stats, 1000000, 4096, 8192);
+    for (int i = 0; i < 10; ++i) {
+        spp_stats_record_send(&s_stats, SPP_STATS_UART_TO_BT, 990, 990 + 100 * i);
+        spp_stats_record_latency(&s_stats, SPP_STATS_UART_TO_BT, 3000 + 100 * i);
+    }
+    spp_stats_record_send(&s_stats, SPP_STATS_BT_TO_UART, 20, 20);
+    spp_stats_record_latency(&s_stats, SPP_STATS_BT_TO_UART, 150);
+    spp_stats_record_drop(&s_stats, SPP_STATS_BT_TO_UART, 7);
+    s_stats.congestion_events = 2;
+
+    const spp_stats_flow_t *f = &s_stats.flow[SPP_STATS_UART_TO_BT];
+    CHECK(f->bytes == 9900 && f->writes == 10 && f->ring_peak == 1890 && f->ring_capacity == 4096);
+    CHECK(f->latency_us.total == 10 && f->latency_us.max == 3900);
+    CHECK(s_stats.flow[SPP_STATS_BT_TO_UART].dropped == 7);
+
+    char   text[1024];
+    FILE  *out = fmemopen(text, sizeof text, "w");
+    CHECK(out != NULL);
+    if (!out) return;
+    spp_stats_dump(&s_stats, 2000000, out);     // one second after the reset
+    fclose(out);
+
+    CHECK(strstr(text, "bridge stats over 1.000 s\n") != NULL);
+    CHECK(strstr(text, "uart->bt: 9900 B, 79.2 kbit/s, 10 writes, 0 B dropped\n") != NULL);
+    CHECK(strstr(text, "  latency us: n 10, min 3000, ") != NULL);
+    CHECK(strstr(text, ", max 3900, mean 3450\n") != NULL);
+    CHECK(strstr(text, "  ring B: now 0, mean 1440, peak 1890 of 4096\n") != NULL);
+    CHECK(strstr(text, "bt->uart: 20 B, 0.1 kbit/s, 1 writes, 7 B dropped\n") != NULL);
+    CHECK(strstr(text, "congestion events 2, uart overflows 0\n") != NULL);
+}
+
+int main(void)
+{
+    test_buckets_cover_every_value();
+    test_percentiles();
+    test_stats_dump();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_spp_stats: ok\n");
+    return EXIT_SUCCESS;
+}
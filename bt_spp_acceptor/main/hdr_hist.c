@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "hdr_hist.h"
+
+#include <string.h>
+
+void hdr_hist_reset(hdr_hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min = UINT32_MAX;
+}
+
+uint32_t hdr_hist_bucket(uint32_t value)
+{
+    if (value < HDR_HIST_SUB_COUNT) return value;
+
+    /* shift keeps the top HDR_HIST_SUB_BITS bits: value >> shift is in [HALF, SUB_COUNT). */
+    uint32_t shift = (31U - (uint32_t)__builtin_clz(value)) - (HDR_HIST_SUB_BITS - 1U);
+    return HDR_HIST_SUB_COUNT + (shift - 1U) * HDR_HIST_HALF + ((value >> shift) - HDR_HIST_HALF);
+}
+
+uint32_t hdr_hist_bucket_low(uint32_t bucket)
+{
+    if (bucket < HDR_HIST_SUB_COUNT) return bucket;
+
+    uint32_t j = bucket - HDR_HIST_SUB_COUNT;
+    uint32_t shift = j / HDR_HIST_HALF + 1U;
+    return (HDR_HIST_HALF + j % HDR_HIST_HALF) << shift;
+}
+
+uint32_t hdr_hist_bucket_high(uint32_t bucket)
+{
+    if (bucket < HDR_HIST_SUB_COUNT) return bucket;
+
+    uint32_t shift = (bucket - HDR_HIST_SUB_COUNT) / HDR_HIST_HALF + 1U;
+    return hdr_hist_bucket_low(bucket) + ((1U << shift) - 1U);
+}
+
+void hdr_hist_record(hdr_hist_t *h, uint32_t value)
+{
+    h->counts[hdr_hist_bucket(value)]++;
+    h->total++;
+    h->sum += value;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+uint32_t hdr_hist_percentile(const hdr_hist_t *h, uint32_t pct_x100)
+{
+    if (h->total == 0) return 0;
+    if (pct_x100 > 10000U) pct_x100 = 10000U;
+
+    /* Rank of the wanted sample, 1-based, rounded up. */
+    uint64_t rank = ((uint64_t)h->total * pct_x100 + 9999U) / 10000U;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < HDR_HIST_BUCKETS; ++b) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint32_t v = hdr_hist_bucket_high(b);
+            if (v > h->max) v = h->max;
+            if (v < h->min) v = h->min;
+            return v;
+        }
+    }
+    return h->max;
+}
+
+uint32_t hdr_hist_mean(const hdr_hist_t *h)
+{
+    return h->total ? (uint32_t)(h->sum / h->total) : 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+/*
+ * HDR-style histogram of 32-bit values (microseconds in the bridge).
+ *
+ * Values below 2^HDR_HIST_SUB_BITS get one bucket each. Above that, every
+ * power of two is split into 2^(HDR_HIST_SUB_BITS - 1) equal buckets, so a
+ * reported value is never more than 1/32 above the true value, from 1 us
+ * to 71 minutes, in a fixed 3.5 KB. Recording is O(1) and does no division.
+ *
+ * Not thread safe; one writer, and readers copy it under the writer's lock.
+ * No FreeRTOS or ESP-IDF dependency.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HDR_HIST_SUB_BITS  6U
+#define HDR_HIST_SUB_COUNT (1U << HDR_HIST_SUB_BITS)
+#define HDR_HIST_HALF      (HDR_HIST_SUB_COUNT / 2U)
+#define HDR_HIST_BUCKETS   (HDR_HIST_SUB_COUNT + (32U - HDR_HIST_SUB_BITS) * HDR_HIST_HALF)
+
+typedef struct {
+    uint32_t counts[HDR_HIST_BUCKETS];
+    uint32_t total;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} hdr_hist_t;
+
+void     hdr_hist_reset(hdr_hist_t *h);
+void     hdr_hist_record(hdr_hist_t *h, uint32_t value);
+
+uint32_t hdr_hist_bucket(uint32_t value);
+uint32_t hdr_hist_bucket_low(uint32_t bucket);
+uint32_t hdr_hist_bucket_high(uint32_t bucket);     // inclusive
+
+/*
+ * Smallest recorded bucket bound at or above the given percentile, in
+ * hundredths of a percent (9900 = p99). Clamped to the recorded min/max;
+ * 0 when the histogram is empty.
+ */
+uint32_t hdr_hist_percentile(const hdr_hist_t *h, uint32_t pct_x100);
+uint32_t hdr_hist_mean(const hdr_hist_t *h);
+
+#ifdef __cplusplus
+}
+#endif
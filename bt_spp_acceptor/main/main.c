@@ -8,32 +8,55 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <stdatomic.h>
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_bt.h"
 #include "esp_bt_main.h"
 #include "esp_gap_bt_api.h"
 #include "esp_bt_device.h"
 #include "esp_spp_api.h"
 #include "driver/uart.h"
-#include "sys/time.h"
 #include "driver/gpio.h"     
+#include "spp_ring.h"
+#include "spp_stats.h"
 
 
 /* ---------- UART CONFIG ---------- */
 #define UART_PORT      UART_NUM_1            // leave UART0 for logs/flash
 #define UART_TX_PIN    GPIO_NUM_17
 #define UART_RX_PIN    GPIO_NUM_16
+#define UART_RTS_PIN   CONFIG_EXAMPLE_BRIDGE_RTS_PIN    // -1: no RTS
+#define UART_CTS_PIN   CONFIG_EXAMPLE_BRIDGE_CTS_PIN    // -1: no CTS
 #define UART_BAUD      115200
-#define UART_BUF_SIZE  2048                  // RX & TX ring-buffer size
+#define UART_BUF_SIZE  2048                  // driver TX ring-buffer size
+#define UART_RX_BUF_SIZE 512                 // driver RX ring: small, so RTS drops soon after the bridge ring fills
+#define UART_RTS_THRESH  100                 // RX FIFO bytes (of 128) before RTS is deasserted
+#define UART_EVT_QUEUE   16
+#define CONSOLE_UART   UART_NUM_0            // log UART, also takes the stats commands
 
 /* ---------- SPP CONFIG ---------- */
 #define SPP_TAG            "BT_UART_BRIDGE"
 #define SPP_SERVER_NAME    "SPP_SERVER"
-#define SPP_SHOW_SPEED     1                 // set 0 to dump data instead
+
+/* ---------- BRIDGE CONFIG ---------- */
+#define BRIDGE_UART_TO_BT_RING  4096         // power of two
+#define BRIDGE_BT_TO_UART_RING  8192         // power of two
+#define BRIDGE_SPP_MTU          ESP_SPP_MAX_MTU                 // largest single esp_spp_write()
+#define BRIDGE_COALESCE_US      (CONFIG_EXAMPLE_BRIDGE_COALESCE_MS * 1000)
+#define BRIDGE_BT_RX_BLOCK_MS   100          // longest the SPP callback waits for UART ring space
+#define BRIDGE_STATS_PERIOD_MS  CONFIG_EXAMPLE_BRIDGE_STATS_PERIOD_MS  // 0: dump on demand only
+
+/* Task notification bits for the SPP TX task. */
+#define BRIDGE_NOTIFY_DATA      (1U << 0)    // UART bytes added to the ring
+#define BRIDGE_NOTIFY_WRITE     (1U << 1)    // ESP_SPP_WRITE_EVT
+#define BRIDGE_NOTIFY_LINK      (1U << 2)    // open, close, congestion change
 
 static const char local_device_name[] = CONFIG_EXAMPLE_LOCAL_DEVICE_NAME;
 static const esp_spp_mode_t esp_spp_mode           = ESP_SPP_MODE_CB;
@@ -42,9 +65,64 @@ static const bool           esp_spp_enable_l2cap_ertm = true;
 static const esp_spp_sec_t  sec_mask   = ESP_SPP_SEC_AUTHENTICATE;
 static const esp_spp_role_t role_slave = ESP_SPP_ROLE_SLAVE;
 
-static uint32_t spp_con_handle = 0;          // 0 = no active SPP link
-static long     data_cnt       = 0;
-static struct timeval t_old    = {0};
+/* Link state, written by the SPP callback and read by the bridge tasks. */
+static _Atomic uint32_t spp_con_handle = 0;   // 0 = no active SPP link
+static _Atomic bool     spp_congested  = false;
+static _Atomic bool     spp_write_ok   = false;   // status of the last WRITE_EVT
+
+/*
+ * uart_to_bt: UART RX task -> SPP TX task. bt_to_uart: SPP callback -> UART
+ * TX task. Each ring has one writer and one reader.
+ */
+static uint8_t    uart_to_bt_buf[BRIDGE_UART_TO_BT_RING];
+static uint8_t    bt_to_uart_buf[BRIDGE_BT_TO_UART_RING];
+static spp_ring_t uart_to_bt;
+static spp_ring_t bt_to_uart;
+static uint8_t    spp_tx_staging[BRIDGE_SPP_MTU];  // only when a write crosses the ring wrap
+
+static QueueHandle_t     uart_evt_queue;
+static TaskHandle_t      uart_rx_task_handle;
+static TaskHandle_t      spp_tx_task_handle;
+static TaskHandle_t      uart_tx_task_handle;
+static SemaphoreHandle_t bt_to_uart_space;     // given by the UART TX task after it frees ring space
+
+/* ---------- BRIDGE COUNTERS ---------- */
+static spp_stats_t  bridge_stats;            // current connection, reset on SRV_OPEN
+static spp_stats_t  bridge_stats_copy;       // console's snapshot (too big for its stack)
+static portMUX_TYPE bridge_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static _Atomic bool bridge_dump_pending = false;   // set on disconnect, served by the console task
+
+/* Consumer side, after spp_ring_consume(): one latency sample per fully sent ring write. */
+static void bridge_count_sent(spp_stats_dir_t dir, spp_ring_t *ring, size_t len, size_t used_before)
+{
+    int64_t now = esp_timer_get_time(), t;
+    portENTER_CRITICAL(&bridge_stats_lock);
+    spp_stats_record_send(&bridge_stats, dir, len, used_before);
+    while (spp_ring_pop_stamp(ring, &t)) spp_stats_record_latency(&bridge_stats, dir, (uint32_t)(now - t));
+    portEXIT_CRITICAL(&bridge_stats_lock);
+}
+
+static void bridge_count_dropped(spp_stats_dir_t dir, size_t len)
+{
+    portENTER_CRITICAL(&bridge_stats_lock);
+    spp_stats_record_drop(&bridge_stats, dir, len);
+    portEXIT_CRITICAL(&bridge_stats_lock);
+}
+
+static void bridge_count_event(uint32_t *counter)
+{
+    portENTER_CRITICAL(&bridge_stats_lock);
+    (*counter)++;
+    portEXIT_CRITICAL(&bridge_stats_lock);
+}
+
+static void bridge_stats_reset(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&bridge_stats_lock);
+    spp_stats_reset(&bridge_stats, now, spp_ring_capacity(&uart_to_bt), spp_ring_capacity(&bt_to_uart));
+    portEXIT_CRITICAL(&bridge_stats_lock);
+}
 
 static char *bda2str(uint8_t *bda, char *str, size_t size)
 {
@@ -54,14 +132,139 @@ static char *bda2str(uint8_t *bda, char *str, size_t size)
     return str;
 }
 
-/* ---------- UART ➜ BT TASK ---------- */
-static void uart_to_bt_task(void *arg)
+/* ---------- UART ➜ RING TASK ---------- */
+/*
+ * Drains the UART driver into uart_to_bt without copying. When the ring is
+ * full it stops reading: the driver RX buffer and then the FIFO fill up and
+ * the UART deasserts RTS until the SPP side has sent some of the backlog.
+ */
+static void uart_rx_task(void *arg)
+{
+    uart_event_t evt;
+    while (1) {
+        size_t pending = 0;
+        uart_get_buffered_data_len(UART_PORT, &pending);
+        if (pending == 0) {
+            if (xQueueReceive(uart_evt_queue, &evt, portMAX_DELAY) == pdTRUE &&
+                (evt.type == UART_FIFO_OVF || (evt.type == UART_BUFFER_FULL && UART_RTS_PIN < 0))) {
+                /* Bytes already lost in hardware: start over from a clean FIFO. */
+                uart_flush_input(UART_PORT);
+                xQueueReset(uart_evt_queue);
+                bridge_count_event(&bridge_stats.uart_overflows);
+            }
+            continue;
+        }
+
+        uint8_t *dst;
+        size_t   room = spp_ring_write_ptr(&uart_to_bt, &dst);
+        if (room == 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+            continue;
+        }
+        int rx = uart_read_bytes(UART_PORT, dst, pending < room ? pending : room, 0);
+        if (rx <= 0) continue;
+        if (!atomic_load(&spp_con_handle)) {
+            bridge_count_dropped(SPP_STATS_UART_TO_BT, rx);   // nobody to send to: read, never commit
+            continue;
+        }
+        spp_ring_commit(&uart_to_bt, rx, esp_timer_get_time());
+        xTaskNotify(spp_tx_task_handle, BRIDGE_NOTIFY_DATA, eSetBits);
+    }
+}
+
+/* ---------- RING ➜ SPP TASK ---------- */
+/*
+ * One esp_spp_write() in flight at a time, of up to BRIDGE_SPP_MTU bytes.
+ * A short write waits until its oldest byte is BRIDGE_COALESCE_US old, so a
+ * UART stream goes out in full frames. Nothing is written while the link
+ * is congested; the bytes stay in the ring until WRITE_EVT acknowledges them.
+ */
+static void spp_tx_task(void *arg)
+{
+    size_t in_flight = 0;
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+
+        uint32_t handle = atomic_load(&spp_con_handle);
+        if (!handle) {
+            in_flight = 0;
+            size_t n = spp_ring_discard(&uart_to_bt);
+            if (n) bridge_count_dropped(SPP_STATS_UART_TO_BT, n);
+        } else if (in_flight == 0 && !atomic_load(&spp_congested)) {
+            size_t  used = spp_ring_used(&uart_to_bt);
+            int64_t oldest, now = esp_timer_get_time();
+            if (used > 0 && used < BRIDGE_SPP_MTU && spp_ring_oldest(&uart_to_bt, &oldest) &&
+                now - oldest < BRIDGE_COALESCE_US) {
+                wait = pdMS_TO_TICKS((BRIDGE_COALESCE_US - (now - oldest)) / 1000) + 1;
+            } else if (used > 0) {
+                size_t         len = used < BRIDGE_SPP_MTU ? used : BRIDGE_SPP_MTU;
+                const uint8_t *data;
+                if (spp_ring_peek(&uart_to_bt, &data) < len) {
+                    spp_ring_copy(&uart_to_bt, spp_tx_staging, len);
+                    data = spp_tx_staging;
+                }
+                if (esp_spp_write(handle, len, (uint8_t *)data) == ESP_OK) {
+                    in_flight = len;
+                } else {
+                    wait = 1;                    // stack queue full: try again next tick
+                }
+            }
+        }
+
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, wait);
+        if ((bits & BRIDGE_NOTIFY_WRITE) && in_flight) {
+            size_t used = spp_ring_used(&uart_to_bt);
+            spp_ring_consume(&uart_to_bt, in_flight);
+            if (atomic_load(&spp_write_ok)) {
+                bridge_count_sent(SPP_STATS_UART_TO_BT, &uart_to_bt, in_flight, used);
+            } else {
+                bridge_count_dropped(SPP_STATS_UART_TO_BT, in_flight);
+            }
+            in_flight = 0;
+            xTaskNotifyGive(uart_rx_task_handle);
+        }
+    }
+}
+
+/* ---------- RING ➜ UART TASK ---------- */
+/* uart_write_bytes() blocks while the driver TX buffer is full, e.g. with CTS deasserted. */
+static void uart_tx_task(void *arg)
 {
-    uint8_t *buf = malloc(256);
     while (1) {
-        int rx = uart_read_bytes(UART_PORT, buf, 256, 20 / portTICK_PERIOD_MS);
-        if (rx > 0 && spp_con_handle) {
-            esp_spp_write(spp_con_handle, rx, buf);
+        const uint8_t *data;
+        size_t         len = spp_ring_peek(&bt_to_uart, &data);
+        if (len == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        size_t used = spp_ring_used(&bt_to_uart);
+        int    tx = uart_write_bytes(UART_PORT, data, len);
+        if (tx <= 0) continue;
+        spp_ring_consume(&bt_to_uart, tx);
+        bridge_count_sent(SPP_STATS_BT_TO_UART, &bt_to_uart, tx, used);
+        xSemaphoreGive(bt_to_uart_space);
+    }
+}
+
+/* SPP callback context. Waiting here holds back RFCOMM credits, which throttles the peer. */
+static void bridge_bt_to_uart(const uint8_t *data, size_t len)
+{
+    int64_t    now = esp_timer_get_time();
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(BRIDGE_BT_RX_BLOCK_MS);
+
+    while (len) {
+        size_t n = spp_ring_write(&bt_to_uart, data, len, now);
+        data += n;
+        len  -= n;
+        if (n) xTaskNotifyGive(uart_tx_task_handle);
+        if (!len) break;
+
+        TickType_t now_ticks = xTaskGetTickCount();
+        if ((int32_t)(deadline - now_ticks) <= 0 ||
+            xSemaphoreTake(bt_to_uart_space, deadline - now_ticks) != pdTRUE) {
+            bridge_count_dropped(SPP_STATS_BT_TO_UART, len);
+            break;
         }
     }
 }
@@ -80,36 +283,40 @@ static void esp_spp_cb(esp_spp_cb_event_t event, esp_spp_cb_param_t *param)
         break;
 
     case ESP_SPP_SRV_OPEN_EVT:                              /* client connected */
-        spp_con_handle = param->srv_open.handle;
+        bridge_stats_reset();
+        atomic_store(&spp_congested, false);
+        atomic_store(&spp_con_handle, param->srv_open.handle);
         ESP_LOGI(SPP_TAG, "Client connected handle=%"PRIu32" (%s)",
-                 spp_con_handle,
+                 param->srv_open.handle,
                  bda2str(param->srv_open.rem_bda, bda_str, sizeof bda_str));
-        gettimeofday(&t_old, NULL);
+        xTaskNotify(spp_tx_task_handle, BRIDGE_NOTIFY_LINK, eSetBits);
         break;
 
     case ESP_SPP_CLOSE_EVT:
         ESP_LOGI(SPP_TAG, "Client disconnected, handle=%"PRIu32, param->close.handle);
-        spp_con_handle = 0;
+        atomic_store(&spp_con_handle, 0);
+        atomic_store(&spp_congested, false);
+        atomic_store(&bridge_dump_pending, true);
+        xTaskNotify(spp_tx_task_handle, BRIDGE_NOTIFY_LINK, eSetBits);
+        break;
+
+    case ESP_SPP_WRITE_EVT:                                 /* UART ➜ BT write done */
+        atomic_store(&spp_write_ok, param->write.status == ESP_SPP_SUCCESS);
+        if (param->write.cong) {
+            atomic_store(&spp_congested, true);
+            bridge_count_event(&bridge_stats.congestion_events);
+        }
+        xTaskNotify(spp_tx_task_handle, BRIDGE_NOTIFY_WRITE, eSetBits);
+        break;
+
+    case ESP_SPP_CONG_EVT:
+        atomic_store(&spp_congested, param->cong.cong);
+        if (!param->cong.cong) xTaskNotify(spp_tx_task_handle, BRIDGE_NOTIFY_LINK, eSetBits);
         break;
 
     case ESP_SPP_DATA_IND_EVT:                              /* BT ➜ UART */
-        if (spp_con_handle == param->data_ind.handle) {
-            uart_write_bytes(UART_PORT,
-                             (const char *)param->data_ind.data,
-                             param->data_ind.len);
-            #if SPP_SHOW_SPEED
-            struct timeval t_now;
-            gettimeofday(&t_now, NULL);
-            data_cnt += param->data_ind.len;
-            if (t_now.tv_sec - t_old.tv_sec >= 3) {
-                float dt = (t_now.tv_sec - t_old.tv_sec) +
-                           (t_now.tv_usec - t_old.tv_usec)/1e6f;
-                float kbps = data_cnt * 8 / dt / 1000.0f;
-                ESP_LOGI(SPP_TAG, "Throughput: %.1f kbit/s", kbps);
-                data_cnt = 0;
-                t_old = t_now;
-            }
-            #endif
+        if (atomic_load(&spp_con_handle) == param->data_ind.handle) {
+            bridge_bt_to_uart(param->data_ind.data, param->data_ind.len);
         }
         break;
 
@@ -118,6 +325,56 @@ static void esp_spp_cb(esp_spp_cb_event_t event, esp_spp_cb_param_t *param)
     }
 }
 
+/* ---------- CONSOLE ---------- */
+/*
+ * Line commands on the console UART:
+ *   stats        dump the counters of the current (or last) connection
+ *   stats reset  dump them, then count afresh
+ * They are also dumped when a client disconnects and, with
+ * EXAMPLE_BRIDGE_STATS_PERIOD_MS set, periodically.
+ */
+static void bridge_dump(bool reset)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&bridge_stats_lock);
+    bridge_stats_copy = bridge_stats;
+    if (reset)
+        spp_stats_reset(&bridge_stats, now, spp_ring_capacity(&uart_to_bt), spp_ring_capacity(&bt_to_uart));
+    portEXIT_CRITICAL(&bridge_stats_lock);
+
+    bridge_stats_copy.flow[SPP_STATS_UART_TO_BT].ring_now = spp_ring_used(&uart_to_bt);
+    bridge_stats_copy.flow[SPP_STATS_BT_TO_UART].ring_now = spp_ring_used(&bt_to_uart);
+    spp_stats_dump(&bridge_stats_copy, now, stdout);
+}
+
+static void console_task(void *arg)
+{
+    char    line[32];
+    size_t  len = 0;
+    int64_t next_dump = esp_timer_get_time() + (int64_t)BRIDGE_STATS_PERIOD_MS * 1000;
+
+    while (1) {
+        uint8_t c;
+        if (uart_read_bytes(CONSOLE_UART, &c, 1, pdMS_TO_TICKS(100)) == 1) {
+            if (c == '\r' || c == '\n') {
+                line[len] = '\0';
+                if (strcmp(line, "stats") == 0) bridge_dump(false);
+                else if (strcmp(line, "stats reset") == 0) bridge_dump(true);
+                else if (len) printf("commands: stats, stats reset\n");
+                len = 0;
+            } else if (len < sizeof line - 1) {
+                line[len++] = (char)c;
+            }
+        }
+
+        if (atomic_exchange(&bridge_dump_pending, false)) bridge_dump(false);
+        if (BRIDGE_STATS_PERIOD_MS > 0 && esp_timer_get_time() >= next_dump) {
+            next_dump += (int64_t)BRIDGE_STATS_PERIOD_MS * 1000;
+            if (atomic_load(&spp_con_handle)) bridge_dump(false);
+        }
+    }
+}
+
 /* ---------- GAP CALLBACK ---------- (unchanged, only minimal logging) */
 static void esp_bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param)
 {
@@ -141,12 +398,30 @@ void app_main(void)
         .data_bits  = UART_DATA_8_BITS,
         .parity     = UART_PARITY_DISABLE,
         .stop_bits  = UART_STOP_BITS_1,
-        .flow_ctrl  = UART_HW_FLOWCTRL_DISABLE
+        .flow_ctrl  = UART_RTS_PIN >= 0 && UART_CTS_PIN >= 0 ? UART_HW_FLOWCTRL_CTS_RTS :
+                      UART_RTS_PIN >= 0 ? UART_HW_FLOWCTRL_RTS :
+                      UART_CTS_PIN >= 0 ? UART_HW_FLOWCTRL_CTS : UART_HW_FLOWCTRL_DISABLE,
+        .rx_flow_ctrl_thresh = UART_RTS_THRESH,
     };
-    ESP_ERROR_CHECK(uart_driver_install(UART_PORT, UART_BUF_SIZE, UART_BUF_SIZE, 0, NULL, 0));
+    ESP_ERROR_CHECK(uart_driver_install(UART_PORT, UART_RX_BUF_SIZE, UART_BUF_SIZE,
+                                        UART_EVT_QUEUE, &uart_evt_queue, 0));
     ESP_ERROR_CHECK(uart_param_config (UART_PORT, &ucfg));
     ESP_ERROR_CHECK(uart_set_pin      (UART_PORT, UART_TX_PIN, UART_RX_PIN,
-                                                     UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
+                                                     UART_RTS_PIN, UART_CTS_PIN));
+    ESP_ERROR_CHECK(uart_set_rx_timeout(UART_PORT, 3));    // UART_DATA after 3 idle symbols
+
+    /* Bridge rings and tasks; they idle until a client connects */
+    spp_ring_init(&uart_to_bt, uart_to_bt_buf, sizeof uart_to_bt_buf);
+    spp_ring_init(&bt_to_uart, bt_to_uart_buf, sizeof bt_to_uart_buf);
+    bt_to_uart_space = xSemaphoreCreateBinary();
+    xTaskCreate(spp_tx_task,  "spp_tx",  4096, NULL, 11, &spp_tx_task_handle);
+    xTaskCreate(uart_tx_task, "uart_tx", 3072, NULL, 12, &uart_tx_task_handle);
+    xTaskCreate(uart_rx_task, "uart_rx", 3072, NULL, 12, &uart_rx_task_handle);
+    bridge_stats_reset();
+
+    /* Console commands on the log UART */
+    ESP_ERROR_CHECK(uart_driver_install(CONSOLE_UART, 256, 0, 0, NULL, 0));
+    xTaskCreate(console_task, "console", 3072, NULL, 1, NULL);
 
     /* BT stack */
     ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_BLE));
@@ -171,8 +446,5 @@ void app_main(void)
     esp_bt_gap_set_device_name(local_device_name);
     esp_bt_gap_set_scan_mode(ESP_BT_CONNECTABLE, ESP_BT_GENERAL_DISCOVERABLE);
 
-    /* Start the UART ➜ BT bridge once everything else is ready */
-    xTaskCreate(uart_to_bt_task, "uart_to_bt", 4096, NULL, 10, NULL);
-
     ESP_LOGI(SPP_TAG, "Bridge ready – pair and open SPP port.");
 }
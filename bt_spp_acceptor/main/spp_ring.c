@@ -0,0 +1,156 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "spp_ring.h"
+
+#include <string.h>
+
+bool spp_ring_init(spp_ring_t *ring, uint8_t *buf, size_t capacity)
+{
+    if (!ring || !buf || capacity < 2 || (capacity & (capacity - 1)) || capacity > 0x80000000U) return false;
+    memset(ring, 0, sizeof(*ring));
+    ring->buf  = buf;
+    ring->mask = (uint32_t)capacity - 1U;
+    return true;
+}
+
+size_t spp_ring_capacity(const spp_ring_t *ring)
+{
+    return (size_t)ring->mask + 1U;
+}
+
+size_t spp_ring_used(const spp_ring_t *ring)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return head - tail;
+}
+
+size_t spp_ring_free(const spp_ring_t *ring)
+{
+    return spp_ring_capacity(ring) - spp_ring_used(ring);
+}
+
+/* ---------- producer ---------- */
+size_t spp_ring_write_ptr(spp_ring_t *ring, uint8_t **out)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t   room = spp_ring_capacity(ring) - (head - tail);
+    size_t   till_end = spp_ring_capacity(ring) - (head & ring->mask);
+
+    *out = ring->buf + (head & ring->mask);
+    return room < till_end ? room : till_end;
+}
+
+void spp_ring_commit(spp_ring_t *ring, size_t len, int64_t now_us)
+{
+    if (len == 0) return;
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed) + (uint32_t)len;
+    uint32_t sh   = atomic_load_explicit(&ring->stamp_head, memory_order_relaxed);
+    uint32_t st   = atomic_load_explicit(&ring->stamp_tail, memory_order_acquire);
+
+    if (sh - st < SPP_RING_STAMPS) {
+        ring->stamps[sh & (SPP_RING_STAMPS - 1U)] = (spp_ring_stamp_t){ .end = head, .t_us = now_us };
+        atomic_store_explicit(&ring->stamp_head, sh + 1U, memory_order_release);
+    }
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+
+    uint32_t used = head - atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (used > ring->high_water) ring->high_water = used;
+}
+
+size_t spp_ring_write(spp_ring_t *ring, const void *src, size_t len, int64_t now_us)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t   room = spp_ring_capacity(ring) - (head - tail);
+    size_t   n = len < room ? len : room;
+    if (n == 0) return 0;
+
+    /* At most two pieces, published as one stamped write. */
+    size_t off = head & ring->mask;
+    size_t first = spp_ring_capacity(ring) - off;
+    if (first > n) first = n;
+    memcpy(ring->buf + off, src, first);
+    memcpy(ring->buf, (const uint8_t *)src + first, n - first);
+    spp_ring_commit(ring, n, now_us);
+    return n;
+}
+
+/* ---------- consumer ---------- */
+size_t spp_ring_peek(const spp_ring_t *ring, const uint8_t **out)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t   used = head - tail;
+    size_t   till_end = spp_ring_capacity(ring) - (tail & ring->mask);
+
+    *out = ring->buf + (tail & ring->mask);
+    return used < till_end ? used : till_end;
+}
+
+size_t spp_ring_copy(const spp_ring_t *ring, void *dst, size_t max)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t   n = head - tail;
+    if (n > max) n = max;
+
+    size_t off = tail & ring->mask;
+    size_t first = spp_ring_capacity(ring) - off;
+    if (first > n) first = n;
+    memcpy(dst, ring->buf + off, first);
+    memcpy((uint8_t *)dst + first, ring->buf, n - first);
+    return n;
+}
+
+void spp_ring_consume(spp_ring_t *ring, size_t len)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + (uint32_t)len, memory_order_release);
+}
+
+bool spp_ring_pop_stamp(spp_ring_t *ring, int64_t *out_t_us)
+{
+    uint32_t st = atomic_load_explicit(&ring->stamp_tail, memory_order_relaxed);
+    uint32_t sh = atomic_load_explicit(&ring->stamp_head, memory_order_acquire);
+    if (st == sh) return false;
+
+    const spp_ring_stamp_t *s = &ring->stamps[st & (SPP_RING_STAMPS - 1U)];
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if ((int32_t)(s->end - tail) > 0) return false;
+
+    *out_t_us = s->t_us;
+    atomic_store_explicit(&ring->stamp_tail, st + 1U, memory_order_release);
+    return true;
+}
+
+bool spp_ring_oldest(const spp_ring_t *ring, int64_t *out_t_us)
+{
+    uint32_t st = atomic_load_explicit(&ring->stamp_tail, memory_order_relaxed);
+    uint32_t sh = atomic_load_explicit(&ring->stamp_head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    /* Stamps of fully consumed writes may not have been popped yet. */
+    for (; st != sh; ++st) {
+        const spp_ring_stamp_t *s = &ring->stamps[st & (SPP_RING_STAMPS - 1U)];
+        if ((int32_t)(s->end - tail) > 0) {
+            *out_t_us = s->t_us;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t spp_ring_discard(spp_ring_t *ring)
+{
+    size_t  n = spp_ring_used(ring);
+    int64_t t;
+    spp_ring_consume(ring, n);
+    while (spp_ring_pop_stamp(ring, &t)) {
+    }
+    return n;
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+/*
+ * Lock-free single-producer / single-consumer byte ring for the UART<->SPP
+ * bridge. One task (or callback) writes, one reads; nothing else touches it.
+ *
+ * Every write is stamped with the time it entered the ring, so the consumer
+ * can tell how long bytes waited: spp_ring_oldest() gives the age of the
+ * oldest unsent byte, and after spp_ring_consume() spp_ring_pop_stamp()
+ * returns the stamp of each write that has now been consumed completely.
+ * When the stamp FIFO is full a write goes unstamped and its bytes count
+ * towards the next stamp.
+ *
+ * Plain C11 atomics only: no FreeRTOS or ESP-IDF dependency.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPP_RING_STAMPS 64U               // power of two
+
+typedef struct {
+    uint32_t end;                         // head position after the write
+    int64_t  t_us;
+} spp_ring_stamp_t;
+
+typedef struct {
+    uint8_t         *buf;
+    uint32_t         mask;                // capacity - 1
+    _Atomic uint32_t head;                // bytes ever written (producer)
+    _Atomic uint32_t tail;                // bytes ever consumed (consumer)
+    spp_ring_stamp_t stamps[SPP_RING_STAMPS];
+    _Atomic uint32_t stamp_head;          // producer
+    _Atomic uint32_t stamp_tail;          // consumer
+    uint32_t         high_water;          // most bytes ever held, producer side
+} spp_ring_t;
+
+/* capacity must be a power of two. */
+bool   spp_ring_init(spp_ring_t *ring, uint8_t *buf, size_t capacity);
+
+size_t spp_ring_capacity(const spp_ring_t *ring);
+size_t spp_ring_used(const spp_ring_t *ring);
+size_t spp_ring_free(const spp_ring_t *ring);
+
+/* ---------- producer ---------- */
+/* Copies as much of src as fits; returns the byte count written. */
+size_t spp_ring_write(spp_ring_t *ring, const void *src, size_t len, int64_t now_us);
+/* Contiguous free space for zero-copy fills; publish it with spp_ring_commit(). */
+size_t spp_ring_write_ptr(spp_ring_t *ring, uint8_t **out);
+void   spp_ring_commit(spp_ring_t *ring, size_t len, int64_t now_us);
+
+/* ---------- consumer ---------- */
+/* Contiguous readable bytes at the tail, without consuming them. */
+size_t spp_ring_peek(const spp_ring_t *ring, const uint8_t **out);
+/* Up to max readable bytes copied to dst across the wrap, without consuming. */
+size_t spp_ring_copy(const spp_ring_t *ring, void *dst, size_t max);
+void   spp_ring_consume(spp_ring_t *ring, size_t len);
+/* Stamp of the next write whose bytes have all been consumed. */
+bool   spp_ring_pop_stamp(spp_ring_t *ring, int64_t *out_t_us);
+/* Stamp of the oldest write still (partly) in the ring. */
+bool   spp_ring_oldest(const spp_ring_t *ring, int64_t *out_t_us);
+/* Consumes everything and its stamps; returns the bytes dropped. */
+size_t spp_ring_discard(spp_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
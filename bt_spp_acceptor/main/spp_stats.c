@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "spp_stats.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+static const char *const flow_names[SPP_STATS_DIRS] = { "uart->bt", "bt->uart" };
+
+void spp_stats_reset(spp_stats_t *s, int64_t now_us, size_t uart_to_bt_ring, size_t bt_to_uart_ring)
+{
+    memset(s, 0, sizeof(*s));
+    s->since_us = now_us;
+    s->flow[SPP_STATS_UART_TO_BT].ring_capacity = (uint32_t)uart_to_bt_ring;
+    s->flow[SPP_STATS_BT_TO_UART].ring_capacity = (uint32_t)bt_to_uart_ring;
+    for (int i = 0; i < SPP_STATS_DIRS; ++i) hdr_hist_reset(&s->flow[i].latency_us);
+}
+
+void spp_stats_record_send(spp_stats_t *s, spp_stats_dir_t dir, size_t len, size_t ring_used)
+{
+    spp_stats_flow_t *f = &s->flow[dir];
+    f->bytes += len;
+    f->writes++;
+    f->ring_samples++;
+    f->ring_sum += ring_used;
+    if (ring_used > f->ring_peak) f->ring_peak = (uint32_t)ring_used;
+}
+
+void spp_stats_record_latency(spp_stats_t *s, spp_stats_dir_t dir, uint32_t latency_us)
+{
+    hdr_hist_record(&s->flow[dir].latency_us, latency_us);
+}
+
+void spp_stats_record_drop(spp_stats_t *s, spp_stats_dir_t dir, size_t len)
+{
+    s->flow[dir].dropped += (uint32_t)len;
+}
+
+static void dump_flow(const char *name, const spp_stats_flow_t *f, int64_t elapsed_us, FILE *out)
+{
+    const hdr_hist_t *h = &f->latency_us;
+    uint64_t kbps_x10 = elapsed_us > 0 ? f->bytes * 8U * 10000U / (uint64_t)elapsed_us : 0;
+
+    fprintf(out, "%s: %" PRIu64 " B, %" PRIu64 ".%" PRIu64 " kbit/s, %" PRIu32 " writes, %" PRIu32 " B dropped\n",
+            name, f->bytes, kbps_x10 / 10U, kbps_x10 % 10U, f->writes, f->dropped);
+    fprintf(out, "  latency us: n %" PRIu32 ", min %" PRIu32 ", p50 %" PRIu32 ", p90 %" PRIu32 ", p99 %" PRIu32
+            ", p99.9 %" PRIu32 ", max %" PRIu32 ", mean %" PRIu32 "\n",
+            h->total, h->total ? h->min : 0, hdr_hist_percentile(h, 5000), hdr_hist_percentile(h, 9000),
+            hdr_hist_percentile(h, 9900), hdr_hist_percentile(h, 9990), h->max, hdr_hist_mean(h));
+    fprintf(out, "  ring B: now %" PRIu32 ", mean %" PRIu32 ", peak %" PRIu32 " of %" PRIu32 "\n",
+            f->ring_now, f->ring_samples ? (uint32_t)(f->ring_sum / f->ring_samples) : 0, f->ring_peak,
+            f->ring_capacity);
+}
+
+void spp_stats_dump(const spp_stats_t *s, int64_t now_us, FILE *out)
+{
+    int64_t elapsed_us = now_us - s->since_us;
+
+    fprintf(out, "bridge stats over %" PRId64 ".%03" PRId64 " s\n", elapsed_us / 1000000, elapsed_us / 1000 % 1000);
+    for (int i = 0; i < SPP_STATS_DIRS; ++i) dump_flow(flow_names[i], &s->flow[i], elapsed_us, out);
+    fprintf(out, "congestion events %" PRIu32 ", uart overflows %" PRIu32 "\n", s->congestion_events,
+            s->uart_overflows);
+}
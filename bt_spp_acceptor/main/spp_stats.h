@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+/*
+ * Per-connection counters for the UART<->SPP bridge, one flow per
+ * direction: bytes, writes, drops, a latency histogram (ring entry until
+ * the bytes were handed to esp_spp_write() / the UART driver) and ring
+ * occupancy sampled at every send. Plus congestion and UART overflow
+ * counts for the link.
+ *
+ * Plain data and no locking: the bridge updates it under its own lock and
+ * dumps a copy. No FreeRTOS or ESP-IDF dependency.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hdr_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SPP_STATS_UART_TO_BT = 0,
+    SPP_STATS_BT_TO_UART,
+    SPP_STATS_DIRS
+} spp_stats_dir_t;
+
+typedef struct {
+    uint64_t   bytes;
+    uint32_t   writes;            // esp_spp_write() / uart_write_bytes() calls
+    uint32_t   dropped;           // bytes
+    hdr_hist_t latency_us;        // one sample per ring write, when its last byte is sent
+    uint32_t   ring_capacity;
+    uint32_t   ring_now;          // filled in by whoever takes the copy to dump
+    uint32_t   ring_peak;
+    uint32_t   ring_samples;
+    uint64_t   ring_sum;
+} spp_stats_flow_t;
+
+typedef struct {
+    int64_t          since_us;
+    spp_stats_flow_t flow[SPP_STATS_DIRS];
+    uint32_t         congestion_events;
+    uint32_t         uart_overflows;
+} spp_stats_t;
+
+void spp_stats_reset(spp_stats_t *s, int64_t now_us, size_t uart_to_bt_ring, size_t bt_to_uart_ring);
+
+/* ring_used: bytes in the ring before this send is consumed. */
+void spp_stats_record_send(spp_stats_t *s, spp_stats_dir_t dir, size_t len, size_t ring_used);
+void spp_stats_record_latency(spp_stats_t *s, spp_stats_dir_t dir, uint32_t latency_us);
+void spp_stats_record_drop(spp_stats_t *s, spp_stats_dir_t dir, size_t len);
+
+void spp_stats_dump(const spp_stats_t *s, int64_t now_us, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
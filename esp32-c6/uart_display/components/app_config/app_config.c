@@ -0,0 +1,196 @@
+#include "app_config.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "sd_storage.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#define APP_CONFIG_NVS_NAMESPACE "app_config"
+#define APP_CONFIG_NVS_KEY "config"
+
+static const char *TAG = "app_config";
+
+/* NVS blob layout; version and size reject records written by other firmware. */
+typedef struct {
+    uint16_t version;
+    uint16_t config_size;
+    uint32_t sd_size;   /* fingerprint of the last imported file */
+    int64_t sd_mtime;
+    app_config_t config;
+} app_config_record_t;
+
+static app_config_record_t s_record;
+static app_config_source_t s_source = APP_CONFIG_SOURCE_DEFAULTS;
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+
+static bool app_config_load_record(app_config_record_t *record)
+{
+    nvs_handle_t handle;
+    if (nvs_open(APP_CONFIG_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false; /* namespace not created yet: first boot */
+    }
+
+    size_t size = sizeof(*record);
+    const esp_err_t ret = nvs_get_blob(handle, APP_CONFIG_NVS_KEY, record, &size);
+    nvs_close(handle);
+    if (ret != ESP_OK) {
+        return false;
+    }
+    if (size != sizeof(*record) || record->version != APP_CONFIG_VERSION ||
+        record->config_size != sizeof(record->config)) {
+        ESP_LOGW(TAG, "stored config v%u (%u bytes) ignored, expected v%u", (unsigned)record->version,
+                 (unsigned)size, (unsigned)APP_CONFIG_VERSION);
+        return false;
+    }
+    return true;
+}
+
+static bool app_config_store_record(const app_config_record_t *record)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(APP_CONFIG_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(handle, APP_CONFIG_NVS_KEY, record, sizeof(*record));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "config not saved: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+bool app_config_init(void)
+{
+    if (s_lock != NULL) {
+        return true;
+    }
+    s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+
+    memset(&s_record, 0, sizeof(s_record));
+    app_config_get_defaults(&s_record.config);
+
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "NVS init failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    app_config_record_t record;
+    if (app_config_load_record(&record)) {
+        s_record = record;
+        s_source = APP_CONFIG_SOURCE_NVS;
+        ESP_LOGI(TAG, "loaded v%u from NVS", (unsigned)APP_CONFIG_VERSION);
+    }
+    return true;
+}
+
+void app_config_get(app_config_t *out_config)
+{
+    if (out_config == NULL) {
+        return;
+    }
+    if (s_lock == NULL) {
+        app_config_get_defaults(out_config);
+        return;
+    }
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    memcpy(out_config, &s_record.config, sizeof(*out_config));
+    (void)xSemaphoreGive(s_lock);
+}
+
+app_config_source_t app_config_get_source(void)
+{
+    return s_source;
+}
+
+bool app_config_save(const app_config_t *config)
+{
+    if (config == NULL || s_lock == NULL) {
+        return false;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    app_config_record_t record = s_record;
+    record.version = APP_CONFIG_VERSION;
+    record.config_size = sizeof(record.config);
+    record.config = *config;
+    const bool saved = app_config_store_record(&record);
+    if (saved) {
+        s_record = record;
+    }
+    (void)xSemaphoreGive(s_lock);
+    return saved;
+}
+
+bool app_config_import_sd(const char *path)
+{
+    struct stat st;
+    if (path == NULL || s_lock == NULL || stat(path, &st) != 0) {
+        return false;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool already_imported = (s_source != APP_CONFIG_SOURCE_DEFAULTS) && s_record.sd_size == (uint32_t)st.st_size &&
+                                  s_record.sd_mtime == (int64_t)st.st_mtime;
+    (void)xSemaphoreGive(s_lock);
+    if (already_imported) {
+        ESP_LOGI(TAG, "%s unchanged since import", path);
+        return false;
+    }
+
+    char text[APP_CONFIG_FILE_MAX_LEN];
+    if (!SD_ReadFile(path, text, sizeof(text))) {
+        return false;
+    }
+
+    app_config_record_t record;
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    record = s_record;
+    (void)xSemaphoreGive(s_lock);
+
+    const uint32_t found = app_config_parse(text, strlen(text), &record.config);
+    if (found == 0U) {
+        ESP_LOGW(TAG, "no usable settings in %s", path);
+        APP_LOGW(STORAGE, "no usable settings in config file");
+        return false;
+    }
+    record.version = APP_CONFIG_VERSION;
+    record.config_size = sizeof(record.config);
+    record.sd_size = (uint32_t)st.st_size;
+    record.sd_mtime = (int64_t)st.st_mtime;
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool saved = app_config_store_record(&record);
+    s_record = record; /* use it this boot even if NVS refused it */
+    s_source = APP_CONFIG_SOURCE_SD;
+    (void)xSemaphoreGive(s_lock);
+
+    ESP_LOGI(TAG, "imported %s (keys 0x%x)%s", path, (unsigned)found, saved ? "" : ", not persisted");
+    APP_LOGI(STORAGE, "config imported from SD");
+    return true;
+}
+
+void app_config_apply_log_levels(const app_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+    for (int i = 0; i < APP_LOG_SUBSYS_COUNT; ++i) {
+        app_log_set_output_level((app_log_subsystem_t)i, (app_log_level_t)config->log_levels[i]);
+    }
+}
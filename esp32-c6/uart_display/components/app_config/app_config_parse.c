@@ -0,0 +1,179 @@
+#include "app_config.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+void app_config_get_defaults(app_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    for (size_t i = 0; i < APP_LOG_SUBSYS_COUNT; ++i) {
+        config->log_levels[i] = APP_CONFIG_DEFAULT_LOG_LEVEL;
+    }
+    config->rest_port = APP_CONFIG_DEFAULT_REST_PORT;
+    config->brightness = APP_CONFIG_DEFAULT_BRIGHTNESS;
+}
+
+typedef struct {
+    const char *ptr;
+    size_t len;
+} app_config_span_t;
+
+static app_config_span_t app_config_trim(const char *ptr, size_t len)
+{
+    while (len > 0U && isspace((unsigned char)ptr[0])) {
+        ptr++;
+        len--;
+    }
+    while (len > 0U && isspace((unsigned char)ptr[len - 1U])) {
+        len--;
+    }
+    return (app_config_span_t){ .ptr = ptr, .len = len };
+}
+
+static bool app_config_span_eq(app_config_span_t span, const char *str, bool ignore_case)
+{
+    const size_t len = strlen(str);
+    if (span.len != len) {
+        return false;
+    }
+    return ignore_case ? (strncasecmp(span.ptr, str, len) == 0) : (strncmp(span.ptr, str, len) == 0);
+}
+
+static bool app_config_parse_uint(app_config_span_t value, uint32_t max, uint32_t *out)
+{
+    if (value.len == 0U || value.len > 5U) {
+        return false;
+    }
+    uint32_t result = 0U;
+    for (size_t i = 0; i < value.len; ++i) {
+        if (value.ptr[i] < '0' || value.ptr[i] > '9') {
+            return false;
+        }
+        result = result * 10U + (uint32_t)(value.ptr[i] - '0');
+    }
+    if (result > max) {
+        return false;
+    }
+    *out = result;
+    return true;
+}
+
+static bool app_config_parse_level(app_config_span_t value, uint8_t *out)
+{
+    uint32_t number;
+    if (app_config_parse_uint(value, APP_LOG_LEVEL_DEBUG, &number)) {
+        *out = (uint8_t)number;
+        return true;
+    }
+    /* Same names as the log line prefix, so the file can be copied from a log. */
+    for (int level = APP_LOG_LEVEL_NONE; level <= APP_LOG_LEVEL_DEBUG; ++level) {
+        if (app_config_span_eq(value, app_log_level_to_str((app_log_level_t)level), true)) {
+            *out = (uint8_t)level;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void app_config_copy_str(char *dst, size_t dst_len, app_config_span_t value)
+{
+    const size_t len = (value.len < dst_len - 1U) ? value.len : dst_len - 1U;
+    memcpy(dst, value.ptr, len);
+    dst[len] = '\0';
+}
+
+/* Applies one "KEY: value" line; returns the app_config_key_t bit it set, or 0. */
+static uint32_t app_config_parse_line(app_config_span_t key, app_config_span_t value, app_config_t *config,
+                                      bool *pass_seen)
+{
+    uint32_t number;
+    uint8_t level;
+
+    if (app_config_span_eq(key, "SSID", false)) {
+        if (value.len == 0U) {
+            return 0U;
+        }
+        app_config_copy_str(config->wifi_ssid, sizeof(config->wifi_ssid), value);
+        return APP_CONFIG_KEY_WIFI;
+    }
+    if (app_config_span_eq(key, "PASS", false)) {
+        app_config_copy_str(config->wifi_pass, sizeof(config->wifi_pass), value);
+        *pass_seen = true;
+        return APP_CONFIG_KEY_WIFI;
+    }
+    if (app_config_span_eq(key, "REST_PORT", false)) {
+        if (!app_config_parse_uint(value, UINT16_MAX, &number) || number == 0U) {
+            return 0U;
+        }
+        config->rest_port = (uint16_t)number;
+        return APP_CONFIG_KEY_REST_PORT;
+    }
+    if (app_config_span_eq(key, "BRIGHTNESS", false)) {
+        if (!app_config_parse_uint(value, 100U, &number)) {
+            return 0U;
+        }
+        config->brightness = (uint8_t)number;
+        return APP_CONFIG_KEY_BRIGHTNESS;
+    }
+    if (app_config_span_eq(key, "LOG", false)) {
+        if (!app_config_parse_level(value, &level)) {
+            return 0U;
+        }
+        memset(config->log_levels, level, sizeof(config->log_levels));
+        return APP_CONFIG_KEY_LOG;
+    }
+    if (key.len > 4U && strncmp(key.ptr, "LOG_", 4) == 0) {
+        const app_config_span_t subsys = { .ptr = key.ptr + 4, .len = key.len - 4U };
+        for (int i = 0; i < APP_LOG_SUBSYS_COUNT; ++i) {
+            if (app_config_span_eq(subsys, app_log_subsystem_to_str((app_log_subsystem_t)i), false)) {
+                if (!app_config_parse_level(value, &level)) {
+                    return 0U;
+                }
+                config->log_levels[i] = level;
+                return APP_CONFIG_KEY_LOG;
+            }
+        }
+    }
+    return 0U;
+}
+
+uint32_t app_config_parse(const char *text, size_t len, app_config_t *config)
+{
+    if (text == NULL || config == NULL) {
+        return 0U;
+    }
+
+    uint32_t found = 0U;
+    bool pass_seen = false;
+    size_t pos = 0U;
+
+    /* One pass over the buffer; spans point into it, nothing is copied or shifted. */
+    while (pos < len && text[pos] != '\0') {
+        size_t end = pos;
+        while (end < len && text[end] != '\n' && text[end] != '\0') {
+            end++;
+        }
+
+        const char *colon = memchr(text + pos, ':', end - pos);
+        if (colon != NULL) {
+            const app_config_span_t key = app_config_trim(text + pos, (size_t)(colon - (text + pos)));
+            const app_config_span_t value = app_config_trim(colon + 1, (size_t)((text + end) - (colon + 1)));
+            found |= app_config_parse_line(key, value, config, &pass_seen);
+        }
+        if (end >= len || text[end] == '\0') {
+            break;
+        }
+        pos = end + 1U;
+    }
+
+    /* A new SSID without a PASS line is an open network, not the old password. */
+    if ((found & APP_CONFIG_KEY_WIFI) != 0U && !pass_seen) {
+        config->wifi_pass[0] = '\0';
+    }
+    return found;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ * app_config.h
+ *
+ * Typed device configuration (WiFi credentials, log levels, REST port,
+ * display brightness) kept in NVS as one versioned record.
+ *
+ * app_config_init() reads the record from NVS, so a normal boot has its
+ * configuration without touching the SD card. app_config_import_sd() parses
+ * a text file (APP_CONFIG_SD_PATH) over the current values and persists the
+ * result; the file's size and mtime are stored with the record, so an
+ * unchanged file is never read or parsed again.
+ *
+ * File format, one "KEY: value" per line (unknown keys are ignored):
+ *   SSID: <name>           PASS: <password>      (PASS optional)
+ *   LOG: <level>           all subsystems
+ *   LOG_<SUBSYS>: <level>  SUBSYS as printed in log lines (WIFI, SD, REST...)
+ *   REST_PORT: <1-65535>   BRIGHTNESS: <0-100>
+ * Levels: NONE, CRIT, ERR, WARN, INFO, DBG (or 0-5).
+ */
+
+#include "app_log.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bump when app_config_t changes; older NVS records are then ignored. */
+#define APP_CONFIG_VERSION 1U
+
+#define APP_CONFIG_SD_PATH "/sdcard/WIFI.TXT"
+#define APP_CONFIG_SSID_LEN 32
+#define APP_CONFIG_PASS_LEN 64
+#define APP_CONFIG_FILE_MAX_LEN 512U
+
+#define APP_CONFIG_DEFAULT_REST_PORT 80U
+#define APP_CONFIG_DEFAULT_BRIGHTNESS 50U
+#define APP_CONFIG_DEFAULT_LOG_LEVEL APP_LOG_LEVEL_DEBUG
+
+typedef struct {
+    char wifi_ssid[APP_CONFIG_SSID_LEN + 1]; /* empty: use WIFI_DEFAULT_SSID */
+    char wifi_pass[APP_CONFIG_PASS_LEN + 1];
+    uint8_t log_levels[APP_LOG_SUBSYS_COUNT]; /* app_log_level_t per subsystem */
+    uint16_t rest_port;
+    uint8_t brightness; /* percent */
+} app_config_t;
+
+typedef enum {
+    APP_CONFIG_SOURCE_DEFAULTS = 0,
+    APP_CONFIG_SOURCE_NVS,
+    APP_CONFIG_SOURCE_SD, /* imported during this boot */
+} app_config_source_t;
+
+/* app_config_parse() result bits: keys that were present and valid. */
+typedef enum {
+    APP_CONFIG_KEY_WIFI = 1U << 0,
+    APP_CONFIG_KEY_LOG = 1U << 1,
+    APP_CONFIG_KEY_REST_PORT = 1U << 2,
+    APP_CONFIG_KEY_BRIGHTNESS = 1U << 3,
+} app_config_key_t;
+
+void app_config_get_defaults(app_config_t *config);
+
+/* Parses text (len bytes, need not be NUL-terminated) over config. No I/O. */
+uint32_t app_config_parse(const char *text, size_t len, app_config_t *config);
+
+/* Initializes NVS and loads the stored record; defaults if none or stale. */
+bool app_config_init(void);
+
+void app_config_get(app_config_t *out_config);
+app_config_source_t app_config_get_source(void);
+
+/* Persists config to NVS and makes it current. */
+bool app_config_save(const app_config_t *config);
+
+/* SD card mounted: imports path unless it is the file already imported. True if the config changed. */
+bool app_config_import_sd(const char *path);
+
+void app_config_apply_log_levels(const app_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
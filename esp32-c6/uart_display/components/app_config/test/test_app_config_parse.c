@@ -0,0 +1,64 @@
+#include "app_config.h"
+
+#include "unity.h"
+
+#include <string.h>
+
+TEST_CASE("app_config parses the legacy WIFI.TXT format", "[app_config]")
+{
+    static const char text[] = "SSID:  Home Net \r\nPASS:\tsecret pass\r\n";
+    app_config_t config;
+    app_config_get_defaults(&config);
+
+    TEST_ASSERT_EQUAL_UINT32(APP_CONFIG_KEY_WIFI, app_config_parse(text, strlen(text), &config));
+    TEST_ASSERT_EQUAL_STRING("Home Net", config.wifi_ssid);
+    TEST_ASSERT_EQUAL_STRING("secret pass", config.wifi_pass);
+    TEST_ASSERT_EQUAL_UINT16(APP_CONFIG_DEFAULT_REST_PORT, config.rest_port);
+    TEST_ASSERT_EQUAL_UINT8(APP_CONFIG_DEFAULT_BRIGHTNESS, config.brightness);
+}
+
+TEST_CASE("app_config parses log levels, port and brightness", "[app_config]")
+{
+    static const char text[] = "LOG: INFO\nLOG_WIFI: dbg\nLOG_SD: 2\nREST_PORT: 8080\nBRIGHTNESS: 65\nCOLOR: blue";
+    app_config_t config;
+    app_config_get_defaults(&config);
+
+    TEST_ASSERT_EQUAL_UINT32(APP_CONFIG_KEY_LOG | APP_CONFIG_KEY_REST_PORT | APP_CONFIG_KEY_BRIGHTNESS,
+                             app_config_parse(text, strlen(text), &config));
+    TEST_ASSERT_EQUAL_UINT8(APP_LOG_LEVEL_INFO, config.log_levels[APP_LOG_SUBSYS_SYSTEM]);
+    TEST_ASSERT_EQUAL_UINT8(APP_LOG_LEVEL_DEBUG, config.log_levels[APP_LOG_SUBSYS_WIFI]);
+    TEST_ASSERT_EQUAL_UINT8(APP_LOG_LEVEL_ERROR, config.log_levels[APP_LOG_SUBSYS_STORAGE]);
+    TEST_ASSERT_EQUAL_UINT16(8080U, config.rest_port);
+    TEST_ASSERT_EQUAL_UINT8(65U, config.brightness);
+    TEST_ASSERT_EQUAL_STRING("", config.wifi_ssid);
+}
+
+TEST_CASE("app_config keeps old values for invalid entries", "[app_config]")
+{
+    static const char text[] = "SSID:\nREST_PORT: 70000\nBRIGHTNESS: 101\nLOG: LOUD\nLOG_FOO: INFO\n";
+    app_config_t config;
+    app_config_get_defaults(&config);
+    strcpy(config.wifi_ssid, "Office");
+    strcpy(config.wifi_pass, "kept");
+
+    TEST_ASSERT_EQUAL_UINT32(0U, app_config_parse(text, strlen(text), &config));
+    TEST_ASSERT_EQUAL_STRING("Office", config.wifi_ssid);
+    TEST_ASSERT_EQUAL_STRING("kept", config.wifi_pass);
+    TEST_ASSERT_EQUAL_UINT16(APP_CONFIG_DEFAULT_REST_PORT, config.rest_port);
+    TEST_ASSERT_EQUAL_UINT8(APP_CONFIG_DEFAULT_BRIGHTNESS, config.brightness);
+    TEST_ASSERT_EQUAL_UINT8(APP_CONFIG_DEFAULT_LOG_LEVEL, config.log_levels[APP_LOG_SUBSYS_REST]);
+}
+
+TEST_CASE("app_config new SSID without PASS clears the password", "[app_config]")
+{
+    static const char text[] = "SSID: Guest\nBRIGHTNESS: 5";
+    app_config_t config;
+    app_config_get_defaults(&config);
+    strcpy(config.wifi_pass, "old");
+
+    /* Parsing stops at len: the BRIGHTNESS line is not part of the input. */
+    TEST_ASSERT_EQUAL_UINT32(APP_CONFIG_KEY_WIFI, app_config_parse(text, 11U, &config));
+    TEST_ASSERT_EQUAL_STRING("Guest", config.wifi_ssid);
+    TEST_ASSERT_EQUAL_STRING("", config.wifi_pass);
+    TEST_ASSERT_EQUAL_UINT8(APP_CONFIG_DEFAULT_BRIGHTNESS, config.brightness);
+}
@@ -1,34 +1,48 @@
 #include "app_log.h"
+#include "app_log_registry.h"
+#include "app_log_ring.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 
+#include <inttypes.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
 
+#define APP_LOG_DRAIN_STACK_SIZE 3072U
+#define APP_LOG_DRAIN_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+
 static bool g_enabled = true;
 static app_log_level_t g_levels[APP_LOG_SUBSYS_COUNT];
-static const app_log_backend_t *g_backend = NULL;
+
+volatile uint8_t app_log_thresholds[APP_LOG_SUBSYS_COUNT];
 
 static StaticSemaphore_t g_mutex_buf;
 static SemaphoreHandle_t g_mutex = NULL;
+static volatile uint32_t g_mutex_drops = 0;
+
+static app_log_ring_slot_t g_ring_slots[APP_LOG_RING_CAPACITY];
+static app_log_ring_t g_ring;
+static TaskHandle_t g_drain_task = NULL;
+static app_log_drain_task_config_t g_drain_config;
 
 static inline bool subsys_in_range(app_log_subsystem_t s)
 {
     return (s >= 0) && (s < APP_LOG_SUBSYS_COUNT);
 }
 
-static inline bool should_log(app_log_subsystem_t subsystem, app_log_level_t level)
+void app_log_refresh_thresholds(void)
 {
-    if (!g_enabled) {
-        return false;
-    }
-
-    if (g_backend == NULL || g_backend->write_line == NULL) {
-        return false;
+    const bool active = g_enabled && app_log_registry_has_backends();
+    for (int i = 0; i < APP_LOG_SUBSYS_COUNT; ++i) {
+        app_log_thresholds[i] = active ? (uint8_t)g_levels[i] : (uint8_t)APP_LOG_LEVEL_NONE;
     }
+}
 
+static inline bool should_log(app_log_subsystem_t subsystem, app_log_level_t level)
+{
     if (level == APP_LOG_LEVEL_NONE) {
         return false;
     }
@@ -38,8 +52,7 @@ static inline bool should_log(app_log_subsystem_t subsystem, app_log_level_t lev
         subsystem = APP_LOG_SUBSYS_SYSTEM;
     }
 
-    const app_log_level_t threshold = g_levels[subsystem];
-    return level <= threshold;
+    return app_log_level_active(subsystem, level);
 }
 
 static size_t append_str(char *dst, size_t cap, size_t at, const char *src)
@@ -151,33 +164,36 @@ bool app_log_init(const app_log_backend_t *backend)
             g_levels[i] = APP_LOG_LEVEL_INFO;
         }
         defaults_set = true;
+        app_log_refresh_thresholds();
     }
 
-    g_backend = backend;
-
-    if (g_backend && g_backend->init) {
-        return g_backend->init(g_backend->ctx);
+    if (backend == NULL) {
+        return true;
     }
 
-    return (g_backend && g_backend->write_line);
+    app_log_backend_config_t config;
+    app_log_backend_get_default_config(&config);
+    config.name = "default";
+    config.backend = backend;
+    config.queue_len = 0U;
+    return app_log_add_backend(&config, NULL);
 }
 
 void app_log_deinit(void)
 {
-    if (g_backend && g_backend->deinit) {
-        g_backend->deinit(g_backend->ctx);
-    }
-    g_backend = NULL;
+    app_log_registry_clear();
 }
 
 void app_log_global_on(void)
 {
     g_enabled = true;
+    app_log_refresh_thresholds();
 }
 
 void app_log_global_off(void)
 {
     g_enabled = false;
+    app_log_refresh_thresholds();
 }
 
 bool app_log_is_enabled(void)
@@ -191,6 +207,7 @@ void app_log_set_output_level(app_log_subsystem_t subsystem, app_log_level_t lev
         for (int i = 0; i < APP_LOG_SUBSYS_COUNT; ++i) {
             g_levels[i] = level;
         }
+        app_log_refresh_thresholds();
         return;
     }
 
@@ -199,6 +216,7 @@ void app_log_set_output_level(app_log_subsystem_t subsystem, app_log_level_t lev
     }
 
     g_levels[subsystem] = level;
+    app_log_refresh_thresholds();
 }
 
 app_log_level_t app_log_get_output_level(app_log_subsystem_t subsystem)
@@ -210,10 +228,152 @@ app_log_level_t app_log_get_output_level(app_log_subsystem_t subsystem)
     return g_levels[subsystem];
 }
 
-static void backend_write(const char *line)
+static void backend_write(app_log_level_t level, const char *line)
+{
+    app_log_registry_write(level, line, NULL, 0U);
+}
+
+static size_t append_prefix(char *line, size_t cap, app_log_subsystem_t subsystem, app_log_level_t level)
+{
+    size_t at = 0;
+    line[0] = '\0';
+
+    at = append_char(line, cap, at, '[');
+    at = append_str(line, cap, at, app_log_subsystem_to_str(subsystem));
+    at = append_str(line, cap, at, "][");
+    at = append_str(line, cap, at, app_log_level_to_str(level));
+    at = append_str(line, cap, at, "] ");
+    return at;
+}
+
+static inline bool deferred_active(void)
 {
-    if (g_backend && g_backend->write_line) {
-        g_backend->write_line(g_backend->ctx, line);
+    return g_drain_task != NULL;
+}
+
+static void deferred_push_va(app_log_subsystem_t subsystem, app_log_level_t level, const char *fmt, va_list args)
+{
+    uint32_t ticket;
+    app_log_record_t *record = app_log_ring_reserve(&g_ring, &ticket);
+    if (record == NULL) {
+        return;
+    }
+
+    const uint32_t now_ms = (uint32_t)pdTICKS_TO_MS(xTaskGetTickCount());
+    app_log_record_capture(record, subsystem, level, now_ms, fmt, args);
+    app_log_ring_commit(&g_ring, ticket);
+
+    xTaskNotifyGive(g_drain_task);
+}
+
+static void deferred_push(app_log_subsystem_t subsystem, app_log_level_t level, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    deferred_push_va(subsystem, level, fmt, args);
+    va_end(args);
+}
+
+static void app_log_drain_task(void *arg)
+{
+    (void)arg;
+
+    app_log_record_t record;
+    char line[APP_LOG_MAX_LINE_LEN];
+    uint8_t frame[APP_LOG_MAX_LINE_LEN];
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (app_log_ring_pop(&g_ring, &record)) {
+            size_t at = append_prefix(line, sizeof(line),
+                                      (app_log_subsystem_t)record.subsystem,
+                                      (app_log_level_t)record.level);
+            (void)app_log_record_render(&record, &line[at], sizeof(line) - at);
+
+            size_t frame_len = 0U;
+            if (app_log_registry_wants_frames()) {
+                frame_len = app_log_record_encode(&record, frame, sizeof(frame));
+            }
+
+            app_log_registry_write((app_log_level_t)record.level, line,
+                                   (frame_len > 0U) ? frame : NULL, frame_len);
+        }
+    }
+}
+
+void app_log_drain_task_get_default_config(app_log_drain_task_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->stack_size = APP_LOG_DRAIN_STACK_SIZE;
+    config->task_priority = APP_LOG_DRAIN_TASK_PRIORITY;
+    config->core_id = tskNO_AFFINITY;
+}
+
+bool app_log_start_drain_task(const app_log_drain_task_config_t *config)
+{
+    if (config == NULL) {
+        return false;
+    }
+
+    if (g_drain_task != NULL) {
+        return true;
+    }
+
+    if (!app_log_ring_init(&g_ring, g_ring_slots, APP_LOG_RING_CAPACITY)) {
+        return false;
+    }
+
+    g_drain_config = *config;
+
+    TaskHandle_t handle = NULL;
+    BaseType_t ret;
+    if (g_drain_config.core_id == tskNO_AFFINITY) {
+        ret = xTaskCreate(app_log_drain_task,
+                          "app_log_drain",
+                          g_drain_config.stack_size,
+                          NULL,
+                          g_drain_config.task_priority,
+                          &handle);
+    } else {
+        ret = xTaskCreatePinnedToCore(app_log_drain_task,
+                                      "app_log_drain",
+                                      g_drain_config.stack_size,
+                                      NULL,
+                                      g_drain_config.task_priority,
+                                      &handle,
+                                      g_drain_config.core_id);
+    }
+
+    if (ret != pdPASS) {
+        return false;
+    }
+
+    /* Publishing the handle switches producers over to the ring. */
+    g_drain_task = handle;
+    return true;
+}
+
+void app_log_get_stats(app_log_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+
+    memset(out_stats, 0, sizeof(*out_stats));
+    out_stats->deferred = deferred_active();
+    out_stats->records_dropped = g_mutex_drops;
+
+    if (out_stats->deferred) {
+        app_log_ring_stats_t ring_stats;
+        app_log_ring_get_stats(&g_ring, &ring_stats);
+        out_stats->ring_capacity = ring_stats.capacity;
+        out_stats->ring_high_water = ring_stats.high_water;
+        out_stats->records_queued = ring_stats.pushed;
+        out_stats->records_dropped += ring_stats.dropped;
     }
 }
 
@@ -223,23 +383,22 @@ void app_log_write(app_log_subsystem_t subsystem, app_log_level_t level, const c
         return;
     }
 
+    if (deferred_active()) {
+        deferred_push(subsystem, level, "%s", msg);
+        return;
+    }
+
     /* Fast serialize only when emitting. */
     if (xSemaphoreTake(g_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        g_mutex_drops++;
         return;
     }
 
     char line[APP_LOG_MAX_LINE_LEN];
-    line[0] = '\0';
-    size_t at = 0;
-
-    at = append_char(line, sizeof(line), at, '[');
-    at = append_str(line, sizeof(line), at, app_log_subsystem_to_str(subsystem));
-    at = append_str(line, sizeof(line), at, "][");
-    at = append_str(line, sizeof(line), at, app_log_level_to_str(level));
-    at = append_str(line, sizeof(line), at, "] ");
+    size_t at = append_prefix(line, sizeof(line), subsystem, level);
     at = append_str(line, sizeof(line), at, msg);
 
-    backend_write(line);
+    backend_write(level, line);
 
     xSemaphoreGive(g_mutex);
 }
@@ -250,24 +409,23 @@ void app_log_write_num(app_log_subsystem_t subsystem, app_log_level_t level, con
         return;
     }
 
+    if (deferred_active()) {
+        deferred_push(subsystem, level, "%s: %" PRIi32, msg, number);
+        return;
+    }
+
     if (xSemaphoreTake(g_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        g_mutex_drops++;
         return;
     }
 
     char line[APP_LOG_MAX_LINE_LEN];
-    line[0] = '\0';
-    size_t at = 0;
-
-    at = append_char(line, sizeof(line), at, '[');
-    at = append_str(line, sizeof(line), at, app_log_subsystem_to_str(subsystem));
-    at = append_str(line, sizeof(line), at, "][");
-    at = append_str(line, sizeof(line), at, app_log_level_to_str(level));
-    at = append_str(line, sizeof(line), at, "] ");
+    size_t at = append_prefix(line, sizeof(line), subsystem, level);
     at = append_str(line, sizeof(line), at, msg);
     at = append_str(line, sizeof(line), at, ": ");
     at = append_i32(line, sizeof(line), at, number);
 
-    backend_write(line);
+    backend_write(level, line);
 
     xSemaphoreGive(g_mutex);
 }
@@ -278,7 +436,16 @@ void app_log_write_fmt(app_log_subsystem_t subsystem, app_log_level_t level, con
         return;
     }
 
+    if (deferred_active()) {
+        va_list args;
+        va_start(args, fmt);
+        deferred_push_va(subsystem, level, fmt, args);
+        va_end(args);
+        return;
+    }
+
     if (xSemaphoreTake(g_mutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        g_mutex_drops++;
         return;
     }
 
@@ -289,17 +456,10 @@ void app_log_write_fmt(app_log_subsystem_t subsystem, app_log_level_t level, con
     va_end(args);
 
     char line[APP_LOG_MAX_LINE_LEN];
-    line[0] = '\0';
-    size_t at = 0;
-
-    at = append_char(line, sizeof(line), at, '[');
-    at = append_str(line, sizeof(line), at, app_log_subsystem_to_str(subsystem));
-    at = append_str(line, sizeof(line), at, "][");
-    at = append_str(line, sizeof(line), at, app_log_level_to_str(level));
-    at = append_str(line, sizeof(line), at, "] ");
+    size_t at = append_prefix(line, sizeof(line), subsystem, level);
     at = append_str(line, sizeof(line), at, msg_buf);
 
-    backend_write(line);
+    backend_write(level, line);
 
     xSemaphoreGive(g_mutex);
 }
@@ -5,6 +5,7 @@
 /* Minimal-dependency UART backend.
  * Uses ROM printf routed to the default console UART.
  */
+#include "esp_rom_serial_output.h"
 #include "esp_rom_sys.h"
 
 static bool uart_init(void *ctx)
@@ -38,3 +39,24 @@ const app_log_backend_t *app_log_backend_uart(void)
 
     return &backend;
 }
+
+static void uart_write_frame(void *ctx, const uint8_t *frame, size_t len)
+{
+    (void)ctx;
+    for (size_t i = 0; i < len; ++i) {
+        (void)esp_rom_output_tx_one_char(frame[i]);
+    }
+}
+
+const app_log_backend_t *app_log_backend_uart_binary(void)
+{
+    static const app_log_backend_t backend = {
+        .init = uart_init,
+        .deinit = uart_deinit,
+        .write_line = uart_write_line,
+        .ctx = NULL,
+        .write_frame = uart_write_frame,
+    };
+
+    return &backend;
+}
@@ -0,0 +1,558 @@
+/*
+ * app_log_record.c
+ *
+ * Capture/render/encode of deferred log records. All passes walk the format
+ * string with the same parser so argument slots always line up.
+ */
+
+#include "app_log_record.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* '%', flags, two '*' widths expanded to INT_MIN, length modifier, NUL. */
+#define APP_LOG_SPEC_MAX_LEN 40
+#define APP_LOG_SPEC_INT_CHARS 11U
+
+_Static_assert(APP_LOG_RECORD_STR_LEN <= UINT8_MAX, "str_used is a uint8_t");
+
+typedef enum {
+    ARG_KIND_NONE = 0,  /* "%%" or malformed spec: no argument */
+    ARG_KIND_INT,
+    ARG_KIND_LONG,
+    ARG_KIND_LLONG,
+    ARG_KIND_SIZE,
+    ARG_KIND_INTMAX,
+    ARG_KIND_PTRDIFF,
+    ARG_KIND_DOUBLE,
+    ARG_KIND_LDOUBLE,
+    ARG_KIND_STR,
+    ARG_KIND_PTR,
+    ARG_KIND_COUNT_PTR, /* "%n": consumed, never rendered */
+} arg_kind_t;
+
+typedef struct {
+    const char *start; /* first char after '%' */
+    size_t len;        /* spec length, excluding '%' */
+    uint8_t stars;     /* '*' width/precision arguments preceding the value */
+    bool is_signed;
+    arg_kind_t kind;
+} fmt_spec_t;
+
+static const char *parse_spec(const char *p, fmt_spec_t *spec)
+{
+    spec->start = p;
+    spec->stars = 0;
+    spec->is_signed = false;
+    spec->kind = ARG_KIND_NONE;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+    }
+
+    arg_kind_t int_kind = ARG_KIND_INT;
+    bool long_double = false;
+    switch (*p) {
+        case 'h':
+            p++;
+            if (*p == 'h') {
+                p++;
+            }
+            break;
+        case 'l':
+            p++;
+            int_kind = ARG_KIND_LONG;
+            if (*p == 'l') {
+                p++;
+                int_kind = ARG_KIND_LLONG;
+            }
+            break;
+        case 'z':
+            p++;
+            int_kind = ARG_KIND_SIZE;
+            break;
+        case 'j':
+            p++;
+            int_kind = ARG_KIND_INTMAX;
+            break;
+        case 't':
+            p++;
+            int_kind = ARG_KIND_PTRDIFF;
+            break;
+        case 'L':
+            p++;
+            long_double = true;
+            break;
+        default:
+            break;
+    }
+
+    switch (*p) {
+        case 'd':
+        case 'i':
+            spec->is_signed = true;
+            spec->kind = int_kind;
+            break;
+        case 'c':
+            spec->is_signed = true;
+            spec->kind = ARG_KIND_INT;
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            spec->kind = int_kind;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec->kind = long_double ? ARG_KIND_LDOUBLE : ARG_KIND_DOUBLE;
+            break;
+        case 's':
+            spec->kind = ARG_KIND_STR;
+            break;
+        case 'p':
+            spec->kind = ARG_KIND_PTR;
+            break;
+        case 'n':
+            spec->kind = ARG_KIND_COUNT_PTR;
+            break;
+        case '\0':
+            /* Truncated spec at end of string: render nothing. */
+            spec->stars = 0;
+            spec->len = (size_t)(p - spec->start);
+            return p;
+        default:
+            /* "%%" and unknown conversions take no argument. */
+            spec->stars = 0;
+            break;
+    }
+
+    p++;
+    spec->len = (size_t)(p - spec->start);
+    return p;
+}
+
+static uint16_t capture_str(app_log_record_t *record, const char *s)
+{
+    if (s == NULL) {
+        s = "(null)";
+    }
+
+    size_t avail = sizeof(record->str_data) - record->str_used;
+    if (avail == 0U) {
+        return (uint16_t)(sizeof(record->str_data) - 1U);
+    }
+
+    const uint16_t offset = record->str_used;
+    size_t n = strlen(s);
+    if (n >= avail) {
+        n = avail - 1U;
+    }
+
+    memcpy(&record->str_data[offset], s, n);
+    record->str_data[offset + n] = '\0';
+    record->str_used = (uint8_t)(offset + n + 1U);
+    return offset;
+}
+
+void app_log_record_capture(app_log_record_t *record,
+                            app_log_subsystem_t subsystem,
+                            app_log_level_t level,
+                            uint32_t timestamp_ms,
+                            const char *fmt,
+                            va_list args)
+{
+    if (record == NULL) {
+        return;
+    }
+
+    record->timestamp_ms = timestamp_ms;
+    record->subsystem = (uint8_t)subsystem;
+    record->level = (uint8_t)level;
+    record->arg_count = 0;
+    record->str_used = 0;
+    record->fmt = (fmt != NULL) ? fmt : "";
+    record->str_data[sizeof(record->str_data) - 1U] = '\0';
+
+    const char *p = record->fmt;
+    while (*p) {
+        if (*p++ != '%') {
+            continue;
+        }
+
+        fmt_spec_t spec;
+        p = parse_spec(p, &spec);
+
+        if (spec.kind == ARG_KIND_NONE) {
+            continue;
+        }
+
+        /* Out of slots: stop consuming so rendering stays consistent. */
+        if ((size_t)record->arg_count + spec.stars + 1U > APP_LOG_RECORD_MAX_ARGS) {
+            break;
+        }
+
+        for (uint8_t s = 0; s < spec.stars; ++s) {
+            record->args[record->arg_count++].i = va_arg(args, int);
+        }
+
+        app_log_arg_t *arg = &record->args[record->arg_count++];
+        switch (spec.kind) {
+            case ARG_KIND_INT:
+                if (spec.is_signed) {
+                    arg->i = va_arg(args, int);
+                } else {
+                    arg->u = va_arg(args, unsigned int);
+                }
+                break;
+            case ARG_KIND_LONG:
+                if (spec.is_signed) {
+                    arg->i = va_arg(args, long);
+                } else {
+                    arg->u = va_arg(args, unsigned long);
+                }
+                break;
+            case ARG_KIND_LLONG:
+                if (spec.is_signed) {
+                    arg->i = va_arg(args, long long);
+                } else {
+                    arg->u = va_arg(args, unsigned long long);
+                }
+                break;
+            case ARG_KIND_SIZE:
+                arg->u = va_arg(args, size_t);
+                break;
+            case ARG_KIND_INTMAX:
+                if (spec.is_signed) {
+                    arg->i = va_arg(args, intmax_t);
+                } else {
+                    arg->u = va_arg(args, uintmax_t);
+                }
+                break;
+            case ARG_KIND_PTRDIFF:
+                arg->i = va_arg(args, ptrdiff_t);
+                break;
+            case ARG_KIND_DOUBLE:
+                arg->d = va_arg(args, double);
+                break;
+            case ARG_KIND_LDOUBLE:
+                arg->d = (double)va_arg(args, long double);
+                break;
+            case ARG_KIND_STR:
+                arg->str_offset = capture_str(record, va_arg(args, const char *));
+                break;
+            case ARG_KIND_PTR:
+            case ARG_KIND_COUNT_PTR:
+                arg->p = va_arg(args, const void *);
+                break;
+            case ARG_KIND_NONE:
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * Expand a conversion spec into dst with any '*' replaced by its captured
+ * value. Returns false, leaving dst unspecified, if the expansion would not
+ * fit in APP_LOG_SPEC_MAX_LEN; the caller must not format with a cut spec.
+ */
+static bool build_spec(char *dst, const fmt_spec_t *spec, const app_log_arg_t *stars)
+{
+    size_t at = 0;
+    uint8_t star = 0;
+
+    dst[at++] = '%';
+    for (size_t i = 0; i < spec->len; ++i) {
+        const char c = spec->start[i];
+        if (c == '*' && star < spec->stars) {
+            if (at + APP_LOG_SPEC_INT_CHARS + 1U > APP_LOG_SPEC_MAX_LEN) {
+                return false;
+            }
+            int n = snprintf(&dst[at], APP_LOG_SPEC_MAX_LEN - at, "%d", (int)stars[star++].i);
+            if (n > 0) {
+                at += (size_t)n;
+            }
+        } else {
+            if (at + 2U > APP_LOG_SPEC_MAX_LEN) {
+                return false;
+            }
+            dst[at++] = c;
+        }
+    }
+
+    dst[at] = '\0';
+    return true;
+}
+
+size_t app_log_record_render(const app_log_record_t *record, char *out_buf, size_t out_len)
+{
+    if (record == NULL || out_buf == NULL || out_len == 0U) {
+        return 0U;
+    }
+
+    size_t at = 0;
+    uint8_t next_arg = 0;
+    const char *p = record->fmt;
+
+    out_buf[0] = '\0';
+
+    while (*p && at + 1U < out_len) {
+        if (*p != '%') {
+            out_buf[at++] = *p++;
+            continue;
+        }
+
+        p++;
+        fmt_spec_t spec;
+        p = parse_spec(p, &spec);
+
+        if (spec.kind == ARG_KIND_NONE) {
+            if (spec.len == 1U && spec.start[0] == '%') {
+                out_buf[at++] = '%';
+            }
+            continue;
+        }
+
+        if ((size_t)next_arg + spec.stars + 1U > record->arg_count) {
+            /* Arguments were not captured (slot overflow); drop the rest. */
+            break;
+        }
+
+        char spec_buf[APP_LOG_SPEC_MAX_LEN];
+        const bool spec_ok = build_spec(spec_buf, &spec, &record->args[next_arg]);
+        next_arg += spec.stars;
+        const app_log_arg_t *arg = &record->args[next_arg++];
+
+        char *dst = &out_buf[at];
+        const size_t cap = out_len - at;
+        int n = 0;
+
+        if (!spec_ok) {
+            /* Overlong spec: show it verbatim rather than format with a cut one. */
+            n = snprintf(dst, cap, "%%%.*s", (int)spec.len, spec.start);
+            if (n > 0) {
+                at += ((size_t)n < cap) ? (size_t)n : (cap - 1U);
+            }
+            continue;
+        }
+
+        switch (spec.kind) {
+            case ARG_KIND_INT:
+                n = spec.is_signed ? snprintf(dst, cap, spec_buf, (int)arg->i)
+                                   : snprintf(dst, cap, spec_buf, (unsigned int)arg->u);
+                break;
+            case ARG_KIND_LONG:
+                n = spec.is_signed ? snprintf(dst, cap, spec_buf, (long)arg->i)
+                                   : snprintf(dst, cap, spec_buf, (unsigned long)arg->u);
+                break;
+            case ARG_KIND_LLONG:
+                n = spec.is_signed ? snprintf(dst, cap, spec_buf, (long long)arg->i)
+                                   : snprintf(dst, cap, spec_buf, (unsigned long long)arg->u);
+                break;
+            case ARG_KIND_SIZE:
+                n = snprintf(dst, cap, spec_buf, (size_t)arg->u);
+                break;
+            case ARG_KIND_INTMAX:
+                n = spec.is_signed ? snprintf(dst, cap, spec_buf, (intmax_t)arg->i)
+                                   : snprintf(dst, cap, spec_buf, (uintmax_t)arg->u);
+                break;
+            case ARG_KIND_PTRDIFF:
+                n = snprintf(dst, cap, spec_buf, (ptrdiff_t)arg->i);
+                break;
+            case ARG_KIND_DOUBLE:
+                n = snprintf(dst, cap, spec_buf, arg->d);
+                break;
+            case ARG_KIND_LDOUBLE:
+                n = snprintf(dst, cap, spec_buf, (long double)arg->d);
+                break;
+            case ARG_KIND_STR:
+                n = snprintf(dst, cap, spec_buf, &record->str_data[arg->str_offset]);
+                break;
+            case ARG_KIND_PTR:
+                n = snprintf(dst, cap, spec_buf, arg->p);
+                break;
+            case ARG_KIND_COUNT_PTR:
+            case ARG_KIND_NONE:
+            default:
+                n = 0;
+                break;
+        }
+
+        if (n > 0) {
+            at += ((size_t)n < cap) ? (size_t)n : (cap - 1U);
+        }
+    }
+
+    out_buf[at] = '\0';
+    return at;
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t at;
+    bool overflow;
+} frame_writer_t;
+
+static void frame_put(frame_writer_t *w, const void *src, size_t n)
+{
+    if (w->overflow || w->at + n > w->cap) {
+        w->overflow = true;
+        return;
+    }
+
+    memcpy(&w->buf[w->at], src, n);
+    w->at += n;
+}
+
+static void frame_put_u8(frame_writer_t *w, uint8_t v)
+{
+    frame_put(w, &v, 1U);
+}
+
+static void frame_put_u32(frame_writer_t *w, uint32_t v)
+{
+    const uint8_t le[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    frame_put(w, le, sizeof(le));
+}
+
+static void frame_put_varint(frame_writer_t *w, uint64_t v)
+{
+    while (v >= 0x80U) {
+        frame_put_u8(w, (uint8_t)(v | 0x80U));
+        v >>= 7;
+    }
+    frame_put_u8(w, (uint8_t)v);
+}
+
+static void frame_put_zigzag(frame_writer_t *w, int64_t v)
+{
+    frame_put_varint(w, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static void frame_put_double(frame_writer_t *w, double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    frame_put_u32(w, (uint32_t)bits);
+    frame_put_u32(w, (uint32_t)(bits >> 32));
+}
+
+size_t app_log_record_encode(const app_log_record_t *record, uint8_t *out_buf, size_t out_len)
+{
+    if (record == NULL || out_buf == NULL || out_len < APP_LOG_FRAME_OVERHEAD) {
+        return 0U;
+    }
+
+    /* Payload length is one byte. */
+    const size_t max_payload = out_len - APP_LOG_FRAME_OVERHEAD;
+    frame_writer_t w = {
+        .buf = &out_buf[2],
+        .cap = (max_payload < UINT8_MAX) ? max_payload : UINT8_MAX,
+        .at = 0U,
+        .overflow = false,
+    };
+
+    frame_put_u32(&w, (uint32_t)(uintptr_t)record->fmt);
+    frame_put_varint(&w, record->timestamp_ms);
+    frame_put_u8(&w, (uint8_t)((record->subsystem << 4) | (record->level & 0x0FU)));
+
+    uint8_t next_arg = 0;
+    const char *p = record->fmt;
+    while (*p) {
+        if (*p++ != '%') {
+            continue;
+        }
+
+        fmt_spec_t spec;
+        p = parse_spec(p, &spec);
+
+        if (spec.kind == ARG_KIND_NONE) {
+            continue;
+        }
+
+        /* Same cut-off as render: the decoder stops at the first missing arg. */
+        if ((size_t)next_arg + spec.stars + 1U > record->arg_count) {
+            break;
+        }
+
+        for (uint8_t s = 0; s < spec.stars; ++s) {
+            frame_put_zigzag(&w, record->args[next_arg++].i);
+        }
+
+        const app_log_arg_t *arg = &record->args[next_arg++];
+        switch (spec.kind) {
+            case ARG_KIND_INT:
+            case ARG_KIND_LONG:
+            case ARG_KIND_LLONG:
+            case ARG_KIND_SIZE:
+            case ARG_KIND_INTMAX:
+            case ARG_KIND_PTRDIFF:
+                if (spec.is_signed || spec.kind == ARG_KIND_PTRDIFF) {
+                    frame_put_zigzag(&w, arg->i);
+                } else {
+                    frame_put_varint(&w, arg->u);
+                }
+                break;
+            case ARG_KIND_DOUBLE:
+            case ARG_KIND_LDOUBLE:
+                frame_put_double(&w, arg->d);
+                break;
+            case ARG_KIND_STR: {
+                const char *str = &record->str_data[arg->str_offset];
+                frame_put(&w, str, strlen(str) + 1U);
+                break;
+            }
+            case ARG_KIND_PTR:
+                frame_put_u32(&w, (uint32_t)(uintptr_t)arg->p);
+                break;
+            case ARG_KIND_COUNT_PTR:
+            case ARG_KIND_NONE:
+            default:
+                break;
+        }
+    }
+
+    if (w.overflow) {
+        return 0U;
+    }
+
+    uint8_t check = 0;
+    for (size_t i = 0; i < w.at; ++i) {
+        check ^= w.buf[i];
+    }
+
+    out_buf[0] = (uint8_t)APP_LOG_FRAME_SYNC;
+    out_buf[1] = (uint8_t)w.at;
+    out_buf[2U + w.at] = check;
+    return w.at + APP_LOG_FRAME_OVERHEAD;
+}
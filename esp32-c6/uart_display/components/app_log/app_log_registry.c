@@ -0,0 +1,278 @@
+/*
+ * app_log_registry.c
+ *
+ * Fans each formatted line out to up to APP_LOG_MAX_BACKENDS backends.
+ * Inline backends are called on the logging task; queued backends get a
+ * bounded FreeRTOS queue and their own writer task so a slow sink (LCD, SD)
+ * never stalls the caller.
+ */
+
+#include "app_log_registry.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <string.h>
+
+#define APP_LOG_BACKEND_DEFAULT_QUEUE_LEN 16U
+#define APP_LOG_BACKEND_DEFAULT_STACK_SIZE 3072U
+#define APP_LOG_BACKEND_DEFAULT_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+
+typedef struct {
+    uint8_t frame_len; /* non-zero: data holds a binary frame, not text */
+    char data[APP_LOG_MAX_LINE_LEN];
+} app_log_queued_line_t;
+
+_Static_assert(APP_LOG_MAX_LINE_LEN <= UINT8_MAX, "frame_len is a uint8_t");
+
+typedef struct {
+    app_log_backend_config_t config;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+    volatile uint32_t level_mask;
+    volatile uint32_t high_water;
+    volatile uint32_t written;
+    volatile uint32_t dropped;
+} app_log_backend_slot_t;
+
+static app_log_backend_slot_t s_slots[APP_LOG_MAX_BACKENDS];
+static volatile size_t s_slot_count = 0;
+static volatile bool s_any_frame_backend = false;
+
+static void backend_writer_task(void *arg)
+{
+    app_log_backend_slot_t *slot = (app_log_backend_slot_t *)arg;
+    const app_log_backend_t *backend = slot->config.backend;
+    app_log_queued_line_t item;
+
+    while (1) {
+        if (xQueueReceive(slot->queue, &item, portMAX_DELAY) == pdTRUE) {
+            if (item.frame_len > 0U) {
+                backend->write_frame(backend->ctx, (const uint8_t *)item.data, item.frame_len);
+            } else {
+                backend->write_line(backend->ctx, item.data);
+            }
+        }
+    }
+}
+
+static void slot_note_depth(app_log_backend_slot_t *slot)
+{
+    const uint32_t depth = (uint32_t)uxQueueMessagesWaiting(slot->queue);
+    if (depth > slot->high_water) {
+        slot->high_water = depth;
+    }
+}
+
+static bool slot_takes_frame(const app_log_backend_slot_t *slot, const uint8_t *frame, size_t frame_len)
+{
+    return frame != NULL && slot->config.backend->write_frame != NULL && frame_len <= APP_LOG_MAX_LINE_LEN;
+}
+
+static void slot_enqueue(app_log_backend_slot_t *slot, const char *line, const uint8_t *frame, size_t frame_len)
+{
+    app_log_queued_line_t item;
+    if (slot_takes_frame(slot, frame, frame_len)) {
+        item.frame_len = (uint8_t)frame_len;
+        memcpy(item.data, frame, frame_len);
+    } else {
+        item.frame_len = 0U;
+        (void)strlcpy(item.data, line, sizeof(item.data));
+    }
+
+    switch (slot->config.overflow) {
+        case APP_LOG_OVERFLOW_BLOCK:
+            if (xQueueSend(slot->queue, &item, pdMS_TO_TICKS(slot->config.block_timeout_ms)) != pdTRUE) {
+                slot->dropped++;
+                return;
+            }
+            break;
+
+        case APP_LOG_OVERFLOW_DROP_OLDEST:
+            while (xQueueSend(slot->queue, &item, 0) != pdTRUE) {
+                app_log_queued_line_t discard;
+                if (xQueueReceive(slot->queue, &discard, 0) == pdTRUE) {
+                    slot->dropped++;
+                }
+            }
+            break;
+
+        case APP_LOG_OVERFLOW_DROP_NEWEST:
+        default:
+            if (xQueueSend(slot->queue, &item, 0) != pdTRUE) {
+                slot->dropped++;
+                return;
+            }
+            break;
+    }
+
+    slot->written++;
+    slot_note_depth(slot);
+}
+
+bool app_log_registry_has_backends(void)
+{
+    return s_slot_count > 0U;
+}
+
+bool app_log_registry_wants_frames(void)
+{
+    return s_any_frame_backend;
+}
+
+void app_log_registry_write(app_log_level_t level, const char *line, const uint8_t *frame, size_t frame_len)
+{
+    const uint32_t bit = APP_LOG_LEVEL_BIT(level);
+    const size_t count = s_slot_count;
+
+    for (size_t i = 0; i < count; ++i) {
+        app_log_backend_slot_t *slot = &s_slots[i];
+        if ((slot->level_mask & bit) == 0U) {
+            continue;
+        }
+
+        if (slot->queue != NULL) {
+            slot_enqueue(slot, line, frame, frame_len);
+        } else {
+            const app_log_backend_t *backend = slot->config.backend;
+            if (slot_takes_frame(slot, frame, frame_len)) {
+                backend->write_frame(backend->ctx, frame, frame_len);
+            } else {
+                backend->write_line(backend->ctx, line);
+            }
+            slot->written++;
+        }
+    }
+}
+
+void app_log_registry_clear(void)
+{
+    const size_t count = s_slot_count;
+    s_slot_count = 0U;
+    s_any_frame_backend = false;
+    app_log_refresh_thresholds();
+
+    for (size_t i = 0; i < count; ++i) {
+        app_log_backend_slot_t *slot = &s_slots[i];
+        if (slot->task != NULL) {
+            vTaskDelete(slot->task);
+            slot->task = NULL;
+        }
+        if (slot->queue != NULL) {
+            vQueueDelete(slot->queue);
+            slot->queue = NULL;
+        }
+        if (slot->config.backend->deinit) {
+            slot->config.backend->deinit(slot->config.backend->ctx);
+        }
+    }
+}
+
+void app_log_backend_get_default_config(app_log_backend_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    config->name = "backend";
+    config->level_mask = APP_LOG_LEVEL_MASK_ALL;
+    config->queue_len = APP_LOG_BACKEND_DEFAULT_QUEUE_LEN;
+    config->overflow = APP_LOG_OVERFLOW_DROP_OLDEST;
+    config->block_timeout_ms = 10U;
+    config->stack_size = APP_LOG_BACKEND_DEFAULT_STACK_SIZE;
+    config->task_priority = APP_LOG_BACKEND_DEFAULT_TASK_PRIORITY;
+    config->core_id = tskNO_AFFINITY;
+}
+
+bool app_log_add_backend(const app_log_backend_config_t *config, app_log_backend_id_t *out_id)
+{
+    if (config == NULL || config->backend == NULL || config->backend->write_line == NULL) {
+        return false;
+    }
+
+    if (s_slot_count >= APP_LOG_MAX_BACKENDS) {
+        return false;
+    }
+
+    app_log_backend_slot_t *slot = &s_slots[s_slot_count];
+    memset(slot, 0, sizeof(*slot));
+    slot->config = *config;
+    slot->level_mask = config->level_mask;
+
+    if (config->backend->init && !config->backend->init(config->backend->ctx)) {
+        return false;
+    }
+
+    if (config->queue_len > 0U) {
+        slot->queue = xQueueCreate(config->queue_len, sizeof(app_log_queued_line_t));
+        if (slot->queue == NULL) {
+            if (config->backend->deinit) {
+                config->backend->deinit(config->backend->ctx);
+            }
+            return false;
+        }
+
+        BaseType_t ret;
+        if (config->core_id == tskNO_AFFINITY) {
+            ret = xTaskCreate(backend_writer_task, "app_log_sink", config->stack_size,
+                              slot, config->task_priority, &slot->task);
+        } else {
+            ret = xTaskCreatePinnedToCore(backend_writer_task, "app_log_sink", config->stack_size,
+                                          slot, config->task_priority, &slot->task, config->core_id);
+        }
+
+        if (ret != pdPASS) {
+            vQueueDelete(slot->queue);
+            slot->queue = NULL;
+            slot->task = NULL;
+            if (config->backend->deinit) {
+                config->backend->deinit(config->backend->ctx);
+            }
+            return false;
+        }
+    }
+
+    if (out_id != NULL) {
+        *out_id = (app_log_backend_id_t)s_slot_count;
+    }
+
+    /* Publish only once the slot is fully set up. */
+    s_slot_count = s_slot_count + 1U;
+    if (config->backend->write_frame != NULL) {
+        s_any_frame_backend = true;
+    }
+    app_log_refresh_thresholds();
+    return true;
+}
+
+void app_log_set_backend_level_mask(app_log_backend_id_t id, uint32_t level_mask)
+{
+    if (id < 0 || (size_t)id >= s_slot_count) {
+        return;
+    }
+
+    s_slots[id].level_mask = level_mask;
+}
+
+size_t app_log_get_backend_count(void)
+{
+    return s_slot_count;
+}
+
+bool app_log_get_backend_stats(app_log_backend_id_t id, app_log_backend_stats_t *out_stats)
+{
+    if (out_stats == NULL || id < 0 || (size_t)id >= s_slot_count) {
+        return false;
+    }
+
+    const app_log_backend_slot_t *slot = &s_slots[id];
+    out_stats->name = slot->config.name;
+    out_stats->level_mask = slot->level_mask;
+    out_stats->queue_capacity = (slot->queue != NULL) ? slot->config.queue_len : 0U;
+    out_stats->queue_high_water = slot->high_water;
+    out_stats->lines_written = slot->written;
+    out_stats->lines_dropped = slot->dropped;
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+/*
+ * app_log_registry.h
+ *
+ * Internal: backend registry and fan-out used by app_log.c.
+ */
+
+#include "app_log.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+bool app_log_registry_has_backends(void);
+bool app_log_registry_wants_frames(void);
+/* frame may be NULL; frame backends then get the text line. */
+void app_log_registry_write(app_log_level_t level, const char *line, const uint8_t *frame, size_t frame_len);
+void app_log_registry_clear(void);
+
+/* Implemented in app_log.c: recompute app_log_thresholds[] after a change. */
+void app_log_refresh_thresholds(void);
@@ -0,0 +1,115 @@
+/*
+ * app_log_ring.c
+ *
+ * Bounded lock-free MPSC ring for deferred log records.
+ */
+
+#include "app_log_ring.h"
+
+#include <string.h>
+
+static void ring_note_occupancy(app_log_ring_t *ring, uint32_t ticket)
+{
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    const uint32_t used = ticket - tail + 1U;
+
+    uint32_t seen = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    while (used > seen && used <= ring->mask + 1U) {
+        if (atomic_compare_exchange_weak_explicit(&ring->high_water, &seen, used,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+bool app_log_ring_init(app_log_ring_t *ring, app_log_ring_slot_t *slots, uint32_t capacity)
+{
+    if (ring == NULL || slots == NULL || capacity == 0U || (capacity & (capacity - 1U)) != 0U) {
+        return false;
+    }
+
+    ring->slots = slots;
+    ring->mask = capacity - 1U;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        atomic_init(&slots[i].seq, i);
+    }
+
+    atomic_init(&ring->head, 0U);
+    atomic_init(&ring->tail, 0U);
+    atomic_init(&ring->pushed, 0U);
+    atomic_init(&ring->dropped, 0U);
+    atomic_init(&ring->high_water, 0U);
+    return true;
+}
+
+app_log_record_t *app_log_ring_reserve(app_log_ring_t *ring, uint32_t *out_ticket)
+{
+    if (ring == NULL || out_ticket == NULL) {
+        return NULL;
+    }
+
+    uint32_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        app_log_ring_slot_t *slot = &ring->slots[pos & ring->mask];
+        const uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        const int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1U,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                ring_note_occupancy(ring, pos);
+                *out_ticket = pos;
+                return &slot->record;
+            }
+            /* CAS failure reloaded pos; retry. */
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&ring->dropped, 1U, memory_order_relaxed);
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+}
+
+void app_log_ring_commit(app_log_ring_t *ring, uint32_t ticket)
+{
+    if (ring == NULL) {
+        return;
+    }
+
+    app_log_ring_slot_t *slot = &ring->slots[ticket & ring->mask];
+    atomic_fetch_add_explicit(&ring->pushed, 1U, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, ticket + 1U, memory_order_release);
+}
+
+bool app_log_ring_pop(app_log_ring_t *ring, app_log_record_t *out_record)
+{
+    if (ring == NULL || out_record == NULL) {
+        return false;
+    }
+
+    const uint32_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    app_log_ring_slot_t *slot = &ring->slots[pos & ring->mask];
+    const uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if ((int32_t)(seq - (pos + 1U)) != 0) {
+        return false;
+    }
+
+    memcpy(out_record, &slot->record, sizeof(*out_record));
+    atomic_store_explicit(&ring->tail, pos + 1U, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, pos + ring->mask + 1U, memory_order_release);
+    return true;
+}
+
+void app_log_ring_get_stats(const app_log_ring_t *ring, app_log_ring_stats_t *out_stats)
+{
+    if (ring == NULL || out_stats == NULL) {
+        return;
+    }
+
+    out_stats->capacity = ring->mask + 1U;
+    out_stats->pushed = atomic_load_explicit(&ring->pushed, memory_order_relaxed);
+    out_stats->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    out_stats->high_water = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+}
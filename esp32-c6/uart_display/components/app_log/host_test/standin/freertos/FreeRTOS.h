@@ -0,0 +1,5 @@
+#pragma once
+
+/* Only the types app_log.h names in its config structs. */
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
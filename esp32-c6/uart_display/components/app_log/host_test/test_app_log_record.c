@@ -0,0 +1,135 @@
+/*
+ * test_app_log_record.c
+ *
+ * Host test: captures records through app_log_record_capture and checks the
+ * rendered text against the C library's snprintf for the same format and
+ * arguments, the handling of specs too long to expand, argument overflow,
+ * and the framing of app_log_record_encode.
+ */
+
+#include "app_log_record.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static void capture(app_log_record_t *record, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    app_log_record_capture(record, APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, 1234U, fmt, args);
+    va_end(args);
+}
+
+static const char *render(const app_log_record_t *record)
+{
+    static char text[APP_LOG_MAX_LINE_LEN];
+    (void)app_log_record_render(record, text, sizeof(text));
+    return text;
+}
+
+static void test_render_matches_snprintf(void)
+{
+    app_log_record_t record;
+    char expected[APP_LOG_MAX_LINE_LEN];
+    char transient[16];
+
+    snprintf(transient, sizeof(transient), "stack-buf");
+    capture(&record, "T=%.1f C %s %5d|%-4u|%lld %% %c %zu %p",
+            21.25, transient, -42, 7U, -5LL, 'z', (size_t)99, (void *)0x1234);
+    /* The caller's buffer may be reused before the drain task renders. */
+    memset(transient, 'X', sizeof(transient) - 1U);
+
+    snprintf(expected, sizeof(expected), "T=%.1f C %s %5d|%-4u|%lld %% %c %zu %p",
+             21.25, "stack-buf", -42, 7U, -5LL, 'z', (size_t)99, (void *)0x1234);
+    CHECK(strcmp(render(&record), expected) == 0);
+}
+
+static void test_star_width_and_precision(void)
+{
+    app_log_record_t record;
+    char expected[APP_LOG_MAX_LINE_LEN];
+
+    capture(&record, "[%*.*f][%-*d][%#*.*llx]", 10, 3, 3.14159, -6, 42, 12, 9, 0xBEEFLL);
+    snprintf(expected, sizeof(expected), "[%*.*f][%-*d][%#*.*llx]", 10, 3, 3.14159, -6, 42, 12, 9, 0xBEEFLL);
+    CHECK(strcmp(render(&record), expected) == 0);
+}
+
+static void test_overlong_spec_is_not_truncated(void)
+{
+    app_log_record_t record;
+
+    /* Formatting with a cut spec would print "1" padded to the wrong width. */
+    capture(&record, "a=%000000000000000000000000000000000000000008d b=%d", 1, 2);
+    CHECK(strcmp(render(&record), "a=%000000000000000000000000000000000000000008d b=2") == 0);
+}
+
+static void test_argument_overflow_stops_render(void)
+{
+    app_log_record_t record;
+
+    capture(&record, "%d %d %d %d %d %d %d %d %d tail", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+    CHECK(record.arg_count == APP_LOG_RECORD_MAX_ARGS);
+    CHECK(strcmp(render(&record), "1 2 3 4 5 6 7 8 ") == 0);
+}
+
+static void test_render_respects_out_len(void)
+{
+    app_log_record_t record;
+    char text[8];
+
+    capture(&record, "value=%s", "0123456789");
+    CHECK(app_log_record_render(&record, text, sizeof(text)) == sizeof(text) - 1U);
+    CHECK(strcmp(text, "value=0") == 0);
+}
+
+static void test_encode_frame(void)
+{
+    app_log_record_t record;
+    uint8_t frame[64];
+
+    capture(&record, "n=%d s=%s", -3, "ok");
+    const size_t len = app_log_record_encode(&record, frame, sizeof(frame));
+    CHECK(len > APP_LOG_FRAME_OVERHEAD);
+    CHECK(frame[0] == APP_LOG_FRAME_SYNC);
+    CHECK((size_t)frame[1] + APP_LOG_FRAME_OVERHEAD == len);
+
+    uint8_t sum = 0;
+    for (size_t i = 2; i + 1U < len; ++i) {
+        sum ^= frame[i];
+    }
+    CHECK(sum == frame[len - 1U]);
+
+    /* The payload ends with the zigzag -3 and the NUL-terminated string. */
+    CHECK(memcmp(&frame[len - 5U], "\x05" "ok", 4) == 0);
+
+    CHECK(app_log_record_encode(&record, frame, len - 1U) == 0U);
+}
+
+int main(void)
+{
+    test_render_matches_snprintf();
+    test_star_width_and_precision();
+    test_overlong_spec_is_not_truncated();
+    test_argument_overflow_stops_render();
+    test_render_respects_out_len();
+    test_encode_frame();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_app_log_record: ok\n");
+    return EXIT_SUCCESS;
+}
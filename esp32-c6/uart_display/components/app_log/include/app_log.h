@@ -7,9 +7,19 @@
  * - Subsystem-specific filtering
  * - Priority/verbosity levels
  * - Global enable/disable
- * - Pluggable backends (UART, LED, network, etc.)
+ * - Pluggable backends (UART, LED, network, etc.), up to APP_LOG_MAX_BACKENDS
+ *   at once, each with its own level mask and optional async queue
+ * - Optional deferred mode: callers push compact records into a lock-free
+ *   ring and a single drain task formats and writes them to the backend.
+ * - APP_LOGx() macro front-ends: compiled out past CONFIG_APP_LOG_MIN_LEVEL,
+ *   otherwise a single table load decides whether to log. Their format
+ *   strings live in a dedicated section so binary backends can send a
+ *   format ID instead of text (see tools/app_log_decode.py).
  */
 
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -22,6 +32,26 @@ extern "C" {
 #define APP_LOG_MAX_LINE_LEN 160
 #endif
 
+#ifndef APP_LOG_MAX_BACKENDS
+#define APP_LOG_MAX_BACKENDS 4
+#endif
+
+#ifndef APP_LOG_RING_CAPACITY
+#define APP_LOG_RING_CAPACITY 32
+#endif
+
+/* Most verbose level compiled into APP_LOGx() call sites (app_log_level_t value). */
+#ifndef APP_LOG_MIN_LEVEL
+#ifdef CONFIG_APP_LOG_MIN_LEVEL
+#define APP_LOG_MIN_LEVEL CONFIG_APP_LOG_MIN_LEVEL
+#else
+#define APP_LOG_MIN_LEVEL 5
+#endif
+#endif
+
+/* Swept into flash .rodata by the default linker mapping. */
+#define APP_LOG_FMT_SECTION ".rodata.app_log_fmt"
+
 typedef enum {
     APP_LOG_LEVEL_NONE = 0,
     APP_LOG_LEVEL_CRITICAL = 1,
@@ -52,11 +82,74 @@ typedef struct {
     void (*deinit)(void *ctx);
     void (*write_line)(void *ctx, const char *line);
     void *ctx;
+    /*
+     * Optional. In deferred mode the backend receives an encoded record
+     * (app_log_record_encode()) instead of the rendered line; write_line is
+     * still used for lines that have no record (direct mode, oversize frames).
+     */
+    void (*write_frame)(void *ctx, const uint8_t *frame, size_t len);
 } app_log_backend_t;
 
+/* Bit per app_log_level_t value. */
+#define APP_LOG_LEVEL_BIT(level) (1U << (unsigned)(level))
+#define APP_LOG_LEVEL_MASK_UPTO(level) ((APP_LOG_LEVEL_BIT((level) + 1) - 1U) & ~APP_LOG_LEVEL_BIT(APP_LOG_LEVEL_NONE))
+#define APP_LOG_LEVEL_MASK_ALL APP_LOG_LEVEL_MASK_UPTO(APP_LOG_LEVEL_DEBUG)
+
+typedef enum {
+    APP_LOG_OVERFLOW_DROP_NEWEST = 0,
+    APP_LOG_OVERFLOW_DROP_OLDEST,
+    APP_LOG_OVERFLOW_BLOCK,
+} app_log_overflow_policy_t;
+
+typedef int8_t app_log_backend_id_t;
+#define APP_LOG_BACKEND_ID_INVALID ((app_log_backend_id_t)-1)
+
+typedef struct {
+    const char *name;
+    const app_log_backend_t *backend;
+    uint32_t level_mask;
+    /* 0 = write_line runs inline on the logging (or drain) task. */
+    uint32_t queue_len;
+    app_log_overflow_policy_t overflow;
+    uint32_t block_timeout_ms;
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+    BaseType_t core_id;
+} app_log_backend_config_t;
+
+typedef struct {
+    const char *name;
+    uint32_t level_mask;
+    uint32_t queue_capacity;
+    uint32_t queue_high_water;
+    uint32_t lines_written;
+    uint32_t lines_dropped;
+} app_log_backend_stats_t;
+
+typedef struct {
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+    BaseType_t core_id;
+} app_log_drain_task_config_t;
+
+typedef struct {
+    bool deferred;
+    uint32_t ring_capacity;
+    uint32_t ring_high_water;
+    uint32_t records_queued;
+    uint32_t records_dropped;
+} app_log_stats_t;
+
+/* backend may be NULL; otherwise it is registered inline with all levels enabled. */
 bool app_log_init(const app_log_backend_t *backend);
 void app_log_deinit(void);
 
+void app_log_backend_get_default_config(app_log_backend_config_t *config);
+bool app_log_add_backend(const app_log_backend_config_t *config, app_log_backend_id_t *out_id);
+void app_log_set_backend_level_mask(app_log_backend_id_t id, uint32_t level_mask);
+size_t app_log_get_backend_count(void);
+bool app_log_get_backend_stats(app_log_backend_id_t id, app_log_backend_stats_t *out_stats);
+
 void app_log_global_on(void);
 void app_log_global_off(void);
 bool app_log_is_enabled(void);
@@ -68,12 +161,70 @@ void app_log_write(app_log_subsystem_t subsystem, app_log_level_t level, const c
 void app_log_write_num(app_log_subsystem_t subsystem, app_log_level_t level, const char *msg, int32_t number);
 void app_log_write_fmt(app_log_subsystem_t subsystem, app_log_level_t level, const char *fmt, ...);
 
+/*
+ * Deferred mode. Once the drain task is running, app_log_write*() only capture
+ * a record (fmt pointer + raw args) and never block; formatting and backend I/O
+ * happen on the drain task. app_log_write_fmt() format strings must be literals.
+ * Records that do not fit in the ring are counted in records_dropped.
+ */
+void app_log_drain_task_get_default_config(app_log_drain_task_config_t *config);
+bool app_log_start_drain_task(const app_log_drain_task_config_t *config);
+void app_log_get_stats(app_log_stats_t *out_stats);
+
 const char *app_log_level_to_str(app_log_level_t level);
 const char *app_log_subsystem_to_str(app_log_subsystem_t subsystem);
 
 /* Built-in backend: UART/console via ROM printf (lowest dependency default). */
 const app_log_backend_t *app_log_backend_uart(void);
 
+/*
+ * Built-in backend: console UART carrying binary record frames in deferred
+ * mode (text lines otherwise). Decode on the host with
+ * tools/app_log_decode.py and the application ELF.
+ */
+const app_log_backend_t *app_log_backend_uart_binary(void);
+
+/*
+ * Effective per-subsystem threshold: the configured level, or NONE while
+ * logging is globally off or no backend is registered. Kept up to date by the
+ * setters above so the macro fast path is one byte load and compare.
+ */
+extern volatile uint8_t app_log_thresholds[APP_LOG_SUBSYS_COUNT];
+
+static inline bool app_log_level_active(app_log_subsystem_t subsystem, app_log_level_t level)
+{
+    return (uint8_t)level <= app_log_thresholds[subsystem];
+}
+
+/* Never called; lets the compiler check APP_LOGx() arguments against fmt. */
+static inline __attribute__((format(printf, 1, 2))) void app_log_fmt_check(const char *fmt, ...)
+{
+    (void)fmt;
+}
+
+/*
+ * APP_LOGx(SUBSYS, fmt, ...): SUBSYS is the suffix of an app_log_subsystem_t
+ * (SENSOR, WIFI, ...) and fmt must be a string literal. Calls more verbose than
+ * APP_LOG_MIN_LEVEL are removed at compile time, arguments included.
+ */
+#define APP_LOG_AT(level, subsys, fmt, ...)                                                        \
+    do {                                                                                           \
+        if ((level) <= APP_LOG_MIN_LEVEL &&                                                        \
+            __builtin_expect(app_log_level_active(APP_LOG_SUBSYS_##subsys, (level)), 0)) {         \
+            static const char app_log_fmt_str[] __attribute__((section(APP_LOG_FMT_SECTION))) = fmt; \
+            if (0) {                                                                               \
+                app_log_fmt_check(fmt, ##__VA_ARGS__);                                             \
+            }                                                                                      \
+            app_log_write_fmt(APP_LOG_SUBSYS_##subsys, (level), app_log_fmt_str, ##__VA_ARGS__);   \
+        }                                                                                          \
+    } while (0)
+
+#define APP_LOGC(subsys, fmt, ...) APP_LOG_AT(APP_LOG_LEVEL_CRITICAL, subsys, fmt, ##__VA_ARGS__)
+#define APP_LOGE(subsys, fmt, ...) APP_LOG_AT(APP_LOG_LEVEL_ERROR, subsys, fmt, ##__VA_ARGS__)
+#define APP_LOGW(subsys, fmt, ...) APP_LOG_AT(APP_LOG_LEVEL_WARN, subsys, fmt, ##__VA_ARGS__)
+#define APP_LOGI(subsys, fmt, ...) APP_LOG_AT(APP_LOG_LEVEL_INFO, subsys, fmt, ##__VA_ARGS__)
+#define APP_LOGD(subsys, fmt, ...) APP_LOG_AT(APP_LOG_LEVEL_DEBUG, subsys, fmt, ##__VA_ARGS__)
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+ * app_log_record.h
+ *
+ * Compact binary log record used by the deferred (drain task) logging path.
+ * Producers capture the format-string pointer plus raw arguments; the drain
+ * task renders the text later, off the caller's stack.
+ *
+ * The format string must have static storage duration (a string literal).
+ * %s arguments are copied into the record because they often point at
+ * caller stack buffers.
+ */
+
+#include "app_log.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef APP_LOG_RECORD_MAX_ARGS
+#define APP_LOG_RECORD_MAX_ARGS 8
+#endif
+
+#ifndef APP_LOG_RECORD_STR_LEN
+#define APP_LOG_RECORD_STR_LEN 96
+#endif
+
+typedef union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void *p;
+    uint16_t str_offset;
+} app_log_arg_t;
+
+typedef struct {
+    uint32_t timestamp_ms;
+    uint8_t subsystem;
+    uint8_t level;
+    uint8_t arg_count;
+    uint8_t str_used;
+    const char *fmt;
+    app_log_arg_t args[APP_LOG_RECORD_MAX_ARGS];
+    char str_data[APP_LOG_RECORD_STR_LEN];
+} app_log_record_t;
+
+void app_log_record_capture(app_log_record_t *record,
+                            app_log_subsystem_t subsystem,
+                            app_log_level_t level,
+                            uint32_t timestamp_ms,
+                            const char *fmt,
+                            va_list args);
+
+/* Render the message text (no [SUBSYS][LVL] prefix). Returns bytes written. */
+size_t app_log_record_render(const app_log_record_t *record, char *out_buf, size_t out_len);
+
+#define APP_LOG_FRAME_SYNC 0xA5U
+#define APP_LOG_FRAME_OVERHEAD 3U /* sync + payload length + checksum */
+
+/*
+ * Encode a record as a binary frame: sync, payload length, payload, XOR of the
+ * payload bytes. The payload is the format ID (u32 LE address of the format
+ * string), the timestamp (varint ms), (subsystem << 4) | level, then each
+ * argument in format order: integers as varints (zigzag if signed), floating
+ * point as IEEE-754 double LE, strings NUL-terminated, pointers as u32 LE.
+ * Returns the frame length, or 0 if it does not fit in out_len.
+ */
+size_t app_log_record_encode(const app_log_record_t *record, uint8_t *out_buf, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ * app_log_ring.h
+ *
+ * Bounded lock-free multi-producer / single-consumer ring of log records.
+ * Producers never block: when the ring is full the record is counted as
+ * dropped. Each slot carries a sequence number (Vyukov-style) so a producer
+ * preempted mid-write never exposes a half-written record to the consumer.
+ *
+ * No FreeRTOS dependency; builds and runs on the host.
+ */
+
+#include "app_log_record.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    atomic_uint_least32_t seq;
+    app_log_record_t record;
+} app_log_ring_slot_t;
+
+typedef struct {
+    app_log_ring_slot_t *slots;
+    uint32_t mask;
+    atomic_uint_least32_t head;      /* next ticket handed to a producer */
+    atomic_uint_least32_t tail;      /* next ticket the consumer reads */
+    atomic_uint_least32_t pushed;
+    atomic_uint_least32_t dropped;
+    atomic_uint_least32_t high_water;
+} app_log_ring_t;
+
+typedef struct {
+    uint32_t capacity;
+    uint32_t pushed;
+    uint32_t dropped;
+    uint32_t high_water;
+} app_log_ring_stats_t;
+
+/* capacity must be a power of two; slots must hold capacity entries. */
+bool app_log_ring_init(app_log_ring_t *ring, app_log_ring_slot_t *slots, uint32_t capacity);
+
+/* Reserve a slot for writing. Returns NULL (and counts a drop) when full. */
+app_log_record_t *app_log_ring_reserve(app_log_ring_t *ring, uint32_t *out_ticket);
+void app_log_ring_commit(app_log_ring_t *ring, uint32_t ticket);
+
+/* Single consumer only. Returns false when no committed record is ready. */
+bool app_log_ring_pop(app_log_ring_t *ring, app_log_record_t *out_record);
+
+void app_log_ring_get_stats(const app_log_ring_t *ring, app_log_ring_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
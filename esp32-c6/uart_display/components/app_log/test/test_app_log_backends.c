@@ -0,0 +1,205 @@
+#include "app_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BLOCKED_QUEUE_LEN 2U
+#define BLOCKED_LINES 5
+
+typedef struct {
+    uint32_t lines;
+    char last[APP_LOG_MAX_LINE_LEN];
+} capture_ctx_t;
+
+static void capture_write_line(void *ctx, const char *line)
+{
+    capture_ctx_t *capture = (capture_ctx_t *)ctx;
+    capture->lines++;
+    (void)strlcpy(capture->last, line, sizeof(capture->last));
+}
+
+TEST_CASE("app_log fans out by backend level mask", "[app_log]")
+{
+    static capture_ctx_t all_ctx;
+    static capture_ctx_t warn_ctx;
+    static const app_log_backend_t all_backend = { .write_line = capture_write_line, .ctx = &all_ctx };
+    static const app_log_backend_t warn_backend = { .write_line = capture_write_line, .ctx = &warn_ctx };
+
+    memset(&all_ctx, 0, sizeof(all_ctx));
+    memset(&warn_ctx, 0, sizeof(warn_ctx));
+
+    TEST_ASSERT_TRUE(app_log_init(NULL));
+    app_log_set_output_level(APP_LOG_SUBSYS_ALL, APP_LOG_LEVEL_DEBUG);
+
+    app_log_backend_config_t config;
+    app_log_backend_id_t warn_id;
+
+    app_log_backend_get_default_config(&config);
+    config.backend = &all_backend;
+    config.queue_len = 0U;
+    TEST_ASSERT_TRUE(app_log_add_backend(&config, NULL));
+
+    app_log_backend_get_default_config(&config);
+    config.name = "warn";
+    config.backend = &warn_backend;
+    config.queue_len = 0U;
+    config.level_mask = APP_LOG_LEVEL_MASK_UPTO(APP_LOG_LEVEL_WARN);
+    TEST_ASSERT_TRUE(app_log_add_backend(&config, &warn_id));
+
+    app_log_write(APP_LOG_SUBSYS_SENSOR, APP_LOG_LEVEL_DEBUG, "noise");
+    app_log_write_num(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_WARN, "retry", 3);
+
+    TEST_ASSERT_EQUAL_UINT32(2U, all_ctx.lines);
+    TEST_ASSERT_EQUAL_UINT32(1U, warn_ctx.lines);
+    TEST_ASSERT_EQUAL_STRING("[WIFI][WARN] retry: 3", warn_ctx.last);
+
+    app_log_backend_stats_t stats;
+    TEST_ASSERT_TRUE(app_log_get_backend_stats(warn_id, &stats));
+    TEST_ASSERT_EQUAL_STRING("warn", stats.name);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.lines_written);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats.queue_capacity);
+
+    app_log_deinit();
+    TEST_ASSERT_EQUAL(0, (int)app_log_get_backend_count());
+}
+
+/* Writer that parks in write_line until the test opens the gate once per line. */
+typedef struct {
+    SemaphoreHandle_t entered;
+    SemaphoreHandle_t gate;
+    volatile uint32_t lines;
+    char seen[BLOCKED_LINES][APP_LOG_MAX_LINE_LEN];
+} blocked_ctx_t;
+
+static void blocked_write_line(void *ctx, const char *line)
+{
+    blocked_ctx_t *blocked = (blocked_ctx_t *)ctx;
+    xSemaphoreGive(blocked->entered);
+    xSemaphoreTake(blocked->gate, portMAX_DELAY);
+    if (blocked->lines < BLOCKED_LINES) {
+        (void)strlcpy(blocked->seen[blocked->lines], line, sizeof(blocked->seen[0]));
+    }
+    blocked->lines++;
+}
+
+static void run_blocked_writer(app_log_overflow_policy_t overflow, const int *expected, uint32_t expected_count,
+                               uint32_t expected_written, uint32_t expected_dropped)
+{
+    static blocked_ctx_t ctx;
+    static app_log_backend_t backend = { .write_line = blocked_write_line, .ctx = &ctx };
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.entered = xSemaphoreCreateCounting(BLOCKED_LINES, 0);
+    ctx.gate = xSemaphoreCreateCounting(BLOCKED_LINES, 0);
+    TEST_ASSERT_NOT_NULL(ctx.entered);
+    TEST_ASSERT_NOT_NULL(ctx.gate);
+
+    TEST_ASSERT_TRUE(app_log_init(NULL));
+    app_log_set_output_level(APP_LOG_SUBSYS_ALL, APP_LOG_LEVEL_DEBUG);
+
+    app_log_backend_config_t config;
+    app_log_backend_id_t id;
+    app_log_backend_get_default_config(&config);
+    config.name = "blocked";
+    config.backend = &backend;
+    config.queue_len = BLOCKED_QUEUE_LEN;
+    config.overflow = overflow;
+    TEST_ASSERT_TRUE(app_log_add_backend(&config, &id));
+
+    /* Line 0 reaches the writer and parks it; the rest pile up in the queue. */
+    app_log_write_num(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, "line", 0);
+    TEST_ASSERT_TRUE(xSemaphoreTake(ctx.entered, pdMS_TO_TICKS(1000)));
+    for (int i = 1; i < BLOCKED_LINES; ++i) {
+        app_log_write_num(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, "line", i);
+    }
+
+    app_log_backend_stats_t stats;
+    TEST_ASSERT_TRUE(app_log_get_backend_stats(id, &stats));
+    TEST_ASSERT_EQUAL_UINT32(BLOCKED_QUEUE_LEN, stats.queue_capacity);
+    TEST_ASSERT_EQUAL_UINT32(BLOCKED_QUEUE_LEN, stats.queue_high_water);
+    TEST_ASSERT_EQUAL_UINT32(expected_written, stats.lines_written);
+    TEST_ASSERT_EQUAL_UINT32(expected_dropped, stats.lines_dropped);
+    TEST_ASSERT_EQUAL_UINT32(0U, ctx.lines);
+
+    for (uint32_t i = 0; i < expected_count; ++i) {
+        xSemaphoreGive(ctx.gate);
+    }
+    for (int wait = 0; wait < 100 && ctx.lines < expected_count; ++wait) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(expected_count, ctx.lines);
+    for (uint32_t i = 0; i < expected_count; ++i) {
+        char want[APP_LOG_MAX_LINE_LEN];
+        (void)snprintf(want, sizeof(want), "[SYS][INFO] line: %d", expected[i]);
+        TEST_ASSERT_EQUAL_STRING(want, ctx.seen[i]);
+    }
+
+    app_log_deinit();
+    vSemaphoreDelete(ctx.entered);
+    vSemaphoreDelete(ctx.gate);
+}
+
+TEST_CASE("app_log queued backend drops newest behind a blocked writer", "[app_log]")
+{
+    static const int delivered[] = { 0, 1, 2 };
+    run_blocked_writer(APP_LOG_OVERFLOW_DROP_NEWEST, delivered, 3U, 3U, 2U);
+}
+
+TEST_CASE("app_log queued backend drops oldest behind a blocked writer", "[app_log]")
+{
+    static const int delivered[] = { 0, 3, 4 };
+    run_blocked_writer(APP_LOG_OVERFLOW_DROP_OLDEST, delivered, 3U, 5U, 2U);
+}
+
+typedef struct {
+    uint32_t inits;
+    uint32_t deinits;
+} lifecycle_ctx_t;
+
+static bool lifecycle_init(void *ctx)
+{
+    ((lifecycle_ctx_t *)ctx)->inits++;
+    return true;
+}
+
+static void lifecycle_deinit(void *ctx)
+{
+    ((lifecycle_ctx_t *)ctx)->deinits++;
+}
+
+static void lifecycle_write_line(void *ctx, const char *line)
+{
+    (void)ctx;
+    (void)line;
+}
+
+TEST_CASE("app_log add_backend deinits the backend when the queue cannot be created", "[app_log]")
+{
+    static lifecycle_ctx_t ctx;
+    static const app_log_backend_t backend = {
+        .init = lifecycle_init,
+        .deinit = lifecycle_deinit,
+        .write_line = lifecycle_write_line,
+        .ctx = &ctx,
+    };
+
+    memset(&ctx, 0, sizeof(ctx));
+    TEST_ASSERT_TRUE(app_log_init(NULL));
+
+    app_log_backend_config_t config;
+    app_log_backend_get_default_config(&config);
+    config.backend = &backend;
+    config.queue_len = 1000000U; /* far beyond the heap */
+    TEST_ASSERT_FALSE(app_log_add_backend(&config, NULL));
+    TEST_ASSERT_EQUAL_UINT32(1U, ctx.inits);
+    TEST_ASSERT_EQUAL_UINT32(1U, ctx.deinits);
+    TEST_ASSERT_EQUAL(0, (int)app_log_get_backend_count());
+
+    app_log_deinit();
+}
@@ -0,0 +1,104 @@
+/* Compile out DEBUG call sites in this file only. */
+#define APP_LOG_MIN_LEVEL 4
+
+#include "app_log.h"
+#include "app_log_record.h"
+
+#include "unity.h"
+
+#include <string.h>
+
+static uint32_t s_lines;
+static char s_last[APP_LOG_MAX_LINE_LEN];
+
+static void count_write_line(void *ctx, const char *line)
+{
+    (void)ctx;
+    s_lines++;
+    (void)strlcpy(s_last, line, sizeof(s_last));
+}
+
+static int bump(int *counter)
+{
+    return ++(*counter);
+}
+
+TEST_CASE("APP_LOGx elides compiled-out levels and filtered arguments", "[app_log]")
+{
+    static const app_log_backend_t backend = { .write_line = count_write_line };
+    int evaluated = 0;
+
+    s_lines = 0;
+    TEST_ASSERT_TRUE(app_log_init(NULL));
+    app_log_backend_config_t config;
+    app_log_backend_get_default_config(&config);
+    config.backend = &backend;
+    config.queue_len = 0U;
+    TEST_ASSERT_TRUE(app_log_add_backend(&config, NULL));
+
+    /* Runtime level allows DEBUG, but the call site was compiled out. */
+    app_log_set_output_level(APP_LOG_SUBSYS_ALL, APP_LOG_LEVEL_DEBUG);
+    APP_LOGD(SENSOR, "debug %d", bump(&evaluated));
+    TEST_ASSERT_EQUAL(0, evaluated);
+    TEST_ASSERT_EQUAL_UINT32(0U, s_lines);
+
+    /* Filtered at runtime: arguments are not evaluated either. */
+    app_log_set_output_level(APP_LOG_SUBSYS_SENSOR, APP_LOG_LEVEL_WARN);
+    APP_LOGI(SENSOR, "info %d", bump(&evaluated));
+    TEST_ASSERT_EQUAL(0, evaluated);
+
+    APP_LOGW(SENSOR, "warn %d", bump(&evaluated));
+    TEST_ASSERT_EQUAL(1, evaluated);
+    TEST_ASSERT_EQUAL_STRING("[SNS][WARN] warn 1", s_last);
+
+    app_log_global_off();
+    APP_LOGE(SENSOR, "off %d", bump(&evaluated));
+    TEST_ASSERT_EQUAL(1, evaluated);
+    app_log_global_on();
+
+    app_log_deinit();
+    APP_LOGC(SENSOR, "no backends %d", bump(&evaluated));
+    TEST_ASSERT_EQUAL(1, evaluated);
+    TEST_ASSERT_EQUAL_UINT32(1U, s_lines);
+}
+
+static void capture_va(app_log_record_t *record, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    app_log_record_capture(record, APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_INFO, 300U, fmt, args);
+    va_end(args);
+}
+
+TEST_CASE("app_log record encodes to a compact binary frame", "[app_log]")
+{
+    static const char fmt[] = "rssi %d ch %u %s";
+    app_log_record_t record;
+    uint8_t frame[64];
+
+    capture_va(&record, fmt, -3, 11U, "ok");
+    const size_t len = app_log_record_encode(&record, frame, sizeof(frame));
+
+    /* id(4) + ts varint(2) + tag(1) + zigzag(-3)(1) + 11(1) + "ok\0"(3) */
+    const uint8_t payload_len = 12U;
+    TEST_ASSERT_EQUAL(payload_len + APP_LOG_FRAME_OVERHEAD, len);
+    TEST_ASSERT_EQUAL_HEX8(APP_LOG_FRAME_SYNC, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(payload_len, frame[1]);
+
+    const uint32_t id = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) |
+                        ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)(uintptr_t)fmt, id);
+
+    const uint8_t expected_tail[] = { 0xAC, 0x02, (APP_LOG_SUBSYS_WIFI << 4) | APP_LOG_LEVEL_INFO,
+                                      0x05, 0x0B, 'o', 'k', 0x00 };
+    TEST_ASSERT_EQUAL_MEMORY(expected_tail, &frame[6], sizeof(expected_tail));
+
+    uint8_t check = 0;
+    for (size_t i = 0; i < payload_len; ++i) {
+        check ^= frame[2 + i];
+    }
+    TEST_ASSERT_EQUAL_HEX8(check, frame[len - 1U]);
+
+    /* Too small: refuse rather than emit a truncated frame. */
+    TEST_ASSERT_EQUAL(0, (int)app_log_record_encode(&record, frame, 10U));
+}
@@ -0,0 +1,141 @@
+#include "app_log_ring.h"
+
+#include "unity.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RING_TEST_CAPACITY 64U
+#define RING_TEST_PRODUCERS 4
+#define RING_TEST_RECORDS_PER_PRODUCER 20000U
+
+static app_log_ring_slot_t s_slots[RING_TEST_CAPACITY];
+static app_log_ring_t s_ring;
+static atomic_int s_producers_finished;
+
+static void capture(app_log_record_t *record, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    app_log_record_capture(record, APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, 0U, fmt, args);
+    va_end(args);
+}
+
+static void *producer_thread(void *arg)
+{
+    const int id = (int)(intptr_t)arg;
+
+    for (uint32_t seq = 0; seq < RING_TEST_RECORDS_PER_PRODUCER; ++seq) {
+        uint32_t ticket;
+        app_log_record_t *record = app_log_ring_reserve(&s_ring, &ticket);
+        if (record == NULL) {
+            sched_yield();
+            continue;
+        }
+        capture(record, "p%d seq %u", id, (unsigned)seq);
+        app_log_ring_commit(&s_ring, ticket);
+    }
+
+    atomic_fetch_add(&s_producers_finished, 1);
+    return NULL;
+}
+
+TEST_CASE("app_log record render matches snprintf", "[app_log]")
+{
+    app_log_record_t record;
+    char rendered[APP_LOG_MAX_LINE_LEN];
+    char expected[APP_LOG_MAX_LINE_LEN];
+    char transient[16];
+
+    (void)strlcpy(transient, "stack-buf", sizeof(transient));
+    capture(&record, "T=%.1f C %s %5d|%-4u|%lld %% %c %*d",
+            21.25, transient, -42, 7U, -5LL, 'z', 4, 9);
+    /* The caller's buffer may be reused before the drain task renders. */
+    memset(transient, 'X', sizeof(transient) - 1U);
+
+    (void)snprintf(expected, sizeof(expected), "T=%.1f C %s %5d|%-4u|%lld %% %c %*d",
+                   21.25, "stack-buf", -42, 7U, -5LL, 'z', 4, 9);
+    (void)app_log_record_render(&record, rendered, sizeof(rendered));
+
+    TEST_ASSERT_EQUAL_STRING(expected, rendered);
+}
+
+TEST_CASE("app_log ring counts drops when full", "[app_log]")
+{
+    app_log_ring_slot_t slots[4];
+    app_log_ring_t ring;
+    app_log_record_t record;
+    uint32_t ticket;
+
+    TEST_ASSERT_FALSE(app_log_ring_init(&ring, slots, 3U));
+    TEST_ASSERT_TRUE(app_log_ring_init(&ring, slots, 4U));
+
+    for (int i = 0; i < 6; ++i) {
+        app_log_record_t *slot = app_log_ring_reserve(&ring, &ticket);
+        if (slot != NULL) {
+            capture(slot, "n=%d", i);
+            app_log_ring_commit(&ring, ticket);
+        }
+    }
+
+    app_log_ring_stats_t stats;
+    app_log_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(4U, stats.pushed);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(4U, stats.high_water);
+
+    char text[16];
+    TEST_ASSERT_TRUE(app_log_ring_pop(&ring, &record));
+    (void)app_log_record_render(&record, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("n=0", text);
+}
+
+TEST_CASE("app_log ring multi-producer stress", "[app_log][stress]")
+{
+    pthread_t producers[RING_TEST_PRODUCERS];
+    uint32_t next_seq[RING_TEST_PRODUCERS] = {0};
+    uint32_t received = 0;
+
+    TEST_ASSERT_TRUE(app_log_ring_init(&s_ring, s_slots, RING_TEST_CAPACITY));
+    atomic_store(&s_producers_finished, 0);
+
+    for (int i = 0; i < RING_TEST_PRODUCERS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&producers[i], NULL, producer_thread, (void *)(intptr_t)i));
+    }
+
+    app_log_record_t record;
+    bool producers_done = false;
+    while (true) {
+        if (app_log_ring_pop(&s_ring, &record)) {
+            const int id = (int)record.args[0].i;
+            const uint32_t seq = (uint32_t)record.args[1].u;
+
+            TEST_ASSERT_TRUE(id >= 0 && id < RING_TEST_PRODUCERS);
+            /* Per-producer order is preserved; gaps are drops, never reordering. */
+            TEST_ASSERT_TRUE(seq >= next_seq[id]);
+            next_seq[id] = seq + 1U;
+            received++;
+            continue;
+        }
+
+        /* One more empty pass after the last producer exits drains stragglers. */
+        if (producers_done) {
+            break;
+        }
+        producers_done = (atomic_load(&s_producers_finished) == RING_TEST_PRODUCERS);
+    }
+
+    for (int i = 0; i < RING_TEST_PRODUCERS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_join(producers[i], NULL));
+    }
+
+    app_log_ring_stats_t stats;
+    app_log_ring_get_stats(&s_ring, &stats);
+
+    TEST_ASSERT_EQUAL_UINT32(stats.pushed, received);
+    TEST_ASSERT_EQUAL_UINT32(RING_TEST_PRODUCERS * RING_TEST_RECORDS_PER_PRODUCER, stats.pushed + stats.dropped);
+    TEST_ASSERT_TRUE(stats.high_water <= RING_TEST_CAPACITY);
+}
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""Decode app_log binary frames (app_log_backend_uart_binary) back into text.
+
+Frames carry the address of the APP_LOGx() format string instead of the
+string itself; this tool looks the address up in the application ELF and
+re-renders the line. Plain text on the stream (boot messages, ESP_LOGx,
+direct-mode app_log lines) is passed through unchanged.
+
+    python app_log_decode.py build/uart_display.elf /dev/ttyACM0
+    python app_log_decode.py build/uart_display.elf capture.bin
+    python app_log_decode.py --sd build/uart_display.elf /media/sd/LOGS/L*.BIN
+
+Requires pyelftools (ships with ESP-IDF) and pyserial for serial ports.
+"""
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+from elftools.elf.elffile import ELFFile
+
+FRAME_SYNC = 0xA5
+
+# sd_log_sink.h block layout.
+SD_BLOCK_SIZE = 4096
+SD_BLOCK_MAGIC = 0x474F4C41
+SD_HEADER = struct.Struct('<IIHHI')
+
+LEVELS = {1: 'CRIT', 2: 'ERR', 3: 'WARN', 4: 'INFO', 5: 'DBG'}
+
+# Order matches app_log_subsystem_t.
+SUBSYSTEMS = ['SYS', 'WIFI', 'DSP', 'UI', 'SD', 'SNS', 'RTC', 'NET', 'REST']
+
+# Mirrors parse_spec() in app_log_record.c.
+SPEC_RE = re.compile(
+    r'%(?P<flags>[-+ #0]*)(?P<width>\*|\d*)(?:\.(?P<prec>\*|\d*))?'
+    r'(?P<length>hh|h|ll|l|z|j|t|L)?(?P<conv>[diouxXcfFeEgGaAspn%])')
+
+
+class FormatTable:
+    def __init__(self, elf_path):
+        self._segments = []
+        self._cache = {}
+        with open(elf_path, 'rb') as f:
+            elf = ELFFile(f)
+            for seg in elf.iter_segments():
+                if seg['p_type'] == 'PT_LOAD' and seg['p_filesz'] > 0:
+                    self._segments.append((seg['p_vaddr'], seg.data()))
+
+    def lookup(self, addr):
+        if addr in self._cache:
+            return self._cache[addr]
+        for base, data in self._segments:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                text = data[addr - base:end].decode('utf-8', 'replace')
+                self._cache[addr] = text
+                return text
+        return None
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.at = 0
+
+    def u8(self):
+        v = self.data[self.at]
+        self.at += 1
+        return v
+
+    def u32(self):
+        v, = struct.unpack_from('<I', self.data, self.at)
+        self.at += 4
+        return v
+
+    def f64(self):
+        v, = struct.unpack_from('<d', self.data, self.at)
+        self.at += 8
+        return v
+
+    def varint(self):
+        shift = 0
+        v = 0
+        while True:
+            b = self.u8()
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return v
+
+    def zigzag(self):
+        v = self.varint()
+        return (v >> 1) ^ -(v & 1)
+
+    def cstr(self):
+        end = self.data.index(b'\0', self.at)
+        s = self.data[self.at:end].decode('utf-8', 'replace')
+        self.at = end + 1
+        return s
+
+    def done(self):
+        return self.at >= len(self.data)
+
+
+def render(fmt, reader):
+    out = []
+    pos = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group('conv')
+        if conv == '%':
+            out.append('%')
+            continue
+        if reader.done():
+            # Record ran out of argument slots on the device.
+            return ''.join(out)
+
+        width = m.group('width') or ''
+        prec = m.group('prec')
+        if width == '*':
+            width = str(reader.zigzag())
+        if prec == '*':
+            prec = str(reader.zigzag())
+        spec = '%' + m.group('flags') + width + ('.' + prec if prec is not None else '')
+
+        length = m.group('length') or ''
+        if conv in 'di' or length == 't':
+            value = reader.zigzag()
+        elif conv == 'c':
+            value = reader.zigzag()
+        elif conv in 'ouxX':
+            value = reader.varint()
+        elif conv in 'fFeEgGaA':
+            value = reader.f64()
+        elif conv == 's':
+            value = reader.cstr()
+        elif conv == 'p':
+            out.append('0x%x' % reader.u32())
+            continue
+        else:  # %n
+            continue
+
+        if conv in 'aA':
+            out.append(float.hex(value))
+        elif conv in 'diu':
+            out.append((spec + 'd') % value)
+        else:
+            out.append((spec + conv) % value)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode_frame(table, payload):
+    r = Reader(payload)
+    fmt_id = r.u32()
+    timestamp_ms = r.varint()
+    tag = r.u8()
+    subsys = tag >> 4
+    level = tag & 0x0F
+
+    fmt = table.lookup(fmt_id)
+    if fmt is None:
+        msg = '<unknown fmt 0x%08x>' % fmt_id
+    else:
+        msg = render(fmt, r)
+
+    name = SUBSYSTEMS[subsys] if subsys < len(SUBSYSTEMS) else 'UNK'
+    return '%10u [%s][%s] %s' % (timestamp_ms, name, LEVELS.get(level, 'NONE'), msg)
+
+
+def decode_stream(table, chunks, write):
+    buf = bytearray()
+    for chunk in chunks:
+        buf += chunk
+        while buf:
+            sync = buf.find(bytes([FRAME_SYNC]))
+            if sync < 0:
+                write(buf.decode('utf-8', 'replace'))
+                buf.clear()
+                break
+            if sync > 0:
+                write(buf[:sync].decode('utf-8', 'replace'))
+                del buf[:sync]
+            if len(buf) < 2 or len(buf) < buf[1] + 3:
+                break
+            length = buf[1]
+            payload = bytes(buf[2:2 + length])
+            check = 0
+            for b in payload:
+                check ^= b
+            if check != buf[2 + length]:
+                # Not a frame (or corrupted): skip the sync byte and resync.
+                del buf[:1]
+                continue
+            del buf[:length + 3]
+            try:
+                write(decode_frame(table, payload) + '\n')
+            except (IndexError, ValueError, struct.error):
+                write('<malformed frame>\n')
+
+
+def sd_block_payloads(paths):
+    for path in paths:
+        with open(path, 'rb') as f:
+            data = f.read()
+        for off in range(0, len(data) - SD_BLOCK_SIZE + 1, SD_BLOCK_SIZE):
+            magic, _seq, used, _reserved, crc = SD_HEADER.unpack_from(data, off)
+            start = off + SD_HEADER.size
+            payload = data[start:start + used]
+            if magic != SD_BLOCK_MAGIC or zlib.crc32(payload) != crc:
+                sys.stderr.write('%s: skipping bad block at 0x%x\n' % (path, off))
+                continue
+            yield payload
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='application ELF the device is running')
+    parser.add_argument('source', nargs='+', help='serial port, captured binary file, or SD log files')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--sd', action='store_true', help='sources are sd_log_sink block files, oldest first')
+    args = parser.parse_args()
+
+    table = FormatTable(args.elf)
+    source = args.source[0]
+
+    if args.sd:
+        chunks = sd_block_payloads(args.source)
+    elif source.startswith('/dev/') or source.upper().startswith('COM'):
+        import serial
+        port = serial.Serial(source, args.baud, timeout=0.1)
+        chunks = iter(lambda: port.read(256), None)
+    else:
+        with open(source, 'rb') as f:
+            chunks = [f.read()]
+
+    def write(text):
+        sys.stdout.write(text)
+        sys.stdout.flush()
+
+    decode_stream(table, chunks, write)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,272 @@
+#include "area_merge.h"
+
+#define AREA_MERGE_WINDOW_BYTES 5U /* CASET/RASET: command + 4 params */
+#define AREA_MERGE_WRITE_BYTES 1U  /* RAMWR command */
+#define AREA_MERGE_SPLIT_PASSES 4U
+
+static int32_t rect_width(const area_merge_rect_t *r)
+{
+    return (int32_t)r->x2 - r->x1 + 1;
+}
+
+static int32_t rect_height(const area_merge_rect_t *r)
+{
+    return (int32_t)r->y2 - r->y1 + 1;
+}
+
+static uint32_t rect_pixels(const area_merge_rect_t *r)
+{
+    return (uint32_t)(rect_width(r) * rect_height(r));
+}
+
+static bool rect_overlaps(const area_merge_rect_t *a, const area_merge_rect_t *b)
+{
+    return a->x1 <= b->x2 && a->x2 >= b->x1 && a->y1 <= b->y2 && a->y2 >= b->y1;
+}
+
+static bool rect_contains(const area_merge_rect_t *outer, const area_merge_rect_t *inner)
+{
+    return inner->x1 >= outer->x1 && inner->x2 <= outer->x2 &&
+           inner->y1 >= outer->y1 && inner->y2 <= outer->y2;
+}
+
+static area_merge_rect_t rect_union(const area_merge_rect_t *a, const area_merge_rect_t *b)
+{
+    area_merge_rect_t u = {
+        .x1 = (a->x1 < b->x1) ? a->x1 : b->x1,
+        .y1 = (a->y1 < b->y1) ? a->y1 : b->y1,
+        .x2 = (a->x2 > b->x2) ? a->x2 : b->x2,
+        .y2 = (a->y2 > b->y2) ? a->y2 : b->y2,
+    };
+    return u;
+}
+
+static size_t rect_remove(area_merge_rect_t *rects, size_t count, size_t index)
+{
+    rects[index] = rects[count - 1U];
+    return count - 1U;
+}
+
+void area_merge_get_default_cost(uint32_t pixel_clock_hz, uint32_t band_px, area_merge_cost_t *cost)
+{
+    if (cost == NULL) {
+        return;
+    }
+    if (pixel_clock_hz == 0U) {
+        pixel_clock_hz = 1U;
+    }
+
+    const uint64_t bit_ns = 1000000000ULL;
+    cost->pixel_ns = (uint32_t)(16ULL * bit_ns / pixel_clock_hz);
+    cost->window_ns = (uint32_t)(AREA_MERGE_WINDOW_BYTES * 8ULL * bit_ns / pixel_clock_hz) +
+                      AREA_MERGE_DEFAULT_CMD_LATENCY_NS;
+    cost->write_ns = (uint32_t)(AREA_MERGE_WRITE_BYTES * 8ULL * bit_ns / pixel_clock_hz) +
+                     AREA_MERGE_DEFAULT_CMD_LATENCY_NS;
+    cost->band_px = band_px;
+    cost->reuse_columns = true;
+}
+
+uint32_t area_merge_bands(const area_merge_cost_t *cost, const area_merge_rect_t *rect)
+{
+    const int32_t w = rect_width(rect);
+    const int32_t h = rect_height(rect);
+    if (w <= 0 || h <= 0) {
+        return 0U;
+    }
+
+    /* Same row count as LVGL's get_max_row() without a rounder. */
+    int32_t rows = (cost->band_px > 0U) ? (int32_t)(cost->band_px / (uint32_t)w) : h;
+    if (rows < 1) {
+        rows = 1;
+    }
+    if (rows > h) {
+        rows = h;
+    }
+    return (uint32_t)((h + rows - 1) / rows);
+}
+
+static uint32_t rect_window_cmds(const area_merge_cost_t *cost, uint32_t bands)
+{
+    return bands + (cost->reuse_columns ? 1U : bands);
+}
+
+uint64_t area_merge_rect_cost_ns(const area_merge_cost_t *cost, const area_merge_rect_t *rect)
+{
+    const uint32_t bands = area_merge_bands(cost, rect);
+    return (uint64_t)rect_window_cmds(cost, bands) * cost->window_ns +
+           (uint64_t)bands * cost->write_ns +
+           (uint64_t)rect_pixels(rect) * cost->pixel_ns;
+}
+
+void area_merge_estimate(const area_merge_cost_t *cost,
+                         const area_merge_rect_t *rects,
+                         size_t count,
+                         area_merge_estimate_t *out)
+{
+    if (cost == NULL || rects == NULL || out == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t bands = area_merge_bands(cost, &rects[i]);
+        const uint32_t windows = rect_window_cmds(cost, bands);
+        const uint32_t pixels = rect_pixels(&rects[i]);
+
+        out->rects++;
+        out->bands += bands;
+        out->window_cmds += windows;
+        out->pixels += pixels;
+        out->bytes += (uint64_t)pixels * 2U + (uint64_t)windows * AREA_MERGE_WINDOW_BYTES +
+                      (uint64_t)bands * AREA_MERGE_WRITE_BYTES;
+        out->cost_ns += area_merge_rect_cost_ns(cost, &rects[i]);
+    }
+}
+
+static size_t drop_contained(area_merge_rect_t *rects, size_t count)
+{
+    for (size_t i = 0; i < count;) {
+        bool covered = false;
+        for (size_t j = 0; j < count && !covered; ++j) {
+            covered = (j != i) && rect_contains(&rects[j], &rects[i]);
+        }
+        if (covered) {
+            count = rect_remove(rects, count, i);
+        } else {
+            ++i;
+        }
+    }
+    return count;
+}
+
+static size_t merge_pass(const area_merge_cost_t *cost, area_merge_rect_t *rects, size_t count)
+{
+    uint64_t costs[AREA_MERGE_MAX_RECTS];
+    for (size_t i = 0; i < count; ++i) {
+        costs[i] = area_merge_rect_cost_ns(cost, &rects[i]);
+    }
+
+    while (count > 1U) {
+        uint64_t best_gain = 0;
+        size_t best_i = 0;
+        size_t best_j = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = i + 1U; j < count; ++j) {
+                const area_merge_rect_t u = rect_union(&rects[i], &rects[j]);
+                const uint64_t separate = costs[i] + costs[j];
+                const uint64_t merged = area_merge_rect_cost_ns(cost, &u);
+                if (merged < separate && separate - merged > best_gain) {
+                    best_gain = separate - merged;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+        if (best_gain == 0U) {
+            break;
+        }
+
+        rects[best_i] = rect_union(&rects[best_i], &rects[best_j]);
+        costs[best_i] = area_merge_rect_cost_ns(cost, &rects[best_i]);
+        rects[best_j] = rects[count - 1U];
+        costs[best_j] = costs[count - 1U];
+        count--;
+        if (best_i == count) {
+            best_i = best_j;
+        }
+
+        /* The merged box may now cover other rectangles outright. */
+        for (size_t k = 0; k < count;) {
+            if (k != best_i && rect_contains(&rects[best_i], &rects[k])) {
+                rects[k] = rects[count - 1U];
+                costs[k] = costs[count - 1U];
+                count--;
+                if (best_i == count) {
+                    best_i = k;
+                }
+                continue;
+            }
+            ++k;
+        }
+    }
+    return count;
+}
+
+/* Up to four pieces covering r minus its overlap with cut. */
+static size_t split_around(const area_merge_rect_t *r, const area_merge_rect_t *cut, area_merge_rect_t out[4])
+{
+    const int16_t oy1 = (cut->y1 > r->y1) ? cut->y1 : r->y1;
+    const int16_t oy2 = (cut->y2 < r->y2) ? cut->y2 : r->y2;
+    const int16_t ox1 = (cut->x1 > r->x1) ? cut->x1 : r->x1;
+    const int16_t ox2 = (cut->x2 < r->x2) ? cut->x2 : r->x2;
+    size_t n = 0;
+
+    if (r->y1 < oy1) {
+        out[n++] = (area_merge_rect_t){ r->x1, r->y1, r->x2, (int16_t)(oy1 - 1) };
+    }
+    if (r->y2 > oy2) {
+        out[n++] = (area_merge_rect_t){ r->x1, (int16_t)(oy2 + 1), r->x2, r->y2 };
+    }
+    if (r->x1 < ox1) {
+        out[n++] = (area_merge_rect_t){ r->x1, oy1, (int16_t)(ox1 - 1), oy2 };
+    }
+    if (r->x2 > ox2) {
+        out[n++] = (area_merge_rect_t){ (int16_t)(ox2 + 1), oy1, r->x2, oy2 };
+    }
+    return n;
+}
+
+static size_t split_pass(const area_merge_cost_t *cost, area_merge_rect_t *rects, size_t count, size_t capacity)
+{
+    bool changed = true;
+    for (uint32_t pass = 0; changed && pass < AREA_MERGE_SPLIT_PASSES; ++pass) {
+        changed = false;
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < count; ++j) {
+                if (i == j || !rect_overlaps(&rects[i], &rects[j]) || rect_contains(&rects[i], &rects[j])) {
+                    continue;
+                }
+
+                area_merge_rect_t pieces[4];
+                const size_t n = split_around(&rects[j], &rects[i], pieces);
+                if (n == 0U || count + n - 1U > capacity) {
+                    continue;
+                }
+                uint64_t split_cost = 0;
+                for (size_t p = 0; p < n; ++p) {
+                    split_cost += area_merge_rect_cost_ns(cost, &pieces[p]);
+                }
+                if (split_cost >= area_merge_rect_cost_ns(cost, &rects[j])) {
+                    continue;
+                }
+
+                rects[j] = pieces[0];
+                for (size_t p = 1; p < n; ++p) {
+                    rects[count++] = pieces[p];
+                }
+                changed = true;
+            }
+        }
+    }
+    return count;
+}
+
+size_t area_merge_optimize(const area_merge_cost_t *cost,
+                           area_merge_rect_t *rects,
+                           size_t count,
+                           size_t capacity)
+{
+    if (cost == NULL || rects == NULL || count < 2U) {
+        return count;
+    }
+    if (capacity > AREA_MERGE_MAX_RECTS) {
+        capacity = AREA_MERGE_MAX_RECTS;
+    }
+    if (count > capacity) {
+        return count;
+    }
+
+    count = drop_contained(rects, count);
+    count = merge_pass(cost, rects, count);
+    return split_pass(cost, rects, count, capacity);
+}
@@ -0,0 +1,107 @@
+#include "area_merge_lvgl.h"
+
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if LV_INV_BUF_SIZE > AREA_MERGE_MAX_RECTS
+#error "area_merge holds fewer rectangles than LV_INV_BUF_SIZE"
+#endif
+
+static const char *TAG = "area_merge";
+
+static area_merge_cost_t s_cost;
+static bool s_installed;
+static bool s_trace;
+static area_merge_lvgl_stats_t s_stats;
+static char s_trace_line[LV_INV_BUF_SIZE * 20U + 8U];
+
+static void area_merge_trace_frame(const lv_disp_t *disp)
+{
+    size_t used = 0;
+    for (uint16_t i = 0; i < disp->inv_p && used < sizeof(s_trace_line); ++i) {
+        const lv_area_t *a = &disp->inv_areas[i];
+        const int n = snprintf(&s_trace_line[used], sizeof(s_trace_line) - used, " %d,%d,%d,%d",
+                               (int)a->x1, (int)a->y1, (int)a->x2, (int)a->y2);
+        if (n < 0) {
+            break;
+        }
+        used += (size_t)n;
+    }
+    s_trace_line[sizeof(s_trace_line) - 1U] = '\0';
+    ESP_LOGI(TAG, "frame%s", s_trace_line);
+}
+
+static void area_merge_refr_timer_cb(lv_timer_t *timer)
+{
+    lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+
+    if (disp != NULL && disp->inv_p > 0U && s_trace) {
+        area_merge_trace_frame(disp);
+    }
+
+    if (disp != NULL && disp->inv_p > 1U) {
+        area_merge_rect_t rects[LV_INV_BUF_SIZE];
+        const size_t count_in = disp->inv_p;
+
+        for (size_t i = 0; i < count_in; ++i) {
+            const lv_area_t *a = &disp->inv_areas[i];
+            rects[i] = (area_merge_rect_t){ a->x1, a->y1, a->x2, a->y2 };
+        }
+
+        area_merge_estimate_t before = { 0 };
+        area_merge_estimate(&s_cost, rects, count_in, &before);
+        const size_t count_out = area_merge_optimize(&s_cost, rects, count_in, LV_INV_BUF_SIZE);
+        area_merge_estimate_t after = { 0 };
+        area_merge_estimate(&s_cost, rects, count_out, &after);
+
+        for (size_t i = 0; i < count_out; ++i) {
+            lv_area_t *a = &disp->inv_areas[i];
+            a->x1 = rects[i].x1;
+            a->y1 = rects[i].y1;
+            a->x2 = rects[i].x2;
+            a->y2 = rects[i].y2;
+            disp->inv_area_joined[i] = 0;
+        }
+        disp->inv_p = (uint16_t)count_out;
+
+        s_stats.frames++;
+        s_stats.rects_in += (uint32_t)count_in;
+        s_stats.rects_out += (uint32_t)count_out;
+        s_stats.cost_in_ns += before.cost_ns;
+        s_stats.cost_out_ns += after.cost_ns;
+    }
+
+    _lv_disp_refr_timer(timer);
+}
+
+bool area_merge_lvgl_install(lv_disp_t *disp, const area_merge_cost_t *cost)
+{
+    if (disp == NULL || disp->refr_timer == NULL || cost == NULL) {
+        return false;
+    }
+
+    s_cost = *cost;
+    if (!s_installed) {
+        lv_timer_set_cb(disp->refr_timer, area_merge_refr_timer_cb);
+        s_installed = true;
+    }
+    ESP_LOGI(TAG, "cost model: %u ns/px, %u ns/window, %u ns/write, %u px bands",
+             (unsigned)s_cost.pixel_ns, (unsigned)s_cost.window_ns,
+             (unsigned)s_cost.write_ns, (unsigned)s_cost.band_px);
+    return true;
+}
+
+void area_merge_lvgl_set_trace(bool enable)
+{
+    s_trace = enable;
+}
+
+void area_merge_lvgl_get_stats(area_merge_lvgl_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+    memcpy(out_stats, &s_stats, sizeof(*out_stats));
+}
@@ -0,0 +1,268 @@
+/*
+ * sim_area_merge.c
+ *
+ * Host simulator: replays invalidation traces through three pipelines and
+ * reports the estimated SPI traffic of each:
+ *
+ *   lvgl     LVGL's join only; the driver sends CASET + RASET every band
+ *   driver   same areas; the driver skips CASET when the columns repeat
+ *   merged   area_merge_optimize() first, then LVGL's join, CASET reuse
+ *
+ * A trace line holds one frame: "frame x1,y1,x2,y2 x1,y1,x2,y2 ...".
+ * Anything before "frame" is ignored, so monitor logs captured with
+ * area_merge_lvgl_set_trace(true) replay as they are. '#' starts a comment.
+ *
+ *   sim_area_merge [--band-px N] [--clock-hz N] [--check] trace...
+ *
+ * --check fails if a merged frame costs more than the driver pipeline or
+ * leaves an input pixel uncovered.
+ */
+
+#include "area_merge.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_LINE_LEN 2048U
+#define SIM_MAX_COORD 1024
+
+enum { SIM_LVGL = 0, SIM_DRIVER, SIM_MERGED, SIM_PIPELINES };
+
+static const char *const s_pipeline_names[SIM_PIPELINES] = { "lvgl", "driver", "merged" };
+
+typedef struct {
+    uint32_t frames;
+    uint32_t input_rects;
+    area_merge_estimate_t total[SIM_PIPELINES];
+    uint32_t worse_frames;
+    uint32_t uncovered_frames;
+} sim_totals_t;
+
+static uint8_t s_grid[SIM_MAX_COORD][SIM_MAX_COORD];
+
+/* lv_refr_join_area(): join overlapping areas whose union is smaller than the pair. */
+static size_t sim_lvgl_join(area_merge_rect_t *rects, size_t count)
+{
+    bool joined[AREA_MERGE_MAX_RECTS] = { false };
+
+    for (size_t in = 0; in < count; ++in) {
+        if (joined[in]) {
+            continue;
+        }
+        for (size_t from = 0; from < count; ++from) {
+            if (joined[from] || in == from) {
+                continue;
+            }
+            const area_merge_rect_t *a = &rects[in];
+            const area_merge_rect_t *b = &rects[from];
+            if (!(a->x1 <= b->x2 && a->x2 >= b->x1 && a->y1 <= b->y2 && a->y2 >= b->y1)) {
+                continue;
+            }
+            area_merge_rect_t u = {
+                .x1 = (a->x1 < b->x1) ? a->x1 : b->x1,
+                .y1 = (a->y1 < b->y1) ? a->y1 : b->y1,
+                .x2 = (a->x2 > b->x2) ? a->x2 : b->x2,
+                .y2 = (a->y2 > b->y2) ? a->y2 : b->y2,
+            };
+            const int64_t size_u = (int64_t)(u.x2 - u.x1 + 1) * (u.y2 - u.y1 + 1);
+            const int64_t size_a = (int64_t)(a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1);
+            const int64_t size_b = (int64_t)(b->x2 - b->x1 + 1) * (b->y2 - b->y1 + 1);
+            if (size_u < size_a + size_b) {
+                rects[in] = u;
+                joined[from] = true;
+            }
+        }
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!joined[i]) {
+            rects[out++] = rects[i];
+        }
+    }
+    return out;
+}
+
+static void sim_paint(const area_merge_rect_t *rects, size_t count, uint8_t bit)
+{
+    for (size_t i = 0; i < count; ++i) {
+        for (int y = rects[i].y1; y <= rects[i].y2; ++y) {
+            for (int x = rects[i].x1; x <= rects[i].x2; ++x) {
+                s_grid[y][x] |= bit;
+            }
+        }
+    }
+}
+
+static bool sim_covers(const area_merge_rect_t *in, size_t in_count,
+                       const area_merge_rect_t *out, size_t out_count)
+{
+    memset(s_grid, 0, sizeof(s_grid));
+    sim_paint(in, in_count, 1U);
+    sim_paint(out, out_count, 2U);
+    for (int y = 0; y < SIM_MAX_COORD; ++y) {
+        for (int x = 0; x < SIM_MAX_COORD; ++x) {
+            if (s_grid[y][x] == 1U) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static size_t sim_parse_frame(const char *text, area_merge_rect_t *rects, size_t capacity)
+{
+    size_t count = 0;
+    const char *p = text;
+
+    while (count < capacity) {
+        int x1, y1, x2, y2, used = 0;
+        if (sscanf(p, " %d,%d,%d,%d%n", &x1, &y1, &x2, &y2, &used) != 4) {
+            break;
+        }
+        p += used;
+        if (x1 < 0 || y1 < 0 || x2 >= SIM_MAX_COORD || y2 >= SIM_MAX_COORD || x1 > x2 || y1 > y2) {
+            continue;
+        }
+        rects[count++] = (area_merge_rect_t){ (int16_t)x1, (int16_t)y1, (int16_t)x2, (int16_t)y2 };
+    }
+    return count;
+}
+
+static void sim_frame(const area_merge_cost_t *cost, const area_merge_rect_t *input, size_t count,
+                      sim_totals_t *totals)
+{
+    area_merge_rect_t joined[AREA_MERGE_MAX_RECTS];
+    area_merge_rect_t merged[AREA_MERGE_MAX_RECTS];
+    area_merge_cost_t lvgl_cost = *cost;
+    area_merge_estimate_t frame[SIM_PIPELINES] = { { 0 } };
+
+    lvgl_cost.reuse_columns = false;
+
+    memcpy(joined, input, count * sizeof(input[0]));
+    const size_t joined_count = sim_lvgl_join(joined, count);
+    area_merge_estimate(&lvgl_cost, joined, joined_count, &frame[SIM_LVGL]);
+    area_merge_estimate(cost, joined, joined_count, &frame[SIM_DRIVER]);
+
+    memcpy(merged, input, count * sizeof(input[0]));
+    size_t merged_count = area_merge_optimize(cost, merged, count, AREA_MERGE_MAX_RECTS);
+    merged_count = sim_lvgl_join(merged, merged_count);
+    area_merge_estimate(cost, merged, merged_count, &frame[SIM_MERGED]);
+
+    if (frame[SIM_MERGED].cost_ns > frame[SIM_DRIVER].cost_ns) {
+        totals->worse_frames++;
+    }
+    if (!sim_covers(input, count, merged, merged_count)) {
+        totals->uncovered_frames++;
+    }
+
+    totals->frames++;
+    totals->input_rects += (uint32_t)count;
+    for (int p = 0; p < SIM_PIPELINES; ++p) {
+        area_merge_estimate_t *t = &totals->total[p];
+        t->rects += frame[p].rects;
+        t->bands += frame[p].bands;
+        t->window_cmds += frame[p].window_cmds;
+        t->pixels += frame[p].pixels;
+        t->bytes += frame[p].bytes;
+        t->cost_ns += frame[p].cost_ns;
+    }
+}
+
+static bool sim_replay(const char *path, const area_merge_cost_t *cost, sim_totals_t *totals)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+
+    char line[SIM_LINE_LEN];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        const char *frame = strstr(line, "frame");
+        if (frame == NULL) {
+            continue;
+        }
+
+        area_merge_rect_t rects[AREA_MERGE_MAX_RECTS];
+        const size_t count = sim_parse_frame(frame + strlen("frame"), rects, AREA_MERGE_MAX_RECTS);
+        if (count > 0U) {
+            sim_frame(cost, rects, count, totals);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static void sim_report(const sim_totals_t *totals)
+{
+    const area_merge_estimate_t *base = &totals->total[SIM_LVGL];
+
+    printf("%u frames, %u input rects\n", (unsigned)totals->frames, (unsigned)totals->input_rects);
+    printf("%-7s %7s %7s %8s %10s %10s %10s %7s\n",
+           "", "rects", "bands", "windows", "pixels", "bytes", "est_us", "saved");
+    for (int p = 0; p < SIM_PIPELINES; ++p) {
+        const area_merge_estimate_t *t = &totals->total[p];
+        const double saved = (base->cost_ns > 0U)
+                                 ? 100.0 * (double)((int64_t)base->cost_ns - (int64_t)t->cost_ns) / (double)base->cost_ns
+                                 : 0.0;
+        printf("%-7s %7u %7u %8u %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %6.1f%%\n",
+               s_pipeline_names[p], (unsigned)t->rects, (unsigned)t->bands, (unsigned)t->window_cmds,
+               t->pixels, t->bytes, t->cost_ns / 1000U, saved);
+    }
+    printf("transactions saved vs lvgl: %" PRId64 ", bytes saved: %" PRId64 "\n",
+           (int64_t)base->bands - (int64_t)totals->total[SIM_MERGED].bands,
+           (int64_t)base->bytes - (int64_t)totals->total[SIM_MERGED].bytes);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t band_px = 320U * 20U;
+    uint32_t clock_hz = 12000000U;
+    bool check = false;
+    int first_trace = argc;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--band-px") == 0 && i + 1 < argc) {
+            band_px = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--clock-hz") == 0 && i + 1 < argc) {
+            clock_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else {
+            first_trace = i;
+            break;
+        }
+    }
+    if (first_trace >= argc) {
+        fprintf(stderr, "usage: %s [--band-px N] [--clock-hz N] [--check] trace...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    area_merge_cost_t cost;
+    area_merge_get_default_cost(clock_hz, band_px, &cost);
+
+    sim_totals_t totals = { 0 };
+    for (int i = first_trace; i < argc; ++i) {
+        if (!sim_replay(argv[i], &cost, &totals)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    sim_report(&totals);
+    if (totals.worse_frames != 0U || totals.uncovered_frames != 0U) {
+        printf("%u frame(s) costlier than the driver pipeline, %u frame(s) with uncovered pixels\n",
+               (unsigned)totals.worse_frames, (unsigned)totals.uncovered_frames);
+        if (check) {
+            return EXIT_FAILURE;
+        }
+    }
+    return (check && totals.frames == 0U) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
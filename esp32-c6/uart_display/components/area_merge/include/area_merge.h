@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ * area_merge.h
+ *
+ * Cost-model driven rewrite of a frame's dirty rectangles before LVGL
+ * renders them. On the SPI panel every flushed band costs a RASET and a
+ * RAMWR command (plus a CASET when its columns differ from the previous
+ * band) on top of its pixels, so a few extra pixels can be cheaper than one
+ * more transaction, and vice versa.
+ *
+ * area_merge_optimize() greedily merges the pair whose bounding box saves the
+ * most estimated SPI time until no merge saves anything, then splits a
+ * rectangle around an overlapping one when sending the overlap twice costs
+ * more than the extra transactions. The estimate follows LVGL's flushing:
+ * each area goes out in bands of band_px / width rows.
+ *
+ * No LVGL or FreeRTOS dependency; builds and runs on the host.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AREA_MERGE_MAX_RECTS 32U
+/* Driver + polling-transaction latency of one command on the C6 (estimate). */
+#define AREA_MERGE_DEFAULT_CMD_LATENCY_NS 12000U
+
+/* Inclusive coordinates, like lv_area_t. */
+typedef struct {
+    int16_t x1;
+    int16_t y1;
+    int16_t x2;
+    int16_t y2;
+} area_merge_rect_t;
+
+typedef struct {
+    uint32_t pixel_ns;   /* wire time of one pixel */
+    uint32_t window_ns;  /* one CASET or RASET: command, 4 params, latency */
+    uint32_t write_ns;   /* RAMWR command and DMA setup, once per band */
+    uint32_t band_px;    /* draw buffer size in pixels */
+    bool reuse_columns;  /* driver skips CASET when the columns did not change */
+} area_merge_cost_t;
+
+typedef struct {
+    uint32_t rects;
+    uint32_t bands;        /* flushes, one RAMWR each */
+    uint32_t window_cmds;  /* CASET + RASET sent */
+    uint64_t pixels;
+    uint64_t bytes;        /* pixels plus command bytes on the wire */
+    uint64_t cost_ns;
+} area_merge_estimate_t;
+
+/* 16-bit pixels at pixel_clock_hz, AREA_MERGE_DEFAULT_CMD_LATENCY_NS per command. */
+void area_merge_get_default_cost(uint32_t pixel_clock_hz, uint32_t band_px, area_merge_cost_t *cost);
+
+uint32_t area_merge_bands(const area_merge_cost_t *cost, const area_merge_rect_t *rect);
+
+uint64_t area_merge_rect_cost_ns(const area_merge_cost_t *cost, const area_merge_rect_t *rect);
+
+/* Adds the flush cost of rects to out (which the caller zeroes once). */
+void area_merge_estimate(const area_merge_cost_t *cost,
+                         const area_merge_rect_t *rects,
+                         size_t count,
+                         area_merge_estimate_t *out);
+
+/*
+ * Rewrites rects in place; capacity bounds how many a split may produce.
+ * Returns the new count. The result covers every input pixel.
+ */
+size_t area_merge_optimize(const area_merge_cost_t *cost,
+                           area_merge_rect_t *rects,
+                           size_t count,
+                           size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
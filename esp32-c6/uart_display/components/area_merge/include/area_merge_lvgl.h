@@ -0,0 +1,44 @@
+#pragma once
+
+/*
+ * area_merge_lvgl.h
+ *
+ * Runs area_merge_optimize() on a display's invalid areas just before each
+ * LVGL refresh, by wrapping the display's refresh timer. LVGL's own join
+ * still runs afterwards; it only merges overlapping areas whose union is
+ * smaller than the pair, which the cost model would merge as well.
+ *
+ * All functions run in the LVGL thread.
+ */
+
+#include "area_merge.h"
+#include "lvgl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t frames;        /* refreshes with more than one invalid area */
+    uint32_t rects_in;
+    uint32_t rects_out;
+    uint64_t cost_in_ns;    /* estimated SPI time before / after rewriting */
+    uint64_t cost_out_ns;
+} area_merge_lvgl_stats_t;
+
+bool area_merge_lvgl_install(lv_disp_t *disp, const area_merge_cost_t *cost);
+
+/*
+ * Logs each frame's invalid areas (before rewriting) as
+ * "frame x1,y1,x2,y2 ..." for replay with host_test/sim_area_merge.
+ */
+void area_merge_lvgl_set_trace(bool enable);
+
+void area_merge_lvgl_get_stats(area_merge_lvgl_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
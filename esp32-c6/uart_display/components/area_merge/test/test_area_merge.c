@@ -0,0 +1,104 @@
+#include "area_merge.h"
+
+#include "unity.h"
+
+#include <string.h>
+
+#define TEST_W 320
+#define TEST_H 172
+
+static uint8_t s_grid[TEST_H][TEST_W];
+
+static area_merge_cost_t test_cost(void)
+{
+    area_merge_cost_t cost;
+    area_merge_get_default_cost(12000000U, TEST_W * 20U, &cost);
+    return cost;
+}
+
+static void paint(const area_merge_rect_t *rects, size_t count, uint8_t bit)
+{
+    for (size_t i = 0; i < count; ++i) {
+        for (int y = rects[i].y1; y <= rects[i].y2; ++y) {
+            for (int x = rects[i].x1; x <= rects[i].x2; ++x) {
+                s_grid[y][x] |= bit;
+            }
+        }
+    }
+}
+
+static void assert_covers(const area_merge_rect_t *in, size_t in_count,
+                          const area_merge_rect_t *out, size_t out_count)
+{
+    memset(s_grid, 0, sizeof(s_grid));
+    paint(in, in_count, 1U);
+    paint(out, out_count, 2U);
+    for (int y = 0; y < TEST_H; ++y) {
+        for (int x = 0; x < TEST_W; ++x) {
+            TEST_ASSERT_NOT_EQUAL(1U, s_grid[y][x]);
+        }
+    }
+}
+
+static uint64_t total_cost(const area_merge_cost_t *cost, const area_merge_rect_t *rects, size_t count)
+{
+    area_merge_estimate_t estimate = { 0 };
+    area_merge_estimate(cost, rects, count, &estimate);
+    return estimate.cost_ns;
+}
+
+TEST_CASE("area_merge bands follow the draw buffer", "[area_merge]")
+{
+    const area_merge_cost_t cost = test_cost();
+    const area_merge_rect_t full = { 0, 0, TEST_W - 1, TEST_H - 1 };
+    const area_merge_rect_t label = { 62, 24, 257, 66 };
+
+    TEST_ASSERT_EQUAL_UINT32(9U, area_merge_bands(&cost, &full)); /* 20 rows per band */
+    TEST_ASSERT_EQUAL_UINT32(2U, area_merge_bands(&cost, &label)); /* 32 rows per band */
+}
+
+TEST_CASE("area_merge joins adjacent glyphs and keeps distant labels", "[area_merge]")
+{
+    const area_merge_cost_t cost = test_cost();
+    const area_merge_rect_t glyphs[] = {
+        { 214, 24, 233, 66 },
+        { 234, 24, 257, 66 },
+    };
+    const area_merge_rect_t labels[] = {
+        { 62, 24, 257, 66 },
+        { 98, 116, 221, 158 },
+    };
+    area_merge_rect_t rects[AREA_MERGE_MAX_RECTS];
+
+    memcpy(rects, glyphs, sizeof(glyphs));
+    TEST_ASSERT_EQUAL_UINT32(1U, area_merge_optimize(&cost, rects, 2, AREA_MERGE_MAX_RECTS));
+    TEST_ASSERT_EQUAL_INT16(214, rects[0].x1);
+    TEST_ASSERT_EQUAL_INT16(257, rects[0].x2);
+
+    memcpy(rects, labels, sizeof(labels));
+    TEST_ASSERT_EQUAL_UINT32(2U, area_merge_optimize(&cost, rects, 2, AREA_MERGE_MAX_RECTS));
+    assert_covers(labels, 2, rects, 2);
+}
+
+TEST_CASE("area_merge never costs more and covers every pixel", "[area_merge]")
+{
+    const area_merge_cost_t cost = test_cost();
+    const area_merge_rect_t input[] = {
+        { 6, 130, 180, 145 },
+        { 0, 138, 319, 141 },
+        { 6, 156, 200, 171 },
+        { 274, 6, 279, 40 },
+        { 282, 14, 287, 40 },
+        { 62, 24, 250, 66 },
+        { 62, 24, 257, 66 },
+    };
+    const size_t count = sizeof(input) / sizeof(input[0]);
+    area_merge_rect_t rects[AREA_MERGE_MAX_RECTS];
+
+    memcpy(rects, input, sizeof(input));
+    const size_t out = area_merge_optimize(&cost, rects, count, AREA_MERGE_MAX_RECTS);
+
+    TEST_ASSERT_TRUE(out <= AREA_MERGE_MAX_RECTS);
+    TEST_ASSERT_TRUE(total_cost(&cost, rects, out) <= total_cost(&cost, input, count));
+    assert_covers(input, count, rects, out);
+}
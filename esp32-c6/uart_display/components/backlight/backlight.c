@@ -0,0 +1,241 @@
+#include "backlight.h"
+#include "backlight_curve.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+
+#include <string.h>
+
+#ifdef CONFIG_BACKLIGHT_GAMMA_X100
+#define BACKLIGHT_DEFAULT_GAMMA_X100 CONFIG_BACKLIGHT_GAMMA_X100
+#else
+#define BACKLIGHT_DEFAULT_GAMMA_X100 220
+#endif
+
+#ifdef CONFIG_BACKLIGHT_FADE_MS
+#define BACKLIGHT_DEFAULT_FADE_MS CONFIG_BACKLIGHT_FADE_MS
+#else
+#define BACKLIGHT_DEFAULT_FADE_MS 800
+#endif
+
+#ifdef CONFIG_BACKLIGHT_DIM_PERCENT
+#define BACKLIGHT_DEFAULT_DIM_PERCENT CONFIG_BACKLIGHT_DIM_PERCENT
+#else
+#define BACKLIGHT_DEFAULT_DIM_PERCENT 15
+#endif
+
+#ifdef CONFIG_BACKLIGHT_DIM_AFTER_S
+#define BACKLIGHT_DEFAULT_DIM_AFTER_S CONFIG_BACKLIGHT_DIM_AFTER_S
+#else
+#define BACKLIGHT_DEFAULT_DIM_AFTER_S 0
+#endif
+
+#ifdef CONFIG_BACKLIGHT_OFF_AFTER_S
+#define BACKLIGHT_DEFAULT_OFF_AFTER_S CONFIG_BACKLIGHT_OFF_AFTER_S
+#else
+#define BACKLIGHT_DEFAULT_OFF_AFTER_S 0
+#endif
+
+static const char *TAG = "backlight";
+
+static backlight_config_t s_config;
+static backlight_curve_t s_curve;
+static bool s_initialized = false;
+
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+static backlight_stats_t s_stats;
+
+void backlight_get_default_config(backlight_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->gpio_num = GPIO_NUM_NC;
+    config->speed_mode = LEDC_LOW_SPEED_MODE;
+    config->timer = LEDC_TIMER_0;
+    config->channel = LEDC_CHANNEL_0;
+    config->resolution = LEDC_TIMER_13_BIT;
+    config->freq_hz = 5000;
+    config->gamma_x100 = BACKLIGHT_DEFAULT_GAMMA_X100;
+    config->min_duty_permille = 10;
+    config->brightness = 75;
+    config->fade_ms = BACKLIGHT_DEFAULT_FADE_MS;
+    config->wake_fade_ms = 150;
+    config->dim_percent = BACKLIGHT_DEFAULT_DIM_PERCENT;
+    config->dim_after_ms = BACKLIGHT_DEFAULT_DIM_AFTER_S * 1000U;
+    config->off_after_ms = BACKLIGHT_DEFAULT_OFF_AFTER_S * 1000U;
+}
+
+/* Caller holds s_lock. */
+static void backlight_fade_locked(uint8_t level, uint32_t fade_ms)
+{
+    const uint32_t duty = backlight_curve_duty(&s_curve, level);
+
+#if SOC_LEDC_SUPPORT_FADE_STOP
+    /* A running fade would make the next one wait for it to finish. */
+    (void)ledc_fade_stop(s_config.speed_mode, s_config.channel);
+#endif
+    if (fade_ms == 0U) {
+        (void)ledc_set_duty(s_config.speed_mode, s_config.channel, duty);
+        (void)ledc_update_duty(s_config.speed_mode, s_config.channel);
+    } else {
+        (void)ledc_set_fade_time_and_start(s_config.speed_mode, s_config.channel, duty, fade_ms,
+                                           LEDC_FADE_NO_WAIT);
+        s_stats.fades++;
+    }
+    s_stats.level = level;
+    s_stats.duty = duty;
+}
+
+static uint8_t backlight_state_level(backlight_state_t state)
+{
+    switch (state) {
+    case BACKLIGHT_STATE_OFF:
+        return 0U;
+    case BACKLIGHT_STATE_DIM:
+        return (s_config.dim_percent < s_stats.brightness) ? s_config.dim_percent : s_stats.brightness;
+    case BACKLIGHT_STATE_ON:
+    default:
+        return s_stats.brightness;
+    }
+}
+
+bool backlight_init(const backlight_config_t *config)
+{
+    if (config == NULL || config->gpio_num == GPIO_NUM_NC) {
+        return false;
+    }
+    if (s_initialized) {
+        return true;
+    }
+
+    s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+    s_config = *config;
+    if (s_config.brightness > 100U) {
+        s_config.brightness = 100U;
+    }
+
+    const ledc_timer_config_t timer_config = {
+        .speed_mode = s_config.speed_mode,
+        .duty_resolution = s_config.resolution,
+        .timer_num = s_config.timer,
+        .freq_hz = s_config.freq_hz,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    const ledc_channel_config_t channel_config = {
+        .gpio_num = s_config.gpio_num,
+        .speed_mode = s_config.speed_mode,
+        .channel = s_config.channel,
+        .timer_sel = s_config.timer,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    if (ledc_timer_config(&timer_config) != ESP_OK || ledc_channel_config(&channel_config) != ESP_OK) {
+        ESP_LOGE(TAG, "LEDC setup failed on GPIO %d", (int)s_config.gpio_num);
+        return false;
+    }
+    if (ledc_fade_func_install(0) != ESP_OK) {
+        ESP_LOGE(TAG, "LEDC fade service not installed");
+        return false;
+    }
+
+    const uint32_t max_duty = (1UL << s_config.resolution) - 1U;
+    const uint32_t min_duty = (max_duty * s_config.min_duty_permille) / 1000U;
+    backlight_curve_build(&s_curve, s_config.gamma_x100, (uint16_t)min_duty, (uint16_t)max_duty);
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.state = BACKLIGHT_STATE_ON;
+    s_stats.brightness = s_config.brightness;
+    backlight_fade_locked(s_stats.brightness, 0U);
+    s_initialized = true;
+    return true;
+}
+
+bool backlight_set(uint8_t percent, uint32_t fade_ms)
+{
+    if (!s_initialized) {
+        return false;
+    }
+    if (percent > 100U) {
+        percent = 100U;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_stats.brightness = percent;
+    /* Dimmed or off: the new level applies when activity wakes the screen. */
+    if (s_stats.state == BACKLIGHT_STATE_ON) {
+        backlight_fade_locked(percent, fade_ms);
+    } else if (s_stats.state == BACKLIGHT_STATE_DIM) {
+        backlight_fade_locked(backlight_state_level(BACKLIGHT_STATE_DIM), fade_ms);
+    }
+    (void)xSemaphoreGive(s_lock);
+    return true;
+}
+
+uint8_t backlight_get(void)
+{
+    return s_stats.brightness;
+}
+
+void backlight_set_auto_dim(uint8_t dim_percent, uint32_t dim_after_ms, uint32_t off_after_ms)
+{
+    if (!s_initialized) {
+        return;
+    }
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_config.dim_percent = (dim_percent > 100U) ? 100U : dim_percent;
+    s_config.dim_after_ms = dim_after_ms;
+    s_config.off_after_ms = off_after_ms;
+    (void)xSemaphoreGive(s_lock);
+}
+
+backlight_state_t backlight_update(uint32_t inactive_ms)
+{
+    if (!s_initialized) {
+        return BACKLIGHT_STATE_ON;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    backlight_state_t target = BACKLIGHT_STATE_ON;
+    if (s_config.off_after_ms != 0U && inactive_ms >= s_config.off_after_ms) {
+        target = BACKLIGHT_STATE_OFF;
+    } else if (s_config.dim_after_ms != 0U && inactive_ms >= s_config.dim_after_ms) {
+        target = BACKLIGHT_STATE_DIM;
+    }
+
+    if (target != s_stats.state) {
+        if (target == BACKLIGHT_STATE_ON) {
+            s_stats.wakes++;
+            backlight_fade_locked(backlight_state_level(target), s_config.wake_fade_ms);
+        } else {
+            if (target == BACKLIGHT_STATE_DIM) {
+                s_stats.dims++;
+            } else {
+                s_stats.offs++;
+            }
+            backlight_fade_locked(backlight_state_level(target), s_config.fade_ms);
+        }
+        s_stats.state = target;
+    }
+    (void)xSemaphoreGive(s_lock);
+    return target;
+}
+
+void backlight_get_stats(backlight_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+    if (!s_initialized) {
+        memset(out_stats, 0, sizeof(*out_stats));
+        return;
+    }
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    memcpy(out_stats, &s_stats, sizeof(*out_stats));
+    (void)xSemaphoreGive(s_lock);
+}
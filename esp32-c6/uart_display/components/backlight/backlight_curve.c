@@ -0,0 +1,41 @@
+#include "backlight_curve.h"
+
+#include <math.h>
+#include <stddef.h>
+
+void backlight_curve_build(backlight_curve_t *curve, uint16_t gamma_x100, uint16_t min_duty, uint16_t max_duty)
+{
+    if (curve == NULL) {
+        return;
+    }
+    if (gamma_x100 == 0U) {
+        gamma_x100 = 100U;
+    }
+    if (min_duty > max_duty) {
+        min_duty = max_duty;
+    }
+
+    const float gamma = (float)gamma_x100 / 100.0f;
+    const float span = (float)(max_duty - min_duty);
+    curve->duty[0] = 0U;
+    for (uint32_t p = 1U; p < BACKLIGHT_CURVE_LEVELS; ++p) {
+        const float scaled = powf((float)p / (float)(BACKLIGHT_CURVE_LEVELS - 1U), gamma);
+        uint32_t duty = min_duty + (uint32_t)lroundf(span * scaled);
+        /* Rounding must not make a higher level darker. */
+        if (duty < curve->duty[p - 1U]) {
+            duty = curve->duty[p - 1U];
+        }
+        curve->duty[p] = (uint16_t)((duty > max_duty) ? max_duty : duty);
+    }
+}
+
+uint16_t backlight_curve_duty(const backlight_curve_t *curve, uint8_t percent)
+{
+    if (curve == NULL) {
+        return 0U;
+    }
+    if (percent >= BACKLIGHT_CURVE_LEVELS) {
+        percent = (uint8_t)(BACKLIGHT_CURVE_LEVELS - 1U);
+    }
+    return curve->duty[percent];
+}
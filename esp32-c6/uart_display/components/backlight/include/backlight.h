@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * backlight.h
+ *
+ * LEDC backlight with a perceptual brightness curve (backlight_curve.h) and
+ * hardware fades. backlight_set() starts an LEDC fade and returns; the
+ * peripheral ramps the duty on its own, so no task waits or wakes for it.
+ *
+ * Auto-dim: backlight_update() is fed the display's inactivity time (from the
+ * LVGL thread) and fades to dim_percent after dim_after_ms and off after
+ * off_after_ms; activity fades back to the set brightness. The returned
+ * state tells the caller when the screen is dark and rendering can stop.
+ */
+
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    BACKLIGHT_STATE_ON = 0,
+    BACKLIGHT_STATE_DIM,
+    BACKLIGHT_STATE_OFF,
+} backlight_state_t;
+
+typedef struct {
+    gpio_num_t gpio_num;
+    ledc_mode_t speed_mode;
+    ledc_timer_t timer;
+    ledc_channel_t channel;
+    ledc_timer_bit_t resolution;
+    uint32_t freq_hz;
+    uint16_t gamma_x100;       /* 220 = 2.2, 100 = linear */
+    uint16_t min_duty_permille; /* duty of 1%, relative to full scale */
+    uint8_t brightness;        /* initial percent */
+    uint16_t fade_ms;          /* dim and off fades */
+    uint16_t wake_fade_ms;     /* fade back to brightness on activity */
+    uint8_t dim_percent;
+    uint32_t dim_after_ms;     /* 0: never dim */
+    uint32_t off_after_ms;     /* 0: never switch off */
+} backlight_config_t;
+
+typedef struct {
+    backlight_state_t state;
+    uint8_t brightness;  /* set level (percent) */
+    uint8_t level;       /* level the last fade was heading to */
+    uint32_t duty;       /* target duty of the last fade */
+    uint32_t fades;
+    uint32_t dims;
+    uint32_t offs;
+    uint32_t wakes;
+} backlight_stats_t;
+
+void backlight_get_default_config(backlight_config_t *config);
+
+bool backlight_init(const backlight_config_t *config);
+
+/* Sets the ON brightness (percent). fade_ms 0 applies it at once. Never blocks on a fade. */
+bool backlight_set(uint8_t percent, uint32_t fade_ms);
+
+uint8_t backlight_get(void);
+
+void backlight_set_auto_dim(uint8_t dim_percent, uint32_t dim_after_ms, uint32_t off_after_ms);
+
+/* Applies the auto-dim policy for inactive_ms of display inactivity; returns the new state. */
+backlight_state_t backlight_update(uint32_t inactive_ms);
+
+void backlight_get_stats(backlight_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
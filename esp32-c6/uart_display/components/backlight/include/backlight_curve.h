@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+ * backlight_curve.h
+ *
+ * Brightness percent -> PWM duty lookup. Perceived brightness is roughly a
+ * power law of luminance, so a linear duty ramp spends most of its range on
+ * levels that all look bright. The table maps percent p to
+ *
+ *   duty = min_duty + (max_duty - min_duty) * (p / 100) ^ gamma
+ *
+ * with 0% fully off, so equal steps in percent look like equal steps in
+ * brightness. No ESP-IDF dependency; builds and runs on the host.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BACKLIGHT_CURVE_LEVELS 101U /* 0..100 % */
+
+typedef struct {
+    uint16_t duty[BACKLIGHT_CURVE_LEVELS];
+} backlight_curve_t;
+
+/*
+ * gamma_x100 is the exponent times 100 (220 = 2.2, 100 = linear).
+ * min_duty is the duty of 1%, so the lowest level stays visible.
+ */
+void backlight_curve_build(backlight_curve_t *curve, uint16_t gamma_x100, uint16_t min_duty, uint16_t max_duty);
+
+/* Percent above 100 is clamped. */
+uint16_t backlight_curve_duty(const backlight_curve_t *curve, uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
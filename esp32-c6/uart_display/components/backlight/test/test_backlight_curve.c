@@ -0,0 +1,41 @@
+#include "backlight_curve.h"
+
+#include "unity.h"
+
+#define TEST_MAX_DUTY 8191U
+#define TEST_MIN_DUTY 81U
+
+TEST_CASE("backlight curve keeps 0% off and 100% at full duty", "[backlight]")
+{
+    backlight_curve_t curve;
+    backlight_curve_build(&curve, 220U, TEST_MIN_DUTY, TEST_MAX_DUTY);
+
+    TEST_ASSERT_EQUAL_UINT16(0U, backlight_curve_duty(&curve, 0U));
+    TEST_ASSERT_EQUAL_UINT16(TEST_MIN_DUTY, backlight_curve_duty(&curve, 1U));
+    TEST_ASSERT_EQUAL_UINT16(TEST_MAX_DUTY, backlight_curve_duty(&curve, 100U));
+    TEST_ASSERT_EQUAL_UINT16(TEST_MAX_DUTY, backlight_curve_duty(&curve, 250U)); /* clamped */
+}
+
+TEST_CASE("backlight curve is monotonic and perceptual", "[backlight]")
+{
+    backlight_curve_t curve;
+    backlight_curve_build(&curve, 220U, TEST_MIN_DUTY, TEST_MAX_DUTY);
+
+    for (uint8_t p = 1U; p <= 100U; ++p) {
+        TEST_ASSERT_TRUE(backlight_curve_duty(&curve, p) >= backlight_curve_duty(&curve, (uint8_t)(p - 1U)));
+    }
+
+    /* 50% is about 0.5^2.2 = 22% of the duty range, not half of it. */
+    const uint16_t mid = backlight_curve_duty(&curve, 50U);
+    TEST_ASSERT_TRUE(mid > TEST_MIN_DUTY + (TEST_MAX_DUTY - TEST_MIN_DUTY) * 20U / 100U);
+    TEST_ASSERT_TRUE(mid < TEST_MIN_DUTY + (TEST_MAX_DUTY - TEST_MIN_DUTY) * 24U / 100U);
+}
+
+TEST_CASE("backlight curve with gamma 1.0 is linear", "[backlight]")
+{
+    backlight_curve_t curve;
+    backlight_curve_build(&curve, 100U, 0U, 1000U);
+
+    TEST_ASSERT_EQUAL_UINT16(250U, backlight_curve_duty(&curve, 25U));
+    TEST_ASSERT_EQUAL_UINT16(500U, backlight_curve_duty(&curve, 50U));
+}
@@ -0,0 +1,209 @@
+#include "boot_graph.h"
+#include "boot_report.h"
+
+#include "esp_log.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <string.h>
+
+#ifdef CONFIG_BOOT_GRAPH_WORKERS
+#define BOOT_GRAPH_DEFAULT_WORKERS CONFIG_BOOT_GRAPH_WORKERS
+#else
+#define BOOT_GRAPH_DEFAULT_WORKERS 2
+#endif
+
+#ifdef CONFIG_BOOT_GRAPH_STACK_SIZE
+#define BOOT_GRAPH_DEFAULT_STACK_SIZE CONFIG_BOOT_GRAPH_STACK_SIZE
+#else
+#define BOOT_GRAPH_DEFAULT_STACK_SIZE 4096
+#endif
+
+#define BOOT_GRAPH_MAX_WORKERS 4U
+#define BOOT_GRAPH_STOP 0xFFU
+
+static const char *TAG = "boot_graph";
+
+typedef struct {
+    uint8_t index;
+    bool ok;
+} boot_graph_result_t;
+
+static const boot_stage_t *s_stages = NULL;
+
+/* Static so a worker still draining its stop token never sees a deleted queue. */
+static StaticQueue_t s_work_queue_buf;
+static uint8_t s_work_storage[BOOT_GRAPH_MAX_STAGES + BOOT_GRAPH_MAX_WORKERS];
+static QueueHandle_t s_work_queue = NULL;
+
+static StaticQueue_t s_result_queue_buf;
+static uint8_t s_result_storage[BOOT_GRAPH_MAX_STAGES * sizeof(boot_graph_result_t)];
+static QueueHandle_t s_result_queue = NULL;
+
+static bool s_running = false;
+
+void boot_graph_get_default_config(boot_graph_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+    memset(config, 0, sizeof(*config));
+    config->workers = BOOT_GRAPH_DEFAULT_WORKERS;
+    config->stack_size = BOOT_GRAPH_DEFAULT_STACK_SIZE;
+    config->task_priority = tskIDLE_PRIORITY + 4;
+    config->main_idle_cb = NULL;
+    config->main_idle_ctx = NULL;
+}
+
+static bool boot_graph_run_stage(size_t index, uint8_t worker)
+{
+    const boot_stage_t *stage = &s_stages[index];
+
+    boot_report_stage_start(index, worker);
+    const bool ok = stage->fn(stage->ctx);
+    boot_report_stage_end(index, ok);
+    if (!ok) {
+        ESP_LOGW(TAG, "Stage %s failed", stage->name);
+    }
+    return ok;
+}
+
+static void boot_graph_worker_task(void *arg)
+{
+    const uint8_t worker = (uint8_t)(uintptr_t)arg;
+
+    for (;;) {
+        uint8_t index = BOOT_GRAPH_STOP;
+        if (xQueueReceive(s_work_queue, &index, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (index == BOOT_GRAPH_STOP) {
+            break;
+        }
+        const boot_graph_result_t result = {
+            .index = index,
+            .ok = boot_graph_run_stage(index, worker),
+        };
+        (void)xQueueSend(s_result_queue, &result, portMAX_DELAY);
+    }
+    vTaskDelete(NULL);
+}
+
+static uint8_t boot_graph_start_workers(const boot_graph_config_t *config)
+{
+    uint8_t want = config->workers;
+    if (want > BOOT_GRAPH_MAX_WORKERS) {
+        want = BOOT_GRAPH_MAX_WORKERS;
+    }
+
+    uint8_t started = 0U;
+    for (uint8_t i = 0; i < want; ++i) {
+        if (xTaskCreate(boot_graph_worker_task, "bootWorker", config->stack_size, (void *)(uintptr_t)(i + 1U),
+                        config->task_priority, NULL) != pdPASS) {
+            ESP_LOGW(TAG, "Could not start boot worker %u", (unsigned)(i + 1U));
+            break;
+        }
+        ++started;
+    }
+    return started;
+}
+
+static int boot_graph_lowest_bit(uint32_t mask)
+{
+    for (int i = 0; i < 32; ++i) {
+        if ((mask & (1UL << i)) != 0U) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool boot_graph_run(const boot_stage_t *stages, size_t count, const boot_graph_config_t *config)
+{
+    boot_graph_config_t defaults;
+    if (config == NULL) {
+        boot_graph_get_default_config(&defaults);
+        config = &defaults;
+    }
+    if (s_running || !boot_graph_validate(stages, count)) {
+        ESP_LOGE(TAG, "Invalid boot graph");
+        return false;
+    }
+    s_running = true;
+    s_stages = stages;
+
+    if (s_work_queue == NULL) {
+        s_work_queue = xQueueCreateStatic(sizeof(s_work_storage), sizeof(uint8_t), s_work_storage,
+                                          &s_work_queue_buf);
+        s_result_queue = xQueueCreateStatic(BOOT_GRAPH_MAX_STAGES, sizeof(boot_graph_result_t),
+                                            s_result_storage, &s_result_queue_buf);
+    }
+
+    boot_report_begin(stages, count);
+    const uint8_t workers = boot_graph_start_workers(config);
+
+    /* Without workers every stage runs on this task, still in dependency order. */
+    uint32_t worker_mask = 0U;
+    if (workers > 0U) {
+        for (size_t i = 0; i < count; ++i) {
+            if (stages[i].affinity == BOOT_STAGE_WORKER) {
+                worker_mask |= BOOT_DEP(i);
+            }
+        }
+    }
+
+    const uint32_t all = (uint32_t)(BOOT_DEP(count) - 1UL);
+    uint32_t started = 0U;
+    uint32_t done = 0U;
+    bool all_ok = true;
+
+    while (done != all) {
+        const uint32_t ready = boot_graph_ready_mask(stages, count, done, started);
+
+        uint32_t dispatch = ready & worker_mask;
+        while (dispatch != 0U) {
+            const int index = boot_graph_lowest_bit(dispatch);
+            const uint8_t token = (uint8_t)index;
+            dispatch &= ~BOOT_DEP(index);
+            started |= BOOT_DEP(index);
+            (void)xQueueSend(s_work_queue, &token, portMAX_DELAY);
+        }
+
+        /* One inline stage per pass, so worker results and newly ready stages are picked up in between. */
+        const int inline_index = boot_graph_lowest_bit(ready & ~worker_mask);
+        if (inline_index >= 0) {
+            started |= BOOT_DEP(inline_index);
+            if (!boot_graph_run_stage((size_t)inline_index, 0U)) {
+                all_ok = false;
+            }
+            done |= BOOT_DEP(inline_index);
+        } else {
+            uint32_t wait_ms = BOOT_GRAPH_IDLE_FOREVER;
+            if (config->main_idle_cb != NULL) {
+                wait_ms = config->main_idle_cb(config->main_idle_ctx);
+            }
+            const TickType_t wait = (wait_ms == BOOT_GRAPH_IDLE_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+
+            boot_graph_result_t result;
+            if (xQueueReceive(s_result_queue, &result, wait) == pdTRUE) {
+                done |= BOOT_DEP(result.index);
+                all_ok = all_ok && result.ok;
+            }
+        }
+
+        boot_graph_result_t result;
+        while (xQueueReceive(s_result_queue, &result, 0) == pdTRUE) {
+            done |= BOOT_DEP(result.index);
+            all_ok = all_ok && result.ok;
+        }
+    }
+
+    for (uint8_t i = 0; i < workers; ++i) {
+        const uint8_t token = BOOT_GRAPH_STOP;
+        (void)xQueueSend(s_work_queue, &token, portMAX_DELAY);
+    }
+
+    boot_report_end();
+    s_running = false;
+    return all_ok;
+}
@@ -0,0 +1,48 @@
+#include "boot_graph.h"
+
+static uint32_t boot_graph_all_mask(size_t count)
+{
+    return (count >= 32U) ? UINT32_MAX : (uint32_t)((1UL << count) - 1UL);
+}
+
+uint32_t boot_graph_ready_mask(const boot_stage_t *stages, size_t count, uint32_t done, uint32_t started)
+{
+    if (stages == NULL) {
+        return 0U;
+    }
+
+    uint32_t ready = 0U;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t bit = BOOT_DEP(i);
+        if ((started & bit) == 0U && (stages[i].deps & ~done) == 0U) {
+            ready |= bit;
+        }
+    }
+    return ready;
+}
+
+bool boot_graph_validate(const boot_stage_t *stages, size_t count)
+{
+    if (stages == NULL || count == 0U || count > BOOT_GRAPH_MAX_STAGES) {
+        return false;
+    }
+
+    const uint32_t all = boot_graph_all_mask(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (stages[i].name == NULL || stages[i].fn == NULL || (stages[i].deps & ~all) != 0U ||
+            (stages[i].deps & BOOT_DEP(i)) != 0U) {
+            return false;
+        }
+    }
+
+    /* Finish every ready stage at once until nothing changes: a leftover means a cycle. */
+    uint32_t done = 0U;
+    while (done != all) {
+        const uint32_t ready = boot_graph_ready_mask(stages, count, done, done);
+        if (ready == 0U) {
+            return false;
+        }
+        done |= ready;
+    }
+    return true;
+}
@@ -0,0 +1,186 @@
+#include "boot_report.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "boot";
+
+static boot_report_t s_report;
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+/* Milestones can be marked before the first graph runs, so they have their own static lock. */
+static portMUX_TYPE s_milestone_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t boot_report_now_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+/* False before the first boot_report_begin(): no stage data to guard yet. */
+static bool boot_report_lock(void)
+{
+    if (s_lock == NULL) {
+        return false;
+    }
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    return true;
+}
+
+static void boot_report_unlock(void)
+{
+    (void)xSemaphoreGive(s_lock);
+}
+
+const char *boot_report_milestone_name(boot_milestone_t milestone)
+{
+    switch (milestone) {
+    case BOOT_MILESTONE_FIRST_FRAME:
+        return "first_frame";
+    case BOOT_MILESTONE_NETWORK:
+        return "network";
+    default:
+        return "unknown";
+    }
+}
+
+void boot_report_begin(const boot_stage_t *stages, size_t count)
+{
+    if (stages == NULL || count > BOOT_GRAPH_MAX_STAGES) {
+        return;
+    }
+
+    /* The runner calls this before it starts any worker, so only one task can get here first. */
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+    }
+    (void)boot_report_lock();
+    /* Milestones may already be set by an earlier graph; keep them. */
+    s_report.count = (uint8_t)count;
+    memset(s_report.stages, 0, sizeof(s_report.stages));
+    for (size_t i = 0; i < count; ++i) {
+        s_report.stages[i].name = stages[i].name;
+    }
+    s_report.graph_start_us = boot_report_now_us();
+    s_report.graph_end_us = 0U;
+    s_report.serial_us = 0U;
+    boot_report_unlock();
+}
+
+void boot_report_stage_start(size_t index, uint8_t worker)
+{
+    const uint32_t now_us = boot_report_now_us();
+
+    if (!boot_report_lock()) {
+        return;
+    }
+    if (index < s_report.count) {
+        s_report.stages[index].start_us = now_us;
+        s_report.stages[index].worker = worker;
+    }
+    boot_report_unlock();
+}
+
+void boot_report_stage_end(size_t index, bool ok)
+{
+    const uint32_t now_us = boot_report_now_us();
+
+    if (!boot_report_lock()) {
+        return;
+    }
+    if (index < s_report.count) {
+        boot_report_stage_t *stage = &s_report.stages[index];
+        stage->duration_us = now_us - stage->start_us;
+        stage->done = true;
+        stage->ok = ok;
+        s_report.serial_us += stage->duration_us;
+    }
+    boot_report_unlock();
+}
+
+void boot_report_end(void)
+{
+    const uint32_t now_us = boot_report_now_us();
+
+    if (!boot_report_lock()) {
+        return;
+    }
+    s_report.graph_end_us = now_us;
+    boot_report_unlock();
+}
+
+void boot_report_mark(boot_milestone_t milestone)
+{
+    if (milestone >= BOOT_MILESTONE_COUNT) {
+        return;
+    }
+    const uint32_t now_us = boot_report_now_us();
+
+    portENTER_CRITICAL(&s_milestone_lock);
+    if (s_report.milestone_us[milestone] == 0U) {
+        s_report.milestone_us[milestone] = (now_us != 0U) ? now_us : 1U;
+    }
+    portEXIT_CRITICAL(&s_milestone_lock);
+}
+
+void boot_report_mark_from_isr(boot_milestone_t milestone)
+{
+    if (milestone >= BOOT_MILESTONE_COUNT) {
+        return;
+    }
+    const uint32_t now_us = boot_report_now_us();
+
+    portENTER_CRITICAL_ISR(&s_milestone_lock);
+    if (s_report.milestone_us[milestone] == 0U) {
+        s_report.milestone_us[milestone] = (now_us != 0U) ? now_us : 1U;
+    }
+    portEXIT_CRITICAL_ISR(&s_milestone_lock);
+}
+
+void boot_report_get(boot_report_t *out_report)
+{
+    if (out_report == NULL) {
+        return;
+    }
+    const bool locked = boot_report_lock();
+    memcpy(out_report, &s_report, sizeof(*out_report));
+    if (locked) {
+        boot_report_unlock();
+    }
+    portENTER_CRITICAL(&s_milestone_lock);
+    memcpy(out_report->milestone_us, s_report.milestone_us, sizeof(out_report->milestone_us));
+    portEXIT_CRITICAL(&s_milestone_lock);
+}
+
+void boot_report_log(void)
+{
+    boot_report_t report;
+    boot_report_get(&report);
+
+    ESP_LOGI(TAG, "%-12s %-6s %9s %9s  %s", "stage", "task", "start ms", "dur ms", "ok");
+    for (size_t i = 0; i < report.count; ++i) {
+        const boot_report_stage_t *stage = &report.stages[i];
+        char task[8];
+        if (stage->worker == 0U) {
+            strlcpy(task, "main", sizeof(task));
+        } else {
+            snprintf(task, sizeof(task), "w%u", (unsigned)stage->worker);
+        }
+        ESP_LOGI(TAG, "%-12s %-6s %9.1f %9.1f  %s", stage->name, task, (double)stage->start_us / 1000.0,
+                 (double)stage->duration_us / 1000.0, !stage->done ? "-" : (stage->ok ? "yes" : "FAILED"));
+    }
+    if (report.graph_end_us != 0U) {
+        ESP_LOGI(TAG, "stages %.1f ms wall, %.1f ms if serial",
+                 (double)(report.graph_end_us - report.graph_start_us) / 1000.0, (double)report.serial_us / 1000.0);
+    }
+    for (int m = 0; m < BOOT_MILESTONE_COUNT; ++m) {
+        if (report.milestone_us[m] != 0U) {
+            ESP_LOGI(TAG, "%s at %.1f ms", boot_report_milestone_name((boot_milestone_t)m),
+                     (double)report.milestone_us[m] / 1000.0);
+        }
+    }
+}
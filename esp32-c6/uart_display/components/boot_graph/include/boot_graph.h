@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ * boot_graph.h
+ *
+ * Dependency-ordered boot. Each stage names the stages it needs (BOOT_DEP()
+ * bits of their index in the array); boot_graph_run() starts every stage
+ * whose dependencies have finished, running MAIN stages on the calling task
+ * (LCD, LVGL, UI: anything that must stay on the LVGL thread) and WORKER
+ * stages concurrently on a small pool of worker tasks.
+ *
+ * Dependencies order stages, they do not gate them: a stage whose dependency
+ * failed still runs and checks what it needs itself. Every stage's start and
+ * duration go to boot_report (boot_report.h).
+ *
+ * While the main task has nothing ready it calls main_idle_cb, so LVGL can
+ * keep rendering the splash screen while workers bring up the network.
+ */
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_GRAPH_MAX_STAGES 24U
+#define BOOT_DEP(index) (1UL << (index))
+
+/* main_idle_cb result: nothing to do until a stage finishes. */
+#define BOOT_GRAPH_IDLE_FOREVER UINT32_MAX
+
+typedef bool (*boot_stage_fn_t)(void *ctx);
+
+typedef enum {
+    BOOT_STAGE_MAIN = 0, /* on the task that calls boot_graph_run() */
+    BOOT_STAGE_WORKER,   /* on any worker task */
+} boot_stage_affinity_t;
+
+typedef struct {
+    const char *name;
+    boot_stage_fn_t fn;
+    void *ctx;
+    uint32_t deps;       /* BOOT_DEP() of stages that must finish first */
+    boot_stage_affinity_t affinity;
+} boot_stage_t;
+
+typedef struct {
+    uint8_t workers;
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+    /* Main task, while it waits for workers; returns ms until it wants to run again. */
+    uint32_t (*main_idle_cb)(void *ctx);
+    void *main_idle_ctx;
+} boot_graph_config_t;
+
+void boot_graph_get_default_config(boot_graph_config_t *config);
+
+/* Every stage has a name and fn, dependencies are in range and there is no cycle. */
+bool boot_graph_validate(const boot_stage_t *stages, size_t count);
+
+/* Stages not yet started whose dependencies are all in done. No I/O. */
+uint32_t boot_graph_ready_mask(const boot_stage_t *stages, size_t count, uint32_t done, uint32_t started);
+
+/* Runs every stage; returns once all have finished (false if any failed or the graph is invalid). */
+bool boot_graph_run(const boot_stage_t *stages, size_t count, const boot_graph_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * boot_report.h
+ *
+ * Boot timing: start and duration of every boot_graph stage plus the
+ * milestones the product cares about (first frame on the panel, first IP).
+ * Times are microseconds of esp_timer, i.e. since the timer started early in
+ * boot. Filled while booting, read by the log table and /api/v1/boot.
+ */
+
+#include "boot_graph.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    BOOT_MILESTONE_FIRST_FRAME = 0,
+    BOOT_MILESTONE_NETWORK,      /* first IP address */
+    BOOT_MILESTONE_COUNT,
+} boot_milestone_t;
+
+typedef struct {
+    const char *name;
+    uint32_t start_us;
+    uint32_t duration_us;
+    uint8_t worker;   /* 0: main task, 1..n: worker task */
+    bool done;
+    bool ok;
+} boot_report_stage_t;
+
+typedef struct {
+    uint8_t count;
+    boot_report_stage_t stages[BOOT_GRAPH_MAX_STAGES];
+    uint32_t graph_start_us;
+    uint32_t graph_end_us;       /* 0 while stages are still running */
+    uint32_t serial_us;          /* sum of stage durations: the boot if run one by one */
+    uint32_t milestone_us[BOOT_MILESTONE_COUNT]; /* 0: not reached yet */
+} boot_report_t;
+
+/* Runner side. */
+void boot_report_begin(const boot_stage_t *stages, size_t count);
+void boot_report_stage_start(size_t index, uint8_t worker);
+void boot_report_stage_end(size_t index, bool ok);
+void boot_report_end(void);
+
+/* First call wins; later calls are ignored. Any task. */
+void boot_report_mark(boot_milestone_t milestone);
+/* Same, from an interrupt handler. */
+void boot_report_mark_from_isr(boot_milestone_t milestone);
+
+void boot_report_get(boot_report_t *out_report);
+
+/* Per-stage table and milestones to the log. */
+void boot_report_log(void);
+
+const char *boot_report_milestone_name(boot_milestone_t milestone);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#include "boot_graph.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+
+enum { STAGE_A = 0, STAGE_B, STAGE_C, STAGE_D };
+
+static bool stage_ok(void *ctx)
+{
+    (void)ctx;
+    return true;
+}
+
+TEST_CASE("boot_graph ready mask follows finished dependencies", "[boot_graph]")
+{
+    /* A and B are independent, C needs both, D needs C. */
+    const boot_stage_t stages[] = {
+        [STAGE_A] = { "a", stage_ok, NULL, 0U, BOOT_STAGE_MAIN },
+        [STAGE_B] = { "b", stage_ok, NULL, 0U, BOOT_STAGE_WORKER },
+        [STAGE_C] = { "c", stage_ok, NULL, BOOT_DEP(STAGE_A) | BOOT_DEP(STAGE_B), BOOT_STAGE_WORKER },
+        [STAGE_D] = { "d", stage_ok, NULL, BOOT_DEP(STAGE_C), BOOT_STAGE_MAIN },
+    };
+
+    TEST_ASSERT_TRUE(boot_graph_validate(stages, 4));
+    TEST_ASSERT_EQUAL_HEX32(BOOT_DEP(STAGE_A) | BOOT_DEP(STAGE_B), boot_graph_ready_mask(stages, 4, 0U, 0U));
+
+    /* B running, A finished: C still waits for B. */
+    TEST_ASSERT_EQUAL_HEX32(0U, boot_graph_ready_mask(stages, 4, BOOT_DEP(STAGE_A),
+                                                      BOOT_DEP(STAGE_A) | BOOT_DEP(STAGE_B)));
+
+    const uint32_t ab = BOOT_DEP(STAGE_A) | BOOT_DEP(STAGE_B);
+    TEST_ASSERT_EQUAL_HEX32(BOOT_DEP(STAGE_C), boot_graph_ready_mask(stages, 4, ab, ab));
+    TEST_ASSERT_EQUAL_HEX32(BOOT_DEP(STAGE_D), boot_graph_ready_mask(stages, 4, ab | BOOT_DEP(STAGE_C),
+                                                                     ab | BOOT_DEP(STAGE_C)));
+}
+
+TEST_CASE("boot_graph validate rejects cycles and bad dependencies", "[boot_graph]")
+{
+    boot_stage_t stages[] = {
+        { "a", stage_ok, NULL, 0U, BOOT_STAGE_MAIN },
+        { "b", stage_ok, NULL, BOOT_DEP(2), BOOT_STAGE_WORKER },
+        { "c", stage_ok, NULL, BOOT_DEP(1), BOOT_STAGE_WORKER },
+    };
+
+    TEST_ASSERT_FALSE(boot_graph_validate(stages, 3)); /* b <-> c */
+
+    stages[2].deps = BOOT_DEP(0);
+    TEST_ASSERT_TRUE(boot_graph_validate(stages, 3));
+
+    stages[2].deps = BOOT_DEP(2); /* itself */
+    TEST_ASSERT_FALSE(boot_graph_validate(stages, 3));
+
+    stages[2].deps = BOOT_DEP(3); /* past the end */
+    TEST_ASSERT_FALSE(boot_graph_validate(stages, 3));
+
+    stages[2].deps = 0U;
+    stages[2].fn = NULL;
+    TEST_ASSERT_FALSE(boot_graph_validate(stages, 3));
+    TEST_ASSERT_FALSE(boot_graph_validate(NULL, 0));
+}
@@ -1,5 +1,6 @@
 #include "debug_console.h"
 
+#include "freertos/semphr.h"
 #include "rtc_clock.h"
 
 #include <string.h>
@@ -13,80 +14,56 @@ extern lv_obj_t *ui_DebugLineLabel4 __attribute__((weak));
 extern lv_obj_t *ui_DebugLineLabel5 __attribute__((weak));
 extern lv_obj_t *ui_DebugLineLabel6 __attribute__((weak));
 
-typedef struct {
-    char text[DEBUG_MSG_MAX_LEN];
-} debug_message_t;
-
-static StaticQueue_t g_logQueueStruct;
-static uint8_t g_logQueueStorage[DEBUG_QUEUE_LENGTH * sizeof(debug_message_t)];
-static QueueHandle_t g_logQueue = NULL;
-static TaskHandle_t g_debugTaskHandle = NULL;
+/* Row gap of the generated ui_Container3 column, kept between console lines. */
+#define DEBUG_CONSOLE_LINE_SPACE 10
+/* Pending lines are picked up this often; slow enough not to keep the LVGL loop awake. */
+#define DEBUG_CONSOLE_UI_PERIOD_MS 100
+
+static debug_line_t s_lines[DEBUG_CONSOLE_SCROLLBACK_LINES];
+static debug_line_store_t s_store;
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+static uint16_t s_scroll;
+static uint32_t s_scroll_anchor; /* s_store.pushed when s_scroll was set */
+static bool s_dirty;
+
+/* Owned by the LVGL timer; the label points at it (lv_label_set_text_static). */
+static char s_view[DEBUG_CONSOLE_VISIBLE_LINES * DEBUG_MSG_MAX_LEN];
+static lv_timer_t *s_ui_timer = NULL;
+static lv_obj_t *s_ui_label = NULL;
 static const char *TAG = "DEBUG";
 
-static void debugConsoleTask(void *param);
-
-static void debug_update_labels(char lines[7][DEBUG_MSG_MAX_LEN])
-{
-    lv_obj_t **const labels[] = {
-        &ui_DebugLineLabel,
-        &ui_DebugLineLabel1,
-        &ui_DebugLineLabel2,
-        &ui_DebugLineLabel3,
-        &ui_DebugLineLabel4,
-        &ui_DebugLineLabel5,
-        &ui_DebugLineLabel6,
-    };
-
-    for (size_t i = 0; i < 7; ++i) {
-        if (*labels[i]) {
-            lv_label_set_text(*labels[i], lines[i]);
-        }
-    }
-}
-
 bool DebugConsole_Init(void)
 {
-    if (g_logQueue != NULL) {
+    if (s_lock != NULL) {
         return true;
     }
 
-    g_logQueue = xQueueCreateStatic(DEBUG_QUEUE_LENGTH, sizeof(debug_message_t),
-                                    g_logQueueStorage, &g_logQueueStruct);
-    if (g_logQueue == NULL) {
-        ESP_LOGE(TAG, "Failed to create debug queue");
+    debug_line_store_init(&s_store, s_lines, DEBUG_CONSOLE_SCROLLBACK_LINES);
+    s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+    if (s_lock == NULL) {
+        ESP_LOGE(TAG, "Failed to create debug console lock");
         return false;
     }
 
-    BaseType_t tcreated = xTaskCreate(
-        debugConsoleTask, "debugConsoleTask", 4096, NULL, 2, &g_debugTaskHandle);
-    if (tcreated != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create debug console task");
-        g_debugTaskHandle = NULL;
-        return false;
-    }
-
-    ESP_LOGI(TAG, "Debug console initialized");
+    ESP_LOGI(TAG, "Debug console initialized (%u lines)", (unsigned)DEBUG_CONSOLE_SCROLLBACK_LINES);
     return true;
 }
 
 void Debug_Log(const char *fmt, ...)
 {
-    debug_message_t msg;
+    char text[DEBUG_MSG_MAX_LEN];
     va_list args;
     va_start(args, fmt);
-    vsnprintf(msg.text, sizeof(msg.text), fmt, args);
+    vsnprintf(text, sizeof(text), fmt, args);
     va_end(args);
-    msg.text[DEBUG_MSG_MAX_LEN - 1] = '\0';
+    text[DEBUG_MSG_MAX_LEN - 1] = '\0';
 
-    DebugConsole_WriteLine(msg.text);
+    DebugConsole_WriteLine(text);
 }
 
-void DebugConsole_WriteLine(const char *line)
+static void debug_format_line(const char *line, char *out, size_t out_len)
 {
-    if (line == NULL) {
-        return;
-    }
-
     /* Avoid double-prefixing if the caller already supplied HH:MM:SS: */
     const bool has_time_prefix =
         (strlen(line) >= 10) &&
@@ -95,46 +72,150 @@ void DebugConsole_WriteLine(const char *line)
         (line[3] >= '0' && line[3] <= '9') && (line[4] >= '0' && line[4] <= '9') &&
         (line[6] >= '0' && line[6] <= '9') && (line[7] >= '0' && line[7] <= '9');
 
-    debug_message_t msg;
-
     if (has_time_prefix) {
-        strncpy(msg.text, line, sizeof(msg.text));
-        msg.text[DEBUG_MSG_MAX_LEN - 1] = '\0';
+        (void)strlcpy(out, line, out_len);
     } else {
         char tbuf[16] = {0};
         RTC_Clock_GetTime(tbuf, sizeof(tbuf));
-        (void)snprintf(msg.text, sizeof(msg.text), "%s: %s", tbuf, line);
-        msg.text[DEBUG_MSG_MAX_LEN - 1] = '\0';
+        (void)snprintf(out, out_len, "%s: %s", tbuf, line);
+    }
+}
+
+static void debug_console_push(const char *text)
+{
+    if (xSemaphoreTake(s_lock, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    debug_line_store_push(&s_store, text);
+    s_dirty = true;
+    (void)xSemaphoreGive(s_lock);
+}
+
+void DebugConsole_WriteLine(const char *line)
+{
+    if (line == NULL) {
+        return;
     }
 
-    ESP_LOGI(TAG, "%s", msg.text);
+    char text[DEBUG_MSG_MAX_LEN];
+    debug_format_line(line, text, sizeof(text));
 
-    if (g_logQueue) {
-        xQueueSend(g_logQueue, &msg, 0);
+    ESP_LOGI(TAG, "%s", text);
+
+    if (s_lock != NULL) {
+        debug_console_push(text);
     }
 }
 
-static void debugConsoleTask(void *param)
+void DebugConsole_PostLine(const char *line)
 {
-    (void)param;
+    if (line == NULL || s_lock == NULL) {
+        return;
+    }
 
-    debug_message_t msg;
-    char lines[7][DEBUG_MSG_MAX_LEN] = {{0}};
+    char text[DEBUG_MSG_MAX_LEN];
+    debug_format_line(line, text, sizeof(text));
+    debug_console_push(text);
+}
 
-    while (1) {
-        if (xQueueReceive(g_logQueue, &msg, portMAX_DELAY) == pdTRUE) {
-            do {
-                for (int i = 6; i > 0; --i) {
-                    strncpy(lines[i], lines[i - 1], DEBUG_MSG_MAX_LEN);
-                    lines[i][DEBUG_MSG_MAX_LEN - 1] = '\0';
-                }
-                strncpy(lines[0], msg.text, DEBUG_MSG_MAX_LEN);
-                lines[0][DEBUG_MSG_MAX_LEN - 1] = '\0';
+void DebugConsole_ScrollBack(uint16_t lines_back)
+{
+    if (s_lock == NULL || xSemaphoreTake(s_lock, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    s_scroll = lines_back;
+    s_scroll_anchor = s_store.pushed;
+    s_dirty = true;
+    (void)xSemaphoreGive(s_lock);
+}
 
-                debug_update_labels(lines);
-            } while (xQueueReceive(g_logQueue, &msg, 0) == pdTRUE);
+/*
+ * The generated screen has one label per line; the console now renders every
+ * visible line into the first one and hides the rest of its rows. Labels 5
+ * and 6 stay for network_debug_task's IP/WiFi lines.
+ */
+static void debug_console_attach_labels(lv_obj_t *label)
+{
+    lv_obj_t **const unused[] = {
+        &ui_DebugLineLabel1,
+        &ui_DebugLineLabel2,
+        &ui_DebugLineLabel3,
+        &ui_DebugLineLabel4,
+    };
+    lv_obj_t **const status[] = {
+        &ui_DebugLineLabel5,
+        &ui_DebugLineLabel6,
+    };
 
-            taskYIELD();
+    lv_obj_set_style_text_line_space(label, DEBUG_CONSOLE_LINE_SPACE, LV_PART_MAIN | LV_STATE_DEFAULT);
+    for (size_t i = 0; i < sizeof(unused) / sizeof(unused[0]); ++i) {
+        if (unused[i] != NULL && *unused[i] != NULL) {
+            lv_obj_add_flag(*unused[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    for (size_t i = 0; i < sizeof(status) / sizeof(status[0]); ++i) {
+        if (status[i] != NULL && *status[i] != NULL) {
+            lv_label_set_text_static(*status[i], "");
         }
     }
 }
+
+static void debug_console_ui_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+
+    lv_obj_t *label = (&ui_DebugLineLabel != NULL) ? ui_DebugLineLabel : NULL;
+    if (label == NULL) {
+        s_ui_label = NULL;
+        return;
+    }
+
+    /* A recreated screen has new label objects; lay them out again. */
+    const bool attached = (label == s_ui_label);
+    if (!attached) {
+        debug_console_attach_labels(label);
+        s_ui_label = label;
+    }
+
+    if (xSemaphoreTake(s_lock, 0) != pdTRUE) {
+        return;
+    }
+    if (!s_dirty && attached) {
+        (void)xSemaphoreGive(s_lock);
+        return;
+    }
+
+    /* A scrolled-back window stays on the same lines while new ones arrive. */
+    uint32_t skip = 0U;
+    if (s_scroll != 0U) {
+        skip = s_scroll + (s_store.pushed - s_scroll_anchor);
+    }
+    const uint32_t max_skip = (s_store.count > DEBUG_CONSOLE_VISIBLE_LINES)
+                                  ? (uint32_t)(s_store.count - DEBUG_CONSOLE_VISIBLE_LINES)
+                                  : 0U;
+    if (skip > max_skip) {
+        skip = max_skip;
+    }
+    (void)debug_line_store_render(&s_store, (uint16_t)skip, DEBUG_CONSOLE_VISIBLE_LINES, s_view, sizeof(s_view));
+    s_dirty = false;
+    (void)xSemaphoreGive(s_lock);
+
+    lv_label_set_text_static(label, s_view);
+}
+
+bool DebugConsole_StartUi(void)
+{
+    if (s_ui_timer != NULL) {
+        return true;
+    }
+    if (!DebugConsole_Init()) {
+        return false;
+    }
+
+    s_ui_timer = lv_timer_create(debug_console_ui_timer_cb, DEBUG_CONSOLE_UI_PERIOD_MS, NULL);
+    if (s_ui_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create debug console UI timer");
+        return false;
+    }
+    return true;
+}
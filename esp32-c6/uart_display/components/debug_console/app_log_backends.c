@@ -15,7 +15,7 @@ static void dbg_deinit(void *ctx)
 static void dbg_write_line(void *ctx, const char *line)
 {
     (void)ctx;
-    DebugConsole_WriteLine(line);
+    DebugConsole_PostLine(line);
 }
 
 const app_log_backend_t *app_log_backend_debug_console(void)
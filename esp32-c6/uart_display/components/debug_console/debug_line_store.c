@@ -0,0 +1,77 @@
+#include "debug_line_store.h"
+
+#include <string.h>
+
+void debug_line_store_init(debug_line_store_t *store, debug_line_t *lines, uint16_t depth)
+{
+    if (store == NULL) {
+        return;
+    }
+
+    store->lines = lines;
+    store->depth = (lines != NULL) ? depth : 0U;
+    store->head = 0U;
+    store->count = 0U;
+    store->pushed = 0U;
+}
+
+void debug_line_store_push(debug_line_store_t *store, const char *line)
+{
+    if (store == NULL || store->depth == 0U || line == NULL) {
+        return;
+    }
+
+    char *slot = store->lines[store->head];
+    const size_t len = strnlen(line, DEBUG_LINE_STORE_LINE_LEN - 1U);
+    memcpy(slot, line, len);
+    slot[len] = '\0';
+
+    store->head = (uint16_t)((store->head + 1U) % store->depth);
+    if (store->count < store->depth) {
+        store->count++;
+    }
+    store->pushed++;
+}
+
+const char *debug_line_store_get(const debug_line_store_t *store, uint16_t age)
+{
+    if (store == NULL || age >= store->count) {
+        return NULL;
+    }
+
+    const uint16_t index = (uint16_t)((store->head + store->depth - 1U - age) % store->depth);
+    return store->lines[index];
+}
+
+size_t debug_line_store_render(const debug_line_store_t *store,
+                               uint16_t skip,
+                               uint16_t max_lines,
+                               char *out_buf,
+                               size_t out_len)
+{
+    if (out_buf == NULL || out_len == 0U) {
+        return 0U;
+    }
+
+    size_t used = 0U;
+    for (uint16_t i = 0; i < max_lines; ++i) {
+        const char *line = debug_line_store_get(store, (uint16_t)(skip + i));
+        if (line == NULL) {
+            break;
+        }
+
+        const size_t sep = (i > 0U) ? 1U : 0U;
+        const size_t len = strlen(line);
+        if (used + sep + len >= out_len) {
+            break;
+        }
+        if (sep != 0U) {
+            out_buf[used++] = '\n';
+        }
+        memcpy(&out_buf[used], line, len);
+        used += len;
+    }
+
+    out_buf[used] = '\0';
+    return used;
+}
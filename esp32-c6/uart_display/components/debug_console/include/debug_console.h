@@ -2,19 +2,48 @@
 
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "lvgl.h"
+#include "sdkconfig.h"
 
-#define DEBUG_MSG_MAX_LEN 64
-#define DEBUG_QUEUE_LENGTH 20
+#include "debug_line_store.h"
 
+#define DEBUG_MSG_MAX_LEN DEBUG_LINE_STORE_LINE_LEN
+
+#ifdef CONFIG_DEBUG_CONSOLE_SCROLLBACK_LINES
+#define DEBUG_CONSOLE_SCROLLBACK_LINES CONFIG_DEBUG_CONSOLE_SCROLLBACK_LINES
+#else
+#define DEBUG_CONSOLE_SCROLLBACK_LINES 32
+#endif
+
+#ifdef CONFIG_DEBUG_CONSOLE_VISIBLE_LINES
+#define DEBUG_CONSOLE_VISIBLE_LINES CONFIG_DEBUG_CONSOLE_VISIBLE_LINES
+#else
+#define DEBUG_CONSOLE_VISIBLE_LINES 5
+#endif
+
+/* Line store only; safe to call before LVGL is up. */
 bool DebugConsole_Init(void);
+
+/*
+ * Starts the LVGL timer that renders the console into ui_DebugLineLabel.
+ * Call after ui_init(). It runs once per display refresh period and only
+ * touches the label when lines arrived or the scroll position changed, so a
+ * burst of writes costs one label update.
+ */
+bool DebugConsole_StartUi(void);
+
 void DebugConsole_WriteLine(const char *line);
+/* Display-only variant (no ESP_LOGI echo); used by the app_log display backend. */
+void DebugConsole_PostLine(const char *line);
+
+/* Shows the window lines_back lines behind the newest (0 follows new output). */
+void DebugConsole_ScrollBack(uint16_t lines_back);
 
 /* Deprecated: Use app_log_write() instead for unified logging */
 __attribute__((deprecated("Use app_log_write() instead")))
@@ -6,10 +6,13 @@
 extern "C" {
 #endif
 
-/* Backend that routes lines to DebugConsole (LVGL debug screen + ESP_LOGI). */
+/* Backend that routes lines to the DebugConsole LVGL debug screen only.
+ * Register it queued (app_log_add_backend) next to app_log_backend_uart()
+ * so the label path never runs on the logging task. */
 const app_log_backend_t *app_log_backend_debug_console(void);
 
-/* Composite backend that routes log lines to both UART and DebugConsole. */
+/* Single backend that routes log lines to both UART (ESP_LOGI) and DebugConsole.
+ * Prefer registering the UART and debug console backends separately. */
 const app_log_backend_t *app_log_backend_composite(void);
 
 #ifdef __cplusplus
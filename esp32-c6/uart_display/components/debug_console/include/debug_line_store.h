@@ -0,0 +1,55 @@
+#pragma once
+
+/*
+ * debug_line_store.h
+ *
+ * Fixed-size scrollback of debug console lines. A push copies the line into
+ * the slot after the newest one and, once full, overwrites the oldest; no
+ * line is ever moved. Rendering joins a window of lines (newest first) into
+ * one newline-separated buffer for a single label.
+ *
+ * Not thread-safe; the debug console serialises access. No FreeRTOS or LVGL
+ * dependency; builds and runs on the host.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEBUG_LINE_STORE_LINE_LEN 64U
+
+typedef char debug_line_t[DEBUG_LINE_STORE_LINE_LEN];
+
+typedef struct {
+    debug_line_t *lines;
+    uint16_t depth;
+    uint16_t head;  /* slot the next push writes */
+    uint16_t count; /* valid lines, at most depth */
+    uint32_t pushed;
+} debug_line_store_t;
+
+void debug_line_store_init(debug_line_store_t *store, debug_line_t *lines, uint16_t depth);
+
+/* Copies line (truncated to DEBUG_LINE_STORE_LINE_LEN - 1 chars). */
+void debug_line_store_push(debug_line_store_t *store, const char *line);
+
+/* age 0 is the newest line; NULL past the oldest. */
+const char *debug_line_store_get(const debug_line_store_t *store, uint16_t age);
+
+/*
+ * Writes up to max_lines lines, newest first, starting skip lines back, joined
+ * by '\n' and NUL-terminated. A line that does not fit ends the output.
+ * Returns the length written.
+ */
+size_t debug_line_store_render(const debug_line_store_t *store,
+                               uint16_t skip,
+                               uint16_t max_lines,
+                               char *out_buf,
+                               size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
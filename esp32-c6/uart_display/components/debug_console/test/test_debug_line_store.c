@@ -0,0 +1,67 @@
+#include "debug_line_store.h"
+
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define STORE_TEST_DEPTH 8U
+
+static debug_line_t s_lines[STORE_TEST_DEPTH];
+static debug_line_store_t s_store;
+
+static void push_numbered(uint32_t first, uint32_t count)
+{
+    char line[16];
+    for (uint32_t i = first; i < first + count; ++i) {
+        (void)snprintf(line, sizeof(line), "line %u", (unsigned)i);
+        debug_line_store_push(&s_store, line);
+    }
+}
+
+TEST_CASE("debug_line_store wraps and renders newest first", "[debug_console]")
+{
+    char view[4 * DEBUG_LINE_STORE_LINE_LEN];
+
+    debug_line_store_init(&s_store, s_lines, STORE_TEST_DEPTH);
+    TEST_ASSERT_NULL(debug_line_store_get(&s_store, 0));
+    TEST_ASSERT_EQUAL_UINT32(0U, debug_line_store_render(&s_store, 0, 4, view, sizeof(view)));
+    TEST_ASSERT_EQUAL_STRING("", view);
+
+    push_numbered(0, 3);
+    TEST_ASSERT_EQUAL_UINT16(3U, s_store.count);
+    debug_line_store_render(&s_store, 0, 4, view, sizeof(view));
+    TEST_ASSERT_EQUAL_STRING("line 2\nline 1\nline 0", view);
+
+    /* 20 pushes into 8 slots keep lines 12..19. */
+    push_numbered(3, 17);
+    TEST_ASSERT_EQUAL_UINT16(STORE_TEST_DEPTH, s_store.count);
+    TEST_ASSERT_EQUAL_UINT32(20U, s_store.pushed);
+    TEST_ASSERT_EQUAL_STRING("line 19", debug_line_store_get(&s_store, 0));
+    TEST_ASSERT_EQUAL_STRING("line 12", debug_line_store_get(&s_store, STORE_TEST_DEPTH - 1U));
+    TEST_ASSERT_NULL(debug_line_store_get(&s_store, STORE_TEST_DEPTH));
+
+    debug_line_store_render(&s_store, 5, 4, view, sizeof(view));
+    TEST_ASSERT_EQUAL_STRING("line 14\nline 13\nline 12", view);
+}
+
+TEST_CASE("debug_line_store truncates long lines and short buffers", "[debug_console]")
+{
+    char long_line[DEBUG_LINE_STORE_LINE_LEN * 2];
+    char view[24];
+
+    memset(long_line, 'x', sizeof(long_line) - 1U);
+    long_line[sizeof(long_line) - 1U] = '\0';
+
+    debug_line_store_init(&s_store, s_lines, STORE_TEST_DEPTH);
+    debug_line_store_push(&s_store, long_line);
+    TEST_ASSERT_EQUAL_UINT32(DEBUG_LINE_STORE_LINE_LEN - 1U, strlen(debug_line_store_get(&s_store, 0)));
+
+    /* A line that does not fit ends the render instead of being cut. */
+    debug_line_store_init(&s_store, s_lines, STORE_TEST_DEPTH);
+    debug_line_store_push(&s_store, "older line here");
+    debug_line_store_push(&s_store, "newest");
+    TEST_ASSERT_EQUAL_UINT32(6U, debug_line_store_render(&s_store, 0, 2, view, 16));
+    TEST_ASSERT_EQUAL_STRING("newest", view);
+    TEST_ASSERT_EQUAL_UINT32(22U, debug_line_store_render(&s_store, 0, 2, view, sizeof(view)));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * job_scheduler.h
+ *
+ * Periodic jobs on one task. Short, non-blocking jobs (clock, sensor reads,
+ * heap/RSSI sampling) share a single stack instead of one task each; due
+ * times live in a timing wheel (job_wheel.h) and the task sleeps until the
+ * next one, or until a job is added.
+ *
+ * Each job's next due time is its previous due time plus its period, so
+ * jobs do not drift with their own run time. A job that starts late is
+ * timed from when it should have run (the jitter); a job so late that whole
+ * periods passed skips them instead of running back to back.
+ */
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JOB_SCHEDULER_MAX_JOBS 8U
+
+typedef int8_t job_scheduler_id_t;
+
+/* Runs on the scheduler task; must not block (every other job waits for it). */
+typedef void (*job_scheduler_fn_t)(void *ctx);
+
+typedef struct {
+    uint32_t tick_ms;              /* due-time resolution */
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+    BaseType_t core_id;
+    uint32_t stats_log_interval_s; /* 0: never log */
+} job_scheduler_config_t;
+
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t runs;
+    uint32_t skipped;              /* periods dropped because the job started too late */
+    uint32_t last_exec_us;
+    uint32_t max_exec_us;
+    uint64_t total_exec_us;
+    uint32_t last_late_us;         /* start - due time */
+    uint32_t max_late_us;
+    uint64_t total_late_us;
+} job_scheduler_job_stats_t;
+
+void job_scheduler_get_default_config(job_scheduler_config_t *config);
+bool job_scheduler_start(const job_scheduler_config_t *config);
+
+/*
+ * First run on the next tick, then every period_ms. Any task, before or after
+ * job_scheduler_start(); jobs added early run once the task starts.
+ */
+bool job_scheduler_add(const char *name,
+                       uint32_t period_ms,
+                       job_scheduler_fn_t fn,
+                       void *ctx,
+                       job_scheduler_id_t *out_id);
+
+/* Copies up to max_jobs entries; returns how many jobs exist. */
+size_t job_scheduler_get_stats(job_scheduler_job_stats_t *out_stats, size_t max_jobs);
+
+/* Scheduler task stack never used so far, in bytes; 0 before start. */
+uint32_t job_scheduler_stack_free_bytes(void);
+
+/* One line per job plus the task's stack use. */
+void job_scheduler_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
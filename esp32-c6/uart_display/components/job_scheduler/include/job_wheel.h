@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * job_wheel.h
+ *
+ * Hashed timing wheel: JOB_WHEEL_SLOTS buckets of one tick each. An entry
+ * due in d ticks goes into bucket (now + d) % SLOTS with (d - 1) / SLOTS
+ * rounds left; advancing one tick walks a single bucket, expiring entries
+ * whose rounds ran out and counting the others down. Scheduling, cancelling
+ * and advancing cost O(entries in one bucket) whatever the periods are.
+ *
+ * Times are relative tick counts only, so nothing wraps. No ESP-IDF
+ * dependency; builds and runs on the host.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JOB_WHEEL_SLOTS 32U
+#define JOB_WHEEL_MAX_ENTRIES 16U
+#define JOB_WHEEL_NONE UINT32_MAX
+
+typedef struct {
+    uint16_t rounds;  /* full turns left before it expires */
+    uint8_t slot;
+    uint8_t next;     /* next entry in the same bucket */
+    bool armed;
+} job_wheel_entry_t;
+
+typedef struct {
+    uint32_t now;     /* ticks advanced since init; only bucket selection uses it */
+    uint8_t heads[JOB_WHEEL_SLOTS];
+    job_wheel_entry_t entries[JOB_WHEEL_MAX_ENTRIES];
+} job_wheel_t;
+
+void job_wheel_init(job_wheel_t *wheel);
+
+/* Arms (or re-arms) entry id to expire delay_ticks from now; 0 is taken as 1. */
+bool job_wheel_schedule(job_wheel_t *wheel, uint8_t id, uint32_t delay_ticks);
+void job_wheel_cancel(job_wheel_t *wheel, uint8_t id);
+
+/* Advances ticks ticks; returns the mask of entries that expired (now disarmed). */
+uint32_t job_wheel_advance(job_wheel_t *wheel, uint32_t ticks);
+
+/* Ticks until the next entry expires (>= 1), or JOB_WHEEL_NONE if nothing is armed. */
+uint32_t job_wheel_next_delay(const job_wheel_t *wheel);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,273 @@
+#include "job_scheduler.h"
+#include "job_wheel.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#include <string.h>
+
+#ifdef CONFIG_JOB_SCHEDULER_TICK_MS
+#define JOB_SCHEDULER_DEFAULT_TICK_MS CONFIG_JOB_SCHEDULER_TICK_MS
+#else
+#define JOB_SCHEDULER_DEFAULT_TICK_MS 10
+#endif
+
+#ifdef CONFIG_JOB_SCHEDULER_STACK_SIZE
+#define JOB_SCHEDULER_DEFAULT_STACK_SIZE CONFIG_JOB_SCHEDULER_STACK_SIZE
+#else
+#define JOB_SCHEDULER_DEFAULT_STACK_SIZE 4096
+#endif
+
+#ifdef CONFIG_JOB_SCHEDULER_STATS_LOG_S
+#define JOB_SCHEDULER_DEFAULT_STATS_LOG_S CONFIG_JOB_SCHEDULER_STATS_LOG_S
+#else
+#define JOB_SCHEDULER_DEFAULT_STATS_LOG_S 0
+#endif
+
+static const char *TAG = "job_scheduler";
+
+typedef struct {
+    job_scheduler_fn_t fn;
+    void *ctx;
+    int64_t period_us;
+    int64_t due_us;
+    job_scheduler_job_stats_t stats;
+} job_scheduler_job_t;
+
+/* Guards the wheel, the job table and the stats; jobs run outside it. */
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static job_wheel_t s_wheel;
+static job_scheduler_job_t s_jobs[JOB_SCHEDULER_MAX_JOBS];
+static size_t s_job_count;
+static int64_t s_wheel_us;     /* time of the wheel's current tick; 0 until first use */
+static int64_t s_tick_us = (int64_t)JOB_SCHEDULER_DEFAULT_TICK_MS * 1000;
+static job_scheduler_config_t s_config;
+static TaskHandle_t s_task_handle = NULL;
+
+void job_scheduler_get_default_config(job_scheduler_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->tick_ms = JOB_SCHEDULER_DEFAULT_TICK_MS;
+    config->stack_size = JOB_SCHEDULER_DEFAULT_STACK_SIZE;
+    config->task_priority = tskIDLE_PRIORITY + 1;
+    config->core_id = tskNO_AFFINITY;
+    config->stats_log_interval_s = JOB_SCHEDULER_DEFAULT_STATS_LOG_S;
+}
+
+/* Caller holds s_lock. */
+static void job_scheduler_wheel_init_locked(int64_t now_us)
+{
+    if (s_wheel_us == 0) {
+        job_wheel_init(&s_wheel);
+        s_wheel_us = now_us;
+    }
+}
+
+/* Caller holds s_lock. Rounds up, so a job never fires before its due time. */
+static void job_scheduler_arm_locked(size_t id)
+{
+    const int64_t ahead_us = s_jobs[id].due_us - s_wheel_us;
+    const uint32_t ticks = (ahead_us <= 0) ? 1U : (uint32_t)((ahead_us + s_tick_us - 1) / s_tick_us);
+    (void)job_wheel_schedule(&s_wheel, (uint8_t)id, ticks);
+}
+
+bool job_scheduler_add(const char *name,
+                       uint32_t period_ms,
+                       job_scheduler_fn_t fn,
+                       void *ctx,
+                       job_scheduler_id_t *out_id)
+{
+    if (name == NULL || fn == NULL || period_ms == 0U) {
+        return false;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    size_t id;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_job_count >= JOB_SCHEDULER_MAX_JOBS) {
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGE(TAG, "No room for job %s", name);
+        return false;
+    }
+    job_scheduler_wheel_init_locked(now_us);
+    id = s_job_count++;
+    job_scheduler_job_t *job = &s_jobs[id];
+    memset(job, 0, sizeof(*job));
+    job->fn = fn;
+    job->ctx = ctx;
+    job->period_us = (int64_t)period_ms * 1000;
+    /* On the wheel's tick grid, so periods that are whole ticks never round up. */
+    job->due_us = s_wheel_us + ((now_us - s_wheel_us) / s_tick_us + 1) * s_tick_us;
+    job->stats.name = name;
+    job->stats.period_ms = period_ms;
+    job_scheduler_arm_locked(id);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_task_handle != NULL) {
+        xTaskNotifyGive(s_task_handle);
+    }
+    if (out_id != NULL) {
+        *out_id = (job_scheduler_id_t)id;
+    }
+    return true;
+}
+
+static void job_scheduler_run_job(size_t id)
+{
+    job_scheduler_job_t *job = &s_jobs[id];
+    const int64_t start_us = esp_timer_get_time();
+
+    /* fn/ctx/period never change once added. */
+    job->fn(job->ctx);
+
+    const int64_t end_us = esp_timer_get_time();
+    const uint32_t exec_us = (uint32_t)(end_us - start_us);
+
+    portENTER_CRITICAL(&s_lock);
+    const int64_t late_us64 = start_us - job->due_us;
+    const uint32_t late_us = (late_us64 > 0) ? (uint32_t)late_us64 : 0U;
+    job_scheduler_job_stats_t *stats = &job->stats;
+    stats->runs++;
+    stats->last_exec_us = exec_us;
+    stats->total_exec_us += exec_us;
+    if (exec_us > stats->max_exec_us) {
+        stats->max_exec_us = exec_us;
+    }
+    stats->last_late_us = late_us;
+    stats->total_late_us += late_us;
+    if (late_us > stats->max_late_us) {
+        stats->max_late_us = late_us;
+    }
+
+    /* Next period boundary after now; anything in between is skipped, not replayed. */
+    int64_t next_us = job->due_us + job->period_us;
+    if (next_us <= end_us) {
+        const int64_t missed = (end_us - job->due_us) / job->period_us;
+        stats->skipped += (uint32_t)missed;
+        next_us = job->due_us + (missed + 1) * job->period_us;
+    }
+    job->due_us = next_us;
+    job_scheduler_arm_locked(id);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void job_scheduler_task(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        const int64_t now_us = esp_timer_get_time();
+
+        portENTER_CRITICAL(&s_lock);
+        const uint32_t elapsed = (uint32_t)((now_us - s_wheel_us) / s_tick_us);
+        const uint32_t expired = job_wheel_advance(&s_wheel, elapsed);
+        s_wheel_us += (int64_t)elapsed * s_tick_us;
+        const uint32_t next_ticks = job_wheel_next_delay(&s_wheel);
+        portEXIT_CRITICAL(&s_lock);
+
+        if (expired != 0U) {
+            for (size_t id = 0; id < JOB_SCHEDULER_MAX_JOBS; ++id) {
+                if ((expired & (1UL << id)) != 0U) {
+                    job_scheduler_run_job(id);
+                }
+            }
+            continue;
+        }
+
+        TickType_t wait = portMAX_DELAY;
+        if (next_ticks != JOB_WHEEL_NONE) {
+            const int64_t wake_us = s_wheel_us + (int64_t)next_ticks * s_tick_us;
+            const int64_t wait_ms = (wake_us - esp_timer_get_time() + 999) / 1000;
+            wait = (wait_ms <= 0) ? 0 : pdMS_TO_TICKS((uint32_t)wait_ms);
+        }
+        if (wait != 0) {
+            (void)ulTaskNotifyTake(pdTRUE, wait);
+        }
+    }
+}
+
+static void job_scheduler_stats_job(void *ctx)
+{
+    (void)ctx;
+    job_scheduler_log_stats();
+}
+
+bool job_scheduler_start(const job_scheduler_config_t *config)
+{
+    if (config == NULL || config->tick_ms == 0U) {
+        return false;
+    }
+    if (s_task_handle != NULL) {
+        return true;
+    }
+
+    s_config = *config;
+    portENTER_CRITICAL(&s_lock);
+    s_tick_us = (int64_t)s_config.tick_ms * 1000;
+    job_scheduler_wheel_init_locked(esp_timer_get_time());
+    portEXIT_CRITICAL(&s_lock);
+
+    BaseType_t ret;
+    if (s_config.core_id == tskNO_AFFINITY) {
+        ret = xTaskCreate(job_scheduler_task, "jobScheduler", s_config.stack_size, NULL,
+                          s_config.task_priority, &s_task_handle);
+    } else {
+        ret = xTaskCreatePinnedToCore(job_scheduler_task, "jobScheduler", s_config.stack_size, NULL,
+                                      s_config.task_priority, &s_task_handle, s_config.core_id);
+    }
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start scheduler task");
+        s_task_handle = NULL;
+        return false;
+    }
+
+    if (s_config.stats_log_interval_s > 0U) {
+        (void)job_scheduler_add("jobStats", s_config.stats_log_interval_s * 1000U, job_scheduler_stats_job, NULL,
+                                NULL);
+    }
+    return true;
+}
+
+size_t job_scheduler_get_stats(job_scheduler_job_stats_t *out_stats, size_t max_jobs)
+{
+    portENTER_CRITICAL(&s_lock);
+    const size_t count = s_job_count;
+    for (size_t i = 0; out_stats != NULL && i < count && i < max_jobs; ++i) {
+        out_stats[i] = s_jobs[i].stats;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return count;
+}
+
+uint32_t job_scheduler_stack_free_bytes(void)
+{
+    if (s_task_handle == NULL) {
+        return 0U;
+    }
+    /* ESP-IDF reports the high water mark in bytes. */
+    return (uint32_t)uxTaskGetStackHighWaterMark(s_task_handle);
+}
+
+void job_scheduler_log_stats(void)
+{
+    job_scheduler_job_stats_t stats[JOB_SCHEDULER_MAX_JOBS];
+    const size_t count = job_scheduler_get_stats(stats, JOB_SCHEDULER_MAX_JOBS);
+
+    for (size_t i = 0; i < count; ++i) {
+        const job_scheduler_job_stats_t *job = &stats[i];
+        const uint32_t runs = (job->runs > 0U) ? job->runs : 1U;
+        ESP_LOGI(TAG, "%-10s %6u ms: runs %u, exec avg %u max %u us, late avg %u max %u us, skipped %u",
+                 job->name, (unsigned)job->period_ms, (unsigned)job->runs,
+                 (unsigned)(job->total_exec_us / runs), (unsigned)job->max_exec_us,
+                 (unsigned)(job->total_late_us / runs), (unsigned)job->max_late_us, (unsigned)job->skipped);
+    }
+    if (s_task_handle != NULL) {
+        ESP_LOGI(TAG, "%u jobs on one %u-byte stack, %u bytes never used", (unsigned)count,
+                 (unsigned)s_config.stack_size, (unsigned)job_scheduler_stack_free_bytes());
+    }
+}
@@ -0,0 +1,101 @@
+#include "job_wheel.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define JOB_WHEEL_NIL 0xFFU
+
+void job_wheel_init(job_wheel_t *wheel)
+{
+    if (wheel == NULL) {
+        return;
+    }
+    memset(wheel, 0, sizeof(*wheel));
+    memset(wheel->heads, JOB_WHEEL_NIL, sizeof(wheel->heads));
+}
+
+void job_wheel_cancel(job_wheel_t *wheel, uint8_t id)
+{
+    if (wheel == NULL || id >= JOB_WHEEL_MAX_ENTRIES || !wheel->entries[id].armed) {
+        return;
+    }
+
+    uint8_t *link = &wheel->heads[wheel->entries[id].slot];
+    while (*link != JOB_WHEEL_NIL) {
+        if (*link == id) {
+            *link = wheel->entries[id].next;
+            break;
+        }
+        link = &wheel->entries[*link].next;
+    }
+    wheel->entries[id].armed = false;
+}
+
+bool job_wheel_schedule(job_wheel_t *wheel, uint8_t id, uint32_t delay_ticks)
+{
+    if (wheel == NULL || id >= JOB_WHEEL_MAX_ENTRIES) {
+        return false;
+    }
+    if (delay_ticks == 0U) {
+        delay_ticks = 1U;
+    }
+
+    job_wheel_cancel(wheel, id);
+
+    job_wheel_entry_t *entry = &wheel->entries[id];
+    const uint32_t rounds = (delay_ticks - 1U) / JOB_WHEEL_SLOTS;
+    entry->rounds = (rounds > UINT16_MAX) ? UINT16_MAX : (uint16_t)rounds;
+    entry->slot = (uint8_t)((wheel->now + delay_ticks) % JOB_WHEEL_SLOTS);
+    entry->next = wheel->heads[entry->slot];
+    entry->armed = true;
+    wheel->heads[entry->slot] = id;
+    return true;
+}
+
+uint32_t job_wheel_advance(job_wheel_t *wheel, uint32_t ticks)
+{
+    if (wheel == NULL) {
+        return 0U;
+    }
+
+    uint32_t expired = 0U;
+    for (uint32_t t = 0; t < ticks; ++t) {
+        wheel->now++;
+        uint8_t *link = &wheel->heads[wheel->now % JOB_WHEEL_SLOTS];
+        while (*link != JOB_WHEEL_NIL) {
+            job_wheel_entry_t *entry = &wheel->entries[*link];
+            if (entry->rounds == 0U) {
+                expired |= 1UL << *link;
+                entry->armed = false;
+                *link = entry->next;
+            } else {
+                entry->rounds--;
+                link = &entry->next;
+            }
+        }
+    }
+    return expired;
+}
+
+uint32_t job_wheel_next_delay(const job_wheel_t *wheel)
+{
+    if (wheel == NULL) {
+        return JOB_WHEEL_NONE;
+    }
+
+    const uint32_t now_slot = wheel->now % JOB_WHEEL_SLOTS;
+    uint32_t best = JOB_WHEEL_NONE;
+    for (uint32_t i = 0; i < JOB_WHEEL_MAX_ENTRIES; ++i) {
+        const job_wheel_entry_t *entry = &wheel->entries[i];
+        if (!entry->armed) {
+            continue;
+        }
+        /* Ticks to the entry's bucket (a full turn if it is the current one), plus its rounds. */
+        const uint32_t to_slot = ((entry->slot + JOB_WHEEL_SLOTS - now_slot - 1U) % JOB_WHEEL_SLOTS) + 1U;
+        const uint32_t delay = to_slot + (uint32_t)entry->rounds * JOB_WHEEL_SLOTS;
+        if (delay < best) {
+            best = delay;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,53 @@
+#include "job_wheel.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+
+TEST_CASE("job_wheel expires entries after their delay, across turns", "[job_scheduler]")
+{
+    job_wheel_t wheel;
+    job_wheel_init(&wheel);
+
+    TEST_ASSERT_EQUAL_UINT32(JOB_WHEEL_NONE, job_wheel_next_delay(&wheel));
+
+    /* 3 ticks, exactly one turn, and one turn plus one. */
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 0, 3U));
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 1, JOB_WHEEL_SLOTS));
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 2, JOB_WHEEL_SLOTS + 1U));
+    TEST_ASSERT_EQUAL_UINT32(3U, job_wheel_next_delay(&wheel));
+
+    TEST_ASSERT_EQUAL_HEX32(0U, job_wheel_advance(&wheel, 2U));
+    TEST_ASSERT_EQUAL_HEX32(1U << 0, job_wheel_advance(&wheel, 1U));
+    TEST_ASSERT_EQUAL_UINT32(JOB_WHEEL_SLOTS - 3U, job_wheel_next_delay(&wheel));
+
+    TEST_ASSERT_EQUAL_HEX32(0U, job_wheel_advance(&wheel, JOB_WHEEL_SLOTS - 4U));
+    TEST_ASSERT_EQUAL_HEX32(1U << 1, job_wheel_advance(&wheel, 1U));
+    TEST_ASSERT_EQUAL_UINT32(1U, job_wheel_next_delay(&wheel));
+    TEST_ASSERT_EQUAL_HEX32(1U << 2, job_wheel_advance(&wheel, 1U));
+    TEST_ASSERT_EQUAL_UINT32(JOB_WHEEL_NONE, job_wheel_next_delay(&wheel));
+}
+
+TEST_CASE("job_wheel reschedule and cancel keep buckets consistent", "[job_scheduler]")
+{
+    job_wheel_t wheel;
+    job_wheel_init(&wheel);
+
+    /* Same bucket: 5 and 5 + 2 turns. */
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 3, 5U));
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 4, 5U + 2U * JOB_WHEEL_SLOTS));
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 5, 5U));
+    job_wheel_cancel(&wheel, 5);
+
+    /* Re-arming moves the entry instead of adding it twice. */
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 3, 7U));
+    TEST_ASSERT_EQUAL_HEX32(0U, job_wheel_advance(&wheel, 5U));
+    TEST_ASSERT_EQUAL_HEX32(1U << 3, job_wheel_advance(&wheel, 2U));
+
+    TEST_ASSERT_EQUAL_UINT32(2U * JOB_WHEEL_SLOTS - 2U, job_wheel_next_delay(&wheel));
+    TEST_ASSERT_EQUAL_HEX32(1U << 4, job_wheel_advance(&wheel, 2U * JOB_WHEEL_SLOTS - 2U));
+
+    TEST_ASSERT_FALSE(job_wheel_schedule(&wheel, JOB_WHEEL_MAX_ENTRIES, 1U));
+    TEST_ASSERT_TRUE(job_wheel_schedule(&wheel, 6, 0U)); /* taken as 1 */
+    TEST_ASSERT_EQUAL_HEX32(1U << 6, job_wheel_advance(&wheel, 1U));
+}
@@ -0,0 +1,135 @@
+/*
+ * history_chart.c
+ *
+ * lv_chart feed for snapshot_history tiers.
+ */
+
+#include "history_chart.h"
+
+#include <string.h>
+
+/* LVGL runs on one task, so feeds share one copy buffer. */
+static snapshot_history_point_t s_points[SNAPSHOT_HISTORY_MAX_POINTS];
+
+static int32_t history_chart_divisor(snapshot_history_metric_t metric)
+{
+    switch (metric) {
+    case SNAPSHOT_HISTORY_FREE_HEAP:
+        return 1024;
+    case SNAPSHOT_HISTORY_TEMPERATURE:
+        return 10;
+    default:
+        return 1;
+    }
+}
+
+static lv_coord_t history_chart_scale(int32_t value, int32_t divisor)
+{
+    /* INT16_MAX is LV_CHART_POINT_NONE; one unit of margin each side leaves room for the range headroom. */
+    value /= divisor;
+    if (value >= INT16_MAX) {
+        return INT16_MAX - 1;
+    }
+    if (value <= INT16_MIN) {
+        return INT16_MIN + 1;
+    }
+    return (lv_coord_t)value;
+}
+
+bool history_chart_feed_init(history_chart_feed_t *feed,
+                             lv_obj_t *chart,
+                             lv_chart_series_t *series,
+                             snapshot_history_metric_t metric,
+                             snapshot_history_tier_t tier)
+{
+    if (feed == NULL || chart == NULL || series == NULL || snapshot_history_tier_capacity(tier) == 0U) {
+        return false;
+    }
+
+    memset(feed, 0, sizeof(*feed));
+    feed->chart = chart;
+    feed->series = series;
+    feed->metric = metric;
+    feed->tier = tier;
+    feed->divisor = history_chart_divisor(metric);
+    for (size_t i = 0; i < SNAPSHOT_HISTORY_MAX_POINTS; ++i) {
+        feed->values[i] = LV_CHART_POINT_NONE;
+    }
+
+    lv_chart_set_point_count(chart, (uint16_t)snapshot_history_tier_capacity(tier));
+    lv_chart_set_ext_y_array(chart, series, feed->values);
+    return true;
+}
+
+void history_chart_feed_update(history_chart_feed_t *feed)
+{
+    if (feed == NULL || feed->chart == NULL) {
+        return;
+    }
+
+    uint32_t newest_s = 0U;
+    const size_t capacity = snapshot_history_tier_capacity(feed->tier);
+    const size_t count = snapshot_history_read(feed->metric, feed->tier, s_points, capacity, &newest_s);
+
+    /* Right-align: newest bucket in the last slot, unused slots blank. */
+    const size_t offset = capacity - count;
+    bool changed = (newest_s != feed->newest_s) || (count != feed->count);
+    for (size_t i = 0; i < capacity; ++i) {
+        lv_coord_t value = LV_CHART_POINT_NONE;
+        if (i >= offset && !SNAPSHOT_HISTORY_POINT_EMPTY(&s_points[i - offset])) {
+            value = history_chart_scale(s_points[i - offset].avg, feed->divisor);
+        }
+        if (feed->values[i] != value) {
+            feed->values[i] = value;
+            changed = true;
+        }
+    }
+
+    feed->newest_s = newest_s;
+    feed->count = count;
+    if (!changed) {
+        return;
+    }
+
+    lv_coord_t min = INT16_MAX;
+    lv_coord_t max = INT16_MIN;
+    for (size_t i = offset; i < capacity; ++i) {
+        if (feed->values[i] == LV_CHART_POINT_NONE) {
+            continue;
+        }
+        min = (feed->values[i] < min) ? feed->values[i] : min;
+        max = (feed->values[i] > max) ? feed->values[i] : max;
+    }
+    if (min <= max) {
+        /* One unit of headroom keeps a flat line off the chart edges. */
+        lv_chart_set_range(feed->chart, LV_CHART_AXIS_PRIMARY_Y, min - 1, max + 1);
+    }
+    lv_chart_refresh(feed->chart);
+}
+
+lv_obj_t *history_chart_create(lv_obj_t *parent,
+                               history_chart_feed_t *feed,
+                               snapshot_history_metric_t metric,
+                               snapshot_history_tier_t tier,
+                               lv_color_t color)
+{
+    lv_obj_t *chart = lv_chart_create(parent);
+    if (chart == NULL) {
+        return NULL;
+    }
+
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_div_line_count(chart, 0, 0);
+    lv_obj_set_style_bg_opa(chart, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(chart, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(chart, 0, LV_PART_MAIN);
+    lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR); /* no point markers */
+    lv_obj_clear_flag(chart, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_chart_series_t *series = lv_chart_add_series(chart, color, LV_CHART_AXIS_PRIMARY_Y);
+    if (series == NULL || !history_chart_feed_init(feed, chart, series, metric, tier)) {
+        lv_obj_del(chart);
+        return NULL;
+    }
+    return chart;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+ * history_chart.h
+ *
+ * Feeds an lv_chart series from snapshot_history. The caller owns the feed
+ * (static storage); the series points at feed->values, so updating the
+ * chart copies at most one tier and allocates nothing. LVGL thread only.
+ */
+
+#include "lvgl.h"
+#include "snapshot_history.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    lv_obj_t *chart;
+    lv_chart_series_t *series;
+    snapshot_history_metric_t metric;
+    snapshot_history_tier_t tier;
+    int32_t divisor; /* lv_coord_t is 16-bit: heap in KiB, temperature in 0.1 C, RSSI in dBm */
+    uint32_t newest_s;
+    size_t count;
+    lv_coord_t values[SNAPSHOT_HISTORY_MAX_POINTS]; /* bucket averages; gaps are LV_CHART_POINT_NONE */
+} history_chart_feed_t;
+
+/* Sizes the chart to the tier and attaches feed->values to the series. */
+bool history_chart_feed_init(history_chart_feed_t *feed,
+                             lv_obj_t *chart,
+                             lv_chart_series_t *series,
+                             snapshot_history_metric_t metric,
+                             snapshot_history_tier_t tier);
+
+/*
+ * Refreshes the chart only when a new bucket opened or the open one moved;
+ * the Y range follows the visible points. Call once per sample period or
+ * faster (an unchanged tier costs one history copy and no redraw).
+ */
+void history_chart_feed_update(history_chart_feed_t *feed);
+
+/* Borderless sparkline chart on parent bound to feed; NULL on failure. Caller sizes it. */
+lv_obj_t *history_chart_create(lv_obj_t *parent,
+                               history_chart_feed_t *feed,
+                               snapshot_history_metric_t metric,
+                               snapshot_history_tier_t tier,
+                               lv_color_t color);
+
+#ifdef __cplusplus
+}
+#endif
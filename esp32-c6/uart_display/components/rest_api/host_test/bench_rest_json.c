@@ -0,0 +1,218 @@
+/*
+ * bench_rest_json.c
+ *
+ * Host benchmark: rest_json writer vs. the snprintf bodies it replaced.
+ * Reports encode throughput and peak stack use of each encoder (measured by
+ * running it on a painted pthread stack).
+ */
+
+#define _GNU_SOURCE
+
+#include "rest_json.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CHUNK_LEN 1440U /* default lwIP TCP MSS on the device */
+#define BENCH_HISTORY_POINTS 120U
+#define BENCH_DURATION_NS 300000000LL
+#define BENCH_STACK_SIZE (64U * 1024U)
+#define BENCH_STACK_PAINT 0xA5U
+
+typedef struct {
+    uint32_t uptime_ms;
+    uint32_t free_heap_bytes;
+    int8_t wifi_rssi_dbm;
+    bool wifi_connected;
+    float temperature_c;
+} bench_snapshot_t;
+
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t avg;
+} bench_point_t;
+
+typedef size_t (*bench_encode_fn)(void);
+
+static bench_snapshot_t s_snapshot = { 123456U, 654321U, -45, true, 21.25f };
+static bench_point_t s_points[BENCH_HISTORY_POINTS];
+static char s_chunk[BENCH_CHUNK_LEN];
+static char s_flat[16384];
+static volatile size_t s_sink;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Stands in for httpd_resp_send_chunk. */
+static bool sink_flush(void *ctx, const char *data, size_t len)
+{
+    (void)ctx;
+    s_sink += (size_t)data[len - 1U];
+    return true;
+}
+
+static size_t writer_status(void)
+{
+    rest_json_writer_t writer;
+    rest_json_init(&writer, s_chunk, sizeof(s_chunk), sink_flush, NULL);
+    rest_json_begin_object(&writer);
+    rest_json_key(&writer, "uptime_ms");
+    rest_json_uint(&writer, s_snapshot.uptime_ms);
+    rest_json_key(&writer, "free_heap_bytes");
+    rest_json_uint(&writer, s_snapshot.free_heap_bytes);
+    rest_json_key(&writer, "wifi_connected");
+    rest_json_bool(&writer, s_snapshot.wifi_connected);
+    rest_json_key(&writer, "wifi_rssi_dbm");
+    rest_json_int(&writer, s_snapshot.wifi_rssi_dbm);
+    rest_json_key(&writer, "celsius");
+    rest_json_float(&writer, s_snapshot.temperature_c, 2U);
+    rest_json_end_object(&writer);
+    (void)rest_json_flush(&writer);
+    return rest_json_ok(&writer) ? rest_json_size(&writer) : 0U;
+}
+
+static size_t snprintf_status(void)
+{
+    int len = snprintf(s_flat, 192,
+                       "{\"uptime_ms\":%" PRIu32 ",\"free_heap_bytes\":%" PRIu32
+                       ",\"wifi_connected\":%s,\"wifi_rssi_dbm\":%d,\"celsius\":%.2f}",
+                       s_snapshot.uptime_ms, s_snapshot.free_heap_bytes,
+                       s_snapshot.wifi_connected ? "true" : "false", (int)s_snapshot.wifi_rssi_dbm,
+                       (double)s_snapshot.temperature_c);
+    s_sink += (size_t)s_flat[len - 1];
+    return (size_t)len;
+}
+
+static size_t writer_history(void)
+{
+    rest_json_writer_t writer;
+    rest_json_init(&writer, s_chunk, sizeof(s_chunk), sink_flush, NULL);
+    rest_json_begin_object(&writer);
+    rest_json_key(&writer, "metric");
+    rest_json_string(&writer, "heap");
+    rest_json_key(&writer, "points");
+    rest_json_begin_array(&writer);
+    for (size_t i = 0; i < BENCH_HISTORY_POINTS; ++i) {
+        rest_json_begin_array(&writer);
+        rest_json_int(&writer, s_points[i].min);
+        rest_json_int(&writer, s_points[i].max);
+        rest_json_int(&writer, s_points[i].avg);
+        rest_json_end_array(&writer);
+    }
+    rest_json_end_array(&writer);
+    rest_json_end_object(&writer);
+    (void)rest_json_flush(&writer);
+    return rest_json_ok(&writer) ? rest_json_size(&writer) : 0U;
+}
+
+static size_t snprintf_history(void)
+{
+    size_t used = (size_t)snprintf(s_flat, sizeof(s_flat), "{\"metric\":\"%s\",\"points\":[", "heap");
+    for (size_t i = 0; i < BENCH_HISTORY_POINTS; ++i) {
+        used += (size_t)snprintf(&s_flat[used], sizeof(s_flat) - used, "%s[%" PRIi32 ",%" PRIi32 ",%" PRIi32 "]",
+                                 (i == 0U) ? "" : ",", s_points[i].min, s_points[i].max, s_points[i].avg);
+    }
+    used += (size_t)snprintf(&s_flat[used], sizeof(s_flat) - used, "]}");
+    s_sink += (size_t)s_flat[used - 1U];
+    return used;
+}
+
+static size_t empty_encoder(void)
+{
+    return 0U;
+}
+
+typedef struct {
+    bench_encode_fn fn;
+    size_t bytes;
+} stack_probe_t;
+
+static void *stack_probe_thread(void *arg)
+{
+    stack_probe_t *probe = (stack_probe_t *)arg;
+    probe->bytes = probe->fn();
+    return NULL;
+}
+
+/* Peak stack depth of fn, from the highest painted byte that was overwritten. */
+static size_t measure_stack(bench_encode_fn fn)
+{
+    uint8_t *stack = aligned_alloc(4096U, BENCH_STACK_SIZE);
+    if (stack == NULL) {
+        return 0U;
+    }
+    memset(stack, BENCH_STACK_PAINT, BENCH_STACK_SIZE);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, BENCH_STACK_SIZE);
+
+    pthread_t thread;
+    stack_probe_t probe = { .fn = fn };
+    if (pthread_create(&thread, &attr, stack_probe_thread, &probe) != 0) {
+        free(stack);
+        return 0U;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    size_t untouched = 0U;
+    while (untouched < BENCH_STACK_SIZE && stack[untouched] == BENCH_STACK_PAINT) {
+        untouched++;
+    }
+    free(stack);
+    return BENCH_STACK_SIZE - untouched;
+}
+
+static void run(const char *name, bench_encode_fn fn, size_t baseline_stack)
+{
+    size_t bytes = 0U;
+    uint64_t calls = 0U;
+    const int64_t start = now_ns();
+    int64_t elapsed;
+
+    do {
+        for (int i = 0; i < 256; ++i) {
+            bytes += fn();
+        }
+        calls += 256U;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_DURATION_NS);
+
+    const double seconds = (double)elapsed / 1e9;
+    const size_t stack = measure_stack(fn);
+    printf("%-18s %8zu B/body %10.1f MB/s %9.0f ns/body %6zu B stack\n",
+           name,
+           bytes / (size_t)calls,
+           (double)bytes / seconds / 1e6,
+           (double)elapsed / (double)calls,
+           (stack > baseline_stack) ? stack - baseline_stack : 0U);
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < BENCH_HISTORY_POINTS; ++i) {
+        s_points[i].min = 180000 + (int32_t)(i * 37U);
+        s_points[i].max = s_points[i].min + 4096;
+        s_points[i].avg = s_points[i].min + 1500 - (int32_t)i;
+    }
+
+    /* Stack is reported relative to a thread that calls an empty encoder. */
+    const size_t baseline_stack = measure_stack(empty_encoder);
+    printf("chunk buffer %u B (static), stack baseline %zu B\n", BENCH_CHUNK_LEN, baseline_stack);
+    run("writer/status", writer_status, baseline_stack);
+    run("snprintf/status", snprintf_status, baseline_stack);
+    run("writer/history", writer_history, baseline_stack);
+    run("snprintf/history", snprintf_history, baseline_stack);
+
+    return (writer_status() != 0U && writer_history() != 0U) ? 0 : 1;
+}
@@ -0,0 +1,505 @@
+/*
+ * load_rest_stream.c
+ *
+ * Host load test for /api/v1/stream. LOAD_CLIENTS clients connect through
+ * the real route handler on the stand-in httpd; each gets a socketpair and a
+ * reader thread. Fast readers drain continuously, slow readers trickle, one
+ * reader hangs up mid-stream. A writer thread churns the snapshot while
+ * producer and sender threads run the stream's task bodies (producer ticks
+ * on a virtual clock, LOAD_TICK_MS per tick).
+ *
+ * Checks: every event is well-formed with increasing ids, each client gets
+ * exactly one baseline, per-client fields and intervals are honoured, slow
+ * readers are coalesced instead of stalling the others, the hung-up client
+ * is closed, and every surviving client ends on the latest values.
+ *
+ * A second run starts the stand-in with rest_api's own httpd settings and
+ * its socket table: with every stream slot taken, more plain GETs connect at
+ * once than there are sockets left. Every stream must keep receiving; the
+ * same run with LRU purge forced on shows the stand-in would cut one off.
+ */
+
+#include "esp_http_server.h"
+#include "rest_api.h"
+#include "rest_routes.h"
+#include "rest_stream.h"
+#include "system_snapshot.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOAD_CLIENTS 12U
+#define LOAD_TICK_MS 100U
+#define LOAD_TICK_REAL_US 2000U
+#define LOAD_DURATION_MS 1500U
+#define LOAD_SETTLE_MS 3000U
+#define LOAD_SEND_BUFFER 4096U
+#define LOAD_SLOW_READ_LEN 64U
+#define LOAD_SLOW_READ_PAUSE_US 5000U
+#define LOAD_HANGUP_AFTER 20U
+#define LOAD_SLOW_INTERVAL_MS 500U
+#define LOAD_FINAL_CELSIUS 42.42f
+#define SOCKET_GETS 8U /* concurrent pollers, more than the sockets streams leave free */
+#define SOCKET_FINAL_CELSIUS 17.17f
+
+typedef enum {
+    CLIENT_FAST = 0,
+    CLIENT_SLOW,
+    CLIENT_HANGUP,
+    CLIENT_TEMPERATURE_ONLY,
+    CLIENT_LONG_INTERVAL,
+} load_client_kind_t;
+
+typedef struct {
+    load_client_kind_t kind;
+    char path[96];
+    int fd;
+    pthread_t thread;
+    atomic_bool saw_final;
+
+    /* Reader-thread results, read after join. */
+    unsigned frames;
+    unsigned snapshots;
+    unsigned deltas;
+    uint32_t last_id;
+    bool malformed;
+    bool ids_out_of_order;
+    bool unexpected_field;
+    double last_celsius;
+} load_client_t;
+
+static load_client_t s_clients[LOAD_CLIENTS];
+static httpd_req_t s_requests[LOAD_CLIENTS + 1U];
+static atomic_bool s_stop_writer;
+static atomic_bool s_stop_producer;
+static atomic_bool s_stop_sender;
+static uint32_t s_now_ms;
+static unsigned s_ticks;
+static float s_final_celsius = LOAD_FINAL_CELSIUS;
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static const char *kind_name(load_client_kind_t kind)
+{
+    static const char *const names[] = { "fast", "slow", "hangup", "temp-only", "interval" };
+    return names[kind];
+}
+
+static void handle_frame(load_client_t *client, char *frame)
+{
+    if (strncmp(frame, "retry: ", 7) == 0 || frame[0] == ':') {
+        return;
+    }
+
+    unsigned long id = 0;
+    char event[16];
+    int data_at = 0;
+    if (sscanf(frame, "id: %lu\nevent: %15[a-z]\ndata: %n", &id, event, &data_at) != 2 || data_at == 0) {
+        client->malformed = true;
+        return;
+    }
+
+    const char *data = frame + data_at;
+    const size_t data_len = strlen(data);
+    if (data_len < 2U || data[0] != '{' || data[data_len - 1U] != '}') {
+        client->malformed = true;
+        return;
+    }
+
+    client->frames++;
+    if (strcmp(event, "snapshot") == 0) {
+        client->snapshots++;
+    } else if (strcmp(event, "delta") == 0) {
+        client->deltas++;
+    } else {
+        client->malformed = true;
+    }
+
+    if (client->frames > 1U && (uint32_t)id <= client->last_id) {
+        client->ids_out_of_order = true;
+    }
+    client->last_id = (uint32_t)id;
+
+    if (client->kind == CLIENT_TEMPERATURE_ONLY &&
+        (strstr(data, "free_heap_bytes") != NULL || strstr(data, "iso8601") != NULL)) {
+        client->unexpected_field = true;
+    }
+
+    const char *celsius = strstr(data, "\"celsius\":");
+    if (celsius != NULL) {
+        client->last_celsius = strtod(celsius + 10, NULL);
+        if (fabs(client->last_celsius - s_final_celsius) < 0.001) {
+            atomic_store(&client->saw_final, true);
+        }
+    }
+}
+
+static void *client_reader(void *arg)
+{
+    load_client_t *client = (load_client_t *)arg;
+    char buf[8192];
+    size_t used = 0U;
+
+    while (1) {
+        const size_t want = (client->kind == CLIENT_SLOW) ? LOAD_SLOW_READ_LEN : sizeof(buf) - used - 1U;
+        const ssize_t n = read(client->fd, buf + used, (want < sizeof(buf) - used - 1U) ? want : sizeof(buf) - used - 1U);
+        if (n <= 0) {
+            break;
+        }
+        used += (size_t)n;
+        buf[used] = '\0';
+
+        char *start = buf;
+        char *end;
+        while ((end = strstr(start, "\n\n")) != NULL) {
+            *end = '\0';
+            handle_frame(client, start);
+            start = end + 2;
+        }
+        used -= (size_t)(start - buf);
+        memmove(buf, start, used);
+
+        if (client->kind == CLIENT_HANGUP && client->frames >= LOAD_HANGUP_AFTER) {
+            break;
+        }
+        if (client->kind == CLIENT_SLOW) {
+            usleep(LOAD_SLOW_READ_PAUSE_US);
+        }
+    }
+
+    close(client->fd);
+    return NULL;
+}
+
+static void *writer_thread(void *arg)
+{
+    (void)arg;
+    uint32_t k = 0U;
+
+    while (!atomic_load(&s_stop_writer)) {
+        system_snapshot_update_temperature(20.0f + (float)(k % 2000U) / 100.0f);
+        system_snapshot_update_metrics(k, 200000U - (k % 5000U), (int8_t)(-40 - (int)(k % 30U)), true);
+        k++;
+        usleep(100);
+    }
+    return NULL;
+}
+
+static void *producer_thread(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&s_stop_producer)) {
+        s_now_ms += LOAD_TICK_MS;
+        s_ticks++;
+        (void)rest_stream_publish(s_now_ms);
+        usleep(LOAD_TICK_REAL_US);
+    }
+    return NULL;
+}
+
+static void *sender_thread(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&s_stop_sender)) {
+        if (!rest_stream_drain()) {
+            usleep(200);
+        }
+    }
+    return NULL;
+}
+
+static load_client_kind_t kind_for(size_t index)
+{
+    switch (index) {
+    case 1:
+        return CLIENT_HANGUP;
+    case 2:
+        return CLIENT_TEMPERATURE_ONLY;
+    case 3:
+        return CLIENT_LONG_INTERVAL;
+    default:
+        return (index % 3U == 0U) ? CLIENT_SLOW : CLIENT_FAST;
+    }
+}
+
+static void connect_clients(httpd_handle_t server)
+{
+    for (size_t i = 0; i < LOAD_CLIENTS; ++i) {
+        load_client_t *client = &s_clients[i];
+        client->kind = kind_for(i);
+        switch (client->kind) {
+        case CLIENT_TEMPERATURE_ONLY:
+            (void)strlcpy(client->path, "/api/v1/stream?fields=temperature", sizeof(client->path));
+            break;
+        case CLIENT_LONG_INTERVAL:
+            snprintf(client->path, sizeof(client->path), "/api/v1/stream?interval_ms=%u", LOAD_SLOW_INTERVAL_MS);
+            break;
+        default:
+            (void)strlcpy(client->path, "/api/v1/stream?fields=time,temperature,heap,rssi", sizeof(client->path));
+            break;
+        }
+
+        CHECK(httpd_standin_connect(server, client->path, LOAD_SEND_BUFFER, &client->fd, &s_requests[i]) == ESP_OK);
+        CHECK(strcmp(s_requests[i].status, "200 OK") == 0);
+        CHECK(s_requests[i].async);
+        CHECK(pthread_create(&client->thread, NULL, client_reader, client) == 0);
+    }
+
+    /* Table full: one more is turned away, the others are unaffected. */
+    int extra_fd = -1;
+    CHECK(httpd_standin_connect(server, "/api/v1/stream", LOAD_SEND_BUFFER, &extra_fd, &s_requests[LOAD_CLIENTS]) == ESP_OK);
+    CHECK(strcmp(s_requests[LOAD_CLIENTS].status, "503 Service Unavailable") == 0);
+    CHECK(!s_requests[LOAD_CLIENTS].async);
+    close(extra_fd);
+
+    httpd_req_t *bad = &s_requests[LOAD_CLIENTS];
+    CHECK(httpd_standin_request(server, "/api/v1/stream?interval_ms=fast", NULL, bad) == ESP_OK);
+    CHECK(strcmp(bad->status, "400 Bad Request") == 0);
+}
+
+static bool wait_for_final(void)
+{
+    for (uint32_t waited = 0U; waited < LOAD_SETTLE_MS; waited += 10U) {
+        bool all = true;
+        for (size_t i = 0; i < LOAD_CLIENTS; ++i) {
+            if (s_clients[i].kind != CLIENT_HANGUP && !atomic_load(&s_clients[i].saw_final)) {
+                all = false;
+            }
+        }
+        if (all) {
+            return true;
+        }
+        usleep(10000);
+    }
+    return false;
+}
+
+typedef struct {
+    httpd_handle_t server;
+    int fd;
+    esp_err_t err;
+    httpd_req_t req;
+} socket_get_t;
+
+static socket_get_t s_gets[SOCKET_GETS];
+
+static void *get_thread(void *arg)
+{
+    socket_get_t *get = (socket_get_t *)arg;
+    get->err = httpd_standin_connect(get->server, "/api/v1/time", LOAD_SEND_BUFFER, &get->fd, &get->req);
+    return NULL;
+}
+
+/* Returns the number of streams closed while the GETs held their sockets. */
+static uint32_t run_streams_vs_gets(bool force_lru_purge)
+{
+    rest_api_config_t api;
+    rest_api_get_default_config(&api);
+    api.stream.interval_ms = LOAD_TICK_MS;
+    httpd_config_t httpd_config;
+    rest_api_get_httpd_config(&api, &httpd_config);
+    httpd_config.lru_purge_enable = httpd_config.lru_purge_enable || force_lru_purge;
+
+    system_snapshot_update_temperature(LOAD_FINAL_CELSIUS);
+    s_final_celsius = SOCKET_FINAL_CELSIUS;
+
+    httpd_handle_t server = NULL;
+    CHECK(httpd_start(&server, &httpd_config) == ESP_OK);
+    CHECK(rest_stream_init(&api.stream));
+    CHECK(rest_stream_register(server));
+    CHECK(rest_routes_register(server));
+
+    const size_t streams = api.stream.max_clients;
+    CHECK(streams > 0U && streams < httpd_config.max_open_sockets && streams <= LOAD_CLIENTS);
+    memset(s_clients, 0, sizeof(s_clients));
+    for (size_t i = 0; i < streams; ++i) {
+        load_client_t *client = &s_clients[i];
+        client->kind = CLIENT_FAST;
+        (void)strlcpy(client->path, "/api/v1/stream?fields=temperature", sizeof(client->path));
+        CHECK(httpd_standin_connect(server, client->path, LOAD_SEND_BUFFER, &client->fd, &s_requests[i]) == ESP_OK);
+        CHECK(s_requests[i].async);
+        CHECK(pthread_create(&client->thread, NULL, client_reader, client) == 0);
+    }
+    s_now_ms += LOAD_TICK_MS;
+    (void)rest_stream_publish(s_now_ms);
+    while (rest_stream_drain()) {
+    }
+
+    pthread_t threads[SOCKET_GETS];
+    for (size_t i = 0; i < SOCKET_GETS; ++i) {
+        s_gets[i].server = server;
+        CHECK(pthread_create(&threads[i], NULL, get_thread, &s_gets[i]) == 0);
+    }
+    unsigned served = 0U;
+    for (size_t i = 0; i < SOCKET_GETS; ++i) {
+        pthread_join(threads[i], NULL);
+        if (s_gets[i].err == ESP_OK) {
+            CHECK(strcmp(s_gets[i].req.status, "200 OK") == 0);
+            served++;
+        }
+    }
+
+    /* Streams learn the new value only if their socket is still theirs. */
+    system_snapshot_update_temperature(SOCKET_FINAL_CELSIUS);
+    s_now_ms += LOAD_TICK_MS;
+    (void)rest_stream_publish(s_now_ms);
+    bool all_final = false;
+    for (uint32_t waited = 0U; waited < LOAD_SETTLE_MS && !all_final; waited += 10U) {
+        while (rest_stream_drain()) {
+        }
+        all_final = true;
+        for (size_t i = 0; i < streams; ++i) {
+            all_final = all_final && atomic_load(&s_clients[i].saw_final);
+        }
+        if (!all_final) {
+            usleep(10000);
+        }
+    }
+
+    rest_stream_stats_t stats;
+    rest_stream_get_stats(&stats);
+    printf("%zu streams + %u GETs on %u sockets%s: %u GETs served, %" PRIu32 " streams closed\n", streams,
+           SOCKET_GETS, (unsigned)httpd_config.max_open_sockets, force_lru_purge ? " (LRU purge forced)" : "",
+           served, stats.clients_closed);
+    if (!force_lru_purge) {
+        CHECK(!httpd_config.lru_purge_enable);
+        CHECK(served == httpd_config.max_open_sockets - streams);
+        CHECK(all_final);
+        CHECK(stats.clients_closed == 0U);
+        CHECK(httpd_standin_open_sockets(server) == (int)httpd_config.max_open_sockets);
+    }
+
+    for (size_t i = 0; i < SOCKET_GETS; ++i) {
+        if (s_gets[i].fd >= 0) {
+            close(s_gets[i].fd);
+        }
+    }
+    rest_stream_stop();
+    for (size_t i = 0; i < streams; ++i) {
+        pthread_join(s_clients[i].thread, NULL);
+    }
+    CHECK(httpd_standin_open_async() == 0);
+    httpd_stop(server);
+    return stats.clients_closed;
+}
+
+int main(void)
+{
+    rest_stream_config_t config;
+    rest_stream_get_default_config(&config);
+    config.interval_ms = LOAD_TICK_MS;
+    config.max_clients = LOAD_CLIENTS;
+
+    system_snapshot_init();
+    system_snapshot_update_time(1726000000, "2024-09-11T08:12:00Z");
+    CHECK(rest_stream_init(&config));
+
+    httpd_handle_t server = httpd_standin_create();
+    CHECK(rest_stream_register(server));
+    connect_clients(server);
+
+    struct timespec t0;
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    pthread_t writer;
+    pthread_t producer;
+    pthread_t sender;
+    CHECK(pthread_create(&writer, NULL, writer_thread, NULL) == 0);
+    CHECK(pthread_create(&producer, NULL, producer_thread, NULL) == 0);
+    CHECK(pthread_create(&sender, NULL, sender_thread, NULL) == 0);
+
+    usleep(LOAD_DURATION_MS * 1000U);
+
+    /* Last state change, then one tick past every client's interval. */
+    atomic_store(&s_stop_writer, true);
+    pthread_join(writer, NULL);
+    atomic_store(&s_stop_producer, true);
+    pthread_join(producer, NULL);
+    system_snapshot_update_temperature(LOAD_FINAL_CELSIUS);
+    s_now_ms += LOAD_SLOW_INTERVAL_MS + LOAD_TICK_MS;
+    (void)rest_stream_publish(s_now_ms);
+
+    CHECK(wait_for_final());
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    atomic_store(&s_stop_sender, true);
+    pthread_join(sender, NULL);
+
+    rest_stream_stats_t stats;
+    rest_stream_get_stats(&stats);
+    rest_stream_stop();
+    for (size_t i = 0; i < LOAD_CLIENTS; ++i) {
+        pthread_join(s_clients[i].thread, NULL);
+    }
+    CHECK(httpd_standin_open_async() == 0);
+
+    const double seconds = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("%u clients, %u ticks in %.2f s: queued %" PRIu32 ", sent %" PRIu32 " (%.0f/s), coalesced %" PRIu32
+           ", closed %" PRIu32 ", rejected %" PRIu32 "\n",
+           LOAD_CLIENTS, s_ticks, seconds, stats.events_queued, stats.events_sent,
+           (double)stats.events_sent / seconds, stats.events_coalesced, stats.clients_closed,
+           stats.clients_rejected);
+
+    unsigned fast_min = UINT32_MAX;
+    unsigned slow_max = 0U;
+    for (size_t i = 0; i < LOAD_CLIENTS; ++i) {
+        const load_client_t *client = &s_clients[i];
+        printf("  client %2zu %-9s frames %4u (snapshot %u, delta %4u) last %.2f\n", i, kind_name(client->kind),
+               client->frames, client->snapshots, client->deltas, client->last_celsius);
+
+        CHECK(!client->malformed);
+        CHECK(!client->ids_out_of_order);
+        CHECK(!client->unexpected_field);
+        CHECK(client->snapshots == 1U);
+        if (client->kind == CLIENT_HANGUP) {
+            CHECK(client->frames >= LOAD_HANGUP_AFTER);
+            continue;
+        }
+        CHECK(fabs(client->last_celsius - LOAD_FINAL_CELSIUS) < 0.001);
+        if (client->kind == CLIENT_FAST && client->frames < fast_min) {
+            fast_min = client->frames;
+        }
+        if (client->kind == CLIENT_SLOW && client->frames > slow_max) {
+            slow_max = client->frames;
+        }
+        if (client->kind == CLIENT_LONG_INTERVAL) {
+            CHECK(client->deltas <= (s_ticks * LOAD_TICK_MS) / LOAD_SLOW_INTERVAL_MS + 2U);
+        }
+    }
+
+    /* Slow readers were collapsed rather than holding the fast ones back. */
+    CHECK(stats.events_coalesced > 0U);
+    CHECK(slow_max < fast_min);
+    CHECK(fast_min >= s_ticks / 4U);
+    CHECK(stats.clients_rejected == 1U);
+    CHECK(stats.clients_closed == 1U); /* the hang-up, before stop */
+
+    httpd_standin_destroy(server);
+
+    CHECK(run_streams_vs_gets(false) == 0U);
+    /* The stand-in evicts the oldest socket, a stream, when allowed to. */
+    CHECK(run_streams_vs_gets(true) > 0U);
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("load_rest_stream: ok\n");
+    return EXIT_SUCCESS;
+}
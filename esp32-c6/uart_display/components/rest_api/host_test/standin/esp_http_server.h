@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+ * esp_http_server.h (host stand-in)
+ *
+ * Just enough of the esp_http_server API for rest_routes.c. A request is a
+ * plain struct: tests fill the inputs via httpd_standin_request() and read
+ * the captured status, headers and body afterwards. Response headers are
+ * kept as pointers until the first send, like the real server, so a header
+ * value that goes out of scope too early shows up as garbage.
+ *
+ * httpd_standin_connect() backs a request with a real socketpair: the body
+ * is written (blocking, unframed) to the server end and the test reads the
+ * client end at its own pace, so slow readers fill real socket buffers.
+ *
+ * A server from httpd_start() also keeps the real server's socket table: a
+ * connection stays open after its response until the client closes it,
+ * and a new one beyond max_open_sockets is refused, or with
+ * lru_purge_enable evicts the socket whose last request is oldest (an
+ * async stream only ever has its first).
+ */
+
+#include "esp_err.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define HTTPD_STANDIN_MAX_HANDLERS 16
+#define HTTPD_STANDIN_MAX_HEADERS 8
+#define HTTPD_STANDIN_HEADER_LEN 96
+#define HTTPD_STANDIN_BODY_LEN 16384
+#define HTTPD_STANDIN_MAX_SOCKETS 32
+#define HTTPD_RESP_USE_STRLEN -1
+#define ESP_ERR_HTTPD_RESULT_TRUNC 0xb00c
+
+typedef void *httpd_handle_t;
+
+typedef struct {
+    UBaseType_t task_priority;
+    size_t stack_size;
+    BaseType_t core_id;
+    uint16_t server_port;
+    uint16_t max_open_sockets;
+    uint16_t max_uri_handlers;
+    bool lru_purge_enable;
+    bool keep_alive_enable;
+    int keep_alive_idle;
+    int keep_alive_interval;
+    int keep_alive_count;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG()                                                     \
+    {                                                                              \
+        .task_priority = tskIDLE_PRIORITY + 5, .stack_size = 4096, .core_id = tskNO_AFFINITY, \
+        .server_port = 80, .max_open_sockets = 7, .max_uri_handlers = 8,            \
+    }
+
+typedef enum {
+    HTTP_GET = 1,
+    HTTP_POST = 3,
+} httpd_method_t;
+
+typedef enum {
+    HTTPD_400_BAD_REQUEST,
+    HTTPD_404_NOT_FOUND,
+    HTTPD_500_INTERNAL_SERVER_ERROR,
+} httpd_err_code_t;
+
+typedef struct httpd_req {
+    const char *uri;
+    int method;
+    void *user_ctx;
+
+    /* Stand-in request inputs. */
+    httpd_handle_t handle;
+    const char *query;
+    const char *if_none_match;
+    int sockfd; /* -1: body captured below */
+    bool async; /* an async copy owns sockfd */
+
+    /* Stand-in response capture. */
+    const char *status;
+    const char *content_type;
+    const char *pending_names[HTTPD_STANDIN_MAX_HEADERS];
+    const char *pending_values[HTTPD_STANDIN_MAX_HEADERS];
+    size_t pending_count;
+    char header_names[HTTPD_STANDIN_MAX_HEADERS][32];
+    char header_values[HTTPD_STANDIN_MAX_HEADERS][HTTPD_STANDIN_HEADER_LEN];
+    size_t header_count;
+    bool headers_sent;
+    char body[HTTPD_STANDIN_BODY_LEN];
+    size_t body_len;
+    unsigned chunks;
+    bool chunked;
+    bool complete;
+} httpd_req_t;
+
+typedef struct httpd_uri {
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+} httpd_uri_t;
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler);
+esp_err_t httpd_resp_set_type(httpd_req_t *req, const char *type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *req, const char *field, const char *value);
+esp_err_t httpd_resp_set_status(httpd_req_t *req, const char *status);
+esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg);
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *req, char *buf, size_t buf_len);
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *req, const char *field, char *val, size_t val_size);
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *req, httpd_req_t **out);
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *req);
+int httpd_req_to_sockfd(httpd_req_t *req);
+
+/* Test side. */
+httpd_handle_t httpd_standin_create(void);
+void httpd_standin_destroy(httpd_handle_t handle);
+esp_err_t httpd_standin_request(httpd_handle_t handle,
+                                const char *path_and_query,
+                                const char *if_none_match,
+                                httpd_req_t *req);
+/*
+ * out_client_fd gets the client end; the caller closes it. ESP_FAIL with
+ * *out_client_fd -1 if the socket table refused the connection.
+ */
+esp_err_t httpd_standin_connect(httpd_handle_t handle,
+                                const char *path_and_query,
+                                size_t send_buffer_len,
+                                int *out_client_fd,
+                                httpd_req_t *req);
+const char *httpd_standin_header(const httpd_req_t *req, const char *name);
+
+/* Async copies begun and not yet completed. */
+int httpd_standin_open_async(void);
+/* Sockets in the table; sockets closed by the peer are reaped first. */
+int httpd_standin_open_sockets(httpd_handle_t handle);
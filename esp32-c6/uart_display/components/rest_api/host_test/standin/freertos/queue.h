@@ -0,0 +1,5 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
@@ -0,0 +1,456 @@
+/*
+ * httpd_standin.c
+ *
+ * Host stand-in for the parts of esp_http_server used by rest_routes.c.
+ */
+
+#include "esp_http_server.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define STANDIN_SEND_TIMEOUT_S 5 /* httpd send_wait_timeout default */
+
+typedef struct {
+    int fd;                /* server end */
+    uint32_t last_request; /* LRU stamp: the socket's latest request */
+    bool async;            /* an async copy owns fd and closes it */
+} standin_socket_t;
+
+typedef struct {
+    httpd_uri_t handlers[HTTPD_STANDIN_MAX_HANDLERS];
+    size_t count;
+
+    /* Socket table; httpd_start() servers only. */
+    bool track_sockets;
+    uint16_t max_open_sockets;
+    bool lru_purge;
+    pthread_mutex_t lock;
+    standin_socket_t sockets[HTTPD_STANDIN_MAX_SOCKETS];
+    size_t socket_count;
+    uint32_t request_clock;
+} standin_server_t;
+
+static atomic_int s_open_async;
+
+static void standin_commit_headers(httpd_req_t *req)
+{
+    if (req->headers_sent) {
+        return;
+    }
+    req->headers_sent = true;
+    if (req->status == NULL) {
+        req->status = "200 OK";
+    }
+    for (size_t i = 0; i < req->pending_count; ++i) {
+        strlcpy(req->header_names[i], req->pending_names[i], sizeof(req->header_names[i]));
+        strlcpy(req->header_values[i], req->pending_values[i], sizeof(req->header_values[i]));
+    }
+    req->header_count = req->pending_count;
+}
+
+static esp_err_t standin_append(httpd_req_t *req, const char *buf, size_t len)
+{
+    if (req->sockfd >= 0 && !req->complete) {
+        while (len > 0U) {
+            const ssize_t sent = send(req->sockfd, buf, len, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return ESP_FAIL;
+            }
+            buf += sent;
+            len -= (size_t)sent;
+        }
+        return ESP_OK;
+    }
+    if (req->complete || req->body_len + len > sizeof(req->body)) {
+        return ESP_FAIL;
+    }
+    memcpy(&req->body[req->body_len], buf, len);
+    req->body_len += len;
+    return ESP_OK;
+}
+
+httpd_handle_t httpd_standin_create(void)
+{
+    return calloc(1, sizeof(standin_server_t));
+}
+
+void httpd_standin_destroy(httpd_handle_t handle)
+{
+    standin_server_t *server = (standin_server_t *)handle;
+    if (server != NULL && server->track_sockets) {
+        for (size_t i = 0; i < server->socket_count; ++i) {
+            if (!server->sockets[i].async) {
+                (void)close(server->sockets[i].fd);
+            }
+        }
+        (void)pthread_mutex_destroy(&server->lock);
+    }
+    free(server);
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    if (handle == NULL || config == NULL || config->max_open_sockets > HTTPD_STANDIN_MAX_SOCKETS) {
+        return ESP_FAIL;
+    }
+    standin_server_t *server = calloc(1, sizeof(standin_server_t));
+    if (server == NULL) {
+        return ESP_FAIL;
+    }
+    server->track_sockets = true;
+    server->max_open_sockets = config->max_open_sockets;
+    server->lru_purge = config->lru_purge_enable;
+    (void)pthread_mutex_init(&server->lock, NULL);
+    *handle = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    httpd_standin_destroy(handle);
+    return ESP_OK;
+}
+
+static void standin_remove_socket_locked(standin_server_t *server, size_t index)
+{
+    server->sockets[index] = server->sockets[server->socket_count - 1U];
+    server->socket_count--;
+}
+
+/* Like the server's select loop: a keep-alive socket the client closed is dropped. */
+static void standin_reap_locked(standin_server_t *server)
+{
+    for (size_t i = 0; i < server->socket_count;) {
+        char byte;
+        if (!server->sockets[i].async &&
+            recv(server->sockets[i].fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+            (void)close(server->sockets[i].fd);
+            standin_remove_socket_locked(server, i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+/* Takes a table slot for fd, purging the LRU socket if allowed; false if refused. */
+static bool standin_accept(standin_server_t *server, int fd)
+{
+    (void)pthread_mutex_lock(&server->lock);
+    standin_reap_locked(server);
+    if (server->socket_count >= server->max_open_sockets) {
+        if (!server->lru_purge || server->socket_count == 0U) {
+            (void)pthread_mutex_unlock(&server->lock);
+            return false;
+        }
+        size_t oldest = 0U;
+        for (size_t i = 1; i < server->socket_count; ++i) {
+            if (server->sockets[i].last_request < server->sockets[oldest].last_request) {
+                oldest = i;
+            }
+        }
+        /* An async owner still holds the fd: cut it off, let the owner close it. */
+        if (server->sockets[oldest].async) {
+            (void)shutdown(server->sockets[oldest].fd, SHUT_RDWR);
+        } else {
+            (void)close(server->sockets[oldest].fd);
+        }
+        standin_remove_socket_locked(server, oldest);
+    }
+    server->sockets[server->socket_count++] = (standin_socket_t){
+        .fd = fd,
+        .last_request = ++server->request_clock,
+    };
+    (void)pthread_mutex_unlock(&server->lock);
+    return true;
+}
+
+static void standin_mark_async(standin_server_t *server, int fd)
+{
+    (void)pthread_mutex_lock(&server->lock);
+    for (size_t i = 0; i < server->socket_count; ++i) {
+        if (server->sockets[i].fd == fd) {
+            server->sockets[i].async = true;
+        }
+    }
+    (void)pthread_mutex_unlock(&server->lock);
+}
+
+static void standin_release(standin_server_t *server, int fd)
+{
+    (void)pthread_mutex_lock(&server->lock);
+    for (size_t i = 0; i < server->socket_count; ++i) {
+        if (server->sockets[i].fd == fd) {
+            standin_remove_socket_locked(server, i);
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&server->lock);
+}
+
+int httpd_standin_open_sockets(httpd_handle_t handle)
+{
+    standin_server_t *server = (standin_server_t *)handle;
+    (void)pthread_mutex_lock(&server->lock);
+    standin_reap_locked(server);
+    const int count = (int)server->socket_count;
+    (void)pthread_mutex_unlock(&server->lock);
+    return count;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    standin_server_t *server = (standin_server_t *)handle;
+    if (server == NULL || uri_handler == NULL || server->count >= HTTPD_STANDIN_MAX_HANDLERS) {
+        return ESP_FAIL;
+    }
+    server->handlers[server->count++] = *uri_handler;
+    return ESP_OK;
+}
+
+static esp_err_t standin_dispatch(standin_server_t *server,
+                                  const char *path_and_query,
+                                  const char *if_none_match,
+                                  int sockfd,
+                                  httpd_req_t *req)
+{
+    memset(req, 0, sizeof(*req));
+    req->handle = server;
+    req->method = HTTP_GET;
+    req->uri = path_and_query;
+    req->if_none_match = if_none_match;
+    req->sockfd = sockfd;
+
+    const char *question = strchr(path_and_query, '?');
+    const size_t path_len = (question != NULL) ? (size_t)(question - path_and_query) : strlen(path_and_query);
+    req->query = (question != NULL) ? question + 1 : NULL;
+
+    for (size_t i = 0; i < server->count; ++i) {
+        const httpd_uri_t *entry = &server->handlers[i];
+        if (strlen(entry->uri) == path_len && strncmp(entry->uri, path_and_query, path_len) == 0 &&
+            (int)entry->method == req->method) {
+            req->user_ctx = entry->user_ctx;
+            return entry->handler(req);
+        }
+    }
+
+    return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "not found");
+}
+
+esp_err_t httpd_standin_request(httpd_handle_t handle,
+                                const char *path_and_query,
+                                const char *if_none_match,
+                                httpd_req_t *req)
+{
+    return standin_dispatch((standin_server_t *)handle, path_and_query, if_none_match, -1, req);
+}
+
+esp_err_t httpd_standin_connect(httpd_handle_t handle,
+                                const char *path_and_query,
+                                size_t send_buffer_len,
+                                int *out_client_fd,
+                                httpd_req_t *req)
+{
+    standin_server_t *server = (standin_server_t *)handle;
+    int fds[2];
+    *out_client_fd = -1;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return ESP_FAIL;
+    }
+    if (server->track_sockets && !standin_accept(server, fds[0])) {
+        (void)close(fds[0]);
+        (void)close(fds[1]);
+        return ESP_FAIL;
+    }
+
+    const int sndbuf = (int)send_buffer_len;
+    const struct timeval timeout = { .tv_sec = STANDIN_SEND_TIMEOUT_S, .tv_usec = 0 };
+    (void)setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    (void)setsockopt(fds[0], SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    *out_client_fd = fds[1];
+
+    const esp_err_t err = standin_dispatch(server, path_and_query, NULL, fds[0], req);
+    if (server->track_sockets) {
+        if (req->async) {
+            standin_mark_async(server, fds[0]);
+        }
+        /* Otherwise the socket stays open for the client's next request. */
+    } else if (!req->async) {
+        (void)close(fds[0]); /* response done: httpd closes (or reuses) the socket */
+    }
+    return err;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *req)
+{
+    return (req != NULL) ? req->sockfd : -1;
+}
+
+int httpd_standin_open_async(void)
+{
+    return atomic_load(&s_open_async);
+}
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *req, httpd_req_t **out)
+{
+    httpd_req_t *copy = malloc(sizeof(*copy));
+    if (copy == NULL) {
+        return ESP_FAIL;
+    }
+    *copy = *req;
+    req->async = true;
+    copy->uri = NULL; /* the caller's strings do not outlive the handler */
+    copy->query = NULL;
+    copy->if_none_match = NULL;
+    atomic_fetch_add(&s_open_async, 1);
+    *out = copy;
+    return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *req)
+{
+    if (req == NULL) {
+        return ESP_FAIL;
+    }
+    atomic_fetch_sub(&s_open_async, 1);
+    standin_server_t *server = (standin_server_t *)req->handle;
+    if (req->sockfd >= 0) {
+        if (server != NULL && server->track_sockets) {
+            standin_release(server, req->sockfd);
+        }
+        (void)close(req->sockfd);
+    }
+    free(req);
+    return ESP_OK;
+}
+
+const char *httpd_standin_header(const httpd_req_t *req, const char *name)
+{
+    for (size_t i = 0; i < req->header_count; ++i) {
+        if (strcasecmp(req->header_names[i], name) == 0) {
+            return req->header_values[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *req, const char *type)
+{
+    req->content_type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *req, const char *field, const char *value)
+{
+    if (req->headers_sent || req->pending_count >= HTTPD_STANDIN_MAX_HEADERS) {
+        return ESP_FAIL;
+    }
+    req->pending_names[req->pending_count] = field;
+    req->pending_values[req->pending_count] = value;
+    req->pending_count++;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *req, const char *status)
+{
+    req->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, ssize_t buf_len)
+{
+    if (req->headers_sent) {
+        return ESP_FAIL;
+    }
+    standin_commit_headers(req);
+    if (buf != NULL) {
+        const size_t len = (buf_len == HTTPD_RESP_USE_STRLEN) ? strlen(buf) : (size_t)buf_len;
+        if (standin_append(req, buf, len) != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
+    req->complete = true;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len)
+{
+    if (req->headers_sent && !req->chunked) {
+        return ESP_FAIL;
+    }
+    standin_commit_headers(req);
+    req->chunked = true;
+    if (buf == NULL || buf_len == 0) {
+        req->complete = true;
+        return ESP_OK;
+    }
+
+    const size_t len = (buf_len == HTTPD_RESP_USE_STRLEN) ? strlen(buf) : (size_t)buf_len;
+    req->chunks++;
+    return standin_append(req, buf, len);
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    switch (error) {
+    case HTTPD_400_BAD_REQUEST:
+        req->status = "400 Bad Request";
+        break;
+    case HTTPD_404_NOT_FOUND:
+        req->status = "404 Not Found";
+        break;
+    default:
+        req->status = "500 Internal Server Error";
+        break;
+    }
+    req->content_type = "text/html";
+    return httpd_resp_send(req, msg, HTTPD_RESP_USE_STRLEN);
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    if (req->query == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (strlcpy(buf, req->query, buf_len) >= buf_len) {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    return ESP_OK;
+}
+
+/* Same contract as the real one: no URL decoding, truncation reported. */
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    const size_t key_len = strlen(key);
+    const char *p = qry;
+    while (p != NULL && *p != '\0') {
+        const char *amp = strchr(p, '&');
+        const size_t pair_len = (amp != NULL) ? (size_t)(amp - p) : strlen(p);
+        if (pair_len > key_len && strncmp(p, key, key_len) == 0 && p[key_len] == '=') {
+            const size_t value_len = pair_len - key_len - 1U;
+            const size_t copy = (value_len < val_size - 1U) ? value_len : val_size - 1U;
+            memcpy(val, p + key_len + 1U, copy);
+            val[copy] = '\0';
+            return (copy < value_len) ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+        }
+        p = (amp != NULL) ? amp + 1 : NULL;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *req, const char *field, char *val, size_t val_size)
+{
+    if (strcasecmp(field, "If-None-Match") != 0 || req->if_none_match == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (strlcpy(val, req->if_none_match, val_size) >= val_size) {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,157 @@
+/*
+ * idf_standin.c
+ *
+ * Host stand-ins for the FreeRTOS/ESP-IDF calls made by system_snapshot and
+ * rest_api. Tasks are never started (tests run the task bodies' pieces on
+ * their own threads); mutexes are real pthread mutexes and a tick is 1 ms.
+ */
+
+#include "idf_standin.h"
+
+#include "esp_err.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t s_now_us;
+
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    const size_t len = strlen(src);
+    if (size > 0U) {
+        const size_t copy = (len < size - 1U) ? len : size - 1U;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return len;
+}
+
+void idf_standin_set_time_us(int64_t now_us)
+{
+    s_now_us = now_us;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    return (code == ESP_OK) ? "ESP_OK" : "ESP_FAIL";
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return 200000U;
+}
+
+uint32_t esp_random(void)
+{
+    return 0x5eedc0deU;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    (void)ap_info;
+    return ESP_FAIL;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0U) {
+        sched_yield();
+        return;
+    }
+    usleep((useconds_t)ticks * 1000U);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t)((uint64_t)now.tv_sec * 1000U + (uint64_t)now.tv_nsec / 1000000U);
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    *previous_wake += increment;
+    const TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(*previous_wake - now) > 0) {
+        vTaskDelay(*previous_wake - now);
+    }
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    (void)task;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    (void)clear_on_exit;
+    vTaskDelay(ticks);
+    return 0U;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out_handle)
+{
+    (void)fn;
+    (void)name;
+    (void)stack;
+    (void)arg;
+    (void)priority;
+    (void)out_handle;
+    return pdFALSE;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *out_handle, BaseType_t core)
+{
+    (void)core;
+    return xTaskCreate(fn, name, stack, arg, priority, out_handle);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    (void)queue;
+    (void)item;
+    (void)ticks;
+    return pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    if (pthread_mutex_init(&buffer->mutex, NULL) != 0) {
+        return NULL;
+    }
+    return buffer;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks)
+{
+    (void)ticks;
+    return (pthread_mutex_lock(&((StaticSemaphore_t *)mutex)->mutex) == 0) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex)
+{
+    return (pthread_mutex_unlock(&((StaticSemaphore_t *)mutex)->mutex) == 0) ? pdTRUE : pdFALSE;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+ * idf_standin.h
+ *
+ * Force-included into every host_test source: the ESP-IDF newlib extras the
+ * component code relies on, plus hooks tests use to drive the stand-ins.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+size_t strlcpy(char *dst, const char *src, size_t size);
+
+/* Value returned by esp_timer_get_time() / esp_get_free_heap_size(). */
+void idf_standin_set_time_us(int64_t now_us);
@@ -0,0 +1,201 @@
+/*
+ * test_rest_routes.c
+ *
+ * Host test: drives the real route handlers through the stand-in httpd and
+ * checks the /api/v1/snapshot caching contract (ETag, 304, field subsets)
+ * plus the streaming paths of the older routes and the /api/v1/boot report.
+ */
+
+#include "boot_report.h"
+#include "esp_http_server.h"
+#include "idf_standin.h"
+#include "rest_api.h"
+#include "rest_routes.h"
+#include "snapshot_history.h"
+#include "system_snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static httpd_req_t s_req;
+static char s_etag[REST_API_ETAG_LEN];
+
+static const char *body(const httpd_req_t *req)
+{
+    static char text[HTTPD_STANDIN_BODY_LEN + 1];
+    memcpy(text, req->body, req->body_len);
+    text[req->body_len] = '\0';
+    return text;
+}
+
+static void seed_snapshot(void)
+{
+    system_snapshot_init();
+    system_snapshot_update_time(1726000000, "2024-09-11T08:12:00Z");
+    system_snapshot_update_temperature(21.25f);
+    system_snapshot_update_metrics(123456U, 654321U, -45, true);
+}
+
+static void test_snapshot_fields_and_etag(httpd_handle_t server)
+{
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time,temperature", NULL, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(!s_req.chunked);
+
+    char expected[160];
+    snprintf(expected, sizeof(expected),
+             "{\"generation\":%u,\"iso8601\":\"2024-09-11T08:12:00Z\",\"epoch\":1726000000,\"celsius\":21.25}",
+             (unsigned)system_snapshot_fields_generation(SYSTEM_SNAPSHOT_FIELD_TIME | SYSTEM_SNAPSHOT_FIELD_TEMPERATURE));
+    CHECK(strcmp(body(&s_req), expected) == 0);
+
+    const char *etag = httpd_standin_header(&s_req, "ETag");
+    CHECK(etag != NULL && etag[0] == '"');
+    CHECK(httpd_standin_header(&s_req, "Cache-Control") != NULL);
+    (void)strlcpy(s_etag, (etag != NULL) ? etag : "", sizeof(s_etag));
+
+    /* Same fields, URL-encoded separator: same validator. */
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time%2Ctemperature", s_etag, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "304 Not Modified") == 0);
+    CHECK(s_req.body_len == 0U);
+}
+
+static void test_snapshot_not_modified_until_field_changes(httpd_handle_t server)
+{
+    /* Uptime/heap churn must not invalidate a time+temperature poll. */
+    system_snapshot_update_metrics(124456U, 654000U, -47, true);
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time,temperature", s_etag, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "304 Not Modified") == 0);
+
+    char weak[REST_API_ETAG_LEN + 16];
+    snprintf(weak, sizeof(weak), "\"other\", W/%s", s_etag);
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time,temperature", weak, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "304 Not Modified") == 0);
+
+    system_snapshot_update_temperature(22.5f);
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time,temperature", s_etag, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(strstr(body(&s_req), "\"celsius\":22.50") != NULL);
+    const char *etag = httpd_standin_header(&s_req, "ETag");
+    CHECK(etag != NULL && strcmp(etag, s_etag) != 0);
+
+    /* A different subset never shares a validator. */
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot?fields=time", etag, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+}
+
+static void test_snapshot_rejects_bad_fields(httpd_handle_t server)
+{
+    static const char *const bad[] = {
+        "/api/v1/snapshot?fields=time,bogus",
+        "/api/v1/snapshot?fields=",
+        "/api/v1/snapshot?fields=time,,heap",
+    };
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+        CHECK(httpd_standin_request(server, bad[i], NULL, &s_req) == ESP_OK);
+        CHECK(strcmp(s_req.status, "400 Bad Request") == 0);
+    }
+
+    CHECK(httpd_standin_request(server, "/api/v1/snapshot", NULL, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(strstr(body(&s_req), "\"wifi_rssi_dbm\":-47") != NULL);
+    CHECK(strstr(body(&s_req), "\"uptime_ms\":124456") != NULL);
+}
+
+static void test_status_unchanged(httpd_handle_t server)
+{
+    system_snapshot_t snapshot;
+    char expected[REST_API_STATUS_JSON_LEN];
+
+    system_snapshot_read(&snapshot);
+    CHECK(rest_api_build_status_json(&snapshot, expected, sizeof(expected)) > 0U);
+    CHECK(httpd_standin_request(server, "/api/v1/status", NULL, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(httpd_standin_header(&s_req, "ETag") == NULL);
+    CHECK(strcmp(body(&s_req), expected) == 0);
+}
+
+static void test_history_goes_chunked(httpd_handle_t server)
+{
+    for (uint32_t s = 0; s < SNAPSHOT_HISTORY_2S_POINTS * SNAPSHOT_HISTORY_2S_PERIOD_S; s += SNAPSHOT_HISTORY_2S_PERIOD_S) {
+        snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, s, (int32_t)(200000U + s));
+    }
+
+    CHECK(httpd_standin_request(server, "/api/v1/history?metric=heap&tier=2s", NULL, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(s_req.chunked && s_req.complete && s_req.chunks > 1U);
+    CHECK(s_req.body_len > 0U && s_req.body[s_req.body_len - 1U] == '}');
+}
+
+static bool stage_noop(void *ctx)
+{
+    (void)ctx;
+    return true;
+}
+
+static void test_boot_report(httpd_handle_t server)
+{
+    const boot_stage_t stages[] = {
+        { "lcd", stage_noop, NULL, 0U, BOOT_STAGE_MAIN },
+        { "wifi", stage_noop, NULL, 0U, BOOT_STAGE_WORKER },
+    };
+
+    idf_standin_set_time_us(1000);
+    boot_report_begin(stages, 2);
+    boot_report_stage_start(0, 0U);
+    boot_report_stage_start(1, 2U);
+    idf_standin_set_time_us(41000);
+    boot_report_stage_end(0, true);
+    boot_report_mark(BOOT_MILESTONE_FIRST_FRAME);
+    idf_standin_set_time_us(61000);
+    boot_report_stage_end(1, false);
+    boot_report_end();
+
+    CHECK(httpd_standin_request(server, "/api/v1/boot", NULL, &s_req) == ESP_OK);
+    CHECK(strcmp(s_req.status, "200 OK") == 0);
+    CHECK(strstr(body(&s_req), "\"first_frame_ms\":41,\"network_ms\":null") != NULL);
+    CHECK(strstr(body(&s_req), "\"stages_ms\":60,\"serial_ms\":100") != NULL);
+    CHECK(strstr(body(&s_req), "{\"name\":\"wifi\",\"worker\":2,\"start_us\":1000,"
+                               "\"duration_us\":60000,\"ok\":false}") != NULL);
+
+    /* The first mark wins. */
+    idf_standin_set_time_us(90000);
+    boot_report_mark(BOOT_MILESTONE_FIRST_FRAME);
+    boot_report_mark(BOOT_MILESTONE_NETWORK);
+    CHECK(httpd_standin_request(server, "/api/v1/boot", NULL, &s_req) == ESP_OK);
+    CHECK(strstr(body(&s_req), "\"first_frame_ms\":41,\"network_ms\":90") != NULL);
+}
+
+int main(void)
+{
+    httpd_handle_t server = httpd_standin_create();
+
+    seed_snapshot();
+    CHECK(rest_routes_register(server));
+
+    test_snapshot_fields_and_etag(server);
+    test_snapshot_not_modified_until_field_changes(server);
+    test_snapshot_rejects_bad_fields(server);
+    test_status_unchanged(server);
+    test_history_goes_chunked(server);
+    test_boot_report(server);
+
+    httpd_standin_destroy(server);
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_rest_routes: ok\n");
+    return EXIT_SUCCESS;
+}
@@ -7,7 +7,11 @@
  * No business logic or hardware access lives here.
  */
 
+#include "boot_report.h"
 #include "freertos/FreeRTOS.h"
+#include "rest_json.h"
+#include "rest_stream.h"
+#include "snapshot_history.h"
 #include "system_snapshot.h"
 
 #include <stdbool.h>
@@ -18,10 +22,24 @@
 extern "C" {
 #endif
 
+/* Buffer sizes for the rest_api_build_*_json() helpers; routes stream instead. */
 #define REST_API_TIME_JSON_LEN 96
 #define REST_API_TEMP_JSON_LEN 64
 #define REST_API_STATUS_JSON_LEN 160
 
+/*
+ * /api/v1/history?format=bin: this header, then `count` points of three
+ * little-endian int32 (min, max, avg); min > max marks a bucket without
+ * samples. Header fields are little-endian: u8 version, u8 metric, u8 tier,
+ * u8 reserved, u32 period_s, u32 newest_s (uptime), u16 count, u16 reserved.
+ */
+#define REST_API_HISTORY_VERSION 1U
+#define REST_API_HISTORY_HEADER_LEN 16U
+#define REST_API_HISTORY_POINT_LEN 12U
+
+/* "\"bbbbbbbb-gggggggg-ff\"" plus NUL: boot tag, fields generation, field mask. */
+#define REST_API_ETAG_LEN 24U
+
 #ifdef REST_API_ENABLE_TRACE
 #include "esp_log.h"
 #define REST_API_TRACE(fmt, ...) ESP_LOGI("REST_API", fmt, ##__VA_ARGS__)
@@ -34,12 +52,30 @@ typedef struct {
     uint32_t stack_size;
     UBaseType_t task_priority;
     BaseType_t core_id;
+    uint16_t max_open_sockets;      /* HTTP/1.1 connections kept open between polls */
+    bool lru_purge;                 /* close the least recently used one when full; off while streams run */
+    bool keep_alive;                /* TCP keep-alive probes reap vanished clients */
+    uint16_t keep_alive_idle_s;
+    uint16_t keep_alive_interval_s;
+    uint16_t keep_alive_count;
+    rest_stream_config_t stream;    /* /api/v1/stream; stream.max_clients 0 disables it */
 } rest_api_config_t;
 
 void rest_api_get_default_config(rest_api_config_t *config);
 bool rest_api_start(const rest_api_config_t *config);
 void rest_api_stop(void);
 
+/* The esp_http_server settings rest_api_start() uses; host tests start the stand-in with them. */
+void rest_api_get_httpd_config(const rest_api_config_t *config, httpd_config_t *out_config);
+
+/* Body writers shared by the routes and the fixed-buffer builders below. */
+void rest_api_write_time_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot);
+void rest_api_write_temperature_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot);
+void rest_api_write_status_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot);
+/* /api/v1/boot: milestones and per-stage timings; milestones not reached yet are null. */
+void rest_api_write_boot_json(rest_json_writer_t *writer, const boot_report_t *report);
+
+/* Return the length written (NUL-terminated), or 0 if out_len is too small. */
 size_t rest_api_build_time_json(const system_snapshot_t *snapshot,
                                 char *out_buf,
                                 size_t out_len);
@@ -49,6 +85,22 @@ size_t rest_api_build_temperature_json(const system_snapshot_t *snapshot,
 size_t rest_api_build_status_json(const system_snapshot_t *snapshot,
                                   char *out_buf,
                                   size_t out_len);
+void rest_api_write_snapshot_json(rest_json_writer_t *writer,
+                                  const system_snapshot_t *snapshot,
+                                  uint32_t fields,
+                                  uint32_t generation);
+
+/* "time,heap,..." -> SYSTEM_SNAPSHOT_FIELD_* mask; false on unknown or empty names. */
+bool rest_api_parse_snapshot_fields(const char *list, uint32_t *out_fields);
+void rest_api_format_etag(uint32_t boot_tag, uint32_t generation, uint32_t fields, char *out_buf, size_t out_len);
+bool rest_api_etag_matches(const char *if_none_match, const char *etag);
+
+size_t rest_api_build_history_header(snapshot_history_metric_t metric,
+                                     snapshot_history_tier_t tier,
+                                     uint32_t newest_s,
+                                     size_t count,
+                                     uint8_t *out_buf,
+                                     size_t out_len);
 
 #ifdef __cplusplus
 }
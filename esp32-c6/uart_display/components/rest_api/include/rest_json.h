@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * rest_json.h
+ *
+ * Allocation-free streaming JSON writer. Output goes into a caller-provided
+ * buffer; when it fills, the buffer is handed to a flush callback (e.g.
+ * httpd_resp_send_chunk) and reused, so response size is not limited by the
+ * buffer. Without a flush callback the buffer is the whole output and an
+ * overflow marks the writer failed. Numbers are formatted without printf.
+ *
+ * Commas and nesting are tracked by the writer: call rest_json_key() before
+ * each value inside an object, and just the value inside an array. Errors are
+ * sticky; check rest_json_ok() once at the end.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define REST_JSON_MAX_DEPTH 16U
+
+/* Return false to abort (e.g. the client went away). */
+typedef bool (*rest_json_flush_fn)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;          /* bytes buffered, not yet flushed */
+    size_t flushed;      /* bytes handed to flush so far */
+    rest_json_flush_fn flush;
+    void *ctx;
+    uint16_t comma_bits; /* bit n: container at depth n already has a member */
+    uint8_t depth;
+    bool after_key;
+    bool failed;
+} rest_json_writer_t;
+
+_Static_assert(REST_JSON_MAX_DEPTH <= 16U, "comma_bits holds one bit per level");
+
+void rest_json_init(rest_json_writer_t *writer, char *buf, size_t cap, rest_json_flush_fn flush, void *ctx);
+
+void rest_json_begin_object(rest_json_writer_t *writer);
+void rest_json_end_object(rest_json_writer_t *writer);
+void rest_json_begin_array(rest_json_writer_t *writer);
+void rest_json_end_array(rest_json_writer_t *writer);
+
+void rest_json_key(rest_json_writer_t *writer, const char *key);
+void rest_json_string(rest_json_writer_t *writer, const char *value);
+void rest_json_int(rest_json_writer_t *writer, int64_t value);
+void rest_json_uint(rest_json_writer_t *writer, uint64_t value);
+void rest_json_bool(rest_json_writer_t *writer, bool value);
+void rest_json_null(rest_json_writer_t *writer);
+
+/*
+ * Fixed-point: exactly `decimals` digits (max 6), rounded half away from
+ * zero. NaN and infinities are written as null.
+ */
+void rest_json_float(rest_json_writer_t *writer, double value, uint8_t decimals);
+
+/* Verbatim bytes, no separators or escaping: framing around a document (SSE). */
+void rest_json_raw(rest_json_writer_t *writer, const char *data, size_t len);
+
+/* Flushes buffered output (no-op without a flush callback). */
+bool rest_json_flush(rest_json_writer_t *writer);
+
+/* True if nothing failed and every container was closed. */
+bool rest_json_ok(const rest_json_writer_t *writer);
+
+/* Total bytes produced, flushed or not. */
+size_t rest_json_size(const rest_json_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+ * rest_stream.h
+ *
+ * Live telemetry over Server-Sent Events:
+ *
+ *   GET /api/v1/stream[?fields=time,temperature,heap,rssi&interval_ms=N]
+ *
+ * The response stays open and carries one `snapshot` event with every
+ * requested field, then `delta` events holding only the fields that changed,
+ * at most one per interval (never faster than the configured producer tick).
+ * Each event's `id` is the snapshot generation. An idle stream gets an SSE
+ * comment every REST_STREAM_KEEPALIVE_MS so dead peers are noticed.
+ *
+ * A producer task reads the snapshot once per tick and copies events into
+ * bounded per-client queues; a sender task drains them, one event per client
+ * per pass, skipping clients whose socket has no send space so one stalled
+ * reader does not hold up the rest. A full queue is collapsed into one event
+ * with the latest values and the union of changed fields (drop-to-latest):
+ * a slow client skips intermediate states but never misses that a field
+ * changed, and the producer never waits on a socket. A failed send closes
+ * the client.
+ *
+ * Streams hold an httpd socket each; rest_api_start() keeps max_clients below
+ * the server's max_open_sockets so polling clients still get a connection,
+ * and turns LRU purge off, which would otherwise close streams first.
+ */
+
+#include "esp_http_server.h"
+#include "freertos/FreeRTOS.h"
+#include "system_snapshot.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef REST_STREAM_MAX_CLIENTS
+#define REST_STREAM_MAX_CLIENTS 4U
+#endif
+#define REST_STREAM_QUEUE_DEPTH 4U
+#define REST_STREAM_MIN_INTERVAL_MS 100U
+#define REST_STREAM_MAX_INTERVAL_MS 60000U
+#define REST_STREAM_KEEPALIVE_MS 15000U
+#define REST_STREAM_FRAME_LEN 512U
+
+typedef enum {
+    REST_STREAM_EVENT_SNAPSHOT = 0, /* baseline: every requested field */
+    REST_STREAM_EVENT_DELTA,        /* only the fields that changed */
+    REST_STREAM_EVENT_KEEPALIVE,    /* SSE comment, no data */
+} rest_stream_event_kind_t;
+
+/* Transport for one client; the route uses httpd async requests. */
+typedef struct {
+    bool (*send)(void *conn, const char *data, size_t len);
+    bool (*writable)(void *conn); /* optional; false leaves the event queued */
+    void (*close)(void *conn);    /* called once, from the sender task */
+} rest_stream_transport_t;
+
+typedef struct {
+    uint32_t interval_ms; /* producer tick; a client's own interval is at least this */
+    uint8_t max_clients;  /* 0 disables the route */
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+} rest_stream_config_t;
+
+typedef struct {
+    uint32_t clients;
+    uint32_t clients_rejected; /* stream table full */
+    uint32_t clients_closed;   /* send failed or stream stopped */
+    uint32_t events_queued;
+    uint32_t events_sent;
+    uint32_t events_coalesced; /* queued events folded into a later one */
+} rest_stream_stats_t;
+
+void rest_stream_get_default_config(rest_stream_config_t *config);
+
+/* rest_stream_init() plus the producer and sender tasks. */
+bool rest_stream_start(const rest_stream_config_t *config);
+
+/* Closes every client; call before httpd_stop(). */
+void rest_stream_stop(void);
+
+bool rest_stream_register(httpd_handle_t server);
+
+void rest_stream_get_stats(rest_stream_stats_t *out_stats);
+
+/* Writes one SSE frame; returns its length, or 0 if out_len is too small. */
+size_t rest_stream_format_event(rest_stream_event_kind_t kind,
+                                uint32_t generation,
+                                uint32_t fields,
+                                const system_snapshot_t *snapshot,
+                                char *out_buf,
+                                size_t out_len);
+
+/*
+ * The pieces the tasks run, public so host tests can drive them from their
+ * own threads: init resets the client table without starting tasks, publish
+ * is one producer tick (true if the sender has work), drain is one sender
+ * pass (true while a writable client still has events).
+ */
+bool rest_stream_init(const rest_stream_config_t *config);
+bool rest_stream_add_client(void *conn,
+                            const rest_stream_transport_t *transport,
+                            uint32_t fields,
+                            uint32_t interval_ms);
+bool rest_stream_publish(uint32_t now_ms);
+bool rest_stream_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,12 +9,18 @@
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "rest_routes.h"
+#include "rest_stream.h"
 
 static const char *TAG = "REST_API";
 
 #define REST_API_DEFAULT_PORT 80U
 #define REST_API_DEFAULT_STACK_SIZE 4096U
 #define REST_API_DEFAULT_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define REST_API_DEFAULT_MAX_OPEN_SOCKETS 7U
+#define REST_API_DEFAULT_KEEP_ALIVE_IDLE_S 10U
+#define REST_API_DEFAULT_KEEP_ALIVE_INTERVAL_S 5U
+#define REST_API_DEFAULT_KEEP_ALIVE_COUNT 3U
+#define REST_API_MAX_URI_HANDLERS 12U
 
 static httpd_handle_t s_server = NULL;
 
@@ -28,6 +34,41 @@ void rest_api_get_default_config(rest_api_config_t *config)
     config->stack_size = REST_API_DEFAULT_STACK_SIZE;
     config->task_priority = REST_API_DEFAULT_TASK_PRIORITY;
     config->core_id = tskNO_AFFINITY;
+    config->max_open_sockets = REST_API_DEFAULT_MAX_OPEN_SOCKETS;
+    config->lru_purge = false;
+    config->keep_alive = true;
+    config->keep_alive_idle_s = REST_API_DEFAULT_KEEP_ALIVE_IDLE_S;
+    config->keep_alive_interval_s = REST_API_DEFAULT_KEEP_ALIVE_INTERVAL_S;
+    config->keep_alive_count = REST_API_DEFAULT_KEEP_ALIVE_COUNT;
+    rest_stream_get_default_config(&config->stream);
+}
+
+void rest_api_get_httpd_config(const rest_api_config_t *config, httpd_config_t *out_config)
+{
+    if (config == NULL || out_config == NULL) {
+        return;
+    }
+
+    httpd_config_t server_config = HTTPD_DEFAULT_CONFIG();
+    server_config.server_port = config->server_port;
+    server_config.stack_size = config->stack_size;
+    server_config.task_priority = config->task_priority;
+    server_config.core_id = config->core_id;
+    server_config.max_uri_handlers = REST_API_MAX_URI_HANDLERS;
+
+    /*
+     * Dashboards poll over persistent connections; keep them open and probe
+     * so dead peers free their slot. A stream socket never sees a second
+     * request, so LRU purge would always evict a stream subscriber to make
+     * room for a poller: it is only allowed when streams are off.
+     */
+    server_config.max_open_sockets = config->max_open_sockets;
+    server_config.lru_purge_enable = config->lru_purge && config->stream.max_clients == 0U;
+    server_config.keep_alive_enable = config->keep_alive;
+    server_config.keep_alive_idle = config->keep_alive_idle_s;
+    server_config.keep_alive_interval = config->keep_alive_interval_s;
+    server_config.keep_alive_count = config->keep_alive_count;
+    *out_config = server_config;
 }
 
 bool rest_api_start(const rest_api_config_t *config)
@@ -40,11 +81,19 @@ bool rest_api_start(const rest_api_config_t *config)
         return true;
     }
 
-    httpd_config_t server_config = HTTPD_DEFAULT_CONFIG();
-    server_config.server_port = config->server_port;
-    server_config.stack_size = config->stack_size;
-    server_config.task_priority = config->task_priority;
-    server_config.core_id = config->core_id;
+    /* Streams never take the last socket: pollers always have one to connect on. */
+    rest_api_config_t effective = *config;
+    if (effective.stream.max_clients >= effective.max_open_sockets) {
+        effective.stream.max_clients = (effective.max_open_sockets > 1U) ? (uint8_t)(effective.max_open_sockets - 1U) : 0U;
+        ESP_LOGW(TAG, "stream clients capped at %u of %u sockets", (unsigned)effective.stream.max_clients,
+                 (unsigned)effective.max_open_sockets);
+    }
+    if (effective.lru_purge && effective.stream.max_clients > 0U) {
+        ESP_LOGW(TAG, "lru_purge ignored: it would close stream sockets");
+    }
+
+    httpd_config_t server_config;
+    rest_api_get_httpd_config(&effective, &server_config);
 
     esp_err_t err = httpd_start(&s_server, &server_config);
     if (err != ESP_OK) {
@@ -53,7 +102,9 @@ bool rest_api_start(const rest_api_config_t *config)
         return false;
     }
 
-    if (!rest_routes_register(s_server)) {
+    if (!rest_routes_register(s_server) || !rest_stream_start(&effective.stream) ||
+        !rest_stream_register(s_server)) {
+        rest_stream_stop();
         httpd_stop(s_server);
         s_server = NULL;
         return false;
@@ -69,6 +120,7 @@ void rest_api_stop(void)
         return;
     }
 
+    rest_stream_stop();
     httpd_stop(s_server);
     s_server = NULL;
     ESP_LOGI(TAG, "REST API stopped");
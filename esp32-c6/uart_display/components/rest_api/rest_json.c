@@ -0,0 +1,310 @@
+/*
+ * rest_json.c
+ *
+ * Allocation-free streaming JSON writer.
+ */
+
+#include "rest_json.h"
+
+#include <math.h>
+#include <string.h>
+
+#define REST_JSON_MAX_DECIMALS 6U
+#define REST_JSON_FIXED_LIMIT 9.0e18 /* |value * 10^decimals| must fit uint64 */
+
+static const uint32_t s_pow10[REST_JSON_MAX_DECIMALS + 1U] = { 1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U };
+static const char s_hex[] = "0123456789abcdef";
+
+static void json_put(rest_json_writer_t *writer, const char *data, size_t len)
+{
+    while (!writer->failed && len > 0U) {
+        size_t room = writer->cap - writer->len;
+        if (room == 0U) {
+            if (writer->flush == NULL || !rest_json_flush(writer)) {
+                writer->failed = true;
+                return;
+            }
+            room = writer->cap;
+        }
+
+        const size_t n = (len < room) ? len : room;
+        memcpy(&writer->buf[writer->len], data, n);
+        writer->len += n;
+        data += n;
+        len -= n;
+    }
+}
+
+static void json_put_char(rest_json_writer_t *writer, char c)
+{
+    /* Fast path: most writes are single characters with room to spare. */
+    if (!writer->failed && writer->len < writer->cap) {
+        writer->buf[writer->len++] = c;
+        return;
+    }
+    json_put(writer, &c, 1U);
+}
+
+/* Separator before a value or key at the current level. */
+static void json_prologue(rest_json_writer_t *writer)
+{
+    if (writer->after_key) {
+        writer->after_key = false;
+        return;
+    }
+    if (writer->depth == 0U) {
+        return;
+    }
+
+    const uint16_t bit = (uint16_t)(1U << (writer->depth - 1U));
+    if ((writer->comma_bits & bit) != 0U) {
+        json_put_char(writer, ',');
+    }
+    writer->comma_bits |= bit;
+}
+
+static void json_put_uint(rest_json_writer_t *writer, uint64_t value)
+{
+    char digits[20];
+    size_t n = 0U;
+
+    do {
+        digits[sizeof(digits) - 1U - n] = (char)('0' + (value % 10U));
+        value /= 10U;
+        n++;
+    } while (value != 0U);
+
+    json_put(writer, &digits[sizeof(digits) - n], n);
+}
+
+static void json_put_escaped(rest_json_writer_t *writer, const char *value)
+{
+    json_put_char(writer, '"');
+
+    const char *run = value;
+    for (const char *p = value; *p != '\0'; ++p) {
+        const unsigned char c = (unsigned char)*p;
+        if (c >= 0x20U && c != '"' && c != '\\') {
+            continue;
+        }
+
+        json_put(writer, run, (size_t)(p - run));
+        run = p + 1;
+
+        char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+        size_t escape_len = 2U;
+        switch (c) {
+        case '"':
+            escape[1] = '"';
+            break;
+        case '\\':
+            escape[1] = '\\';
+            break;
+        case '\n':
+            escape[1] = 'n';
+            break;
+        case '\r':
+            escape[1] = 'r';
+            break;
+        case '\t':
+            escape[1] = 't';
+            break;
+        default:
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = s_hex[c >> 4];
+            escape[5] = s_hex[c & 0x0FU];
+            escape_len = 6U;
+            break;
+        }
+        json_put(writer, escape, escape_len);
+    }
+    json_put(writer, run, strlen(run));
+
+    json_put_char(writer, '"');
+}
+
+static void json_open(rest_json_writer_t *writer, char c)
+{
+    json_prologue(writer);
+    if (writer->depth >= REST_JSON_MAX_DEPTH) {
+        writer->failed = true;
+        return;
+    }
+    writer->depth++;
+    writer->comma_bits &= (uint16_t)~(1U << (writer->depth - 1U));
+    json_put_char(writer, c);
+}
+
+static void json_close(rest_json_writer_t *writer, char c)
+{
+    if (writer->depth == 0U || writer->after_key) {
+        writer->failed = true;
+        return;
+    }
+    writer->depth--;
+    json_put_char(writer, c);
+}
+
+void rest_json_init(rest_json_writer_t *writer, char *buf, size_t cap, rest_json_flush_fn flush, void *ctx)
+{
+    if (writer == NULL) {
+        return;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->buf = buf;
+    writer->cap = cap;
+    writer->flush = flush;
+    writer->ctx = ctx;
+    writer->failed = (buf == NULL || cap == 0U);
+}
+
+void rest_json_begin_object(rest_json_writer_t *writer)
+{
+    json_open(writer, '{');
+}
+
+void rest_json_end_object(rest_json_writer_t *writer)
+{
+    json_close(writer, '}');
+}
+
+void rest_json_begin_array(rest_json_writer_t *writer)
+{
+    json_open(writer, '[');
+}
+
+void rest_json_end_array(rest_json_writer_t *writer)
+{
+    json_close(writer, ']');
+}
+
+void rest_json_key(rest_json_writer_t *writer, const char *key)
+{
+    if (key == NULL || writer->after_key || writer->depth == 0U) {
+        writer->failed = true;
+        return;
+    }
+
+    json_prologue(writer);
+    json_put_escaped(writer, key);
+    json_put_char(writer, ':');
+    writer->after_key = true;
+}
+
+void rest_json_string(rest_json_writer_t *writer, const char *value)
+{
+    json_prologue(writer);
+    if (value == NULL) {
+        json_put(writer, "null", 4U);
+        return;
+    }
+    json_put_escaped(writer, value);
+}
+
+void rest_json_int(rest_json_writer_t *writer, int64_t value)
+{
+    json_prologue(writer);
+    if (value < 0) {
+        json_put_char(writer, '-');
+        json_put_uint(writer, (uint64_t)0 - (uint64_t)value);
+        return;
+    }
+    json_put_uint(writer, (uint64_t)value);
+}
+
+void rest_json_uint(rest_json_writer_t *writer, uint64_t value)
+{
+    json_prologue(writer);
+    json_put_uint(writer, value);
+}
+
+void rest_json_bool(rest_json_writer_t *writer, bool value)
+{
+    json_prologue(writer);
+    if (value) {
+        json_put(writer, "true", 4U);
+    } else {
+        json_put(writer, "false", 5U);
+    }
+}
+
+void rest_json_null(rest_json_writer_t *writer)
+{
+    json_prologue(writer);
+    json_put(writer, "null", 4U);
+}
+
+void rest_json_float(rest_json_writer_t *writer, double value, uint8_t decimals)
+{
+    if (decimals > REST_JSON_MAX_DECIMALS) {
+        decimals = REST_JSON_MAX_DECIMALS;
+    }
+
+    const double scaled = value * (double)s_pow10[decimals];
+    if (isnan(scaled) || isinf(scaled) || scaled >= REST_JSON_FIXED_LIMIT || scaled <= -REST_JSON_FIXED_LIMIT) {
+        rest_json_null(writer);
+        return;
+    }
+
+    json_prologue(writer);
+
+    const bool negative = scaled < 0.0;
+    const uint64_t rounded = (uint64_t)((negative ? -scaled : scaled) + 0.5);
+    if (negative && rounded != 0U) {
+        json_put_char(writer, '-');
+    }
+
+    json_put_uint(writer, rounded / s_pow10[decimals]);
+    if (decimals == 0U) {
+        return;
+    }
+
+    char frac[REST_JSON_MAX_DECIMALS + 1U];
+    uint32_t rest = (uint32_t)(rounded % s_pow10[decimals]);
+    frac[0] = '.';
+    for (size_t i = decimals; i > 0U; --i) {
+        frac[i] = (char)('0' + (rest % 10U));
+        rest /= 10U;
+    }
+    json_put(writer, frac, (size_t)decimals + 1U);
+}
+
+void rest_json_raw(rest_json_writer_t *writer, const char *data, size_t len)
+{
+    if (data == NULL) {
+        writer->failed = true;
+        return;
+    }
+    json_put(writer, data, len);
+}
+
+bool rest_json_flush(rest_json_writer_t *writer)
+{
+    if (writer == NULL || writer->failed) {
+        return false;
+    }
+    if (writer->flush == NULL || writer->len == 0U) {
+        return true;
+    }
+
+    if (!writer->flush(writer->ctx, writer->buf, writer->len)) {
+        writer->failed = true;
+        return false;
+    }
+    writer->flushed += writer->len;
+    writer->len = 0U;
+    return true;
+}
+
+bool rest_json_ok(const rest_json_writer_t *writer)
+{
+    return writer != NULL && !writer->failed && writer->depth == 0U && !writer->after_key;
+}
+
+size_t rest_json_size(const rest_json_writer_t *writer)
+{
+    return (writer == NULL) ? 0U : writer->flushed + writer->len;
+}
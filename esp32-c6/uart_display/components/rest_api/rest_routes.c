@@ -2,134 +2,610 @@
  * rest_routes.c
  *
  * HTTP route registration and JSON serialization.
+ *
+ * Bodies are produced by rest_json writers over one static, MSS-sized
+ * buffer. A body that fits is sent with Content-Length in one call; larger
+ * bodies switch to chunked transfer as the buffer fills, so no route has an
+ * upper bound on its output.
+ *
+ * /api/v1/snapshot is the batched route: the ETag is the newest generation
+ * of the requested fields (plus a per-boot tag), so a poll whose fields did
+ * not change is answered 304 without reading or serializing the snapshot.
  */
 
 #include "rest_api.h"
 
+#include "boot_report.h"
 #include "esp_http_server.h"
+#include "esp_random.h"
+#include "rest_json.h"
+#include "sdkconfig.h"
+#include "snapshot_history.h"
 #include "system_snapshot.h"
 
-#include <inttypes.h>
-#include <stdio.h>
+#include <string.h>
+
+#ifdef CONFIG_LWIP_TCP_MSS
+#define REST_API_CHUNK_LEN CONFIG_LWIP_TCP_MSS
+#else
+#define REST_API_CHUNK_LEN 1440
+#endif
+
+#define REST_HISTORY_QUERY_LEN 64
+#define REST_HISTORY_PARAM_LEN 8
+#define REST_HISTORY_BIN_CHUNK_LEN 256
+#define REST_SNAPSHOT_QUERY_LEN 96
+#define REST_SNAPSHOT_FIELDS_LEN 64
+#define REST_IF_NONE_MATCH_LEN 96
+
+typedef struct {
+    httpd_req_t *req;
+    bool chunked;
+} rest_stream_t;
+
+typedef struct {
+    snapshot_history_metric_t metric;
+    snapshot_history_tier_t tier;
+    uint32_t newest_s;
+    size_t count;
+} rest_history_view_t;
+
+typedef struct {
+    const system_snapshot_t *snapshot;
+    uint32_t fields;
+    uint32_t generation;
+} rest_snapshot_view_t;
+
+typedef struct {
+    const char *name;
+    uint32_t field;
+} rest_field_name_t;
+
+static const rest_field_name_t s_field_names[] = {
+    { "time", SYSTEM_SNAPSHOT_FIELD_TIME },
+    { "temperature", SYSTEM_SNAPSHOT_FIELD_TEMPERATURE },
+    { "uptime", SYSTEM_SNAPSHOT_FIELD_UPTIME },
+    { "heap", SYSTEM_SNAPSHOT_FIELD_FREE_HEAP },
+    { "rssi", SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI },
+    { "connected", SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED },
+    { "wifi_link", SYSTEM_SNAPSHOT_FIELD_WIFI_LINK },
+    { "all", SYSTEM_SNAPSHOT_FIELD_ALL },
+};
+
+typedef void (*rest_json_body_fn)(rest_json_writer_t *writer, const void *arg);
+
+/* httpd runs handlers on one task, so one static copy of each is enough. */
+static char s_chunk[REST_API_CHUNK_LEN];
+static snapshot_history_point_t s_history_points[SNAPSHOT_HISTORY_MAX_POINTS];
+
+/* Generations restart at boot; this keeps old ETags from matching. */
+static uint32_t s_etag_boot_tag;
+
+static bool rest_stream_flush(void *ctx, const char *data, size_t len)
+{
+    rest_stream_t *stream = (rest_stream_t *)ctx;
+    stream->chunked = true;
+    return httpd_resp_send_chunk(stream->req, data, (ssize_t)len) == ESP_OK;
+}
 
-static esp_err_t rest_send_json(httpd_req_t *req, const char *payload, size_t len)
+static esp_err_t rest_send_json_stream(httpd_req_t *req, rest_json_body_fn body, const void *arg)
 {
     esp_err_t err = httpd_resp_set_type(req, "application/json");
     if (err != ESP_OK) {
         return err;
     }
 
-    return httpd_resp_send(req, payload, len);
+    rest_stream_t stream = { .req = req, .chunked = false };
+    rest_json_writer_t writer;
+    rest_json_init(&writer, s_chunk, sizeof(s_chunk), rest_stream_flush, &stream);
+    body(&writer, arg);
+
+    if (!stream.chunked) {
+        if (!rest_json_ok(&writer)) {
+            return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "json_error");
+        }
+        return httpd_resp_send(req, writer.buf, (ssize_t)writer.len);
+    }
+
+    /* Headers are gone; failing here drops the connection mid-body. */
+    if (!rest_json_ok(&writer) || !rest_json_flush(&writer)) {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
-size_t rest_api_build_time_json(const system_snapshot_t *snapshot,
-                                char *out_buf,
-                                size_t out_len)
+static size_t rest_build_into(rest_json_body_fn body, const void *arg, char *out_buf, size_t out_len)
 {
-    if (snapshot == NULL || out_buf == NULL || out_len == 0U) {
+    if (arg == NULL || out_buf == NULL || out_len == 0U) {
         return 0U;
     }
 
-    int len = snprintf(out_buf,
-                       out_len,
-                       "{\"iso8601\":\"%s\",\"epoch\":%" PRIi64 "}",
-                       snapshot->iso8601,
-                       snapshot->epoch_seconds);
-
-    if (len < 0 || (size_t)len >= out_len) {
+    /* One byte kept back for the terminator. */
+    rest_json_writer_t writer;
+    rest_json_init(&writer, out_buf, out_len - 1U, NULL, NULL);
+    body(&writer, arg);
+    if (!rest_json_ok(&writer)) {
+        out_buf[0] = '\0';
         return 0U;
     }
 
-    return (size_t)len;
+    out_buf[writer.len] = '\0';
+    return writer.len;
+}
+
+void rest_api_write_time_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot)
+{
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "iso8601");
+    rest_json_string(writer, snapshot->iso8601);
+    rest_json_key(writer, "epoch");
+    rest_json_int(writer, snapshot->epoch_seconds);
+    rest_json_end_object(writer);
+}
+
+void rest_api_write_temperature_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot)
+{
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "celsius");
+    rest_json_float(writer, snapshot->temperature_c, 2U);
+    rest_json_end_object(writer);
+}
+
+void rest_api_write_status_json(rest_json_writer_t *writer, const system_snapshot_t *snapshot)
+{
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "uptime_ms");
+    rest_json_uint(writer, snapshot->uptime_ms);
+    rest_json_key(writer, "free_heap_bytes");
+    rest_json_uint(writer, snapshot->free_heap_bytes);
+    rest_json_key(writer, "wifi_connected");
+    rest_json_bool(writer, snapshot->wifi_connected);
+    rest_json_key(writer, "wifi_rssi_dbm");
+    rest_json_int(writer, snapshot->wifi_rssi_dbm);
+    rest_json_end_object(writer);
+}
+
+static void rest_write_ms_or_null(rest_json_writer_t *writer, uint32_t us)
+{
+    if (us == 0U) {
+        rest_json_null(writer);
+    } else {
+        rest_json_uint(writer, us / 1000U);
+    }
+}
+
+void rest_api_write_boot_json(rest_json_writer_t *writer, const boot_report_t *report)
+{
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "first_frame_ms");
+    rest_write_ms_or_null(writer, report->milestone_us[BOOT_MILESTONE_FIRST_FRAME]);
+    rest_json_key(writer, "network_ms");
+    rest_write_ms_or_null(writer, report->milestone_us[BOOT_MILESTONE_NETWORK]);
+    rest_json_key(writer, "stages_ms");
+    rest_write_ms_or_null(writer, (report->graph_end_us != 0U) ? report->graph_end_us - report->graph_start_us : 0U);
+    rest_json_key(writer, "serial_ms");
+    rest_json_uint(writer, report->serial_us / 1000U);
+    rest_json_key(writer, "stages");
+    rest_json_begin_array(writer);
+    for (size_t i = 0; i < report->count; ++i) {
+        const boot_report_stage_t *stage = &report->stages[i];
+        rest_json_begin_object(writer);
+        rest_json_key(writer, "name");
+        rest_json_string(writer, stage->name);
+        rest_json_key(writer, "worker");
+        rest_json_uint(writer, stage->worker);
+        rest_json_key(writer, "start_us");
+        rest_json_uint(writer, stage->start_us);
+        rest_json_key(writer, "duration_us");
+        rest_json_uint(writer, stage->duration_us);
+        rest_json_key(writer, "ok");
+        if (stage->done) {
+            rest_json_bool(writer, stage->ok);
+        } else {
+            rest_json_null(writer);
+        }
+        rest_json_end_object(writer);
+    }
+    rest_json_end_array(writer);
+    rest_json_end_object(writer);
+}
+
+static void rest_time_body(rest_json_writer_t *writer, const void *arg)
+{
+    rest_api_write_time_json(writer, (const system_snapshot_t *)arg);
+}
+
+static void rest_temperature_body(rest_json_writer_t *writer, const void *arg)
+{
+    rest_api_write_temperature_json(writer, (const system_snapshot_t *)arg);
+}
+
+static void rest_status_body(rest_json_writer_t *writer, const void *arg)
+{
+    rest_api_write_status_json(writer, (const system_snapshot_t *)arg);
+}
+
+static void rest_boot_body(rest_json_writer_t *writer, const void *arg)
+{
+    rest_api_write_boot_json(writer, (const boot_report_t *)arg);
+}
+
+size_t rest_api_build_time_json(const system_snapshot_t *snapshot,
+                                char *out_buf,
+                                size_t out_len)
+{
+    return rest_build_into(rest_time_body, snapshot, out_buf, out_len);
 }
 
 size_t rest_api_build_temperature_json(const system_snapshot_t *snapshot,
                                        char *out_buf,
                                        size_t out_len)
 {
-    if (snapshot == NULL || out_buf == NULL || out_len == 0U) {
+    return rest_build_into(rest_temperature_body, snapshot, out_buf, out_len);
+}
+
+size_t rest_api_build_status_json(const system_snapshot_t *snapshot,
+                                  char *out_buf,
+                                  size_t out_len)
+{
+    return rest_build_into(rest_status_body, snapshot, out_buf, out_len);
+}
+
+size_t rest_api_build_history_header(snapshot_history_metric_t metric,
+                                     snapshot_history_tier_t tier,
+                                     uint32_t newest_s,
+                                     size_t count,
+                                     uint8_t *out_buf,
+                                     size_t out_len)
+{
+    if (out_buf == NULL || out_len < REST_API_HISTORY_HEADER_LEN || count > UINT16_MAX) {
         return 0U;
     }
 
-    int len = snprintf(out_buf,
-                       out_len,
-                       "{\"celsius\":%.2f}",
-                       (double)snapshot->temperature_c);
+    const uint32_t period_s = snapshot_history_tier_period_s(tier);
+    out_buf[0] = REST_API_HISTORY_VERSION;
+    out_buf[1] = (uint8_t)metric;
+    out_buf[2] = (uint8_t)tier;
+    out_buf[3] = 0U;
+    for (size_t i = 0; i < 4U; ++i) {
+        out_buf[4U + i] = (uint8_t)(period_s >> (8U * i));
+        out_buf[8U + i] = (uint8_t)(newest_s >> (8U * i));
+    }
+    out_buf[12] = (uint8_t)count;
+    out_buf[13] = (uint8_t)(count >> 8);
+    out_buf[14] = 0U;
+    out_buf[15] = 0U;
+    return REST_API_HISTORY_HEADER_LEN;
+}
 
-    if (len < 0 || (size_t)len >= out_len) {
-        return 0U;
+static size_t rest_history_put_point(const snapshot_history_point_t *point, uint8_t *out_buf)
+{
+    const int32_t values[3] = { point->min, point->max, point->avg };
+    for (size_t v = 0; v < 3U; ++v) {
+        for (size_t i = 0; i < 4U; ++i) {
+            out_buf[v * 4U + i] = (uint8_t)((uint32_t)values[v] >> (8U * i));
+        }
     }
+    return REST_API_HISTORY_POINT_LEN;
+}
 
-    return (size_t)len;
+static esp_err_t rest_history_send_binary(httpd_req_t *req, const rest_history_view_t *view)
+{
+    uint8_t chunk[REST_HISTORY_BIN_CHUNK_LEN];
+    size_t used = rest_api_build_history_header(view->metric, view->tier, view->newest_s, view->count,
+                                                chunk, sizeof(chunk));
+
+    esp_err_t err = httpd_resp_set_type(req, "application/octet-stream");
+    for (size_t i = 0; err == ESP_OK && i < view->count; ++i) {
+        if (used + REST_API_HISTORY_POINT_LEN > sizeof(chunk)) {
+            err = httpd_resp_send_chunk(req, (const char *)chunk, (ssize_t)used);
+            used = 0U;
+        }
+        used += rest_history_put_point(&s_history_points[i], &chunk[used]);
+    }
+    if (err == ESP_OK && used > 0U) {
+        err = httpd_resp_send_chunk(req, (const char *)chunk, (ssize_t)used);
+    }
+    if (err == ESP_OK) {
+        err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return err;
 }
 
-size_t rest_api_build_status_json(const system_snapshot_t *snapshot,
-                                  char *out_buf,
-                                  size_t out_len)
+static void rest_history_body(rest_json_writer_t *writer, const void *arg)
 {
-    if (snapshot == NULL || out_buf == NULL || out_len == 0U) {
-        return 0U;
+    const rest_history_view_t *view = (const rest_history_view_t *)arg;
+
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "metric");
+    rest_json_string(writer, snapshot_history_metric_name(view->metric));
+    rest_json_key(writer, "tier");
+    rest_json_string(writer, snapshot_history_tier_name(view->tier));
+    rest_json_key(writer, "period_s");
+    rest_json_uint(writer, snapshot_history_tier_period_s(view->tier));
+    rest_json_key(writer, "newest_s");
+    rest_json_uint(writer, view->newest_s);
+    rest_json_key(writer, "points");
+    rest_json_begin_array(writer);
+    for (size_t i = 0; i < view->count; ++i) {
+        const snapshot_history_point_t *point = &s_history_points[i];
+        /* Gaps are null so clients keep the time axis. */
+        if (SNAPSHOT_HISTORY_POINT_EMPTY(point)) {
+            rest_json_null(writer);
+            continue;
+        }
+        rest_json_begin_array(writer);
+        rest_json_int(writer, point->min);
+        rest_json_int(writer, point->max);
+        rest_json_int(writer, point->avg);
+        rest_json_end_array(writer);
     }
+    rest_json_end_array(writer);
+    rest_json_end_object(writer);
+}
 
-    const char *wifi_connected = snapshot->wifi_connected ? "true" : "false";
+/* httpd_query_key_value() does not URL-decode; browsers send ',' as %2C. */
+static size_t rest_field_separator_len(const char *p)
+{
+    if (p[0] == ',') {
+        return 1U;
+    }
+    if (p[0] == '%' && p[1] == '2' && (p[2] == 'C' || p[2] == 'c')) {
+        return 3U;
+    }
+    return 0U;
+}
 
-    int len = snprintf(out_buf,
-                       out_len,
-                       "{\"uptime_ms\":%" PRIu32
-                       ",\"free_heap_bytes\":%" PRIu32
-                       ",\"wifi_connected\":%s,\"wifi_rssi_dbm\":%d}",
-                       snapshot->uptime_ms,
-                       snapshot->free_heap_bytes,
-                       wifi_connected,
-                       (int)snapshot->wifi_rssi_dbm);
+bool rest_api_parse_snapshot_fields(const char *list, uint32_t *out_fields)
+{
+    if (list == NULL || out_fields == NULL) {
+        return false;
+    }
 
-    if (len < 0 || (size_t)len >= out_len) {
-        return 0U;
+    uint32_t fields = 0U;
+    const char *name = list;
+    while (*name != '\0') {
+        size_t len = 0U;
+        while (name[len] != '\0' && rest_field_separator_len(&name[len]) == 0U) {
+            len++;
+        }
+
+        bool known = false;
+        for (size_t i = 0; i < sizeof(s_field_names) / sizeof(s_field_names[0]); ++i) {
+            if (strlen(s_field_names[i].name) == len && strncmp(s_field_names[i].name, name, len) == 0) {
+                fields |= s_field_names[i].field;
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+
+        name += len;
+        name += rest_field_separator_len(name);
     }
 
-    return (size_t)len;
+    if (fields == 0U) {
+        return false;
+    }
+    *out_fields = fields;
+    return true;
 }
 
-static esp_err_t rest_time_get_handler(httpd_req_t *req)
+void rest_api_format_etag(uint32_t boot_tag, uint32_t generation, uint32_t fields, char *out_buf, size_t out_len)
 {
-    system_snapshot_t snapshot;
-    char buffer[REST_API_TIME_JSON_LEN];
+    static const char hex[] = "0123456789abcdef";
+    const uint32_t parts[3] = { boot_tag, generation, fields & SYSTEM_SNAPSHOT_FIELD_ALL };
+
+    if (out_buf == NULL || out_len < REST_API_ETAG_LEN) {
+        if (out_buf != NULL && out_len > 0U) {
+            out_buf[0] = '\0';
+        }
+        return;
+    }
+
+    /* "bbbbbbbb-gggggggg-ff" */
+    size_t pos = 0U;
+    out_buf[pos++] = '"';
+    for (size_t p = 0; p < 3U; ++p) {
+        const size_t digits = (p == 2U) ? 2U : 8U;
+        for (size_t d = digits; d > 0U; --d) {
+            out_buf[pos++] = hex[(parts[p] >> (4U * (d - 1U))) & 0x0FU];
+        }
+        out_buf[pos++] = (p == 2U) ? '"' : '-';
+    }
+    out_buf[pos] = '\0';
+}
+
+bool rest_api_etag_matches(const char *if_none_match, const char *etag)
+{
+    if (if_none_match == NULL || etag == NULL) {
+        return false;
+    }
+
+    const size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    while (*p != '\0') {
+        while (*p == ' ' || *p == ',') {
+            p++;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        /* Weak comparison (RFC 9110 13.1.2): ignore a W/ prefix. */
+        if (p[0] == 'W' && p[1] == '/') {
+            p += 2;
+        }
+
+        const char *end = strchr(p, ',');
+        size_t len = (end != NULL) ? (size_t)(end - p) : strlen(p);
+        while (len > 0U && p[len - 1U] == ' ') {
+            len--;
+        }
+        if (len == etag_len && strncmp(p, etag, len) == 0) {
+            return true;
+        }
+        p += (end != NULL) ? (size_t)(end - p) : strlen(p);
+    }
+    return false;
+}
 
+void rest_api_write_snapshot_json(rest_json_writer_t *writer,
+                                  const system_snapshot_t *snapshot,
+                                  uint32_t fields,
+                                  uint32_t generation)
+{
+    rest_json_begin_object(writer);
+    rest_json_key(writer, "generation");
+    rest_json_uint(writer, generation);
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_TIME) != 0U) {
+        rest_json_key(writer, "iso8601");
+        rest_json_string(writer, snapshot->iso8601);
+        rest_json_key(writer, "epoch");
+        rest_json_int(writer, snapshot->epoch_seconds);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_TEMPERATURE) != 0U) {
+        rest_json_key(writer, "celsius");
+        rest_json_float(writer, snapshot->temperature_c, 2U);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_UPTIME) != 0U) {
+        rest_json_key(writer, "uptime_ms");
+        rest_json_uint(writer, snapshot->uptime_ms);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_FREE_HEAP) != 0U) {
+        rest_json_key(writer, "free_heap_bytes");
+        rest_json_uint(writer, snapshot->free_heap_bytes);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED) != 0U) {
+        rest_json_key(writer, "wifi_connected");
+        rest_json_bool(writer, snapshot->wifi_connected);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI) != 0U) {
+        rest_json_key(writer, "wifi_rssi_dbm");
+        rest_json_int(writer, snapshot->wifi_rssi_dbm);
+    }
+    if ((fields & SYSTEM_SNAPSHOT_FIELD_WIFI_LINK) != 0U) {
+        const system_snapshot_wifi_link_t *link = &snapshot->wifi_link;
+        rest_json_key(writer, "wifi_link");
+        rest_json_begin_object(writer);
+        rest_json_key(writer, "disconnects");
+        rest_json_uint(writer, link->disconnects);
+        rest_json_key(writer, "reconnects");
+        rest_json_uint(writer, link->reconnects);
+        rest_json_key(writer, "last_reconnect_ms");
+        rest_json_uint(writer, link->last_reconnect_ms);
+        rest_json_key(writer, "avg_reconnect_ms");
+        rest_json_uint(writer, link->avg_reconnect_ms);
+        rest_json_key(writer, "max_reconnect_ms");
+        rest_json_uint(writer, link->max_reconnect_ms);
+        rest_json_key(writer, "attempts");
+        rest_json_uint(writer, link->attempts);
+        rest_json_key(writer, "last_reason");
+        rest_json_uint(writer, link->last_reason);
+        rest_json_end_object(writer);
+    }
+    rest_json_end_object(writer);
+}
+
+static void rest_snapshot_body(rest_json_writer_t *writer, const void *arg)
+{
+    const rest_snapshot_view_t *view = (const rest_snapshot_view_t *)arg;
+    rest_api_write_snapshot_json(writer, view->snapshot, view->fields, view->generation);
+}
+
+/* GET /api/v1/snapshot[?fields=time,temperature,uptime,heap,rssi,connected,wifi_link] */
+static esp_err_t rest_snapshot_get_handler(httpd_req_t *req)
+{
+    char query[REST_SNAPSHOT_QUERY_LEN];
+    char fields_param[REST_SNAPSHOT_FIELDS_LEN];
+    uint32_t fields = SYSTEM_SNAPSHOT_FIELD_ALL;
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "fields", fields_param, sizeof(fields_param)) == ESP_OK &&
+        !rest_api_parse_snapshot_fields(fields_param, &fields)) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad_fields");
+    }
+
+    /* Taken before the read: the body is at least as new as its ETag. */
+    const uint32_t generation = system_snapshot_fields_generation(fields);
+    char etag[REST_API_ETAG_LEN];
+    rest_api_format_etag(s_etag_boot_tag, generation, fields, etag, sizeof(etag));
+    (void)httpd_resp_set_hdr(req, "ETag", etag);
+    (void)httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char if_none_match[REST_IF_NONE_MATCH_LEN];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        rest_api_etag_matches(if_none_match, etag)) {
+        (void)httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    system_snapshot_t snapshot;
     system_snapshot_read(&snapshot);
-    size_t len = rest_api_build_time_json(&snapshot, buffer, sizeof(buffer));
-    if (len == 0U) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "snapshot_error");
+    const rest_snapshot_view_t view = { .snapshot = &snapshot, .fields = fields, .generation = generation };
+    return rest_send_json_stream(req, rest_snapshot_body, &view);
+}
+
+/* GET /api/v1/history?metric=heap|rssi|temp&tier=2s|1m|1h[&format=json|bin] */
+static esp_err_t rest_history_get_handler(httpd_req_t *req)
+{
+    char query[REST_HISTORY_QUERY_LEN];
+    char metric_name[REST_HISTORY_PARAM_LEN] = "heap";
+    char tier_name[REST_HISTORY_PARAM_LEN] = "1m";
+    char format[REST_HISTORY_PARAM_LEN] = "json";
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        (void)httpd_query_key_value(query, "metric", metric_name, sizeof(metric_name));
+        (void)httpd_query_key_value(query, "tier", tier_name, sizeof(tier_name));
+        (void)httpd_query_key_value(query, "format", format, sizeof(format));
     }
 
-    return rest_send_json(req, buffer, len);
+    rest_history_view_t view = { .newest_s = 0U };
+    if (!snapshot_history_metric_from_name(metric_name, &view.metric) ||
+        !snapshot_history_tier_from_name(tier_name, &view.tier)) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad_metric_or_tier");
+    }
+
+    view.count = snapshot_history_read(view.metric, view.tier, s_history_points,
+                                       SNAPSHOT_HISTORY_MAX_POINTS, &view.newest_s);
+
+    if (strcmp(format, "bin") == 0) {
+        return rest_history_send_binary(req, &view);
+    }
+    return rest_send_json_stream(req, rest_history_body, &view);
 }
 
-static esp_err_t rest_temperature_get_handler(httpd_req_t *req)
+static esp_err_t rest_time_get_handler(httpd_req_t *req)
 {
     system_snapshot_t snapshot;
-    char buffer[REST_API_TEMP_JSON_LEN];
 
     system_snapshot_read(&snapshot);
-    size_t len = rest_api_build_temperature_json(&snapshot, buffer, sizeof(buffer));
-    if (len == 0U) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "snapshot_error");
-    }
+    return rest_send_json_stream(req, rest_time_body, &snapshot);
+}
 
-    return rest_send_json(req, buffer, len);
+static esp_err_t rest_temperature_get_handler(httpd_req_t *req)
+{
+    system_snapshot_t snapshot;
+
+    system_snapshot_read(&snapshot);
+    return rest_send_json_stream(req, rest_temperature_body, &snapshot);
 }
 
 static esp_err_t rest_status_get_handler(httpd_req_t *req)
 {
     system_snapshot_t snapshot;
-    char buffer[REST_API_STATUS_JSON_LEN];
 
     system_snapshot_read(&snapshot);
-    size_t len = rest_api_build_status_json(&snapshot, buffer, sizeof(buffer));
-    if (len == 0U) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "snapshot_error");
-    }
+    return rest_send_json_stream(req, rest_status_body, &snapshot);
+}
 
-    return rest_send_json(req, buffer, len);
+static esp_err_t rest_boot_get_handler(httpd_req_t *req)
+{
+    boot_report_t report;
+
+    boot_report_get(&report);
+    return rest_send_json_stream(req, rest_boot_body, &report);
 }
 
 bool rest_routes_register(httpd_handle_t server)
@@ -138,6 +614,8 @@ bool rest_routes_register(httpd_handle_t server)
         return false;
     }
 
+    s_etag_boot_tag = esp_random();
+
     const httpd_uri_t time_uri = {
         .uri = "/api/v1/time",
         .method = HTTP_GET,
@@ -159,6 +637,27 @@ bool rest_routes_register(httpd_handle_t server)
         .user_ctx = NULL
     };
 
+    const httpd_uri_t snapshot_uri = {
+        .uri = "/api/v1/snapshot",
+        .method = HTTP_GET,
+        .handler = rest_snapshot_get_handler,
+        .user_ctx = NULL
+    };
+
+    const httpd_uri_t history_uri = {
+        .uri = "/api/v1/history",
+        .method = HTTP_GET,
+        .handler = rest_history_get_handler,
+        .user_ctx = NULL
+    };
+
+    const httpd_uri_t boot_uri = {
+        .uri = "/api/v1/boot",
+        .method = HTTP_GET,
+        .handler = rest_boot_get_handler,
+        .user_ctx = NULL
+    };
+
     if (httpd_register_uri_handler(server, &time_uri) != ESP_OK) {
         return false;
     }
@@ -171,5 +670,17 @@ bool rest_routes_register(httpd_handle_t server)
         return false;
     }
 
+    if (httpd_register_uri_handler(server, &snapshot_uri) != ESP_OK) {
+        return false;
+    }
+
+    if (httpd_register_uri_handler(server, &history_uri) != ESP_OK) {
+        return false;
+    }
+
+    if (httpd_register_uri_handler(server, &boot_uri) != ESP_OK) {
+        return false;
+    }
+
     return true;
 }
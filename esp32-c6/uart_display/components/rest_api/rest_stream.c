@@ -0,0 +1,563 @@
+/*
+ * rest_stream.c
+ *
+ * Server-Sent Events telemetry stream.
+ *
+ * Ownership: the httpd task adds clients, the producer task fills their
+ * queues and only the sender task frees a slot, so the sender can use a
+ * slot's conn/transport outside the lock while it sends. The lock covers the
+ * queues, slot states and stats; it is never held across a socket write.
+ */
+
+#include "rest_stream.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "rest_api.h"
+#include "rest_json.h"
+
+#include <string.h>
+#include <sys/select.h>
+
+static const char *TAG = "REST_STREAM";
+
+#define REST_STREAM_DEFAULT_INTERVAL_MS 1000U
+#define REST_STREAM_DEFAULT_MAX_CLIENTS 3U
+#define REST_STREAM_DEFAULT_STACK_SIZE 3072U
+#define REST_STREAM_DEFAULT_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define REST_STREAM_QUERY_LEN 96
+#define REST_STREAM_PARAM_LEN 64
+#define REST_STREAM_STOP_WAIT_MS 1000U
+#define REST_STREAM_RETRY_FRAME "retry: 3000\n\n"
+
+/* Uptime changes every metrics tick; streaming it by default would make every tick a delta. */
+#define REST_STREAM_DEFAULT_FIELDS (SYSTEM_SNAPSHOT_FIELD_ALL & ~(uint32_t)SYSTEM_SNAPSHOT_FIELD_UPTIME)
+
+typedef struct {
+    rest_stream_event_kind_t kind;
+    uint32_t changed;
+    system_snapshot_t values;
+} rest_stream_event_t;
+
+typedef enum {
+    STREAM_SLOT_FREE = 0,
+    STREAM_SLOT_ACTIVE,
+    STREAM_SLOT_CLOSING,
+} rest_stream_slot_state_t;
+
+typedef struct {
+    rest_stream_slot_state_t state;
+    void *conn;
+    const rest_stream_transport_t *transport;
+    uint32_t fields;
+    uint32_t interval_ms;
+    uint32_t last_push_ms;
+    uint32_t pending; /* changed fields waiting for the client's interval */
+    uint8_t head;
+    uint8_t count;
+    rest_stream_event_t queue[REST_STREAM_QUEUE_DEPTH];
+} rest_stream_client_t;
+
+static rest_stream_config_t s_config;
+static rest_stream_client_t s_clients[REST_STREAM_MAX_CLIENTS];
+static rest_stream_stats_t s_stats;
+static SemaphoreHandle_t s_lock;
+static StaticSemaphore_t s_lock_buf;
+static TaskHandle_t s_producer_task;
+static TaskHandle_t s_sender_task;
+
+/* Producer-only. */
+static uint32_t s_published_generation;
+static uint32_t s_last_tick_ms;
+static system_snapshot_t s_tick_snapshot;
+
+/* Sender-only. */
+static char s_frame[REST_STREAM_FRAME_LEN];
+
+static bool rest_stream_httpd_send(void *conn, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)conn, data, (ssize_t)len) == ESP_OK;
+}
+
+/* lwIP reports writable only above the send low-water mark, well over one frame. */
+static bool rest_stream_httpd_writable(void *conn)
+{
+    const int fd = httpd_req_to_sockfd((httpd_req_t *)conn);
+    if (fd < 0) {
+        return true; /* let the send report it */
+    }
+
+    fd_set write_fds;
+    struct timeval no_wait = { .tv_sec = 0, .tv_usec = 0 };
+    FD_ZERO(&write_fds);
+    FD_SET(fd, &write_fds);
+    return select(fd + 1, NULL, &write_fds, NULL, &no_wait) != 0;
+}
+
+static void rest_stream_httpd_close(void *conn)
+{
+    httpd_req_t *req = (httpd_req_t *)conn;
+
+    (void)httpd_resp_send_chunk(req, NULL, 0);
+    (void)httpd_req_async_handler_complete(req);
+}
+
+static const rest_stream_transport_t s_httpd_transport = {
+    .send = rest_stream_httpd_send,
+    .writable = rest_stream_httpd_writable,
+    .close = rest_stream_httpd_close,
+};
+
+static void rest_stream_notify_sender(void)
+{
+    if (s_sender_task != NULL) {
+        xTaskNotifyGive(s_sender_task);
+    }
+}
+
+/* Caller holds s_lock. A full queue collapses into the new event (drop-to-latest). */
+static void rest_stream_enqueue(rest_stream_client_t *client,
+                                rest_stream_event_kind_t kind,
+                                uint32_t changed,
+                                const system_snapshot_t *values)
+{
+    if (client->count == REST_STREAM_QUEUE_DEPTH) {
+        for (uint8_t i = 0; i < client->count; ++i) {
+            const rest_stream_event_t *stale = &client->queue[(client->head + i) % REST_STREAM_QUEUE_DEPTH];
+            changed |= stale->changed;
+            if (stale->kind == REST_STREAM_EVENT_SNAPSHOT) {
+                kind = REST_STREAM_EVENT_SNAPSHOT; /* the baseline was never sent */
+            }
+        }
+        s_stats.events_coalesced += client->count;
+        client->count = 0U;
+    }
+
+    rest_stream_event_t *event = &client->queue[(client->head + client->count) % REST_STREAM_QUEUE_DEPTH];
+    event->kind = kind;
+    event->changed = changed;
+    if (values != NULL) {
+        event->values = *values;
+    }
+    client->count++;
+    s_stats.events_queued++;
+}
+
+static void rest_stream_close_client(rest_stream_client_t *client)
+{
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    void *conn = client->conn;
+    const rest_stream_transport_t *transport = client->transport;
+    memset(client, 0, sizeof(*client));
+    s_stats.clients--;
+    s_stats.clients_closed++;
+    (void)xSemaphoreGive(s_lock);
+
+    transport->close(conn);
+}
+
+static bool rest_stream_parse_interval(const char *text, uint32_t *out_interval_ms)
+{
+    uint32_t value = 0U;
+
+    if (*text == '\0') {
+        return false;
+    }
+    for (const char *p = text; *p != '\0'; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        value = value * 10U + (uint32_t)(*p - '0');
+        if (value > REST_STREAM_MAX_INTERVAL_MS) {
+            return false;
+        }
+    }
+
+    *out_interval_ms = value;
+    return true;
+}
+
+/* GET /api/v1/stream[?fields=...&interval_ms=N] */
+static esp_err_t rest_stream_get_handler(httpd_req_t *req)
+{
+    char query[REST_STREAM_QUERY_LEN];
+    char param[REST_STREAM_PARAM_LEN];
+    uint32_t fields = REST_STREAM_DEFAULT_FIELDS;
+    uint32_t interval_ms = s_config.interval_ms;
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "fields", param, sizeof(param)) == ESP_OK &&
+            !rest_api_parse_snapshot_fields(param, &fields)) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad_fields");
+        }
+        if (httpd_query_key_value(query, "interval_ms", param, sizeof(param)) == ESP_OK &&
+            !rest_stream_parse_interval(param, &interval_ms)) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad_interval");
+        }
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool full = s_stats.clients >= s_config.max_clients;
+    if (full) {
+        s_stats.clients_rejected++;
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    if (full) {
+        (void)httpd_resp_set_status(req, "503 Service Unavailable");
+        (void)httpd_resp_set_hdr(req, "Retry-After", "10");
+        return httpd_resp_send(req, "stream_full", HTTPD_RESP_USE_STRLEN);
+    }
+
+    (void)httpd_resp_set_type(req, "text/event-stream");
+    (void)httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (httpd_resp_send_chunk(req, REST_STREAM_RETRY_FRAME, sizeof(REST_STREAM_RETRY_FRAME) - 1U) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    /* The copy keeps the socket open after this handler returns. */
+    httpd_req_t *stream_req = NULL;
+    if (httpd_req_async_handler_begin(req, &stream_req) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    if (!rest_stream_add_client(stream_req, &s_httpd_transport, fields, interval_ms)) {
+        rest_stream_httpd_close(stream_req); /* lost a race for the last slot */
+    }
+    return ESP_OK;
+}
+
+static void rest_stream_producer_task(void *arg)
+{
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(s_config.interval_ms));
+        if (rest_stream_publish((uint32_t)(esp_timer_get_time() / 1000))) {
+            rest_stream_notify_sender();
+        }
+    }
+}
+
+static void rest_stream_sender_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (rest_stream_drain()) {
+        }
+    }
+}
+
+void rest_stream_get_default_config(rest_stream_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->interval_ms = REST_STREAM_DEFAULT_INTERVAL_MS;
+    config->max_clients = REST_STREAM_DEFAULT_MAX_CLIENTS;
+    config->stack_size = REST_STREAM_DEFAULT_STACK_SIZE;
+    config->task_priority = REST_STREAM_DEFAULT_TASK_PRIORITY;
+}
+
+bool rest_stream_init(const rest_stream_config_t *config)
+{
+    if (config == NULL || config->interval_ms < REST_STREAM_MIN_INTERVAL_MS ||
+        config->interval_ms > REST_STREAM_MAX_INTERVAL_MS || s_producer_task != NULL) {
+        return false;
+    }
+
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+        if (s_lock == NULL) {
+            return false;
+        }
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_config = *config;
+    if (s_config.max_clients > REST_STREAM_MAX_CLIENTS) {
+        s_config.max_clients = REST_STREAM_MAX_CLIENTS;
+    }
+    memset(s_clients, 0, sizeof(s_clients));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_published_generation = 0U;
+    s_last_tick_ms = 0U;
+    (void)xSemaphoreGive(s_lock);
+    return true;
+}
+
+bool rest_stream_start(const rest_stream_config_t *config)
+{
+    if (s_producer_task != NULL) {
+        return true;
+    }
+    if (!rest_stream_init(config)) {
+        return false;
+    }
+    if (s_config.max_clients == 0U) {
+        return true;
+    }
+
+    if (xTaskCreate(rest_stream_sender_task, "restStreamTx", s_config.stack_size, NULL,
+                    s_config.task_priority, &s_sender_task) != pdPASS) {
+        s_sender_task = NULL;
+        return false;
+    }
+    if (xTaskCreate(rest_stream_producer_task, "restStream", s_config.stack_size, NULL,
+                    s_config.task_priority, &s_producer_task) != pdPASS) {
+        vTaskDelete(s_sender_task);
+        s_sender_task = NULL;
+        s_producer_task = NULL;
+        return false;
+    }
+
+    ESP_LOGI(TAG, "stream every %u ms, up to %u clients",
+             (unsigned)s_config.interval_ms, (unsigned)s_config.max_clients);
+    return true;
+}
+
+void rest_stream_stop(void)
+{
+    if (s_lock == NULL) {
+        return;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (size_t i = 0; i < REST_STREAM_MAX_CLIENTS; ++i) {
+        if (s_clients[i].state == STREAM_SLOT_ACTIVE) {
+            s_clients[i].state = STREAM_SLOT_CLOSING;
+        }
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    if (s_sender_task == NULL) {
+        (void)rest_stream_drain();
+        return;
+    }
+
+    rest_stream_notify_sender();
+    for (uint32_t waited = 0U; waited < REST_STREAM_STOP_WAIT_MS; waited += 10U) {
+        rest_stream_stats_t stats;
+        rest_stream_get_stats(&stats);
+        if (stats.clients == 0U) {
+            return;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    ESP_LOGW(TAG, "stream clients still open after %u ms", (unsigned)REST_STREAM_STOP_WAIT_MS);
+}
+
+bool rest_stream_register(httpd_handle_t server)
+{
+    if (server == NULL || s_lock == NULL) {
+        return false;
+    }
+    if (s_config.max_clients == 0U) {
+        return true;
+    }
+
+    const httpd_uri_t stream_uri = {
+        .uri = "/api/v1/stream",
+        .method = HTTP_GET,
+        .handler = rest_stream_get_handler,
+        .user_ctx = NULL
+    };
+
+    return httpd_register_uri_handler(server, &stream_uri) == ESP_OK;
+}
+
+bool rest_stream_add_client(void *conn,
+                            const rest_stream_transport_t *transport,
+                            uint32_t fields,
+                            uint32_t interval_ms)
+{
+    if (conn == NULL || transport == NULL || transport->send == NULL || transport->close == NULL ||
+        s_lock == NULL || (fields & SYSTEM_SNAPSHOT_FIELD_ALL) == 0U) {
+        return false;
+    }
+
+    system_snapshot_t baseline;
+    system_snapshot_read(&baseline);
+
+    bool added = false;
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (size_t i = 0; i < REST_STREAM_MAX_CLIENTS && s_stats.clients < s_config.max_clients; ++i) {
+        rest_stream_client_t *client = &s_clients[i];
+        if (client->state != STREAM_SLOT_FREE) {
+            continue;
+        }
+
+        client->state = STREAM_SLOT_ACTIVE;
+        client->conn = conn;
+        client->transport = transport;
+        client->fields = fields & SYSTEM_SNAPSHOT_FIELD_ALL;
+        client->interval_ms = (interval_ms > s_config.interval_ms) ? interval_ms : s_config.interval_ms;
+        client->last_push_ms = s_last_tick_ms;
+        rest_stream_enqueue(client, REST_STREAM_EVENT_SNAPSHOT, client->fields, &baseline);
+        s_stats.clients++;
+        added = true;
+        break;
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    if (added) {
+        rest_stream_notify_sender();
+    }
+    return added;
+}
+
+bool rest_stream_publish(uint32_t now_ms)
+{
+    if (s_lock == NULL) {
+        return false;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool idle = (s_stats.clients == 0U);
+    (void)xSemaphoreGive(s_lock);
+    if (idle) {
+        return false;
+    }
+
+    /* One snapshot read per tick, shared by every client. */
+    system_snapshot_delta_t delta;
+    const uint32_t changed = system_snapshot_read_since(s_published_generation, &delta);
+    s_published_generation = delta.generation;
+    system_snapshot_read(&s_tick_snapshot);
+
+    bool queued = false;
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_last_tick_ms = now_ms;
+    for (size_t i = 0; i < REST_STREAM_MAX_CLIENTS; ++i) {
+        rest_stream_client_t *client = &s_clients[i];
+        if (client->state != STREAM_SLOT_ACTIVE) {
+            continue;
+        }
+
+        client->pending |= changed & client->fields;
+        queued = queued || (client->count > 0U); /* backlog waiting for send space */
+        const uint32_t elapsed_ms = now_ms - client->last_push_ms;
+        if (client->pending != 0U && elapsed_ms >= client->interval_ms) {
+            rest_stream_enqueue(client, REST_STREAM_EVENT_DELTA, client->pending, &s_tick_snapshot);
+            client->pending = 0U;
+            client->last_push_ms = now_ms;
+            queued = true;
+        } else if (client->pending == 0U && client->count == 0U && elapsed_ms >= REST_STREAM_KEEPALIVE_MS) {
+            rest_stream_enqueue(client, REST_STREAM_EVENT_KEEPALIVE, 0U, NULL);
+            client->last_push_ms = now_ms;
+            queued = true;
+        }
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    return queued;
+}
+
+bool rest_stream_drain(void)
+{
+    if (s_lock == NULL) {
+        return false;
+    }
+
+    bool more = false;
+    for (size_t i = 0; i < REST_STREAM_MAX_CLIENTS; ++i) {
+        rest_stream_client_t *client = &s_clients[i];
+
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        const rest_stream_slot_state_t state = client->state;
+        const bool has_event = (client->count > 0U);
+        (void)xSemaphoreGive(s_lock);
+
+        if (state == STREAM_SLOT_CLOSING) {
+            rest_stream_close_client(client);
+            continue;
+        }
+        /* Only this task frees slots, so conn/transport stay valid unlocked. */
+        if (state != STREAM_SLOT_ACTIVE || !has_event ||
+            (client->transport->writable != NULL && !client->transport->writable(client->conn))) {
+            continue;
+        }
+
+        /* The producer may have collapsed the queue meanwhile, never emptied it. */
+        rest_stream_event_t event;
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        event = client->queue[client->head];
+        client->head = (uint8_t)((client->head + 1U) % REST_STREAM_QUEUE_DEPTH);
+        client->count--;
+        more = more || (client->count > 0U);
+        (void)xSemaphoreGive(s_lock);
+
+        const size_t len = rest_stream_format_event(event.kind, event.values.generation, event.changed,
+                                                    &event.values, s_frame, sizeof(s_frame));
+        if (len == 0U || !client->transport->send(client->conn, s_frame, len)) {
+            rest_stream_close_client(client);
+            continue;
+        }
+
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_stats.events_sent++;
+        (void)xSemaphoreGive(s_lock);
+    }
+    return more;
+}
+
+void rest_stream_get_stats(rest_stream_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+    if (s_lock == NULL) {
+        memset(out_stats, 0, sizeof(*out_stats));
+        return;
+    }
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out_stats = s_stats;
+    (void)xSemaphoreGive(s_lock);
+}
+
+size_t rest_stream_format_event(rest_stream_event_kind_t kind,
+                                uint32_t generation,
+                                uint32_t fields,
+                                const system_snapshot_t *snapshot,
+                                char *out_buf,
+                                size_t out_len)
+{
+    static const char snapshot_prefix[] = "\nevent: snapshot\ndata: ";
+    static const char delta_prefix[] = "\nevent: delta\ndata: ";
+    rest_json_writer_t writer;
+
+    if (out_buf == NULL || out_len == 0U || (kind != REST_STREAM_EVENT_KEEPALIVE && snapshot == NULL)) {
+        return 0U;
+    }
+
+    rest_json_init(&writer, out_buf, out_len - 1U, NULL, NULL);
+    if (kind == REST_STREAM_EVENT_KEEPALIVE) {
+        rest_json_raw(&writer, ":\n\n", 3U);
+    } else {
+        rest_json_raw(&writer, "id: ", 4U);
+        rest_json_uint(&writer, generation);
+        if (kind == REST_STREAM_EVENT_SNAPSHOT) {
+            rest_json_raw(&writer, snapshot_prefix, sizeof(snapshot_prefix) - 1U);
+        } else {
+            rest_json_raw(&writer, delta_prefix, sizeof(delta_prefix) - 1U);
+        }
+        rest_api_write_snapshot_json(&writer, snapshot, fields, generation);
+        rest_json_raw(&writer, "\n\n", 2U);
+    }
+
+    if (!rest_json_ok(&writer)) {
+        out_buf[0] = '\0';
+        return 0U;
+    }
+
+    const size_t len = rest_json_size(&writer);
+    out_buf[len] = '\0';
+    return len;
+}
@@ -51,3 +51,23 @@ TEST_CASE("rest_api status json", "[rest_api]")
     TEST_ASSERT_NOT_EQUAL(0U, len);
     TEST_ASSERT_EQUAL_STRING("{\"uptime_ms\":123456,\"free_heap_bytes\":654321,\"wifi_connected\":true,\"wifi_rssi_dbm\":-45}", buffer);
 }
+
+TEST_CASE("rest_api snapshot fields and etag", "[rest_api]")
+{
+    uint32_t fields = 0U;
+    char etag[REST_API_ETAG_LEN];
+
+    TEST_ASSERT_TRUE(rest_api_parse_snapshot_fields("time,temperature", &fields));
+    TEST_ASSERT_EQUAL_HEX32(SYSTEM_SNAPSHOT_FIELD_TIME | SYSTEM_SNAPSHOT_FIELD_TEMPERATURE, fields);
+    TEST_ASSERT_TRUE(rest_api_parse_snapshot_fields("heap%2Crssi", &fields));
+    TEST_ASSERT_EQUAL_HEX32(SYSTEM_SNAPSHOT_FIELD_FREE_HEAP | SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI, fields);
+    TEST_ASSERT_FALSE(rest_api_parse_snapshot_fields("time,nope", &fields));
+    TEST_ASSERT_FALSE(rest_api_parse_snapshot_fields("", &fields));
+
+    rest_api_format_etag(0x12345678U, 42U, SYSTEM_SNAPSHOT_FIELD_TIME, etag, sizeof(etag));
+    TEST_ASSERT_EQUAL_STRING("\"12345678-0000002a-01\"", etag);
+    TEST_ASSERT_TRUE(rest_api_etag_matches(etag, etag));
+    TEST_ASSERT_TRUE(rest_api_etag_matches("\"x\", W/\"12345678-0000002a-01\"", etag));
+    TEST_ASSERT_TRUE(rest_api_etag_matches("*", etag));
+    TEST_ASSERT_FALSE(rest_api_etag_matches("\"12345678-0000002b-01\"", etag));
+}
@@ -0,0 +1,81 @@
+#include "rest_json.h"
+
+#include "unity.h"
+
+#include <math.h>
+#include <string.h>
+
+typedef struct {
+    char out[256];
+    size_t len;
+    size_t calls;
+} capture_t;
+
+static bool capture_flush(void *ctx, const char *data, size_t len)
+{
+    capture_t *capture = (capture_t *)ctx;
+    if (capture->len + len >= sizeof(capture->out)) {
+        return false;
+    }
+    memcpy(&capture->out[capture->len], data, len);
+    capture->len += len;
+    capture->out[capture->len] = '\0';
+    capture->calls++;
+    return true;
+}
+
+TEST_CASE("rest_json formats values without printf", "[rest_api][json]")
+{
+    char buf[160];
+    rest_json_writer_t writer;
+
+    rest_json_init(&writer, buf, sizeof(buf) - 1U, NULL, NULL);
+    rest_json_begin_object(&writer);
+    rest_json_key(&writer, "s");
+    rest_json_string(&writer, "a\"b\\c\n\x01");
+    rest_json_key(&writer, "i");
+    rest_json_int(&writer, INT64_MIN);
+    rest_json_key(&writer, "f");
+    rest_json_begin_array(&writer);
+    rest_json_float(&writer, 21.25, 2U);
+    rest_json_float(&writer, -0.004, 2U);
+    rest_json_float(&writer, -1.005, 1U);
+    rest_json_float(&writer, 7.0, 0U);
+    rest_json_float(&writer, NAN, 2U);
+    rest_json_end_array(&writer);
+    rest_json_key(&writer, "e");
+    rest_json_begin_object(&writer);
+    rest_json_end_object(&writer);
+    rest_json_end_object(&writer);
+    TEST_ASSERT_TRUE(rest_json_ok(&writer));
+    buf[writer.len] = '\0';
+
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"a\\\"b\\\\c\\n\\u0001\",\"i\":-9223372036854775808,"
+                             "\"f\":[21.25,0.00,-1.0,7,null],\"e\":{}}", buf);
+}
+
+TEST_CASE("rest_json streams through a small buffer", "[rest_api][json]")
+{
+    char buf[8];
+    capture_t capture = { .len = 0U };
+    rest_json_writer_t writer;
+
+    rest_json_init(&writer, buf, sizeof(buf), capture_flush, &capture);
+    rest_json_begin_array(&writer);
+    for (int i = 0; i < 20; ++i) {
+        rest_json_uint(&writer, (uint64_t)i * 1000U);
+    }
+    rest_json_end_array(&writer);
+    TEST_ASSERT_TRUE(rest_json_ok(&writer));
+    TEST_ASSERT_TRUE(rest_json_flush(&writer));
+
+    TEST_ASSERT_EQUAL_STRING("[0,1000,2000,3000,4000,5000,6000,7000,8000,9000,10000,11000,"
+                             "12000,13000,14000,15000,16000,17000,18000,19000]", capture.out);
+    TEST_ASSERT_EQUAL(strlen(capture.out), rest_json_size(&writer));
+    TEST_ASSERT_TRUE(capture.calls > 1U);
+
+    /* Without a flush callback, overflow fails instead of truncating silently. */
+    rest_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    rest_json_string(&writer, "longer than eight");
+    TEST_ASSERT_FALSE(rest_json_ok(&writer));
+}
@@ -0,0 +1,45 @@
+#include "rest_stream.h"
+
+#include "unity.h"
+
+#include <string.h>
+
+static void build_stream_snapshot(system_snapshot_t *snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->epoch_seconds = 1726000000;
+    (void)strlcpy(snapshot->iso8601, "2024-09-11T08:12:00Z", sizeof(snapshot->iso8601));
+    snapshot->temperature_c = 21.25f;
+    snapshot->free_heap_bytes = 654321U;
+    snapshot->wifi_connected = true;
+    snapshot->wifi_rssi_dbm = -45;
+}
+
+TEST_CASE("rest_stream event framing", "[rest_api]")
+{
+    system_snapshot_t snapshot;
+    char frame[REST_STREAM_FRAME_LEN];
+
+    build_stream_snapshot(&snapshot);
+
+    size_t len = rest_stream_format_event(REST_STREAM_EVENT_DELTA, 17U,
+                                          SYSTEM_SNAPSHOT_FIELD_TEMPERATURE | SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI,
+                                          &snapshot, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_STRING("id: 17\nevent: delta\ndata: {\"generation\":17,\"celsius\":21.25,\"wifi_rssi_dbm\":-45}\n\n",
+                             frame);
+    TEST_ASSERT_EQUAL(strlen(frame), len);
+
+    len = rest_stream_format_event(REST_STREAM_EVENT_SNAPSHOT, 3U, SYSTEM_SNAPSHOT_FIELD_TIME, &snapshot,
+                                   frame, sizeof(frame));
+    TEST_ASSERT_NOT_EQUAL(0U, len);
+    TEST_ASSERT_EQUAL_STRING("id: 3\nevent: snapshot\ndata: {\"generation\":3,\"iso8601\":\"2024-09-11T08:12:00Z\",\"epoch\":1726000000}\n\n",
+                             frame);
+
+    len = rest_stream_format_event(REST_STREAM_EVENT_KEEPALIVE, 0U, 0U, NULL, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_STRING(":\n\n", frame);
+    TEST_ASSERT_EQUAL(3U, len);
+
+    /* Never a truncated frame on the wire. */
+    TEST_ASSERT_EQUAL(0U, rest_stream_format_event(REST_STREAM_EVENT_DELTA, 17U, SYSTEM_SNAPSHOT_FIELD_ALL,
+                                                   &snapshot, frame, 24U));
+}
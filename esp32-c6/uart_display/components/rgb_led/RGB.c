@@ -1,5 +1,12 @@
 #include "rgb_led.h"
 
+#include "driver/rmt_tx.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "freertos/semphr.h"
+#include "job_scheduler.h"
+#include "led_ws2812_encoder.h"
+
 static uint8_t RGB_Data[192][3] ={
     {64, 1, 0}, {63, 2, 0}, {62, 3, 0}, {61, 4, 0}, {60, 5, 0}, {59, 6, 0}, {58, 7, 0}, {57, 8, 0},
     {56, 9, 0}, {55, 10, 0}, {54, 11, 0}, {53, 12, 0}, {52, 13, 0}, {51, 14, 0}, {50, 15, 0}, {49, 16, 0},
@@ -29,54 +36,115 @@ static uint8_t RGB_Data[192][3] ={
     {57, 0, 8}, {58, 0, 7}, {59, 0, 6}, {60, 0, 5}, {61, 0, 4}, {62, 0, 3}, {63, 0, 2}, {64, 0, 1}
 };
 
-static led_strip_handle_t led_strip;
+/* WS2812 at 10 MHz: 0.1 us per RMT tick. */
+#define RGB_RMT_RESOLUTION_HZ (10 * 1000 * 1000)
+/* Longest Set_RGB() waits for a buffer; one frame plus reset is well under 1 ms. */
+#define RGB_BUFFER_WAIT_MS 10U
+
+static const char *TAG = "RGB";
+
+static rmt_channel_handle_t s_channel = NULL;
+static rmt_encoder_handle_t s_encoder = NULL;
+static uint8_t s_pixels[LED_FRAME_BUFFERS][RGB_LED_COUNT * 3U];
+static led_frame_t s_frame;
+static StaticSemaphore_t s_tx_done_buf;
+static StaticSemaphore_t s_draw_lock_buf;
+static SemaphoreHandle_t s_tx_done = NULL;   /* given on every finished transfer */
+static SemaphoreHandle_t s_draw_lock = NULL; /* one drawing task at a time (led_frame rule) */
+
+static bool rgb_transmit(void *ctx, const uint8_t *buf, size_t len)
+{
+    (void)ctx;
+    const rmt_transmit_config_t tx_config = { .loop_count = 0 };
+    return rmt_transmit(s_channel, s_encoder, buf, len, &tx_config) == ESP_OK;
+}
+
+static bool IRAM_ATTR rgb_tx_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *ctx)
+{
+    (void)channel;
+    (void)edata;
+    (void)ctx;
+
+    BaseType_t woken = pdFALSE;
+    (void)led_frame_complete(&s_frame);
+    (void)xSemaphoreGiveFromISR(s_tx_done, &woken);
+    return woken == pdTRUE;
+}
 
 void RGB_Init(void)
 {
-    /* LED strip initialization with the GPIO and pixels number*/
-    led_strip_config_t strip_config = {
-        .strip_gpio_num = BLINK_GPIO,
-        .max_leds = 1, // at least one LED on board
-    };
-    led_strip_rmt_config_t rmt_config = {
-        .resolution_hz = 10 * 1000 * 1000, // 10MHz
-        .flags.with_dma = false,
+    s_tx_done = xSemaphoreCreateBinaryStatic(&s_tx_done_buf);
+    s_draw_lock = xSemaphoreCreateMutexStatic(&s_draw_lock_buf);
+    const led_frame_backend_t backend = { .transmit = rgb_transmit, .ctx = NULL };
+    (void)led_frame_init(&s_frame, s_pixels[0], s_pixels[1], sizeof(s_pixels[0]), &backend);
+
+    /* One queued transfer per buffer: submit never waits for the one on the wire. */
+    const rmt_tx_channel_config_t channel_config = {
+        .gpio_num = BLINK_GPIO,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = RGB_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = 48,
+        .trans_queue_depth = LED_FRAME_BUFFERS,
     };
-    ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip));
+    ESP_ERROR_CHECK(rmt_new_tx_channel(&channel_config, &s_channel));
+    ESP_ERROR_CHECK(led_ws2812_encoder_new(RGB_RMT_RESOLUTION_HZ, &s_encoder));
+    const rmt_tx_event_callbacks_t callbacks = { .on_trans_done = rgb_tx_done };
+    ESP_ERROR_CHECK(rmt_tx_register_event_callbacks(s_channel, &callbacks, NULL));
+    ESP_ERROR_CHECK(rmt_enable(s_channel));
 
     /* Set all LED off to clear all pixels */
-    led_strip_clear(led_strip);
+    Set_RGB(0, 0, 0);
+}
+
+/* Draws into a free buffer and starts sending it; waits up to `wait` for a buffer, never for the wire. */
+static bool rgb_show(uint8_t red_val, uint8_t green_val, uint8_t blue_val, TickType_t wait)
+{
+    if (s_channel == NULL) {
+        return false;
+    }
+
+    (void)xSemaphoreTake(s_draw_lock, portMAX_DELAY);
+    uint8_t *pixels = led_frame_acquire(&s_frame);
+    while (pixels == NULL && wait > 0U && xSemaphoreTake(s_tx_done, wait) == pdTRUE) {
+        pixels = led_frame_acquire(&s_frame);
+    }
+
+    bool ok = false;
+    if (pixels != NULL) {
+        /* WS2812 wire order is GRB. */
+        pixels[0] = green_val;
+        pixels[1] = red_val;
+        pixels[2] = blue_val;
+        ok = led_frame_submit(&s_frame, pixels);
+    }
+    (void)xSemaphoreGive(s_draw_lock);
+    return ok;
 }
 
 void Set_RGB(uint8_t red_val, uint8_t green_val, uint8_t blue_val)
 {
-    /* Set the LED pixel using RGB from 0 (0%) to 255 (100%) for each color */
-    led_strip_set_pixel(led_strip, 0, red_val, green_val, blue_val);
-    /* Refresh the strip to send data */
-    led_strip_refresh(led_strip);
+    if (!rgb_show(red_val, green_val, blue_val, pdMS_TO_TICKS(RGB_BUFFER_WAIT_MS))) {
+        ESP_LOGW(TAG, "LED frame not sent");
+    }
 }
 
-void _RGB_Example(void *arg)
+static void rgb_example_job(void *ctx)
 {
     static uint8_t i = 0;
-    while(1)
-    {
-        Set_RGB(RGB_Data[i][0]*3, RGB_Data[i][1]*3, RGB_Data[i][2]*3);
-        i++;
-        if(i >= 192) i = 0;
-        vTaskDelay(20 / portTICK_PERIOD_MS);
-    }
+    (void)ctx;
+
+    /* Runs on the shared scheduler task: never wait; a frame with no free buffer is skipped (busy). */
+    (void)rgb_show(RGB_Data[i][0] * 3, RGB_Data[i][1] * 3, RGB_Data[i][2] * 3, 0);
+    i++;
+    if (i >= 192) i = 0;
+}
+
+bool RGB_Example(void)
+{
+    return job_scheduler_add("rgb", RGB_FRAME_PERIOD_MS, rgb_example_job, NULL, NULL);
 }
 
-void RGB_Example(void)
+void RGB_GetStats(led_frame_stats_t *out_stats)
 {
-    // RGB
-    xTaskCreatePinnedToCore(
-        _RGB_Example, 
-        "RGB Demo",
-        4096, 
-        NULL, 
-        4, 
-        NULL, 
-        0);
+    led_frame_get_stats(&s_frame, out_stats);
 }
@@ -0,0 +1,364 @@
+/*
+ * check_ws2812_stream.c
+ *
+ * Drives led_ws2812_stream the way the RMT simple encoder does and checks
+ * what would go on the wire. The pixel source is a procedural rainbow, so
+ * no frame exists anywhere; the only symbol storage is a --mem sized array
+ * standing in for the channel's memory block. Refills follow the RMT
+ * ping-pong (one full block, then half a block each time one half has been
+ * sent), or random sizes with --random SEED.
+ *
+ * The symbols are decoded as a waveform (adjacent phases of the same level
+ * merged) and every high/low is checked against two timing profiles:
+ *
+ *   WS2812B     T0H 250-550  T0L 700-1000  T1H 650-950  T1L 300-600  ns, reset >= 50 us
+ *   WS2812B-V5  T0H 220-380  T0L 580-1000  T1H 580-1000 T1L 220-420  ns, reset >= 280 us
+ *
+ * The decoded GRB bytes must match the source, pixel for pixel, in every
+ * frame.
+ *
+ *   check_ws2812_stream [--leds N] [--frames N] [--resolution HZ] [--mem N]
+ *                       [--random SEED] [--check]
+ */
+
+#include "led_ws2812_stream.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_MAX_MEM 1024U
+
+typedef struct {
+    const char *name;
+    uint32_t t0h_min, t0h_max, t0l_min, t0l_max;
+    uint32_t t1h_min, t1h_max, t1l_min, t1l_max;
+    uint32_t reset_min;
+} check_profile_t;
+
+static const check_profile_t s_profiles[] = {
+    { "WS2812B", 250, 550, 700, 1000, 650, 950, 300, 600, 50000 },
+    { "WS2812B-V5", 220, 380, 580, 1000, 580, 1000, 220, 420, 280000 },
+};
+#define CHECK_PROFILES (sizeof(s_profiles) / sizeof(s_profiles[0]))
+
+typedef struct {
+    uint32_t leds;
+    uint32_t frames;
+    uint32_t resolution_hz;
+    uint32_t mem;
+    uint32_t seed;  /* 0: ping-pong refills */
+    bool check;
+} check_config_t;
+
+typedef struct {
+    uint32_t frame;
+    uint32_t leds;
+} rainbow_t;
+
+/* Waveform decoder: one instance per frame. */
+typedef struct {
+    const check_config_t *config;
+    rainbow_t *source;
+    int level;            /* level of the phase being accumulated, -1 before the first */
+    uint64_t phase_ticks;
+    uint64_t high_ticks;  /* last complete high phase */
+    uint32_t bit_count;
+    uint32_t pixel;
+    uint32_t byte_bits;
+    uint32_t bits;
+    uint64_t wire_ticks;
+    uint32_t errors;
+    uint32_t min_ns[2][2]; /* [bit][0: high, 1: low] */
+    uint32_t max_ns[2][2];
+    uint64_t reset_ns;
+} check_decoder_t;
+
+static void rainbow_pixel(void *ctx, uint32_t index, uint8_t grb[3])
+{
+    const rainbow_t *rb = ctx;
+    /* Hue wheel over the strip, shifted a little every frame. */
+    const uint32_t hue = (uint32_t)(((uint64_t)index * 1536U / rb->leds + rb->frame * 37U) % 1536U);
+    const uint8_t ramp = (uint8_t)(hue & 0xFFU);
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    switch (hue >> 8) {
+    case 0: r = 255; g = ramp; break;
+    case 1: r = (uint8_t)(255U - ramp); g = 255; break;
+    case 2: g = 255; b = ramp; break;
+    case 3: g = (uint8_t)(255U - ramp); b = 255; break;
+    case 4: r = ramp; b = 255; break;
+    default: r = 255; b = (uint8_t)(255U - ramp); break;
+    }
+    grb[0] = g;
+    grb[1] = r;
+    grb[2] = b;
+}
+
+static uint32_t ticks_to_ns(const check_decoder_t *dec, uint64_t ticks)
+{
+    return (uint32_t)(ticks * 1000000000ULL / dec->config->resolution_hz);
+}
+
+static void decoder_fail(check_decoder_t *dec, const char *what, uint32_t ns)
+{
+    if (dec->errors++ < 10U) {
+        fprintf(stderr, "frame %" PRIu32 " bit %" PRIu32 ": %s (%" PRIu32 " ns)\n", dec->source->frame,
+                dec->bit_count, what, ns);
+    }
+}
+
+static void decoder_track(check_decoder_t *dec, int bit, int phase, uint32_t ns)
+{
+    if (ns < dec->min_ns[bit][phase]) {
+        dec->min_ns[bit][phase] = ns;
+    }
+    if (ns > dec->max_ns[bit][phase]) {
+        dec->max_ns[bit][phase] = ns;
+    }
+}
+
+static int decoder_classify_high(check_decoder_t *dec, uint32_t ns)
+{
+    int bit = -1;
+    for (size_t i = 0; i < CHECK_PROFILES; ++i) {
+        const check_profile_t *p = &s_profiles[i];
+        int here = (ns >= p->t0h_min && ns <= p->t0h_max) ? 0 : (ns >= p->t1h_min && ns <= p->t1h_max) ? 1 : -1;
+        if (here < 0 || (bit >= 0 && here != bit)) {
+            decoder_fail(dec, p->name, ns);
+            return -1;
+        }
+        bit = here;
+    }
+    return bit;
+}
+
+static void decoder_push_bit(check_decoder_t *dec, int bit)
+{
+    dec->bits = (dec->bits << 1) | (uint32_t)bit;
+    dec->bit_count++;
+    if (++dec->byte_bits < 24U) {
+        return;
+    }
+
+    uint8_t want[3];
+    rainbow_pixel(dec->source, dec->pixel, want);
+    const uint32_t expect = ((uint32_t)want[0] << 16) | ((uint32_t)want[1] << 8) | want[2];
+    if ((dec->bits & 0xFFFFFFU) != expect) {
+        if (dec->errors++ < 10U) {
+            fprintf(stderr, "frame %" PRIu32 " pixel %" PRIu32 ": got %06" PRIX32 " want %06" PRIX32 "\n",
+                    dec->source->frame, dec->pixel, dec->bits & 0xFFFFFFU, expect);
+        }
+    }
+    dec->pixel++;
+    dec->byte_bits = 0;
+    dec->bits = 0;
+}
+
+/* A low phase ended by the next high: it closes the previous bit. */
+static void decoder_close_bit(check_decoder_t *dec, uint64_t low_ticks)
+{
+    const uint32_t high_ns = ticks_to_ns(dec, dec->high_ticks);
+    const uint32_t low_ns = ticks_to_ns(dec, low_ticks);
+    const int bit = decoder_classify_high(dec, high_ns);
+    if (bit < 0) {
+        return;
+    }
+    for (size_t i = 0; i < CHECK_PROFILES; ++i) {
+        const check_profile_t *p = &s_profiles[i];
+        const uint32_t lo = bit ? p->t1l_min : p->t0l_min;
+        const uint32_t hi = bit ? p->t1l_max : p->t0l_max;
+        if (low_ns < lo || low_ns > hi) {
+            decoder_fail(dec, bit ? "T1L out of window" : "T0L out of window", low_ns);
+        }
+    }
+    decoder_track(dec, bit, 0, high_ns);
+    decoder_track(dec, bit, 1, low_ns);
+    decoder_push_bit(dec, bit);
+}
+
+static void decoder_phase(check_decoder_t *dec, int level, uint32_t ticks)
+{
+    if (ticks == 0U) {
+        decoder_fail(dec, "zero-length phase", 0);
+        return;
+    }
+    dec->wire_ticks += ticks;
+    if (level == dec->level) {
+        dec->phase_ticks += ticks;
+        return;
+    }
+    if (dec->level == 1) {
+        dec->high_ticks = dec->phase_ticks;
+    } else if (dec->level == 0) {
+        if (dec->high_ticks == 0U) {
+            decoder_fail(dec, "stream starts low", ticks_to_ns(dec, dec->phase_ticks));
+        } else {
+            decoder_close_bit(dec, dec->phase_ticks);
+        }
+    }
+    dec->level = level;
+    dec->phase_ticks = ticks;
+}
+
+static void decoder_symbol(check_decoder_t *dec, uint32_t symbol)
+{
+    decoder_phase(dec, (int)((symbol >> 15) & 1U), symbol & 0x7FFFU);
+    decoder_phase(dec, (int)(symbol >> 31), (symbol >> 16) & 0x7FFFU);
+}
+
+/* End of the stream: the last low holds the last bit's tail and the reset. */
+static void decoder_finish(check_decoder_t *dec)
+{
+    if (dec->level != 0 || dec->high_ticks == 0U) {
+        decoder_fail(dec, "stream does not end low", 0);
+        return;
+    }
+    const uint32_t high_ns = ticks_to_ns(dec, dec->high_ticks);
+    const int bit = decoder_classify_high(dec, high_ns);
+    if (bit < 0) {
+        return;
+    }
+    decoder_track(dec, bit, 0, high_ns);
+    decoder_push_bit(dec, bit);
+
+    /* RES is the line's low time after the last falling edge, tail included. */
+    const uint64_t low_ns = (uint64_t)dec->phase_ticks * 1000000000ULL / dec->config->resolution_hz;
+    dec->reset_ns = low_ns;
+    for (size_t i = 0; i < CHECK_PROFILES; ++i) {
+        if (low_ns < s_profiles[i].reset_min) {
+            decoder_fail(dec, "reset too short", (uint32_t)low_ns);
+        }
+    }
+    if (dec->pixel != dec->config->leds || dec->byte_bits != 0U) {
+        fprintf(stderr, "frame %" PRIu32 ": decoded %" PRIu32 " pixels + %" PRIu32 " bits, want %" PRIu32 "\n",
+                dec->source->frame, dec->pixel, dec->byte_bits, dec->config->leds);
+        dec->errors++;
+    }
+}
+
+static bool parse_args(int argc, char **argv, check_config_t *config)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--check") == 0) {
+            config->check = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const uint32_t value = (uint32_t)strtoul(argv[++i], NULL, 0);
+        if (strcmp(arg, "--leds") == 0) {
+            config->leds = value;
+        } else if (strcmp(arg, "--frames") == 0) {
+            config->frames = value;
+        } else if (strcmp(arg, "--resolution") == 0) {
+            config->resolution_hz = value;
+        } else if (strcmp(arg, "--mem") == 0) {
+            config->mem = value;
+        } else if (strcmp(arg, "--random") == 0) {
+            config->seed = value;
+        } else {
+            return false;
+        }
+    }
+    return config->leds > 0U && config->frames > 0U && config->mem >= 2U && config->mem <= CHECK_MAX_MEM;
+}
+
+int main(int argc, char **argv)
+{
+    check_config_t config = {
+        .leds = 3000,
+        .frames = 3,
+        .resolution_hz = 10000000,
+        .mem = 48,
+    };
+    if (!parse_args(argc, argv, &config)) {
+        fprintf(stderr,
+                "usage: %s [--leds N] [--frames N] [--resolution HZ] [--mem N] [--random SEED] [--check]\n",
+                argv[0]);
+        return 2;
+    }
+
+    led_ws2812_symbols_t symbols;
+    if (!led_ws2812_symbols_init(&symbols, config.resolution_hz)) {
+        fprintf(stderr, "resolution %" PRIu32 " Hz not supported\n", config.resolution_hz);
+        return 2;
+    }
+
+    uint32_t mem[CHECK_MAX_MEM];
+    uint32_t errors = 0;
+    uint64_t refills = 0;
+    uint64_t symbols_total = 0;
+    uint64_t fill_ns = 0;
+    uint32_t max_refill = 0;
+    check_decoder_t last = { 0 };
+    srand(config.seed);
+
+    for (uint32_t frame = 0; frame < config.frames; ++frame) {
+        rainbow_t source_ctx = { .frame = frame, .leds = config.leds };
+        const led_ws2812_source_t source = { .pixel = rainbow_pixel, .ctx = &source_ctx, .led_count = config.leds };
+        check_decoder_t dec = { .config = &config, .source = &source_ctx, .level = -1 };
+        memset(dec.min_ns, 0xFF, sizeof(dec.min_ns));
+
+        led_ws2812_stream_t stream;
+        led_ws2812_stream_begin(&stream, &symbols, &source);
+        bool done = false;
+        size_t room = config.mem;
+        while (!done) {
+            if (config.seed != 0U) {
+                room = 1U + (size_t)rand() % config.mem;
+            }
+            struct timespec t0;
+            struct timespec t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            const size_t n = led_ws2812_stream_fill(&stream, mem, room, &done);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            fill_ns += (uint64_t)((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec));
+            if (n == 0U && !done) {
+                fprintf(stderr, "frame %" PRIu32 ": no progress with %zu symbols free\n", frame, room);
+                return 1;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                decoder_symbol(&dec, mem[i]);
+            }
+            refills++;
+            symbols_total += n;
+            if (n > max_refill) {
+                max_refill = (uint32_t)n;
+            }
+            room = config.mem / 2U;  /* ping-pong: one half drained */
+        }
+        decoder_finish(&dec);
+        errors += dec.errors;
+        last = dec;
+    }
+
+    const uint64_t frame_us = last.wire_ticks * 1000000ULL / config.resolution_hz;
+    printf("leds %" PRIu32 ", frames %" PRIu32 ", resolution %" PRIu32 " Hz, %s refills of <= %" PRIu32 " symbols\n",
+           config.leds, config.frames, config.resolution_hz, config.seed ? "random" : "ping-pong", config.mem);
+    printf("  symbols %" PRIu64 " in %" PRIu64 " refills (max %" PRIu32 "), frame on the wire %" PRIu64 " us\n",
+           symbols_total, refills, max_refill, frame_us);
+    printf("  bit 0: high %" PRIu32 "-%" PRIu32 " ns, low %" PRIu32 "-%" PRIu32 " ns\n", last.min_ns[0][0],
+           last.max_ns[0][0], last.min_ns[0][1], last.max_ns[0][1]);
+    printf("  bit 1: high %" PRIu32 "-%" PRIu32 " ns, low %" PRIu32 "-%" PRIu32 " ns\n", last.min_ns[1][0],
+           last.max_ns[1][0], last.min_ns[1][1], last.max_ns[1][1]);
+    printf("  final low %" PRIu64 " ns (last bit tail + reset)\n", last.reset_ns);
+    printf("  RAM: %zu B of symbols vs %" PRIu32 " B GRB frame, %" PRIu64 " B full symbol buffer\n",
+           (size_t)config.mem * sizeof(uint32_t), config.leds * 3U, (uint64_t)config.leds * 24U * sizeof(uint32_t));
+    printf("  host fill cost %.1f ns/symbol (a half block drains in %" PRIu64 " ns)\n",
+           symbols_total ? (double)fill_ns / (double)symbols_total : 0.0,
+           (uint64_t)(config.mem / 2U) * 1200U);
+    printf("  errors %" PRIu32 "\n", errors);
+
+    if (config.check && errors != 0U) {
+        fprintf(stderr, "check failed\n");
+        return 1;
+    }
+    return 0;
+}
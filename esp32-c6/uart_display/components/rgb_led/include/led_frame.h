@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ * led_frame.h
+ *
+ * Double-buffered, non-blocking pixel frames for an LED transmit backend.
+ * The drawing task acquires a free buffer, fills it and submits it; submit
+ * starts the transfer and returns at once, so frame N+1 is drawn while
+ * frame N is still on the wire. The backend reports each finished transfer
+ * with led_frame_complete() (typically from its done interrupt), which
+ * frees that buffer.
+ *
+ * Ownership: a buffer belongs to exactly one side at a time.
+ *   FREE     nobody; led_frame_acquire() may hand it out
+ *   DRAWING  the task that acquired it; it may write the pixels
+ *   SENDING  the backend, from submit until its transfer completes; the
+ *            pixels must not change (the RMT/SPI encoders read them while
+ *            sending)
+ * Submitting a buffer the caller does not hold is refused and counted.
+ *
+ * One task acquires and submits; one completion context (task or ISR)
+ * completes. Buffer states are atomics, so neither side takes a lock. No
+ * ESP-IDF dependency; builds and runs on the host.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_FRAME_BUFFERS 2U
+
+typedef enum {
+    LED_FRAME_BUF_FREE = 0,
+    LED_FRAME_BUF_DRAWING,
+    LED_FRAME_BUF_SENDING,
+} led_frame_buf_state_t;
+
+typedef struct {
+    /*
+     * Starts sending len bytes of buf and returns without waiting for it.
+     * Transfers finish in the order they were started; each one must be
+     * reported with led_frame_complete(). False: nothing was started.
+     */
+    bool (*transmit)(void *ctx, const uint8_t *buf, size_t len);
+    void *ctx;
+} led_frame_backend_t;
+
+typedef struct {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t busy;        /* acquire found both buffers taken */
+    uint32_t misuse;      /* submit/release of a buffer the caller does not hold */
+    uint32_t tx_errors;
+} led_frame_stats_t;
+
+typedef struct {
+    led_frame_backend_t backend;
+    uint8_t *buf[LED_FRAME_BUFFERS];
+    size_t len;
+    atomic_uint_least32_t state[LED_FRAME_BUFFERS];  /* led_frame_buf_state_t */
+    uint32_t seq[LED_FRAME_BUFFERS];                 /* submit order, valid while SENDING */
+    uint32_t next_seq;
+    /* Written by the drawing task, except completed (completion side). */
+    uint32_t submitted;
+    uint32_t busy;
+    uint32_t misuse;
+    uint32_t tx_errors;
+    atomic_uint_least32_t completed;
+} led_frame_t;
+
+/* Both buffers hold len bytes and start zeroed (all pixels off). */
+bool led_frame_init(led_frame_t *frame, uint8_t *buf_a, uint8_t *buf_b, size_t len,
+                    const led_frame_backend_t *backend);
+
+/*
+ * A free buffer for drawing, or NULL while one is being sent and the other
+ * is sent or held. Its pixels are those of the frame before the last one:
+ * redraw every pixel.
+ */
+uint8_t *led_frame_acquire(led_frame_t *frame);
+
+/* Hands a DRAWING buffer to the backend. False if refused or the transmit failed (buffer freed). */
+bool led_frame_submit(led_frame_t *frame, uint8_t *buf);
+
+/* Gives a DRAWING buffer back unsent. */
+void led_frame_release(led_frame_t *frame, uint8_t *buf);
+
+/* The oldest transfer finished: frees its buffer and returns it (NULL if none was sending). */
+const uint8_t *led_frame_complete(led_frame_t *frame);
+
+size_t led_frame_in_flight(const led_frame_t *frame);
+void led_frame_get_stats(const led_frame_t *frame, led_frame_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * led_ws2812_encoder.h
+ *
+ * RMT encoder for WS2812 pixels: GRB bytes MSB first, then a 280 us low
+ * reset so every transfer latches on its own, even when the RMT queue
+ * starts the next one straight after it.
+ *
+ * The stream encoder sends the same waveform from a led_ws2812_source_t
+ * instead of a GRB buffer: pixels are pulled one at a time, from the RMT
+ * interrupt, as channel memory drains. Pass the source as the transmit
+ * payload and keep it alive until the transfer is done:
+ *
+ *     led_ws2812_source_t src = { .pixel = gradient, .ctx = &fx, .led_count = 3000 };
+ *     rmt_transmit(channel, stream_encoder, &src, sizeof(src), &tx_config);
+ */
+
+#include "driver/rmt_encoder.h"
+#include "esp_err.h"
+#include "led_ws2812_stream.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t led_ws2812_encoder_new(uint32_t resolution_hz, rmt_encoder_handle_t *out_encoder);
+esp_err_t led_ws2812_stream_encoder_new(uint32_t resolution_hz, rmt_encoder_handle_t *out_encoder);
+
+#ifdef __cplusplus
+}
+#endif
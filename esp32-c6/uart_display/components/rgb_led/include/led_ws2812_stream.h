@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ * led_ws2812_stream.h
+ *
+ * WS2812 symbol generator that pulls pixels from a callback instead of a
+ * frame buffer. Each call fills as many RMT symbols as fit (bit granular,
+ * one symbol per bit, then one reset symbol), so a strip of any length
+ * needs neither a GRB frame nor a symbol buffer in RAM: only the RMT
+ * channel's own memory, refilled as it drains. led_ws2812_encoder.h wraps
+ * it as an RMT simple encoder.
+ *
+ * Symbols use the rmt_symbol_word_t layout: duration0 bits 0-14, level0
+ * bit 15, duration1 bits 16-30, level1 bit 31. No ESP-IDF dependency;
+ * builds and runs on the host.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* WS2812B-V5 latches after 280 us of low; older parts after 50 us. */
+#define LED_WS2812_RESET_US 280U
+
+#define LED_WS2812_SYMBOL(d0, l0, d1, l1) \
+    ((uint32_t)(d0) | ((uint32_t)(l0) << 15) | ((uint32_t)(d1) << 16) | ((uint32_t)(l1) << 31))
+
+/*
+ * Writes pixel `index` as G, R, B. May be called from the RMT interrupt
+ * while the strip is being sent: keep it short and ISR safe.
+ */
+typedef void (*led_ws2812_pixel_fn_t)(void *ctx, uint32_t index, uint8_t grb[3]);
+
+typedef struct {
+    led_ws2812_pixel_fn_t pixel;
+    void *ctx;
+    uint32_t led_count;
+} led_ws2812_source_t;
+
+typedef struct {
+    uint32_t bit0;   /* T0H 0.3 us high, T0L 0.9 us low */
+    uint32_t bit1;   /* T1H 0.9 us high, T1L 0.3 us low */
+    uint32_t reset;  /* LED_WS2812_RESET_US low, split over both halves */
+} led_ws2812_symbols_t;
+
+typedef struct {
+    led_ws2812_symbols_t symbols;
+    led_ws2812_source_t source;
+    uint32_t next_led;
+    uint32_t bits;   /* current pixel, MSB first, left-aligned in the top 24 bits */
+    uint8_t bits_left;
+    bool reset_sent;
+} led_ws2812_stream_t;
+
+/* resolution_hz: RMT tick rate; a multiple of 10 MHz keeps every timing exact. */
+bool led_ws2812_symbols_init(led_ws2812_symbols_t *symbols, uint32_t resolution_hz);
+
+void led_ws2812_stream_begin(led_ws2812_stream_t *stream, const led_ws2812_symbols_t *symbols,
+                             const led_ws2812_source_t *source);
+
+/*
+ * Writes up to max symbols and returns how many. *out_done is set once the
+ * last pixel and the reset have been written.
+ */
+size_t led_ws2812_stream_fill(led_ws2812_stream_t *stream, uint32_t *out, size_t max, bool *out_done);
+
+#ifdef __cplusplus
+}
+#endif
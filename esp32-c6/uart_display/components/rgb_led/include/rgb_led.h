@@ -1,10 +1,31 @@
 #pragma once
 
+/*
+ * rgb_led.h
+ *
+ * On-board WS2812 driven by the RMT peripheral through led_frame: two pixel
+ * buffers, so a colour change draws the next frame while the previous one is
+ * still being sent and never waits for the transfer. The demo animation is a
+ * job_scheduler job, paced at RGB_FRAME_PERIOD_MS without drift.
+ */
+
 #include "driver/gpio.h"
-#include "led_strip.h"
+#include "led_frame.h"
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #define BLINK_GPIO 8
+#define RGB_LED_COUNT 1U
+#define RGB_FRAME_PERIOD_MS 20U
 
 void RGB_Init(void);
+
+/* Returns once the frame is queued; waits only while both buffers are busy. One task at a time. */
 void Set_RGB(uint8_t red_val, uint8_t green_val, uint8_t blue_val);
-void RGB_Example(void);
+
+/* Adds the palette animation as the "rgb" job; job_scheduler must be started. */
+bool RGB_Example(void);
+
+/* busy counts animation frames skipped because both buffers were taken. */
+void RGB_GetStats(led_frame_stats_t *out_stats);
@@ -0,0 +1,131 @@
+#include "led_frame.h"
+
+#include <string.h>
+
+static int led_frame_index(const led_frame_t *frame, const uint8_t *buf)
+{
+    for (uint32_t i = 0; i < LED_FRAME_BUFFERS; ++i) {
+        if (frame->buf[i] == buf) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static led_frame_buf_state_t led_frame_state(const led_frame_t *frame, uint32_t i)
+{
+    return (led_frame_buf_state_t)atomic_load_explicit(&frame->state[i], memory_order_acquire);
+}
+
+static void led_frame_set_state(led_frame_t *frame, uint32_t i, led_frame_buf_state_t state)
+{
+    atomic_store_explicit(&frame->state[i], (uint_least32_t)state, memory_order_release);
+}
+
+bool led_frame_init(led_frame_t *frame, uint8_t *buf_a, uint8_t *buf_b, size_t len,
+                    const led_frame_backend_t *backend)
+{
+    if (frame == NULL || buf_a == NULL || buf_b == NULL || buf_a == buf_b || len == 0U ||
+        backend == NULL || backend->transmit == NULL) {
+        return false;
+    }
+
+    memset(frame, 0, sizeof(*frame));
+    frame->backend = *backend;
+    frame->buf[0] = buf_a;
+    frame->buf[1] = buf_b;
+    frame->len = len;
+    memset(buf_a, 0, len);
+    memset(buf_b, 0, len);
+    for (uint32_t i = 0; i < LED_FRAME_BUFFERS; ++i) {
+        atomic_init(&frame->state[i], LED_FRAME_BUF_FREE);
+    }
+    atomic_init(&frame->completed, 0U);
+    return true;
+}
+
+uint8_t *led_frame_acquire(led_frame_t *frame)
+{
+    /* Only this side moves a buffer out of FREE, so a FREE buffer stays ours. */
+    for (uint32_t i = 0; i < LED_FRAME_BUFFERS; ++i) {
+        if (led_frame_state(frame, i) == LED_FRAME_BUF_FREE) {
+            led_frame_set_state(frame, i, LED_FRAME_BUF_DRAWING);
+            return frame->buf[i];
+        }
+    }
+    frame->busy++;
+    return NULL;
+}
+
+bool led_frame_submit(led_frame_t *frame, uint8_t *buf)
+{
+    const int i = led_frame_index(frame, buf);
+    if (i < 0 || led_frame_state(frame, (uint32_t)i) != LED_FRAME_BUF_DRAWING) {
+        frame->misuse++;
+        return false;
+    }
+
+    /* SENDING before the transfer starts: it may complete before transmit() returns. */
+    frame->seq[i] = frame->next_seq++;
+    led_frame_set_state(frame, (uint32_t)i, LED_FRAME_BUF_SENDING);
+    if (!frame->backend.transmit(frame->backend.ctx, buf, frame->len)) {
+        /* Never started, so the completion side cannot be freeing it. */
+        led_frame_set_state(frame, (uint32_t)i, LED_FRAME_BUF_FREE);
+        frame->tx_errors++;
+        return false;
+    }
+    frame->submitted++;
+    return true;
+}
+
+void led_frame_release(led_frame_t *frame, uint8_t *buf)
+{
+    const int i = led_frame_index(frame, buf);
+    if (i < 0 || led_frame_state(frame, (uint32_t)i) != LED_FRAME_BUF_DRAWING) {
+        frame->misuse++;
+        return;
+    }
+    led_frame_set_state(frame, (uint32_t)i, LED_FRAME_BUF_FREE);
+}
+
+const uint8_t *led_frame_complete(led_frame_t *frame)
+{
+    int oldest = -1;
+    for (uint32_t i = 0; i < LED_FRAME_BUFFERS; ++i) {
+        if (led_frame_state(frame, i) != LED_FRAME_BUF_SENDING) {
+            continue;
+        }
+        if (oldest < 0 || (int32_t)(frame->seq[i] - frame->seq[oldest]) < 0) {
+            oldest = (int)i;
+        }
+    }
+    if (oldest < 0) {
+        return NULL;
+    }
+
+    led_frame_set_state(frame, (uint32_t)oldest, LED_FRAME_BUF_FREE);
+    atomic_fetch_add_explicit(&frame->completed, 1U, memory_order_relaxed);
+    return frame->buf[oldest];
+}
+
+size_t led_frame_in_flight(const led_frame_t *frame)
+{
+    size_t count = 0;
+    for (uint32_t i = 0; i < LED_FRAME_BUFFERS; ++i) {
+        count += (led_frame_state(frame, i) == LED_FRAME_BUF_SENDING) ? 1U : 0U;
+    }
+    return count;
+}
+
+void led_frame_get_stats(const led_frame_t *frame, led_frame_stats_t *out_stats)
+{
+    if (frame == NULL || out_stats == NULL) {
+        return;
+    }
+
+    out_stats->submitted = frame->submitted;
+    out_stats->completed = atomic_load_explicit(&frame->completed, memory_order_relaxed);
+    out_stats->busy = frame->busy;
+    out_stats->misuse = frame->misuse;
+    out_stats->tx_errors = frame->tx_errors;
+}
@@ -0,0 +1,184 @@
+#include "led_ws2812_encoder.h"
+
+#include "esp_attr.h"
+#include "esp_check.h"
+
+#include <stdlib.h>
+
+/* One pixel per refill at least, so the source is never asked for a fraction of one. */
+#define LED_WS2812_STREAM_MIN_CHUNK 24U
+
+static const char *TAG = "ws2812_enc";
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_encoder_t *bytes_encoder;
+    rmt_encoder_t *copy_encoder;
+    int state;  /* 0: pixels, 1: reset code */
+    rmt_symbol_word_t reset_code;
+} led_ws2812_encoder_t;
+
+static size_t IRAM_ATTR led_ws2812_encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel,
+                                          const void *data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    led_ws2812_encoder_t *ws = __containerof(encoder, led_ws2812_encoder_t, base);
+    rmt_encode_state_t session = RMT_ENCODING_RESET;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t symbols = 0;
+
+    if (ws->state == 0) {
+        symbols += ws->bytes_encoder->encode(ws->bytes_encoder, channel, data, data_size, &session);
+        if (session & RMT_ENCODING_COMPLETE) {
+            ws->state = 1;
+        }
+        if (session & RMT_ENCODING_MEM_FULL) {
+            *ret_state = RMT_ENCODING_MEM_FULL;
+            return symbols;
+        }
+    }
+
+    symbols += ws->copy_encoder->encode(ws->copy_encoder, channel, &ws->reset_code, sizeof(ws->reset_code), &session);
+    if (session & RMT_ENCODING_COMPLETE) {
+        ws->state = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (session & RMT_ENCODING_MEM_FULL) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = state;
+    return symbols;
+}
+
+static esp_err_t led_ws2812_reset(rmt_encoder_t *encoder)
+{
+    led_ws2812_encoder_t *ws = __containerof(encoder, led_ws2812_encoder_t, base);
+    rmt_encoder_reset(ws->bytes_encoder);
+    rmt_encoder_reset(ws->copy_encoder);
+    ws->state = 0;
+    return ESP_OK;
+}
+
+static esp_err_t led_ws2812_del(rmt_encoder_t *encoder)
+{
+    led_ws2812_encoder_t *ws = __containerof(encoder, led_ws2812_encoder_t, base);
+    if (ws->bytes_encoder != NULL) {
+        rmt_del_encoder(ws->bytes_encoder);
+    }
+    if (ws->copy_encoder != NULL) {
+        rmt_del_encoder(ws->copy_encoder);
+    }
+    free(ws);
+    return ESP_OK;
+}
+
+esp_err_t led_ws2812_encoder_new(uint32_t resolution_hz, rmt_encoder_handle_t *out_encoder)
+{
+    ESP_RETURN_ON_FALSE(out_encoder != NULL && resolution_hz >= 1000000U, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    led_ws2812_encoder_t *ws = calloc(1, sizeof(*ws));
+    ESP_RETURN_ON_FALSE(ws != NULL, ESP_ERR_NO_MEM, TAG, "no memory for encoder");
+    ws->base.encode = led_ws2812_encode;
+    ws->base.reset = led_ws2812_reset;
+    ws->base.del = led_ws2812_del;
+
+    /* T0H 0.3 us / T0L 0.9 us, T1H 0.9 us / T1L 0.3 us. */
+    const uint32_t ticks_300ns = resolution_hz * 3U / 10000000U;
+    const rmt_bytes_encoder_config_t bytes_config = {
+        .bit0 = { .level0 = 1, .duration0 = ticks_300ns, .level1 = 0, .duration1 = ticks_300ns * 3U },
+        .bit1 = { .level0 = 1, .duration0 = ticks_300ns * 3U, .level1 = 0, .duration1 = ticks_300ns },
+        .flags.msb_first = 1,
+    };
+    const rmt_copy_encoder_config_t copy_config = {};
+    const uint32_t reset_ticks = resolution_hz / 1000000U * LED_WS2812_RESET_US / 2U;
+    ws->reset_code = (rmt_symbol_word_t){ .level0 = 0, .duration0 = reset_ticks, .level1 = 0, .duration1 = reset_ticks };
+
+    esp_err_t err = rmt_new_bytes_encoder(&bytes_config, &ws->bytes_encoder);
+    if (err == ESP_OK) {
+        err = rmt_new_copy_encoder(&copy_config, &ws->copy_encoder);
+    }
+    if (err != ESP_OK) {
+        led_ws2812_del(&ws->base);
+        ESP_LOGE(TAG, "encoder setup failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    *out_encoder = &ws->base;
+    return ESP_OK;
+}
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_encoder_t *simple_encoder;
+    led_ws2812_stream_t stream;
+    led_ws2812_symbols_t symbols;
+} led_ws2812_stream_encoder_t;
+
+static size_t IRAM_ATTR led_ws2812_stream_cb(const void *data, size_t data_size, size_t symbols_written,
+                                             size_t symbols_free, rmt_symbol_word_t *symbols, bool *done, void *arg)
+{
+    led_ws2812_stream_encoder_t *ws = arg;
+
+    if (symbols_written == 0U) {
+        if (data_size != sizeof(led_ws2812_source_t)) {
+            *done = true;
+            return 0;
+        }
+        led_ws2812_stream_begin(&ws->stream, &ws->symbols, data);
+    }
+    return led_ws2812_stream_fill(&ws->stream, (uint32_t *)symbols, symbols_free, done);
+}
+
+static size_t IRAM_ATTR led_ws2812_stream_encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel,
+                                                 const void *data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    led_ws2812_stream_encoder_t *ws = __containerof(encoder, led_ws2812_stream_encoder_t, base);
+    return ws->simple_encoder->encode(ws->simple_encoder, channel, data, data_size, ret_state);
+}
+
+static esp_err_t led_ws2812_stream_reset(rmt_encoder_t *encoder)
+{
+    led_ws2812_stream_encoder_t *ws = __containerof(encoder, led_ws2812_stream_encoder_t, base);
+    return rmt_encoder_reset(ws->simple_encoder);
+}
+
+static esp_err_t led_ws2812_stream_del(rmt_encoder_t *encoder)
+{
+    led_ws2812_stream_encoder_t *ws = __containerof(encoder, led_ws2812_stream_encoder_t, base);
+    if (ws->simple_encoder != NULL) {
+        rmt_del_encoder(ws->simple_encoder);
+    }
+    free(ws);
+    return ESP_OK;
+}
+
+esp_err_t led_ws2812_stream_encoder_new(uint32_t resolution_hz, rmt_encoder_handle_t *out_encoder)
+{
+    _Static_assert(sizeof(rmt_symbol_word_t) == sizeof(uint32_t), "symbol layout");
+    ESP_RETURN_ON_FALSE(out_encoder != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    led_ws2812_stream_encoder_t *ws = calloc(1, sizeof(*ws));
+    ESP_RETURN_ON_FALSE(ws != NULL, ESP_ERR_NO_MEM, TAG, "no memory for encoder");
+    if (!led_ws2812_symbols_init(&ws->symbols, resolution_hz)) {
+        free(ws);
+        ESP_LOGE(TAG, "unsupported resolution %lu Hz", (unsigned long)resolution_hz);
+        return ESP_ERR_INVALID_ARG;
+    }
+    ws->base.encode = led_ws2812_stream_encode;
+    ws->base.reset = led_ws2812_stream_reset;
+    ws->base.del = led_ws2812_stream_del;
+
+    const rmt_simple_encoder_config_t simple_config = {
+        .callback = led_ws2812_stream_cb,
+        .arg = ws,
+        .min_chunk_size = LED_WS2812_STREAM_MIN_CHUNK,
+    };
+    esp_err_t err = rmt_new_simple_encoder(&simple_config, &ws->simple_encoder);
+    if (err != ESP_OK) {
+        free(ws);
+        ESP_LOGE(TAG, "stream encoder setup failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    *out_encoder = &ws->base;
+    return ESP_OK;
+}
@@ -0,0 +1,68 @@
+#include "led_ws2812_stream.h"
+
+#include <string.h>
+
+#define LED_WS2812_MAX_TICKS 0x7FFFU
+
+bool led_ws2812_symbols_init(led_ws2812_symbols_t *symbols, uint32_t resolution_hz)
+{
+    if (symbols == NULL) {
+        return false;
+    }
+
+    /* 0.3 us is the shortest phase; at least one tick, at most a 15-bit duration per reset half. */
+    const uint32_t t300ns = (uint32_t)((uint64_t)resolution_hz * 3U / 10000000U);
+    const uint64_t reset_half = (uint64_t)resolution_hz * LED_WS2812_RESET_US / 2000000U;
+    if (t300ns == 0U || t300ns * 3U > LED_WS2812_MAX_TICKS || reset_half == 0U || reset_half > LED_WS2812_MAX_TICKS) {
+        return false;
+    }
+
+    symbols->bit0 = LED_WS2812_SYMBOL(t300ns, 1, t300ns * 3U, 0);
+    symbols->bit1 = LED_WS2812_SYMBOL(t300ns * 3U, 1, t300ns, 0);
+    symbols->reset = LED_WS2812_SYMBOL(reset_half, 0, reset_half, 0);
+    return true;
+}
+
+void led_ws2812_stream_begin(led_ws2812_stream_t *stream, const led_ws2812_symbols_t *symbols,
+                             const led_ws2812_source_t *source)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->symbols = *symbols;
+    stream->source = *source;
+}
+
+size_t led_ws2812_stream_fill(led_ws2812_stream_t *stream, uint32_t *out, size_t max, bool *out_done)
+{
+    size_t written = 0;
+
+    while (written < max) {
+        if (stream->bits_left == 0U) {
+            if (stream->next_led >= stream->source.led_count) {
+                break;
+            }
+            uint8_t grb[3] = { 0, 0, 0 };
+            stream->source.pixel(stream->source.ctx, stream->next_led++, grb);
+            stream->bits = ((uint32_t)grb[0] << 24) | ((uint32_t)grb[1] << 16) | ((uint32_t)grb[2] << 8);
+            stream->bits_left = 24U;
+        }
+
+        /* Whole runs of bits at a time: this runs in the RMT interrupt. */
+        size_t run = max - written;
+        if (run > stream->bits_left) {
+            run = stream->bits_left;
+        }
+        for (size_t i = 0; i < run; ++i) {
+            out[written++] = (stream->bits & 0x80000000U) ? stream->symbols.bit1 : stream->symbols.bit0;
+            stream->bits <<= 1;
+        }
+        stream->bits_left = (uint8_t)(stream->bits_left - run);
+    }
+
+    if (!stream->reset_sent && stream->bits_left == 0U && stream->next_led >= stream->source.led_count &&
+        written < max) {
+        out[written++] = stream->symbols.reset;
+        stream->reset_sent = true;
+    }
+    *out_done = stream->reset_sent;
+    return written;
+}
@@ -0,0 +1,121 @@
+#include "led_frame.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_LEDS 4U
+#define TEST_LEN (TEST_LEDS * 3U)
+
+/* Stand-in backend: records what went on the wire and can refuse a transfer. */
+typedef struct {
+    const uint8_t *sent[8];
+    uint8_t wire[8][TEST_LEN];
+    uint32_t count;
+    bool fail_next;
+} test_backend_t;
+
+static bool test_transmit(void *ctx, const uint8_t *buf, size_t len)
+{
+    test_backend_t *backend = ctx;
+    if (backend->fail_next) {
+        backend->fail_next = false;
+        return false;
+    }
+    TEST_ASSERT_EQUAL_UINT32(TEST_LEN, len);
+    backend->sent[backend->count] = buf;
+    memcpy(backend->wire[backend->count], buf, len);
+    backend->count++;
+    return true;
+}
+
+static void test_setup(led_frame_t *frame, test_backend_t *backend, uint8_t *a, uint8_t *b)
+{
+    memset(backend, 0, sizeof(*backend));
+    const led_frame_backend_t ops = { .transmit = test_transmit, .ctx = backend };
+    TEST_ASSERT_TRUE(led_frame_init(frame, a, b, TEST_LEN, &ops));
+}
+
+TEST_CASE("led_frame hands each buffer to one owner at a time", "[rgb_led]")
+{
+    static uint8_t a[TEST_LEN];
+    static uint8_t b[TEST_LEN];
+    test_backend_t backend;
+    led_frame_t frame;
+    test_setup(&frame, &backend, a, b);
+
+    uint8_t *first = led_frame_acquire(&frame);
+    TEST_ASSERT_NOT_NULL(first);
+    memset(first, 0x11, TEST_LEN);
+    TEST_ASSERT_TRUE(led_frame_submit(&frame, first));
+    TEST_ASSERT_EQUAL_PTR(first, backend.sent[0]);
+
+    /* While frame 1 is on the wire the other buffer is drawn; frame 1 is never touched. */
+    uint8_t *second = led_frame_acquire(&frame);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE(first != second);
+    memset(second, 0x22, TEST_LEN);
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x11, first, TEST_LEN);
+
+    /* Both taken: no third buffer, and a sending buffer cannot be submitted again. */
+    TEST_ASSERT_NULL(led_frame_acquire(&frame));
+    TEST_ASSERT_FALSE(led_frame_submit(&frame, first));
+    TEST_ASSERT_EQUAL_UINT32(1U, backend.count);
+
+    TEST_ASSERT_TRUE(led_frame_submit(&frame, second));
+    TEST_ASSERT_EQUAL_UINT32(2U, led_frame_in_flight(&frame));
+    TEST_ASSERT_FALSE(led_frame_submit(&frame, second));
+
+    /* Transfers complete in submit order and free exactly that buffer. */
+    TEST_ASSERT_EQUAL_PTR(first, led_frame_complete(&frame));
+    TEST_ASSERT_EQUAL_PTR(first, led_frame_acquire(&frame));
+    TEST_ASSERT_NULL(led_frame_acquire(&frame));
+    TEST_ASSERT_EQUAL_PTR(second, led_frame_complete(&frame));
+    TEST_ASSERT_NULL(led_frame_complete(&frame));
+
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x11, backend.wire[0], TEST_LEN);
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x22, backend.wire[1], TEST_LEN);
+
+    led_frame_stats_t stats;
+    led_frame_get_stats(&frame, &stats);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.submitted);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.completed);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.busy);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats.misuse);
+}
+
+TEST_CASE("led_frame refuses foreign buffers and frees a buffer whose transmit failed", "[rgb_led]")
+{
+    static uint8_t a[TEST_LEN];
+    static uint8_t b[TEST_LEN];
+    static uint8_t other[TEST_LEN];
+    test_backend_t backend;
+    led_frame_t frame;
+    test_setup(&frame, &backend, a, b);
+
+    TEST_ASSERT_FALSE(led_frame_submit(&frame, other));
+    TEST_ASSERT_FALSE(led_frame_submit(&frame, a));  /* FREE, never acquired */
+
+    uint8_t *buf = led_frame_acquire(&frame);
+    backend.fail_next = true;
+    TEST_ASSERT_FALSE(led_frame_submit(&frame, buf));
+    TEST_ASSERT_EQUAL_UINT32(0U, led_frame_in_flight(&frame));
+
+    /* Released buffers go back to the pool unsent. */
+    uint8_t *x = led_frame_acquire(&frame);
+    uint8_t *y = led_frame_acquire(&frame);
+    TEST_ASSERT_NOT_NULL(x);
+    TEST_ASSERT_NOT_NULL(y);
+    led_frame_release(&frame, y);
+    led_frame_release(&frame, y);
+    TEST_ASSERT_TRUE(led_frame_submit(&frame, x));
+    TEST_ASSERT_EQUAL_PTR(y, led_frame_acquire(&frame));
+
+    led_frame_stats_t stats;
+    led_frame_get_stats(&frame, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.submitted);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.tx_errors);
+    TEST_ASSERT_EQUAL_UINT32(3U, stats.misuse);
+    TEST_ASSERT_EQUAL_UINT32(1U, backend.count);
+}
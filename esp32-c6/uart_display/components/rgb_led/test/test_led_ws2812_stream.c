@@ -0,0 +1,68 @@
+#include "led_ws2812_stream.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_LEDS 5U
+#define TEST_SYMBOLS (TEST_LEDS * 24U + 1U)
+
+static void test_pixel(void *ctx, uint32_t index, uint8_t grb[3])
+{
+    uint32_t *calls = ctx;
+    (*calls)++;
+    grb[0] = (uint8_t)(0xA5U ^ index);
+    grb[1] = (uint8_t)(index * 37U);
+    grb[2] = (uint8_t)(0xFFU - index);
+}
+
+static size_t test_stream(uint32_t *out, size_t chunk, uint32_t *calls)
+{
+    led_ws2812_symbols_t symbols;
+    TEST_ASSERT_TRUE(led_ws2812_symbols_init(&symbols, 10000000U));
+    const led_ws2812_source_t source = { .pixel = test_pixel, .ctx = calls, .led_count = TEST_LEDS };
+    led_ws2812_stream_t stream;
+    led_ws2812_stream_begin(&stream, &symbols, &source);
+
+    size_t total = 0;
+    bool done = false;
+    while (!done) {
+        size_t room = TEST_SYMBOLS + 8U - total;
+        size_t n = led_ws2812_stream_fill(&stream, out + total, room < chunk ? room : chunk, &done);
+        TEST_ASSERT_TRUE(n > 0U);
+        total += n;
+    }
+    return total;
+}
+
+TEST_CASE("led_ws2812_stream emits one symbol per bit and a reset in any chunking", "[rgb_led]")
+{
+    uint32_t whole[TEST_SYMBOLS + 8U];
+    uint32_t calls = 0;
+    TEST_ASSERT_EQUAL_UINT32(TEST_SYMBOLS, test_stream(whole, SIZE_MAX, &calls));
+    TEST_ASSERT_EQUAL_UINT32(TEST_LEDS, calls);
+
+    /* 10 MHz: 3 + 9 ticks for a 0, 9 + 3 for a 1; reset 2 x 1400 ticks low. */
+    TEST_ASSERT_EQUAL_HEX32(LED_WS2812_SYMBOL(9, 1, 3, 0), whole[0]);   /* G of pixel 0 is 0xA5 */
+    TEST_ASSERT_EQUAL_HEX32(LED_WS2812_SYMBOL(3, 1, 9, 0), whole[1]);
+    TEST_ASSERT_EQUAL_HEX32(LED_WS2812_SYMBOL(1400, 0, 1400, 0), whole[TEST_SYMBOLS - 1U]);
+
+    static const size_t chunks[] = { 1, 7, 23, 24, 25, 48 };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+        uint32_t split[TEST_SYMBOLS + 8U];
+        calls = 0;
+        TEST_ASSERT_EQUAL_UINT32(TEST_SYMBOLS, test_stream(split, chunks[i], &calls));
+        TEST_ASSERT_EQUAL_UINT32(TEST_LEDS, calls);
+        TEST_ASSERT_EQUAL_MEMORY(whole, split, sizeof(uint32_t) * TEST_SYMBOLS);
+    }
+}
+
+TEST_CASE("led_ws2812_stream rejects resolutions it cannot time", "[rgb_led]")
+{
+    led_ws2812_symbols_t symbols;
+    TEST_ASSERT_FALSE(led_ws2812_symbols_init(&symbols, 1000000U));   /* 0.3 us < 1 tick */
+    TEST_ASSERT_FALSE(led_ws2812_symbols_init(&symbols, 400000000U)); /* reset half > 15 bits */
+    TEST_ASSERT_TRUE(led_ws2812_symbols_init(&symbols, 40000000U));
+    TEST_ASSERT_EQUAL_HEX32(LED_WS2812_SYMBOL(12, 1, 36, 0), symbols.bit0);
+}
@@ -1,19 +1,18 @@
 #pragma once
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 #include "lvgl.h"
 #include <stdbool.h>
 
-extern QueueHandle_t rtcQueue;
-extern QueueHandle_t dateQueue;
-extern QueueHandle_t tempQueue;
 extern lv_obj_t *uic_Label6;
 extern lv_obj_t *uic_LabelDate;
 extern lv_obj_t *uic_LabelTemp;
 
+#define RTC_TIME_JOB_PERIOD_MS 1000U
+#define RTC_TEMP_JOB_PERIOD_MS 2000U
+
+/* Call after system_snapshot_init(); the labels follow snapshot changes. */
 bool rtc_task_init(void);
-void start_rtc_task(void);
-void start_date_task(void);
-void start_temp_task(void);
+
+/* Time and temperature sampling as job_scheduler jobs (no task of their own). */
+bool rtc_task_start_jobs(void);
 void rtc_ui_clock_update(void);
@@ -4,143 +4,100 @@
 #include "temp_sensor.h"
 #include "app_log.h"
 #include "system_snapshot.h"
+#include "snapshot_history.h"
 #include "esp_log.h"
-#include "freertos/task.h"
+#include "job_scheduler.h"
 #include <stdio.h>
 #include <time.h>
 
+_Static_assert(RTC_TEMP_JOB_PERIOD_MS == SNAPSHOT_HISTORY_2S_PERIOD_S * 1000U,
+               "one temperature sample per finest history bucket");
+
 static const char *TAG = "RTC_TASK";
 
-#define RTC_QUEUE_LENGTH 10
-#define RTC_QUEUE_ITEM_SIZE 16
-#define DATE_QUEUE_ITEM_SIZE 16
-#define TEMP_QUEUE_ITEM_SIZE 16
-#define RTC_TASK_STACK_SIZE 4096
-#define DATE_TASK_STACK_SIZE 4096
-#define TEMP_TASK_STACK_SIZE 4096
-#define RTC_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
-#define DATE_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
-#define TEMP_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
-
-QueueHandle_t rtcQueue = NULL;
-QueueHandle_t dateQueue = NULL;
-QueueHandle_t tempQueue = NULL;
+#define RTC_LABEL_TEXT_SIZE 16
+
 lv_obj_t *uic_Label6 = NULL;
 lv_obj_t *uic_LabelDate = NULL;
 lv_obj_t *uic_LabelTemp = NULL;
 
-static void rtcClockTask(void *arg)
-{
-    char tbuf[RTC_QUEUE_ITEM_SIZE];
-    char iso_buf[SYSTEM_SNAPSHOT_ISO8601_LEN];
-
-    while (1) {
-        RTC_Clock_GetTime(tbuf, sizeof(tbuf));
-        (void)xQueueSend(rtcQueue, tbuf, 0);
-
-        time_t now = time(NULL);
-        struct tm timeinfo;
-        gmtime_r(&now, &timeinfo);
-        (void)strftime(iso_buf, sizeof(iso_buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
-        system_snapshot_update_time((int64_t)now, iso_buf);
-
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
-}
+/* UI subscription: time/date/temperature labels are redrawn only on change. */
+static system_snapshot_subscriber_id_t s_ui_subscriber = -1;
+static int s_ui_date_key = -1;
 
-static void dateTask(void *arg)
+static void rtc_time_job(void *ctx)
 {
-    char dbuf[DATE_QUEUE_ITEM_SIZE];
+    (void)ctx;
+    char iso_buf[SYSTEM_SNAPSHOT_ISO8601_LEN];
 
-    while (1) {
-        RTC_Clock_GetDate(dbuf, sizeof(dbuf));
-        (void)xQueueSend(dateQueue, dbuf, 0);
-        vTaskDelay(pdMS_TO_TICKS(24UL * 60 * 60 * 1000));
-    }
+    time_t now = time(NULL);
+    struct tm timeinfo;
+    gmtime_r(&now, &timeinfo);
+    (void)strftime(iso_buf, sizeof(iso_buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+    system_snapshot_update_time((int64_t)now, iso_buf);
 }
 
-static void tempTask(void *arg)
+static void rtc_temp_job(void *ctx)
 {
-    char tbuf[TEMP_QUEUE_ITEM_SIZE];
+    (void)ctx;
     float temp_c = 0.0f;
 
-    while (1) {
-        if (TempSensor_ReadCelsius(&temp_c)) {
-            (void)snprintf(tbuf, sizeof(tbuf), "%.1f C", (double)temp_c);
-            (void)xQueueSend(tempQueue, tbuf, 0);
-            app_log_write_fmt(APP_LOG_SUBSYS_SENSOR, APP_LOG_LEVEL_DEBUG, "TEMP: %.1f C", (double)temp_c);
-            system_snapshot_update_temperature(temp_c);
-        }
-        vTaskDelay(pdMS_TO_TICKS(2000));
+    if (TempSensor_ReadCelsius(&temp_c)) {
+        APP_LOGD(SENSOR, "TEMP: %.1f C", (double)temp_c);
+        system_snapshot_update_temperature(temp_c);
+        snapshot_history_record(SNAPSHOT_HISTORY_TEMPERATURE, (int32_t)(temp_c * 100.0f));
     }
 }
 
 bool rtc_task_init(void)
 {
-    ESP_LOGI(TAG, "Creating RTC update queue");
-    rtcQueue = xQueueCreate(RTC_QUEUE_LENGTH, RTC_QUEUE_ITEM_SIZE);
-    if (rtcQueue == NULL) {
-        return false;
+    ESP_LOGI(TAG, "Subscribing UI to time/temperature changes");
+    if (s_ui_subscriber >= 0) {
+        return true;
     }
 
-    dateQueue = xQueueCreate(RTC_QUEUE_LENGTH, DATE_QUEUE_ITEM_SIZE);
-    if (dateQueue == NULL) {
-        vQueueDelete(rtcQueue);
-        rtcQueue = NULL;
-        return false;
-    }
-
-    tempQueue = xQueueCreate(RTC_QUEUE_LENGTH, TEMP_QUEUE_ITEM_SIZE);
-    if (tempQueue == NULL) {
-        vQueueDelete(rtcQueue);
-        rtcQueue = NULL;
-        vQueueDelete(dateQueue);
-        dateQueue = NULL;
-        return false;
-    }
-
-    return true;
+    /* No callback: the LVGL timer collects changes on its own tick. */
+    return system_snapshot_subscribe(SYSTEM_SNAPSHOT_FIELD_TIME | SYSTEM_SNAPSHOT_FIELD_TEMPERATURE,
+                                     NULL, NULL, &s_ui_subscriber);
 }
 
-void start_rtc_task(void)
+bool rtc_task_start_jobs(void)
 {
-    ESP_LOGI(TAG, "Starting RTC clock task");
-    xTaskCreate(rtcClockTask, "rtcClockTask", RTC_TASK_STACK_SIZE, NULL, RTC_TASK_PRIORITY, NULL);
+    ESP_LOGI(TAG, "Scheduling clock and temperature jobs");
+    return job_scheduler_add("rtc", RTC_TIME_JOB_PERIOD_MS, rtc_time_job, NULL, NULL) &&
+           job_scheduler_add("temp", RTC_TEMP_JOB_PERIOD_MS, rtc_temp_job, NULL, NULL);
 }
 
-void start_date_task(void)
+void rtc_ui_clock_update(void)
 {
-    ESP_LOGI(TAG, "Starting RTC date task");
-    xTaskCreate(dateTask, "dateTask", DATE_TASK_STACK_SIZE, NULL, DATE_TASK_PRIORITY, NULL);
-}
+    char text[RTC_LABEL_TEXT_SIZE];
+    system_snapshot_delta_t delta;
 
-void start_temp_task(void)
-{
-    ESP_LOGI(TAG, "Starting temperature task");
-    xTaskCreate(tempTask, "tempTask", TEMP_TASK_STACK_SIZE, NULL, TEMP_TASK_PRIORITY, NULL);
-}
+    if (system_snapshot_take_changes(s_ui_subscriber, &delta) == 0U) {
+        return;
+    }
 
-void rtc_ui_clock_update(void)
-{
-    char clockStr[RTC_QUEUE_ITEM_SIZE];
-    char dateStr[DATE_QUEUE_ITEM_SIZE];
-    char tempStr[TEMP_QUEUE_ITEM_SIZE];
+    if ((delta.changed & SYSTEM_SNAPSHOT_FIELD_TIME) != 0U) {
+        const time_t now = (time_t)delta.values.epoch_seconds;
+        struct tm timeinfo;
+        localtime_r(&now, &timeinfo);
 
-    if (uic_Label6 != NULL && rtcQueue != NULL) {
-        if (xQueueReceive(rtcQueue, clockStr, 0) == pdTRUE) {
-            lv_label_set_text(uic_Label6, clockStr);
+        if (uic_Label6 != NULL) {
+            (void)strftime(text, sizeof(text), "%H:%M:%S", &timeinfo);
+            lv_label_set_text(uic_Label6, text);
         }
-    }
 
-    if (uic_LabelDate != NULL && dateQueue != NULL) {
-        if (xQueueReceive(dateQueue, dateStr, 0) == pdTRUE) {
-            lv_label_set_text(uic_LabelDate, dateStr);
+        /* The date label only changes at midnight (or when the clock is set). */
+        const int date_key = timeinfo.tm_year * 366 + timeinfo.tm_yday;
+        if (uic_LabelDate != NULL && date_key != s_ui_date_key) {
+            s_ui_date_key = date_key;
+            (void)strftime(text, sizeof(text), "%Y-%m-%d", &timeinfo);
+            lv_label_set_text(uic_LabelDate, text);
         }
     }
 
-    if (uic_LabelTemp != NULL && tempQueue != NULL) {
-        if (xQueueReceive(tempQueue, tempStr, 0) == pdTRUE) {
-            lv_label_set_text(uic_LabelTemp, tempStr);
-        }
+    if ((delta.changed & SYSTEM_SNAPSHOT_FIELD_TEMPERATURE) != 0U && uic_LabelTemp != NULL) {
+        (void)snprintf(text, sizeof(text), "%.1f C", (double)delta.values.temperature_c);
+        lv_label_set_text(uic_LabelTemp, text);
     }
 }
@@ -17,15 +17,24 @@
 #include "freertos/task.h"
 
 #define SD_MOUNT_POINT "/sdcard"
+#define SD_MOUNT_ATTEMPTS 3
 
 static const char *SD_STORAGE_TAG = "SD_Storage";
 static bool s_sd_mounted = false;
 
 bool SD_Mount(void)
+{
+    return SD_MountAttempts(SD_MOUNT_ATTEMPTS);
+}
+
+bool SD_MountAttempts(int attempts)
 {
     if (s_sd_mounted) {
         return true;
     }
+    if (attempts < 1) {
+        attempts = 1;
+    }
 
     esp_vfs_fat_sdmmc_mount_config_t mount_config = {
         .format_if_mount_failed = false,
@@ -65,20 +74,20 @@ bool SD_Mount(void)
     slot_config.host_id = host.slot;
 
     // Retry mounting with delays for large cards
-    for (int attempt = 1; attempt <= 3; attempt++) {
-        ESP_LOGI(SD_STORAGE_TAG, "SD mount attempt %d of 3...", attempt);
+    for (int attempt = 1; attempt <= attempts; attempt++) {
+        ESP_LOGI(SD_STORAGE_TAG, "SD mount attempt %d of %d...", attempt, attempts);
         ret = esp_vfs_fat_sdspi_mount(SD_MOUNT_POINT, &host, &slot_config, &mount_config, &card);
         if (ret == ESP_OK) {
             break;
         }
         ESP_LOGW(SD_STORAGE_TAG, "Mount attempt %d failed: %s", attempt, esp_err_to_name(ret));
-        if (attempt < 3) {
+        if (attempt < attempts) {
             vTaskDelay(pdMS_TO_TICKS(500));  // Wait 500ms before retry
         }
     }
 
     if (ret != ESP_OK) {
-        ESP_LOGE(SD_STORAGE_TAG, "Mount failed after 3 attempts: %s", esp_err_to_name(ret));
+        ESP_LOGE(SD_STORAGE_TAG, "Mount failed after %d attempts: %s", attempts, esp_err_to_name(ret));
         app_log_write_fmt(APP_LOG_SUBSYS_STORAGE, APP_LOG_LEVEL_ERROR, "mount failed: %s", esp_err_to_name(ret));
         return false;
     }
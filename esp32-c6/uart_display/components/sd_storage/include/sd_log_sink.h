@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * sd_log_sink.h
+ *
+ * app_log backend that persists log lines to rotating files on the SD card.
+ * Callers only copy the line into one of two RAM blocks; a low-priority
+ * writer task writes whole SD_LOG_BLOCK_SIZE blocks at block-aligned file
+ * offsets, so logging never waits on the SPI bus the LCD shares. The writer
+ * sends each block in spi_arbiter chunks between LCD frames.
+ *
+ * File format: a sequence of SD_LOG_BLOCK_SIZE blocks. Each block is a
+ * sd_log_block_header_t, `used` payload bytes, then zero padding. The payload
+ * is newline-terminated text lines ("<uptime ms> [SUBSYS][LVL] msg") and, in
+ * binary mode, app_log record frames. A partly filled block is rewritten in
+ * place on every flush until it fills, so at most flush_interval_ms of logs
+ * is lost on a power cut. On start the newest file's tail is validated
+ * (header CRC) and appended to.
+ */
+
+#include "app_log.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_LOG_BLOCK_SIZE 4096U
+#define SD_LOG_BLOCK_MAGIC 0x474F4C41U /* "ALOG" */
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t seq;      /* increases by one per block, across files */
+    uint16_t used;     /* payload bytes */
+    uint16_t reserved;
+    uint32_t crc32;    /* esp_rom_crc32_le over the payload */
+} sd_log_block_header_t;
+
+#define SD_LOG_BLOCK_PAYLOAD (SD_LOG_BLOCK_SIZE - sizeof(sd_log_block_header_t))
+
+typedef struct {
+    const char *dir;            /* created if missing, e.g. "/sdcard/LOGS" */
+    uint32_t max_file_size;     /* rotate once a file holds this many bytes */
+    uint32_t max_files;         /* oldest files beyond this count are deleted */
+    uint32_t flush_interval_ms; /* partial block rewrite period */
+    bool binary;                /* accept app_log binary frames (deferred mode) */
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+    BaseType_t core_id;
+} sd_log_sink_config_t;
+
+typedef struct {
+    uint32_t file_index;
+    uint32_t block_seq;
+    uint32_t bytes_staged;
+    uint32_t blocks_written; /* full-block writes, including partial rewrites */
+    uint32_t lines_dropped;  /* both RAM blocks busy, lock timeout, or sink not running */
+    uint32_t write_errors;
+    uint32_t files_rotated;
+    uint32_t recovered_bytes; /* payload found in the tail block at start */
+    uint32_t max_write_us;    /* one block, including waits for the SPI arbiter */
+} sd_log_sink_stats_t;
+
+void sd_log_sink_get_default_config(sd_log_sink_config_t *config);
+
+/* SD card must already be mounted. */
+bool sd_log_sink_start(const sd_log_sink_config_t *config);
+
+/* Inline backend (queue_len 0 is enough: write_line only copies into RAM). */
+const app_log_backend_t *app_log_backend_sd(void);
+
+/* Write everything staged so far; false on timeout or if not running. */
+bool sd_log_sink_sync(uint32_t timeout_ms);
+
+/*
+ * Stop accepting lines, write everything staged, close the file and end the
+ * writer task. False on timeout (the writer is left to finish on its own).
+ * sd_log_sink_start() may be called again afterwards.
+ */
+bool sd_log_sink_stop(uint32_t timeout_ms);
+
+void sd_log_sink_get_stats(sd_log_sink_stats_t *out_stats);
+
+/* Block helpers (no I/O): used by the writer, tail recovery and tests. */
+void sd_log_block_seal(uint8_t *block, uint32_t seq, uint16_t used);
+bool sd_log_block_check(const uint8_t *block, uint32_t *out_seq, uint16_t *out_used);
+
+#ifdef __cplusplus
+}
+#endif
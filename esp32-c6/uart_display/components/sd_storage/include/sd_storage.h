@@ -4,6 +4,8 @@
 #include <stddef.h>
 
 bool SD_Mount(void);
+/* SD_Mount() with a caller-chosen number of tries (500 ms apart); 1 when nothing at boot needs the card. */
+bool SD_MountAttempts(int attempts);
 bool SD_ReadFile(const char *path, char *out, size_t len);
 bool SD_DeleteFile(const char *path);
 void Flash_Searching(void);
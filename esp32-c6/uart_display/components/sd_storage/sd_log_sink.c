@@ -0,0 +1,742 @@
+/*
+ * sd_log_sink.c
+ *
+ * Double-buffered, block-aligned app_log file sink for the SD card.
+ * See sd_log_sink.h for the file format.
+ */
+
+#include "sd_log_sink.h"
+
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "spi_arbiter.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SD_LOG_SINK_STACK_SIZE 4096U
+#define SD_LOG_SINK_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define SD_LOG_SINK_FLUSH_INTERVAL_MS 2000U
+#define SD_LOG_SINK_MAX_FILE_SIZE (256U * 1024U)
+#define SD_LOG_SINK_MAX_FILES 8U
+#define SD_LOG_SINK_PATH_LEN 64
+#define SD_LOG_SINK_LOCK_TIMEOUT_MS 10U
+
+_Static_assert(sizeof(sd_log_block_header_t) == 16, "block header layout is part of the file format");
+_Static_assert(SD_LOG_BLOCK_PAYLOAD <= UINT16_MAX, "used is a uint16_t");
+
+typedef enum {
+    BACK_FREE = 0,
+    BACK_FULL,    /* swapped out by a producer, waiting for the writer */
+    BACK_WRITING, /* owned by the writer */
+} back_state_t;
+
+static const char *TAG = "SD_LOG";
+
+static sd_log_sink_config_t s_config;
+static TaskHandle_t s_task = NULL;
+
+/*
+ * s_lock serialises producers and the writer's snapshot of the front block.
+ * It is a mutex, not a critical section, because both sides copy up to a
+ * whole block while holding it; s_mux only guards the stats counters.
+ */
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* Block images: header is sealed in place just before the write. */
+static uint8_t s_block[2][SD_LOG_BLOCK_SIZE] __attribute__((aligned(4)));
+
+/* Guarded by s_lock. */
+static bool s_running = false;        /* false: producers drop, writer drains and exits */
+static bool s_writer_done = false;    /* writer has let go of s_file */
+static uint8_t s_front = 0;
+static uint16_t s_front_used = 0;
+static uint16_t s_front_synced = 0;   /* front bytes already on the card */
+static uint32_t s_front_gen = 0;      /* bumped on every swap */
+static back_state_t s_back_state = BACK_FREE;
+static uint16_t s_back_used = 0;
+
+/* Writer task only. */
+static FILE *s_file = NULL;
+static uint32_t s_file_index = 0;
+static uint32_t s_file_block = 0;     /* block slot within s_file for the current seq */
+static uint32_t s_block_seq = 0;
+
+static sd_log_sink_stats_t s_stats;
+
+void sd_log_block_seal(uint8_t *block, uint32_t seq, uint16_t used)
+{
+    sd_log_block_header_t header = {
+        .magic = SD_LOG_BLOCK_MAGIC,
+        .seq = seq,
+        .used = used,
+        .reserved = 0,
+        .crc32 = esp_rom_crc32_le(0, &block[sizeof(header)], used),
+    };
+
+    memcpy(block, &header, sizeof(header));
+    memset(&block[sizeof(header) + used], 0, SD_LOG_BLOCK_PAYLOAD - used);
+}
+
+bool sd_log_block_check(const uint8_t *block, uint32_t *out_seq, uint16_t *out_used)
+{
+    sd_log_block_header_t header;
+    memcpy(&header, block, sizeof(header));
+
+    if (header.magic != SD_LOG_BLOCK_MAGIC || header.used > SD_LOG_BLOCK_PAYLOAD) {
+        return false;
+    }
+
+    if (esp_rom_crc32_le(0, &block[sizeof(header)], header.used) != header.crc32) {
+        return false;
+    }
+
+    if (out_seq != NULL) {
+        *out_seq = header.seq;
+    }
+    if (out_used != NULL) {
+        *out_used = header.used;
+    }
+    return true;
+}
+
+static void make_path(char *out, size_t len, uint32_t index)
+{
+    /* 8.3 name: works without FATFS long file name support. */
+    (void)snprintf(out, len, "%s/L%07" PRIu32 ".BIN", s_config.dir, index % 10000000U);
+}
+
+static bool parse_index(const char *name, uint32_t *out_index)
+{
+    if (name[0] != 'L' || strlen(name) != 12 || strcmp(&name[8], ".BIN") != 0) {
+        return false;
+    }
+
+    uint32_t index = 0;
+    for (int i = 1; i < 8; ++i) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        index = index * 10U + (uint32_t)(name[i] - '0');
+    }
+
+    *out_index = index;
+    return true;
+}
+
+static void delete_file(uint32_t index)
+{
+    char path[SD_LOG_SINK_PATH_LEN];
+    make_path(path, sizeof(path), index);
+    (void)unlink(path);
+}
+
+static bool open_file(uint32_t index, const char *mode)
+{
+    char path[SD_LOG_SINK_PATH_LEN];
+    make_path(path, sizeof(path), index);
+
+    s_file = fopen(path, mode);
+    if (s_file == NULL) {
+        ESP_LOGE(TAG, "open %s failed: errno %d", path, errno);
+        return false;
+    }
+
+    /* Whole blocks go straight to FATFS; no stdio staging copy. */
+    (void)setvbuf(s_file, NULL, _IONBF, 0);
+    s_file_index = index;
+    return true;
+}
+
+static bool rotate_file(void)
+{
+    if (s_file != NULL) {
+        (void)fclose(s_file);
+        s_file = NULL;
+    }
+
+    const uint32_t next = s_file_index + 1U;
+    if (!open_file(next, "w+b")) {
+        return false;
+    }
+
+    if (next >= s_config.max_files) {
+        delete_file(next - s_config.max_files);
+    }
+
+    s_file_block = 0;
+    portENTER_CRITICAL(&s_mux);
+    s_stats.files_rotated++;
+    portEXIT_CRITICAL(&s_mux);
+    return true;
+}
+
+static uint32_t file_blocks(FILE *file)
+{
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0) {
+        return 0;
+    }
+    return (uint32_t)(st.st_size / SD_LOG_BLOCK_SIZE);
+}
+
+/* Walk back past blocks torn by a power cut mid-write; returns the block count up to the last valid one. */
+static uint32_t last_valid_block(FILE *file, uint32_t blocks, uint8_t *block, uint32_t *out_seq, uint16_t *out_used)
+{
+    while (blocks > 0U) {
+        if (fseek(file, (long)((blocks - 1U) * SD_LOG_BLOCK_SIZE), SEEK_SET) == 0 &&
+            fread(block, 1, SD_LOG_BLOCK_SIZE, file) == SD_LOG_BLOCK_SIZE &&
+            sd_log_block_check(block, out_seq, out_used)) {
+            return blocks;
+        }
+        blocks--;
+    }
+    return 0;
+}
+
+/*
+ * Sequence numbers never go back: when the newest file holds no valid block,
+ * continue after the last block of the newest older file that has one.
+ */
+static uint32_t seq_after_older_files(uint32_t newest, uint32_t first_kept, uint8_t *block)
+{
+    char path[SD_LOG_SINK_PATH_LEN];
+    for (uint32_t index = newest; index > first_kept;) {
+        --index;
+        make_path(path, sizeof(path), index);
+        FILE *file = fopen(path, "rb");
+        if (file == NULL) {
+            continue;
+        }
+        uint32_t seq = 0;
+        const bool found = last_valid_block(file, file_blocks(file), block, &seq, NULL) > 0U;
+        (void)fclose(file);
+        if (found) {
+            return seq + 1U;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Find the newest file, drop a torn or corrupt tail, and resume the last
+ * block if it still has room. Runs before the writer task exists.
+ */
+static bool recover_tail(void)
+{
+    DIR *dir = opendir(s_config.dir);
+    if (dir == NULL) {
+        if (mkdir(s_config.dir, 0775) != 0) {
+            ESP_LOGE(TAG, "mkdir %s failed: errno %d", s_config.dir, errno);
+            return false;
+        }
+        dir = opendir(s_config.dir);
+        if (dir == NULL) {
+            return false;
+        }
+    }
+
+    bool found = false;
+    uint32_t newest = 0;
+    uint32_t oldest = UINT32_MAX;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        uint32_t index;
+        if (!parse_index(entry->d_name, &index)) {
+            continue;
+        }
+        found = true;
+        newest = (index > newest) ? index : newest;
+        oldest = (index < oldest) ? index : oldest;
+    }
+    (void)closedir(dir);
+
+    if (!found) {
+        /* No retained block to order against. */
+        s_file_block = 0;
+        s_block_seq = 0;
+        return open_file(0, "w+b");
+    }
+
+    uint32_t first_kept = oldest;
+    for (; first_kept + s_config.max_files <= newest; ++first_kept) {
+        delete_file(first_kept);
+    }
+
+    if (!open_file(newest, "r+b")) {
+        return false;
+    }
+
+    struct stat st;
+    off_t size = 0;
+    if (fstat(fileno(s_file), &st) == 0) {
+        size = st.st_size;
+    }
+
+    uint8_t *block = s_block[0];
+    uint32_t seq = 0;
+    uint16_t used = 0;
+    const uint32_t blocks = last_valid_block(s_file, (uint32_t)(size / SD_LOG_BLOCK_SIZE), block, &seq, &used);
+    const bool valid = blocks > 0U;
+
+    if ((off_t)blocks * SD_LOG_BLOCK_SIZE != size) {
+        ESP_LOGW(TAG, "truncating torn tail of L%07" PRIu32 " to %" PRIu32 " blocks", newest, blocks);
+        (void)ftruncate(fileno(s_file), (off_t)blocks * SD_LOG_BLOCK_SIZE);
+    }
+
+    if (!valid) {
+        s_file_block = 0;
+        s_block_seq = seq_after_older_files(newest, first_kept, block);
+        return true;
+    }
+
+    if (used < SD_LOG_BLOCK_PAYLOAD) {
+        /* Keep filling the tail block in place; it is already in s_block[0]. */
+        s_front = 0;
+        s_front_used = used;
+        s_front_synced = used;
+        s_file_block = blocks - 1U;
+        s_block_seq = seq;
+        s_stats.recovered_bytes = used;
+    } else {
+        s_file_block = blocks;
+        s_block_seq = seq + 1U;
+    }
+
+    return true;
+}
+
+/*
+ * One SPI2 grant per chunk (sector aligned: the block offset is), so a
+ * block write never holds off an LCD frame for more than one chunk. The
+ * seek goes with the first chunk, the FAT/directory update with the sync.
+ */
+static bool write_block_chunked(const uint8_t *block)
+{
+    const size_t chunk = spi_arbiter_sd_chunk_bytes();
+    bool ok = true;
+
+    for (size_t off = 0; ok && off < SD_LOG_BLOCK_SIZE; off += chunk) {
+        const size_t len = (SD_LOG_BLOCK_SIZE - off < chunk) ? SD_LOG_BLOCK_SIZE - off : chunk;
+        spi_arbiter_sd_chunk_begin();
+        if (off == 0U) {
+            ok = fseek(s_file, (long)(s_file_block * SD_LOG_BLOCK_SIZE), SEEK_SET) == 0;
+        }
+        ok = ok && fwrite(block + off, 1, len, s_file) == len;
+        spi_arbiter_sd_chunk_end();
+    }
+    if (!ok) {
+        return false;
+    }
+
+    spi_arbiter_sd_chunk_begin();
+    ok = fflush(s_file) == 0 && fsync(fileno(s_file)) == 0;
+    spi_arbiter_sd_chunk_end();
+    return ok;
+}
+
+static bool write_block(uint8_t *block, uint16_t used, bool full)
+{
+    if (s_file_block * SD_LOG_BLOCK_SIZE >= s_config.max_file_size && !rotate_file()) {
+        return false;
+    }
+
+    sd_log_block_seal(block, s_block_seq, used);
+
+    const int64_t start_us = esp_timer_get_time();
+    const bool ok = write_block_chunked(block);
+    const uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    if (!ok) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&s_mux);
+    if (elapsed_us > s_stats.max_write_us) {
+        s_stats.max_write_us = elapsed_us;
+    }
+    s_stats.blocks_written++;
+    s_stats.file_index = s_file_index;
+    s_stats.block_seq = s_block_seq;
+    portEXIT_CRITICAL(&s_mux);
+
+    if (full) {
+        s_file_block++;
+        s_block_seq++;
+    }
+    return true;
+}
+
+/* Returns false once there is nothing left to write. */
+static bool writer_step(void)
+{
+    uint8_t *block;
+    uint16_t used;
+    bool full;
+    uint32_t gen;
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    const uint8_t back = s_front ^ 1U;
+    if (s_back_state == BACK_FULL) {
+        s_back_state = BACK_WRITING;
+        block = s_block[back];
+        used = s_back_used;
+        full = true;
+        gen = 0;
+    } else if (s_back_state == BACK_FREE && s_front_used != s_front_synced) {
+        /* Snapshot the partial front block; producers keep appending to it. */
+        s_back_state = BACK_WRITING;
+        block = s_block[back];
+        used = s_front_used;
+        memcpy(block, s_block[s_front], sizeof(sd_log_block_header_t) + used);
+        full = false;
+        gen = s_front_gen;
+    } else {
+        (void)xSemaphoreGive(s_lock);
+        return false;
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    const bool ok = write_block(block, used, full);
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_back_state = BACK_FREE;
+    if (ok && !full && gen == s_front_gen) {
+        s_front_synced = used;
+    }
+    (void)xSemaphoreGive(s_lock);
+
+    if (!ok) {
+        portENTER_CRITICAL(&s_mux);
+        s_stats.write_errors++;
+        portEXIT_CRITICAL(&s_mux);
+    }
+    return ok;
+}
+
+static void sd_log_writer_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(s_config.flush_interval_ms));
+        while (writer_step()) {
+        }
+
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        const bool running = s_running;
+        (void)xSemaphoreGive(s_lock);
+        if (!running) {
+            break;
+        }
+    }
+
+    /* Lines staged before s_running dropped; nothing can be added now. */
+    while (writer_step()) {
+    }
+
+    /* sd_log_sink_stop() closes the file and deletes this task. */
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_writer_done = true;
+    (void)xSemaphoreGive(s_lock);
+    vTaskSuspend(NULL);
+}
+
+static void count_drop(void)
+{
+    portENTER_CRITICAL(&s_mux);
+    s_stats.lines_dropped++;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+static void sink_append(const void *data, size_t len, const char *prefix, size_t prefix_len)
+{
+    const size_t total = prefix_len + len;
+
+    if (s_lock == NULL || total > SD_LOG_BLOCK_PAYLOAD) {
+        count_drop();
+        return;
+    }
+
+    /* Only ever contended by another producer or the writer's snapshot copy. */
+    if (xSemaphoreTake(s_lock, pdMS_TO_TICKS(SD_LOG_SINK_LOCK_TIMEOUT_MS)) != pdTRUE) {
+        count_drop();
+        return;
+    }
+
+    if (!s_running) {
+        (void)xSemaphoreGive(s_lock);
+        count_drop();
+        return;
+    }
+
+    if (s_front_used + total > SD_LOG_BLOCK_PAYLOAD) {
+        if (s_back_state != BACK_FREE) {
+            (void)xSemaphoreGive(s_lock);
+            count_drop();
+            return;
+        }
+        s_back_used = s_front_used;
+        s_back_state = BACK_FULL;
+        s_front ^= 1U;
+        s_front_used = 0;
+        s_front_synced = 0;
+        s_front_gen++;
+        /* Under the lock so stop cannot retire the task in between. */
+        if (s_task != NULL) {
+            xTaskNotifyGive(s_task);
+        }
+    }
+
+    uint8_t *dst = &s_block[s_front][sizeof(sd_log_block_header_t) + s_front_used];
+    memcpy(dst, prefix, prefix_len);
+    memcpy(dst + prefix_len, data, len);
+    s_front_used = (uint16_t)(s_front_used + total);
+    (void)xSemaphoreGive(s_lock);
+
+    portENTER_CRITICAL(&s_mux);
+    s_stats.bytes_staged += (uint32_t)total;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+static size_t format_uptime(char *out, size_t cap)
+{
+    char tmp[11];
+    size_t n = 0;
+    uint32_t ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+    do {
+        tmp[n++] = (char)('0' + (ms % 10U));
+        ms /= 10U;
+    } while (ms != 0U && n < sizeof(tmp));
+
+    size_t at = 0;
+    while (n > 0U && at + 1U < cap) {
+        out[at++] = tmp[--n];
+    }
+    out[at++] = ' ';
+    return at;
+}
+
+static bool sd_backend_init(void *ctx)
+{
+    (void)ctx;
+    return s_task != NULL;
+}
+
+static void sd_backend_deinit(void *ctx)
+{
+    (void)ctx;
+    (void)sd_log_sink_sync(1000);
+}
+
+static void sd_backend_write_line(void *ctx, const char *line)
+{
+    (void)ctx;
+    if (line == NULL) {
+        return;
+    }
+
+    /* Prefix and newline are staged with the line so a swap never splits it. */
+    char prefix[12];
+    const size_t prefix_len = format_uptime(prefix, sizeof(prefix));
+
+    char text[APP_LOG_MAX_LINE_LEN + 1];
+    size_t len = strlcpy(text, line, sizeof(text) - 1U);
+    if (len > sizeof(text) - 2U) {
+        len = sizeof(text) - 2U;
+    }
+    text[len++] = '\n';
+
+    sink_append(text, len, prefix, prefix_len);
+}
+
+static void sd_backend_write_frame(void *ctx, const uint8_t *frame, size_t len)
+{
+    (void)ctx;
+    sink_append(frame, len, NULL, 0U);
+}
+
+const app_log_backend_t *app_log_backend_sd(void)
+{
+    static const app_log_backend_t text_backend = {
+        .init = sd_backend_init,
+        .deinit = sd_backend_deinit,
+        .write_line = sd_backend_write_line,
+        .ctx = NULL,
+    };
+    static const app_log_backend_t binary_backend = {
+        .init = sd_backend_init,
+        .deinit = sd_backend_deinit,
+        .write_line = sd_backend_write_line,
+        .ctx = NULL,
+        .write_frame = sd_backend_write_frame,
+    };
+
+    return s_config.binary ? &binary_backend : &text_backend;
+}
+
+void sd_log_sink_get_default_config(sd_log_sink_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    config->dir = "/sdcard/LOGS";
+    config->max_file_size = SD_LOG_SINK_MAX_FILE_SIZE;
+    config->max_files = SD_LOG_SINK_MAX_FILES;
+    config->flush_interval_ms = SD_LOG_SINK_FLUSH_INTERVAL_MS;
+    config->binary = false;
+    config->stack_size = SD_LOG_SINK_STACK_SIZE;
+    config->task_priority = SD_LOG_SINK_TASK_PRIORITY;
+    config->core_id = tskNO_AFFINITY;
+}
+
+bool sd_log_sink_start(const sd_log_sink_config_t *config)
+{
+    if (config == NULL || config->dir == NULL || config->max_files == 0U ||
+        config->max_file_size < SD_LOG_BLOCK_SIZE || config->flush_interval_ms == 0U) {
+        return false;
+    }
+
+    if (s_task != NULL) {
+        return true;
+    }
+
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+    }
+
+    s_config = *config;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_front = 0;
+    s_front_used = 0;
+    s_front_synced = 0;
+    s_front_gen = 0;
+    s_back_state = BACK_FREE;
+    s_writer_done = false;
+
+    if (!recover_tail()) {
+        if (s_file != NULL) {
+            (void)fclose(s_file);
+            s_file = NULL;
+        }
+        return false;
+    }
+
+    s_stats.file_index = s_file_index;
+    s_stats.block_seq = s_block_seq;
+
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_running = true;
+    (void)xSemaphoreGive(s_lock);
+
+    BaseType_t ret;
+    if (s_config.core_id == tskNO_AFFINITY) {
+        ret = xTaskCreate(sd_log_writer_task, "sd_log", s_config.stack_size,
+                          NULL, s_config.task_priority, &s_task);
+    } else {
+        ret = xTaskCreatePinnedToCore(sd_log_writer_task, "sd_log", s_config.stack_size,
+                                      NULL, s_config.task_priority, &s_task, s_config.core_id);
+    }
+
+    if (ret != pdPASS) {
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_running = false;
+        (void)xSemaphoreGive(s_lock);
+        s_task = NULL;
+        (void)fclose(s_file);
+        s_file = NULL;
+        return false;
+    }
+
+    ESP_LOGI(TAG, "logging to %s/L%07" PRIu32 ".BIN (block %" PRIu32 ", %" PRIu32 " bytes recovered)",
+             s_config.dir, s_file_index, s_file_block, s_stats.recovered_bytes);
+    return true;
+}
+
+bool sd_log_sink_sync(uint32_t timeout_ms)
+{
+    if (s_task == NULL) {
+        return false;
+    }
+
+    const TickType_t start = xTaskGetTickCount();
+    while (1) {
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        const bool idle = (s_back_state == BACK_FREE) && (s_front_used == s_front_synced);
+        (void)xSemaphoreGive(s_lock);
+
+        if (idle) {
+            return true;
+        }
+
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeout_ms)) {
+            return false;
+        }
+
+        xTaskNotifyGive(s_task);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+bool sd_log_sink_stop(uint32_t timeout_ms)
+{
+    if (s_task == NULL) {
+        return true;
+    }
+
+    /* New lines are dropped from here; the writer drains what is staged. */
+    (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_running = false;
+    (void)xSemaphoreGive(s_lock);
+
+    const TickType_t start = xTaskGetTickCount();
+    while (1) {
+        (void)xSemaphoreTake(s_lock, portMAX_DELAY);
+        const bool done = s_writer_done;
+        (void)xSemaphoreGive(s_lock);
+
+        if (done) {
+            break;
+        }
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeout_ms)) {
+            /* The writer still owns s_file; leave it to finish. */
+            ESP_LOGW(TAG, "stop timed out waiting for the writer");
+            return false;
+        }
+        xTaskNotifyGive(s_task);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    vTaskDelete(s_task);
+    s_task = NULL;
+    if (s_file != NULL) {
+        (void)fclose(s_file);
+        s_file = NULL;
+    }
+    return true;
+}
+
+void sd_log_sink_get_stats(sd_log_sink_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_mux);
+    *out_stats = s_stats;
+    portEXIT_CRITICAL(&s_mux);
+}
@@ -0,0 +1,127 @@
+#include "sd_log_sink.h"
+#include "sd_storage.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_LINES 1000
+#define BENCH_DIR "/sdcard/BENCH"
+
+static void remove_bench_dir(void)
+{
+    DIR *dir = opendir(BENCH_DIR);
+    if (dir == NULL) {
+        return;
+    }
+
+    struct dirent *entry;
+    char path[64];
+    while ((entry = readdir(dir)) != NULL) {
+        (void)snprintf(path, sizeof(path), BENCH_DIR "/%s", entry->d_name);
+        (void)unlink(path);
+    }
+    (void)closedir(dir);
+    (void)rmdir(BENCH_DIR);
+}
+
+TEST_CASE("sd_log block seal/check detects torn blocks", "[sd_storage]")
+{
+    static uint8_t block[SD_LOG_BLOCK_SIZE];
+    const char payload[] = "123 [SNS][DBG] TEMP: 23.4 C\n";
+    uint32_t seq = 0;
+    uint16_t used = 0;
+
+    memset(block, 0xA5, sizeof(block));
+    memcpy(&block[sizeof(sd_log_block_header_t)], payload, sizeof(payload) - 1U);
+    sd_log_block_seal(block, 42U, (uint16_t)(sizeof(payload) - 1U));
+
+    TEST_ASSERT_TRUE(sd_log_block_check(block, &seq, &used));
+    TEST_ASSERT_EQUAL_UINT32(42U, seq);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(payload) - 1U, used);
+    /* Padding is zeroed so stale bytes never reach the card. */
+    TEST_ASSERT_EQUAL_HEX8(0x00, block[sizeof(sd_log_block_header_t) + used]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, block[SD_LOG_BLOCK_SIZE - 1U]);
+
+    /* A write cut short leaves payload that no longer matches the CRC. */
+    block[sizeof(sd_log_block_header_t) + 4U] ^= 0x01;
+    TEST_ASSERT_FALSE(sd_log_block_check(block, NULL, NULL));
+
+    memset(block, 0, sizeof(block));
+    TEST_ASSERT_FALSE(sd_log_block_check(block, NULL, NULL));
+}
+
+TEST_CASE("sd_log_sink throughput vs per-line fprintf", "[sd_storage][benchmark]")
+{
+    char line[80];
+
+    TEST_ASSERT_TRUE(SD_Mount());
+
+    /* Baseline: one fprintf + fflush per line, as a naive persistent log would. */
+    FILE *f = fopen("/sdcard/BENCH.TXT", "w");
+    TEST_ASSERT_NOT_NULL(f);
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_LINES; ++i) {
+        fprintf(f, "%d [SNS][DBG] TEMP: 23.4 C sample %04d\n", i, i);
+        fflush(f);
+    }
+    fclose(f);
+    const int64_t fprintf_us = esp_timer_get_time() - start;
+    (void)SD_DeleteFile("/sdcard/BENCH.TXT");
+
+    sd_log_sink_config_t config;
+    sd_log_sink_get_default_config(&config);
+    config.dir = BENCH_DIR;
+    config.max_files = 2U;
+    TEST_ASSERT_TRUE(sd_log_sink_start(&config));
+    const app_log_backend_t *backend = app_log_backend_sd();
+
+    sd_log_sink_stats_t before;
+    sd_log_sink_get_stats(&before);
+
+    int64_t caller_us = 0;
+    uint32_t stalls = 0;
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_LINES; ++i) {
+        (void)snprintf(line, sizeof(line), "[SNS][DBG] TEMP: 23.4 C sample %04d", i);
+        sd_log_sink_stats_t stats;
+        uint32_t dropped;
+        do {
+            sd_log_sink_get_stats(&stats);
+            dropped = stats.lines_dropped;
+            const int64_t t0 = esp_timer_get_time();
+            backend->write_line(backend->ctx, line);
+            caller_us += esp_timer_get_time() - t0;
+            sd_log_sink_get_stats(&stats);
+            if (stats.lines_dropped != dropped) {
+                /* Both blocks busy: let the writer catch up so every line lands. */
+                stalls++;
+                vTaskDelay(1);
+            }
+        } while (stats.lines_dropped != dropped);
+    }
+    TEST_ASSERT_TRUE(sd_log_sink_sync(5000));
+    const int64_t sink_us = esp_timer_get_time() - start;
+
+    sd_log_sink_stats_t after;
+    sd_log_sink_get_stats(&after);
+
+    /* Later tests get a stopped sink and no leftover files. */
+    TEST_ASSERT_TRUE(sd_log_sink_stop(5000));
+    remove_bench_dir();
+
+    printf("per-line fprintf: %" PRIi64 " us, sink end-to-end: %" PRIi64 " us, sink caller: %" PRIi64
+           " us, blocks: %" PRIu32 ", max block write: %" PRIu32 " us, stalls: %" PRIu32 "\n",
+           fprintf_us, sink_us, caller_us, after.blocks_written - before.blocks_written,
+           after.max_write_us, stalls);
+
+    TEST_ASSERT_EQUAL_UINT32(0U, after.write_errors);
+    TEST_ASSERT_LESS_THAN(fprintf_us, sink_us);
+}
@@ -0,0 +1,511 @@
+/*
+ * sim_spi_arbiter.c
+ *
+ * Host simulator of the shared SPI2 bus: the LVGL flush engine sends frames
+ * as bands (rendered into `slots` buffers, each band one transaction) while
+ * the SD log sink writes 4 KB blocks at a jittered rate. Two schedules are
+ * compared:
+ *
+ *   fifo      ESP-IDF bus lock only: transactions in arrival order, each
+ *             SD block one multi-sector transaction
+ *   arbiter   spi_arbiter_policy: the LCD holds the bus per frame and goes
+ *             first, SD writes go in --chunk byte pieces between frames
+ *
+ * Reported per schedule: LCD stall (time a rendered band waited while SD had
+ * the bus, per frame), SD throughput and block latency, bus occupancy.
+ *
+ *   sim_spi_arbiter [--seconds N] [--fps N] [--frame-rows N] [--sd-kbps N]
+ *                   [--chunk N] [--check]
+ *
+ * --check fails unless the arbiter keeps every LCD stall within one chunk,
+ * SD keeps up with the offered rate, and the worst stall beats fifo.
+ *
+ * Full-screen redraws at 30 fps (--frame-rows 172) saturate the bus: SD
+ * then only gets the render gaps between frames and falls behind, while
+ * fifo keeps SD up by stretching every frame.
+ */
+
+#include "spi_arbiter_policy.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MAX_SLOTS 4
+#define SIM_MAX_BLOCKS 256
+#define SIM_NEVER INT64_MAX
+
+typedef struct {
+    uint32_t seconds;
+    uint32_t fps;
+    uint32_t width;
+    uint32_t frame_rows;      /* rows redrawn per frame */
+    uint32_t band_lines;
+    uint32_t slots;
+    uint32_t render_band_us;  /* LVGL drawing time per band */
+    uint32_t lcd_hz;
+    uint32_t lcd_cmd_us;      /* CASET/RASET/RAMWR per band */
+    uint32_t sd_hz;
+    uint32_t sd_cmd_us;       /* command, CRC and busy wait per transaction */
+    uint32_t sd_block;
+    uint32_t sd_kbps;         /* offered log rate */
+    uint32_t chunk;
+    uint32_t guard_us;
+    uint32_t sd_max_wait_us;
+} sim_config_t;
+
+typedef struct {
+    int frame;
+    int band;
+    int64_t arrival;          /* rendered, handed to the flush task */
+    bool first;
+    bool last;
+    int64_t frame_start;
+} sim_band_t;
+
+typedef enum { SIM_BUS_IDLE = 0, SIM_BUS_LCD, SIM_BUS_SD } sim_bus_t;
+
+typedef struct {
+    const sim_config_t *cfg;
+    bool arbiter;
+    spi_arbiter_policy_t policy;
+    int64_t now;
+    int64_t end;
+
+    sim_bus_t bus;
+    int64_t bus_end;
+    uint32_t bus_bytes;       /* SD bytes in the current transfer */
+    uint64_t busy_us[3];
+
+    /* LCD: bands rendered and waiting (ring), band on the bus, band being rendered. */
+    sim_band_t queue[SIM_MAX_SLOTS];
+    int q_head;
+    int q_count;
+    sim_band_t on_bus;
+    bool rendering;
+    int64_t render_done;
+    sim_band_t render_band;
+    int bands_per_frame;
+    int frame;                /* next frame to start */
+    int next_band;            /* of the frame being rendered; bands_per_frame when done */
+    int64_t frame_start;
+    bool lcd_waiting;         /* arbiter: frame_begin blocked */
+    int lcd_granted_frame;    /* arbiter: bands of later frames wait in the flush task */
+
+    /* SD: block arrival times, bytes left of the head block. */
+    int64_t blocks[SIM_MAX_BLOCKS];
+    int b_head;
+    int b_count;
+    uint32_t head_left;
+    int64_t next_block;
+    uint32_t rng;
+    bool sd_granted;
+    int64_t sd_retry_at;
+
+    /* Results. */
+    uint32_t frames;
+    int64_t frame_stall[SIM_MAX_SLOTS];  /* by frame % SIM_MAX_SLOTS */
+    int64_t max_stall;
+    int64_t total_stall;
+    uint32_t stalled_frames;
+    uint64_t sd_bytes;
+    uint64_t offered_bytes;
+    int64_t max_block_latency;
+    uint32_t dropped_blocks;
+} sim_t;
+
+static int64_t sim_xfer_us(uint64_t bytes, uint32_t hz, uint32_t cmd_us)
+{
+    return (int64_t)((bytes * 8U * 1000000U + hz - 1U) / hz) + cmd_us;
+}
+
+static uint32_t sim_rand(sim_t *sim)
+{
+    sim->rng = sim->rng * 1664525U + 1013904223U;
+    return sim->rng >> 8;
+}
+
+/* Block interval jittered +-50% around the offered rate. */
+static int64_t sim_block_interval(sim_t *sim)
+{
+    const int64_t mean = (int64_t)sim->cfg->sd_block * 1000000 / ((int64_t)sim->cfg->sd_kbps * 1024);
+    return mean / 2 + (int64_t)(sim_rand(sim) % (uint32_t)(mean + 1));
+}
+
+static void sim_init(sim_t *sim, const sim_config_t *cfg, bool arbiter)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->cfg = cfg;
+    sim->arbiter = arbiter;
+    sim->end = (int64_t)cfg->seconds * 1000000;
+    sim->now = 1;
+    sim->bands_per_frame = (int)((cfg->frame_rows + cfg->band_lines - 1U) / cfg->band_lines);
+    sim->next_band = sim->bands_per_frame;
+    sim->frame_start = sim->now;
+    sim->rng = 12345U;
+    sim->next_block = sim->now + sim_block_interval(sim);
+    sim->sd_retry_at = SIM_NEVER;
+
+    const spi_arbiter_policy_config_t policy_config = {
+        .guard_us = cfg->guard_us,
+        .sd_max_wait_us = cfg->sd_max_wait_us,
+        .sd_chunk_est_us = (uint32_t)sim_xfer_us(cfg->chunk, cfg->sd_hz, cfg->sd_cmd_us),
+    };
+    spi_arbiter_policy_init(&sim->policy, &policy_config, sim->now);
+}
+
+static int64_t sim_frame_period(const sim_t *sim)
+{
+    return 1000000 / (int64_t)sim->cfg->fps;
+}
+
+static uint32_t sim_band_rows(const sim_t *sim, int band)
+{
+    const uint32_t done = (uint32_t)band * sim->cfg->band_lines;
+    const uint32_t left = sim->cfg->frame_rows - done;
+    return (left < sim->cfg->band_lines) ? left : sim->cfg->band_lines;
+}
+
+/* spi_arbiter_hand_over_locked(). */
+static void sim_hand_over(sim_t *sim)
+{
+    switch (spi_arbiter_policy_next(&sim->policy, sim->now)) {
+    case SPI_ARBITER_OWNER_LCD:
+        (void)spi_arbiter_policy_lcd_try(&sim->policy, sim->now);
+        sim->lcd_waiting = false;
+        sim->lcd_granted_frame++;
+        break;
+    case SPI_ARBITER_OWNER_SD:
+        (void)spi_arbiter_policy_sd_try(&sim->policy, sim->now);
+        sim->sd_granted = true;
+        sim->sd_retry_at = SIM_NEVER;
+        break;
+    default:
+        break;
+    }
+}
+
+static int sim_slots_used(const sim_t *sim)
+{
+    return sim->q_count + (sim->bus == SIM_BUS_LCD ? 1 : 0) + (sim->rendering ? 1 : 0);
+}
+
+static bool sim_complete_transfer(sim_t *sim)
+{
+    if (sim->bus == SIM_BUS_IDLE || sim->bus_end > sim->now) {
+        return false;
+    }
+
+    const sim_bus_t done = sim->bus;
+    sim->bus = SIM_BUS_IDLE;
+    if (done == SIM_BUS_LCD) {
+        if (sim->on_bus.last) {
+            sim->frames++;
+            const int64_t stall = sim->frame_stall[sim->on_bus.frame % SIM_MAX_SLOTS];
+            sim->frame_stall[sim->on_bus.frame % SIM_MAX_SLOTS] = 0;
+            sim->total_stall += stall;
+            sim->stalled_frames += (stall > 0) ? 1U : 0U;
+            if (stall > sim->max_stall) {
+                sim->max_stall = stall;
+            }
+            if (sim->arbiter) {
+                spi_arbiter_policy_release(&sim->policy, sim->now, sim->on_bus.frame_start + sim_frame_period(sim));
+                sim_hand_over(sim);
+            }
+        }
+        return true;
+    }
+
+    sim->sd_bytes += sim->bus_bytes;
+    sim->head_left -= sim->bus_bytes;
+    if (sim->head_left == 0U) {
+        const int64_t latency = sim->now - sim->blocks[sim->b_head];
+        if (latency > sim->max_block_latency) {
+            sim->max_block_latency = latency;
+        }
+        sim->b_head = (sim->b_head + 1) % SIM_MAX_BLOCKS;
+        sim->b_count--;
+        sim->head_left = (sim->b_count > 0) ? sim->cfg->sd_block : 0U;
+    }
+    if (sim->arbiter) {
+        spi_arbiter_policy_release(&sim->policy, sim->now, 0);
+        sim_hand_over(sim);
+    }
+    return true;
+}
+
+static bool sim_step_render(sim_t *sim)
+{
+    bool changed = false;
+
+    if (sim->rendering && sim->render_done <= sim->now) {
+        sim->rendering = false;
+        sim->render_band.arrival = sim->now;
+        sim->queue[(sim->q_head + sim->q_count) % SIM_MAX_SLOTS] = sim->render_band;
+        sim->q_count++;
+        if (sim->arbiter && sim->render_band.first) {
+            if (spi_arbiter_policy_lcd_try(&sim->policy, sim->now)) {
+                sim->lcd_granted_frame = sim->render_band.frame;
+            } else {
+                sim->lcd_waiting = true;
+            }
+        }
+        changed = true;
+    }
+
+    if (!sim->rendering && sim->next_band >= sim->bands_per_frame && sim->frame_start <= sim->now) {
+        /* LVGL's refresh timer: the next frame starts on the period grid. */
+        sim->next_band = 0;
+        sim->frame++;
+        changed = true;
+    }
+
+    if (!sim->rendering && sim->next_band < sim->bands_per_frame && sim_slots_used(sim) < (int)sim->cfg->slots) {
+        sim->render_band = (sim_band_t){
+            .frame = sim->frame,
+            .band = sim->next_band,
+            .first = sim->next_band == 0,
+            .last = sim->next_band == sim->bands_per_frame - 1,
+            .frame_start = sim->frame_start,
+        };
+        sim->rendering = true;
+        sim->render_done = sim->now + sim->cfg->render_band_us;
+        sim->next_band++;
+        if (sim->next_band == sim->bands_per_frame) {
+            const int64_t period = sim_frame_period(sim);
+            sim->frame_start += period;
+            if (sim->frame_start <= sim->now) {
+                sim->frame_start = ((sim->now / period) + 1) * period;
+            }
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+static bool sim_step_sd_arrival(sim_t *sim)
+{
+    if (sim->next_block > sim->now) {
+        return false;
+    }
+    sim->offered_bytes += sim->cfg->sd_block;
+    if (sim->b_count == SIM_MAX_BLOCKS) {
+        sim->dropped_blocks++;
+    } else {
+        sim->blocks[(sim->b_head + sim->b_count) % SIM_MAX_BLOCKS] = sim->now;
+        if (sim->b_count++ == 0) {
+            sim->head_left = sim->cfg->sd_block;
+        }
+    }
+    sim->next_block = sim->now + sim_block_interval(sim);
+    return true;
+}
+
+static void sim_start(sim_t *sim, sim_bus_t who, int64_t duration, uint32_t bytes)
+{
+    sim->bus = who;
+    sim->bus_end = sim->now + duration;
+    sim->bus_bytes = bytes;
+    sim->busy_us[who] += (uint64_t)duration;
+}
+
+static void sim_start_band(sim_t *sim)
+{
+    sim->on_bus = sim->queue[sim->q_head];
+    sim->q_head = (sim->q_head + 1) % SIM_MAX_SLOTS;
+    sim->q_count--;
+    const uint64_t bytes = (uint64_t)sim_band_rows(sim, sim->on_bus.band) * sim->cfg->width * 2U;
+    sim_start(sim, SIM_BUS_LCD, sim_xfer_us(bytes, sim->cfg->lcd_hz, sim->cfg->lcd_cmd_us), 0);
+}
+
+static bool sim_dispatch_fifo(sim_t *sim)
+{
+    if (sim->bus != SIM_BUS_IDLE) {
+        return false;
+    }
+    /* Arrival order; a partly written block keeps the bus lock's place it already had. */
+    const bool band = sim->q_count > 0;
+    const bool block = sim->b_count > 0;
+    if (band && (!block || sim->queue[sim->q_head].arrival <= sim->blocks[sim->b_head])) {
+        sim_start_band(sim);
+        return true;
+    }
+    if (block) {
+        sim_start(sim, SIM_BUS_SD, sim_xfer_us(sim->head_left, sim->cfg->sd_hz, sim->cfg->sd_cmd_us), sim->head_left);
+        return true;
+    }
+    return false;
+}
+
+static bool sim_dispatch_arbiter(sim_t *sim)
+{
+    if (sim->bus != SIM_BUS_IDLE) {
+        return false;
+    }
+    if (sim->policy.owner == SPI_ARBITER_OWNER_LCD && sim->q_count > 0 &&
+        sim->queue[sim->q_head].frame <= sim->lcd_granted_frame) {
+        sim_start_band(sim);
+        return true;
+    }
+    if (sim->b_count == 0) {
+        return false;
+    }
+    if (!sim->sd_granted) {
+        if (sim->sd_retry_at != SIM_NEVER && sim->sd_retry_at > sim->now) {
+            return false;
+        }
+        if (!spi_arbiter_policy_sd_try(&sim->policy, sim->now)) {
+            const uint32_t retry = spi_arbiter_policy_sd_retry_us(&sim->policy, sim->now);
+            sim->sd_retry_at = sim->now + ((retry > 0U) ? retry : 1U);
+            return false;
+        }
+        sim->sd_retry_at = SIM_NEVER;
+    }
+    sim->sd_granted = false;
+    const uint32_t bytes = (sim->head_left < sim->cfg->chunk) ? sim->head_left : sim->cfg->chunk;
+    sim_start(sim, SIM_BUS_SD, sim_xfer_us(bytes, sim->cfg->sd_hz, sim->cfg->sd_cmd_us), bytes);
+    return true;
+}
+
+static int64_t sim_next_event(const sim_t *sim)
+{
+    int64_t next = sim->next_block;
+    if (sim->bus != SIM_BUS_IDLE && sim->bus_end < next) {
+        next = sim->bus_end;
+    }
+    if (sim->rendering && sim->render_done < next) {
+        next = sim->render_done;
+    }
+    if (!sim->rendering && sim->next_band >= sim->bands_per_frame && sim->frame_start < next) {
+        next = sim->frame_start;
+    }
+    if (sim->sd_retry_at < next) {
+        next = sim->sd_retry_at;
+    }
+    return (next > sim->now) ? next : sim->now + 1;
+}
+
+static void sim_run(sim_t *sim)
+{
+    while (sim->now < sim->end) {
+        bool changed;
+        do {
+            changed = sim_complete_transfer(sim);
+            changed |= sim_step_render(sim);
+            changed |= sim_step_sd_arrival(sim);
+            changed |= sim->arbiter ? sim_dispatch_arbiter(sim) : sim_dispatch_fifo(sim);
+        } while (changed);
+
+        const int64_t next = sim_next_event(sim);
+        /* A rendered band waiting while SD has (or is about to give back) the bus. */
+        if (sim->q_count > 0 && sim->bus != SIM_BUS_LCD &&
+            (sim->bus == SIM_BUS_SD || sim->lcd_waiting)) {
+            sim->frame_stall[sim->queue[sim->q_head].frame % SIM_MAX_SLOTS] += next - sim->now;
+        }
+        sim->now = next;
+    }
+}
+
+static void sim_report(const char *name, const sim_t *sim)
+{
+    const double window = (double)sim->now;
+    printf("%-8s %6u %9" PRId64 " %9" PRId64 " %7u %9.1f %9.1f %9.1f %6.1f%% %6.1f%%\n",
+           name, (unsigned)sim->frames, sim->max_stall,
+           (sim->frames > 0U) ? sim->total_stall / sim->frames : 0, (unsigned)sim->stalled_frames,
+           (double)sim->offered_bytes / 1024.0 / (window / 1e6),
+           (double)sim->sd_bytes / 1024.0 / (window / 1e6),
+           (double)sim->max_block_latency / 1000.0,
+           100.0 * (double)sim->busy_us[SIM_BUS_LCD] / window,
+           100.0 * (double)sim->busy_us[SIM_BUS_SD] / window);
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg = {
+        .seconds = 20,
+        .fps = 30,
+        .width = 320,
+        .frame_rows = 60,
+        .band_lines = 20,
+        .slots = 3,
+        .render_band_us = 1500,
+        .lcd_hz = 12000000,
+        .lcd_cmd_us = 40,
+        .sd_hz = 10000000,
+        .sd_cmd_us = 150,
+        .sd_block = 4096,
+        .sd_kbps = 48,
+        .chunk = 512,
+        .guard_us = 200,
+        .sd_max_wait_us = 50000,
+    };
+    bool check = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            cfg.seconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            cfg.fps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--frame-rows") == 0 && i + 1 < argc) {
+            cfg.frame_rows = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--sd-kbps") == 0 && i + 1 < argc) {
+            cfg.sd_kbps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) {
+            cfg.chunk = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--fps N] [--frame-rows N] [--sd-kbps N] [--chunk N] [--check]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (cfg.seconds == 0U || cfg.fps == 0U || cfg.frame_rows == 0U || cfg.sd_kbps == 0U || cfg.chunk == 0U ||
+        cfg.slots > SIM_MAX_SLOTS) {
+        fprintf(stderr, "invalid parameters\n");
+        return EXIT_FAILURE;
+    }
+
+    static sim_t fifo;
+    static sim_t arb;
+    sim_init(&fifo, &cfg, false);
+    sim_init(&arb, &cfg, true);
+    sim_run(&fifo);
+    sim_run(&arb);
+
+    printf("%u s, %u fps, %u rows/frame, SD %u KB/s in %u B blocks, %u B chunks\n",
+           (unsigned)cfg.seconds, (unsigned)cfg.fps, (unsigned)cfg.frame_rows,
+           (unsigned)cfg.sd_kbps, (unsigned)cfg.sd_block, (unsigned)cfg.chunk);
+    printf("%-8s %6s %9s %9s %7s %9s %9s %9s %7s %7s\n", "", "frames", "stall_max", "stall_avg", "stalled",
+           "sd_offer", "sd_kbps", "blk_ms", "lcd", "sd");
+    sim_report("fifo", &fifo);
+    sim_report("arbiter", &arb);
+
+    spi_arbiter_policy_stats_t stats;
+    spi_arbiter_policy_get_stats(&arb.policy, arb.now, &stats);
+    printf("arbiter: %u SD chunks (avg %u us), %u deferred, %u forced, SD max wait %u us, LCD max wait %u us\n",
+           (unsigned)stats.sd_chunks, (unsigned)stats.sd_chunk_avg_us, (unsigned)stats.sd_deferrals,
+           (unsigned)stats.sd_forced, (unsigned)stats.sd_max_wait_us, (unsigned)stats.lcd_max_wait_us);
+
+    if (!check) {
+        return EXIT_SUCCESS;
+    }
+    const int64_t chunk_us = sim_xfer_us(cfg.chunk, cfg.sd_hz, cfg.sd_cmd_us);
+    bool ok = true;
+    if (arb.max_stall > chunk_us) {
+        printf("FAIL: arbiter LCD stall %" PRId64 " us exceeds one chunk (%" PRId64 " us)\n", arb.max_stall, chunk_us);
+        ok = false;
+    }
+    if (arb.dropped_blocks != 0U || (double)arb.sd_bytes < 0.98 * (double)arb.offered_bytes) {
+        printf("FAIL: SD fell behind (%" PRIu64 " of %" PRIu64 " bytes, %u dropped)\n",
+               arb.sd_bytes, arb.offered_bytes, (unsigned)arb.dropped_blocks);
+        ok = false;
+    }
+    if (arb.max_stall >= fifo.max_stall) {
+        printf("FAIL: arbiter worst stall not below fifo\n");
+        ok = false;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
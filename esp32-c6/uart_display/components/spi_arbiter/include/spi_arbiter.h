@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+ * spi_arbiter.h
+ *
+ * Schedules the two clients of the shared SPI2 bus: the LCD (LVGL flush
+ * engine) and the SD card (log sink). ESP-IDF's bus lock only interleaves
+ * single transactions first come first served, so a 4 KB SD write can land
+ * in the middle of a frame and stall it by several milliseconds. Here the
+ * LCD holds the bus for a whole frame and goes first whenever it asks; SD
+ * writes are split into chunks of chunk_bytes that are only started when
+ * they fit before the next expected frame (spi_arbiter_policy.h).
+ *
+ * Cooperative: only callers that bracket their transfers with these calls
+ * are scheduled. Until spi_arbiter_init() every call returns at once.
+ */
+
+#include "spi_arbiter_policy.h"
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    size_t chunk_bytes;        /* SD clients split transfers into pieces this size */
+    uint32_t guard_us;
+    uint32_t sd_max_wait_us;
+    uint32_t sd_chunk_est_us;  /* until a chunk has been timed */
+} spi_arbiter_config_t;
+
+typedef struct {
+    spi_arbiter_policy_stats_t policy;
+    uint32_t window_us;        /* since spi_arbiter_init() */
+    uint8_t lcd_pct;           /* bus occupancy */
+    uint8_t sd_pct;
+} spi_arbiter_stats_t;
+
+void spi_arbiter_get_default_config(spi_arbiter_config_t *config);
+bool spi_arbiter_init(const spi_arbiter_config_t *config);
+bool spi_arbiter_is_active(void);
+
+/* Chunk size SD clients should use; SIZE_MAX before init (no splitting). */
+size_t spi_arbiter_sd_chunk_bytes(void);
+
+/* Flush task, before the first band of a frame; blocks while an SD chunk finishes. */
+void spi_arbiter_lcd_frame_begin(void);
+
+/*
+ * DMA-done ISR of the last band. next_frame_us: esp_timer time the next
+ * frame is expected (0: unknown). Returns true if a task woke.
+ */
+bool spi_arbiter_lcd_frame_end_from_isr(int64_t next_frame_us);
+
+/* Flush task, when the last band never reached the bus (draw error). */
+void spi_arbiter_lcd_frame_end(int64_t next_frame_us);
+
+/* Task context; one SD chunk at a time across all SD clients. */
+void spi_arbiter_sd_chunk_begin(void);
+void spi_arbiter_sd_chunk_end(void);
+
+void spi_arbiter_get_stats(spi_arbiter_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ * spi_arbiter_policy.h
+ *
+ * Who may use the shared SPI2 bus next: the LCD (one grant per frame, from
+ * its first band to its last band's DMA done) or the SD card (one grant per
+ * bounded chunk). The LCD is never refused while the bus is free and
+ * always goes before a waiting SD chunk. An SD chunk starts only if its
+ * expected duration (running average of measured chunks) plus guard_us ends
+ * before the LCD's next expected frame, so SD traffic fills the gaps
+ * between frames. The expected frame time is a hint: once it passes with
+ * no frame, SD may go again. An SD request older than sd_max_wait_us is
+ * overdue and goes before the LCD's next frame, so a display redrawing
+ * back to back still leaves the card one chunk per sd_max_wait_us.
+ *
+ * Also accounts bus occupancy per client and wait times. Pure state
+ * machine over caller-supplied microsecond timestamps; no ESP-IDF
+ * dependency, builds and runs on the host.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SPI_ARBITER_OWNER_NONE = 0,
+    SPI_ARBITER_OWNER_LCD,
+    SPI_ARBITER_OWNER_SD,
+    SPI_ARBITER_OWNER_COUNT,
+} spi_arbiter_owner_t;
+
+typedef struct {
+    uint32_t guard_us;          /* slack kept before the next expected frame */
+    uint32_t sd_max_wait_us;    /* SD never waits longer than this for a free bus */
+    uint32_t sd_chunk_est_us;   /* chunk duration until one has been measured */
+} spi_arbiter_policy_config_t;
+
+typedef struct {
+    int64_t since_us;
+    uint64_t busy_us[SPI_ARBITER_OWNER_COUNT];  /* [NONE] unused */
+    uint32_t lcd_frames;
+    uint32_t lcd_waits;          /* frames that found an SD chunk on the bus */
+    uint32_t lcd_max_wait_us;
+    uint32_t sd_chunks;
+    uint32_t sd_deferrals;       /* chunk requests turned away for an upcoming frame */
+    uint32_t sd_forced;          /* chunks granted because sd_max_wait_us ran out */
+    uint32_t sd_max_wait_us;
+    uint32_t sd_chunk_avg_us;
+    uint32_t sd_chunk_max_us;
+} spi_arbiter_policy_stats_t;
+
+typedef struct {
+    spi_arbiter_policy_config_t config;
+    spi_arbiter_owner_t owner;
+    int64_t owner_since_us;
+    uint8_t lcd_depth;             /* LCD frames begun and not yet ended (pipelined) */
+    int64_t lcd_waiting_since_us;  /* 0: LCD not waiting */
+    int64_t sd_waiting_since_us;   /* 0: SD not waiting */
+    int64_t lcd_next_frame_us;     /* 0: no frame expected */
+    spi_arbiter_policy_stats_t stats;
+} spi_arbiter_policy_t;
+
+void spi_arbiter_policy_init(spi_arbiter_policy_t *policy, const spi_arbiter_policy_config_t *config, int64_t now_us);
+
+/*
+ * True if granted (the caller now owns the bus); false marks the client
+ * waiting. The LCD may begin its next frame while the previous one is still
+ * on the wire: that nests (unless an SD chunk is overdue), and the bus is
+ * freed when the last one ends.
+ */
+bool spi_arbiter_policy_lcd_try(spi_arbiter_policy_t *policy, int64_t now_us);
+bool spi_arbiter_policy_sd_try(spi_arbiter_policy_t *policy, int64_t now_us);
+
+/*
+ * Owner gives the bus back. For the LCD, next_frame_us is when its next
+ * frame is expected (0: unknown, SD may use the bus freely).
+ */
+void spi_arbiter_policy_release(spi_arbiter_policy_t *policy, int64_t now_us, int64_t next_frame_us);
+
+/* Who should be woken now that the bus is free: overdue SD, LCD, then SD if a chunk fits. */
+spi_arbiter_owner_t spi_arbiter_policy_next(const spi_arbiter_policy_t *policy, int64_t now_us);
+
+/*
+ * Microseconds until a refused SD request should try again: when the
+ * expected frame time passes or the request is forced, whichever is first.
+ * While the bus is held only the forced deadline counts; the release is
+ * expected to hand the bus over (spi_arbiter_policy_next).
+ */
+uint32_t spi_arbiter_policy_sd_retry_us(const spi_arbiter_policy_t *policy, int64_t now_us);
+
+/* Stats with busy time up to now_us; occupancy is busy_us / (now_us - since_us). */
+void spi_arbiter_policy_get_stats(const spi_arbiter_policy_t *policy, int64_t now_us,
+                                  spi_arbiter_policy_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,241 @@
+#include "spi_arbiter.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+
+#include <string.h>
+
+#ifdef CONFIG_SPI_ARBITER_SD_CHUNK_BYTES
+#define SPI_ARBITER_DEFAULT_CHUNK_BYTES CONFIG_SPI_ARBITER_SD_CHUNK_BYTES
+#else
+#define SPI_ARBITER_DEFAULT_CHUNK_BYTES 512
+#endif
+
+#ifdef CONFIG_SPI_ARBITER_GUARD_US
+#define SPI_ARBITER_DEFAULT_GUARD_US CONFIG_SPI_ARBITER_GUARD_US
+#else
+#define SPI_ARBITER_DEFAULT_GUARD_US 200
+#endif
+
+#ifdef CONFIG_SPI_ARBITER_SD_MAX_WAIT_MS
+#define SPI_ARBITER_DEFAULT_SD_MAX_WAIT_MS CONFIG_SPI_ARBITER_SD_MAX_WAIT_MS
+#else
+#define SPI_ARBITER_DEFAULT_SD_MAX_WAIT_MS 50
+#endif
+
+static const char *TAG = "spi_arbiter";
+
+/* Guards the policy and the grant flags; also taken from the LCD DMA-done ISR. */
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static spi_arbiter_policy_t s_policy;
+static size_t s_chunk_bytes;
+static bool s_active;
+
+/* Set under s_lock when a release hands the bus to a waiter, then its semaphore is given. */
+static bool s_lcd_granted;
+static bool s_sd_granted;
+static StaticSemaphore_t s_lcd_grant_buf;
+static StaticSemaphore_t s_sd_grant_buf;
+static StaticSemaphore_t s_sd_client_buf;
+static SemaphoreHandle_t s_lcd_grant = NULL;
+static SemaphoreHandle_t s_sd_grant = NULL;
+static SemaphoreHandle_t s_sd_client = NULL;  /* one SD chunk in the policy at a time */
+
+void spi_arbiter_get_default_config(spi_arbiter_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->chunk_bytes = SPI_ARBITER_DEFAULT_CHUNK_BYTES;
+    config->guard_us = SPI_ARBITER_DEFAULT_GUARD_US;
+    config->sd_max_wait_us = (uint32_t)SPI_ARBITER_DEFAULT_SD_MAX_WAIT_MS * 1000U;
+    /* 512 B at the 10 MHz SD clock is ~410 us on the wire, plus command overhead. */
+    config->sd_chunk_est_us = 600;
+}
+
+bool spi_arbiter_init(const spi_arbiter_config_t *config)
+{
+    if (config == NULL || config->chunk_bytes == 0U || s_active) {
+        return false;
+    }
+
+    s_lcd_grant = xSemaphoreCreateBinaryStatic(&s_lcd_grant_buf);
+    s_sd_grant = xSemaphoreCreateBinaryStatic(&s_sd_grant_buf);
+    s_sd_client = xSemaphoreCreateMutexStatic(&s_sd_client_buf);
+
+    const spi_arbiter_policy_config_t policy_config = {
+        .guard_us = config->guard_us,
+        .sd_max_wait_us = config->sd_max_wait_us,
+        .sd_chunk_est_us = config->sd_chunk_est_us,
+    };
+    portENTER_CRITICAL(&s_lock);
+    spi_arbiter_policy_init(&s_policy, &policy_config, esp_timer_get_time());
+    s_chunk_bytes = config->chunk_bytes;
+    s_active = true;
+    portEXIT_CRITICAL(&s_lock);
+
+    ESP_LOGI(TAG, "SD chunks of %u bytes, guard %u us, SD max wait %u ms",
+             (unsigned)config->chunk_bytes, (unsigned)config->guard_us,
+             (unsigned)(config->sd_max_wait_us / 1000U));
+    return true;
+}
+
+bool spi_arbiter_is_active(void)
+{
+    return s_active;
+}
+
+size_t spi_arbiter_sd_chunk_bytes(void)
+{
+    return s_active ? s_chunk_bytes : SIZE_MAX;
+}
+
+/*
+ * Caller holds s_lock and has just freed the bus. Grants it to the next
+ * waiter, if any; the caller gives the returned semaphore after unlocking.
+ */
+static SemaphoreHandle_t spi_arbiter_hand_over_locked(int64_t now_us)
+{
+    switch (spi_arbiter_policy_next(&s_policy, now_us)) {
+    case SPI_ARBITER_OWNER_LCD:
+        (void)spi_arbiter_policy_lcd_try(&s_policy, now_us);
+        s_lcd_granted = true;
+        return s_lcd_grant;
+    case SPI_ARBITER_OWNER_SD:
+        (void)spi_arbiter_policy_sd_try(&s_policy, now_us);
+        s_sd_granted = true;
+        return s_sd_grant;
+    default:
+        return NULL;
+    }
+}
+
+void spi_arbiter_lcd_frame_begin(void)
+{
+    if (!s_active) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    const bool granted = spi_arbiter_policy_lcd_try(&s_policy, esp_timer_get_time());
+    portEXIT_CRITICAL(&s_lock);
+
+    /* Only an SD chunk can be on the bus; its end hands the bus straight over. */
+    while (!granted) {
+        (void)xSemaphoreTake(s_lcd_grant, portMAX_DELAY);
+        portENTER_CRITICAL(&s_lock);
+        const bool handed = s_lcd_granted;
+        s_lcd_granted = false;
+        portEXIT_CRITICAL(&s_lock);
+        if (handed) {
+            return;
+        }
+    }
+}
+
+bool spi_arbiter_lcd_frame_end_from_isr(int64_t next_frame_us)
+{
+    if (!s_active) {
+        return false;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_lock);
+    spi_arbiter_policy_release(&s_policy, now_us, next_frame_us);
+    SemaphoreHandle_t wake = spi_arbiter_hand_over_locked(now_us);
+    portEXIT_CRITICAL_ISR(&s_lock);
+
+    BaseType_t woken = pdFALSE;
+    if (wake != NULL) {
+        (void)xSemaphoreGiveFromISR(wake, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+void spi_arbiter_lcd_frame_end(int64_t next_frame_us)
+{
+    if (!s_active) {
+        return;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    spi_arbiter_policy_release(&s_policy, now_us, next_frame_us);
+    SemaphoreHandle_t wake = spi_arbiter_hand_over_locked(now_us);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (wake != NULL) {
+        (void)xSemaphoreGive(wake);
+    }
+}
+
+void spi_arbiter_sd_chunk_begin(void)
+{
+    if (!s_active) {
+        return;
+    }
+
+    (void)xSemaphoreTake(s_sd_client, portMAX_DELAY);
+    while (1) {
+        portENTER_CRITICAL(&s_lock);
+        const int64_t now_us = esp_timer_get_time();
+        bool granted = s_sd_granted;
+        s_sd_granted = false;
+        if (!granted) {
+            granted = spi_arbiter_policy_sd_try(&s_policy, now_us);
+        }
+        const uint32_t retry_us = spi_arbiter_policy_sd_retry_us(&s_policy, now_us);
+        portEXIT_CRITICAL(&s_lock);
+
+        if (granted) {
+            return;
+        }
+        /* Woken early by a hand-over; the timeout covers a frame that never came. */
+        TickType_t ticks = pdMS_TO_TICKS((retry_us + 999U) / 1000U);
+        (void)xSemaphoreTake(s_sd_grant, (ticks > 0U) ? ticks : 1U);
+    }
+}
+
+void spi_arbiter_sd_chunk_end(void)
+{
+    if (!s_active) {
+        return;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    spi_arbiter_policy_release(&s_policy, now_us, 0);
+    SemaphoreHandle_t wake = spi_arbiter_hand_over_locked(now_us);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (wake != NULL) {
+        (void)xSemaphoreGive(wake);
+    }
+    (void)xSemaphoreGive(s_sd_client);
+}
+
+void spi_arbiter_get_stats(spi_arbiter_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+
+    memset(out_stats, 0, sizeof(*out_stats));
+    if (!s_active) {
+        return;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    spi_arbiter_policy_get_stats(&s_policy, now_us, &out_stats->policy);
+    portEXIT_CRITICAL(&s_lock);
+
+    const uint64_t window_us = (uint64_t)(now_us - out_stats->policy.since_us);
+    out_stats->window_us = (window_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)window_us;
+    if (window_us > 0U) {
+        out_stats->lcd_pct = (uint8_t)(out_stats->policy.busy_us[SPI_ARBITER_OWNER_LCD] * 100U / window_us);
+        out_stats->sd_pct = (uint8_t)(out_stats->policy.busy_us[SPI_ARBITER_OWNER_SD] * 100U / window_us);
+    }
+}
@@ -0,0 +1,181 @@
+#include "spi_arbiter_policy.h"
+
+#include <stddef.h>
+#include <string.h>
+
+static uint32_t spi_arbiter_chunk_est_us(const spi_arbiter_policy_t *policy)
+{
+    return (policy->stats.sd_chunks > 0U) ? policy->stats.sd_chunk_avg_us : policy->config.sd_chunk_est_us;
+}
+
+/* An SD request has waited sd_max_wait_us: it goes before the LCD's next frame. */
+static bool spi_arbiter_sd_overdue(const spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    return policy->sd_waiting_since_us != 0 &&
+           now_us - policy->sd_waiting_since_us >= (int64_t)policy->config.sd_max_wait_us;
+}
+
+/* An SD chunk started now ends (plus guard) before the next expected frame. */
+static bool spi_arbiter_sd_fits(const spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    if (policy->lcd_next_frame_us == 0 || now_us >= policy->lcd_next_frame_us) {
+        return true;
+    }
+    const int64_t end_us = now_us + spi_arbiter_chunk_est_us(policy) + policy->config.guard_us;
+    return end_us <= policy->lcd_next_frame_us;
+}
+
+static void spi_arbiter_take(spi_arbiter_policy_t *policy, spi_arbiter_owner_t owner, int64_t now_us)
+{
+    policy->owner = owner;
+    policy->owner_since_us = now_us;
+}
+
+void spi_arbiter_policy_init(spi_arbiter_policy_t *policy, const spi_arbiter_policy_config_t *config, int64_t now_us)
+{
+    if (policy == NULL || config == NULL) {
+        return;
+    }
+    memset(policy, 0, sizeof(*policy));
+    policy->config = *config;
+    policy->stats.since_us = now_us;
+}
+
+bool spi_arbiter_policy_lcd_try(spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    /* Back-to-back frames would keep the bus forever; an overdue SD chunk goes in between. */
+    if (policy->owner == SPI_ARBITER_OWNER_LCD && !spi_arbiter_sd_overdue(policy, now_us)) {
+        policy->lcd_depth++;
+        policy->stats.lcd_frames++;
+        return true;
+    }
+    if (policy->owner != SPI_ARBITER_OWNER_NONE) {
+        if (policy->lcd_waiting_since_us == 0) {
+            policy->lcd_waiting_since_us = now_us;
+        }
+        return false;
+    }
+
+    if (policy->lcd_waiting_since_us != 0) {
+        const uint32_t waited_us = (uint32_t)(now_us - policy->lcd_waiting_since_us);
+        policy->stats.lcd_waits++;
+        if (waited_us > policy->stats.lcd_max_wait_us) {
+            policy->stats.lcd_max_wait_us = waited_us;
+        }
+        policy->lcd_waiting_since_us = 0;
+    }
+    policy->stats.lcd_frames++;
+    policy->lcd_depth = 1U;
+    spi_arbiter_take(policy, SPI_ARBITER_OWNER_LCD, now_us);
+    return true;
+}
+
+bool spi_arbiter_policy_sd_try(spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    const bool overdue = spi_arbiter_sd_overdue(policy, now_us);
+    const bool yield = policy->lcd_waiting_since_us != 0 || !spi_arbiter_sd_fits(policy, now_us);
+    if (policy->owner != SPI_ARBITER_OWNER_NONE || (yield && !overdue)) {
+        if (policy->owner == SPI_ARBITER_OWNER_NONE && policy->lcd_waiting_since_us == 0) {
+            policy->stats.sd_deferrals++;
+        }
+        if (policy->sd_waiting_since_us == 0) {
+            policy->sd_waiting_since_us = now_us;
+        }
+        return false;
+    }
+
+    if (policy->sd_waiting_since_us != 0) {
+        const uint32_t waited_us = (uint32_t)(now_us - policy->sd_waiting_since_us);
+        if (waited_us > policy->stats.sd_max_wait_us) {
+            policy->stats.sd_max_wait_us = waited_us;
+        }
+        policy->sd_waiting_since_us = 0;
+    }
+    if (yield) {
+        policy->stats.sd_forced++;
+    }
+    spi_arbiter_take(policy, SPI_ARBITER_OWNER_SD, now_us);
+    return true;
+}
+
+void spi_arbiter_policy_release(spi_arbiter_policy_t *policy, int64_t now_us, int64_t next_frame_us)
+{
+    const spi_arbiter_owner_t owner = policy->owner;
+    if (owner == SPI_ARBITER_OWNER_NONE) {
+        return;
+    }
+
+    if (owner == SPI_ARBITER_OWNER_LCD) {
+        policy->lcd_next_frame_us = next_frame_us;
+        if (policy->lcd_depth > 1U) {
+            policy->lcd_depth--;
+            return;
+        }
+        policy->lcd_depth = 0U;
+    }
+
+    const uint32_t held_us = (uint32_t)(now_us - policy->owner_since_us);
+    policy->stats.busy_us[owner] += held_us;
+    if (owner == SPI_ARBITER_OWNER_SD) {
+        /* Running average over ~8 chunks; the first one seeds it. */
+        spi_arbiter_policy_stats_t *stats = &policy->stats;
+        stats->sd_chunks++;
+        stats->sd_chunk_avg_us = (stats->sd_chunks == 1U)
+                                     ? held_us
+                                     : (uint32_t)(((uint64_t)stats->sd_chunk_avg_us * 7U + held_us) / 8U);
+        if (held_us > stats->sd_chunk_max_us) {
+            stats->sd_chunk_max_us = held_us;
+        }
+    }
+    policy->owner = SPI_ARBITER_OWNER_NONE;
+}
+
+spi_arbiter_owner_t spi_arbiter_policy_next(const spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    if (policy->owner != SPI_ARBITER_OWNER_NONE) {
+        return SPI_ARBITER_OWNER_NONE;
+    }
+    if (spi_arbiter_sd_overdue(policy, now_us)) {
+        return SPI_ARBITER_OWNER_SD;
+    }
+    if (policy->lcd_waiting_since_us != 0) {
+        return SPI_ARBITER_OWNER_LCD;
+    }
+    if (policy->sd_waiting_since_us != 0 && spi_arbiter_sd_fits(policy, now_us)) {
+        return SPI_ARBITER_OWNER_SD;
+    }
+    return SPI_ARBITER_OWNER_NONE;
+}
+
+uint32_t spi_arbiter_policy_sd_retry_us(const spi_arbiter_policy_t *policy, int64_t now_us)
+{
+    int64_t retry_us = 0;
+    if (policy->owner != SPI_ARBITER_OWNER_NONE || policy->lcd_waiting_since_us != 0) {
+        /* The release hands the bus over; only the forced deadline needs a timer. */
+        retry_us = INT64_MAX;
+    } else if (policy->lcd_next_frame_us > now_us) {
+        retry_us = policy->lcd_next_frame_us - now_us;
+    }
+    if (policy->sd_waiting_since_us != 0) {
+        const int64_t forced_in_us = policy->sd_waiting_since_us + policy->config.sd_max_wait_us - now_us;
+        if (forced_in_us < retry_us) {
+            retry_us = forced_in_us;
+        }
+    }
+    if (retry_us > (int64_t)policy->config.sd_max_wait_us) {
+        retry_us = policy->config.sd_max_wait_us;
+    }
+    return (retry_us > 0) ? (uint32_t)retry_us : 0U;
+}
+
+void spi_arbiter_policy_get_stats(const spi_arbiter_policy_t *policy, int64_t now_us,
+                                  spi_arbiter_policy_stats_t *out_stats)
+{
+    if (policy == NULL || out_stats == NULL) {
+        return;
+    }
+    *out_stats = policy->stats;
+    if (policy->owner != SPI_ARBITER_OWNER_NONE) {
+        out_stats->busy_us[policy->owner] += (uint64_t)(now_us - policy->owner_since_us);
+    }
+}
@@ -0,0 +1,83 @@
+#include "spi_arbiter_policy.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+
+static void policy_setup(spi_arbiter_policy_t *policy)
+{
+    const spi_arbiter_policy_config_t config = {
+        .guard_us = 100,
+        .sd_max_wait_us = 20000,
+        .sd_chunk_est_us = 500,
+    };
+    spi_arbiter_policy_init(policy, &config, 1000);
+}
+
+TEST_CASE("spi_arbiter_policy gives the LCD priority and fits SD chunks between frames", "[spi_arbiter]")
+{
+    spi_arbiter_policy_t policy;
+    policy_setup(&policy);
+
+    /* Frame 1 on the bus; SD waits and is handed the bus when it ends. */
+    TEST_ASSERT_TRUE(spi_arbiter_policy_lcd_try(&policy, 1000));
+    TEST_ASSERT_FALSE(spi_arbiter_policy_sd_try(&policy, 2000));
+    spi_arbiter_policy_release(&policy, 5000, 11000);
+    TEST_ASSERT_EQUAL(SPI_ARBITER_OWNER_SD, spi_arbiter_policy_next(&policy, 5000));
+    TEST_ASSERT_TRUE(spi_arbiter_policy_sd_try(&policy, 5000));
+
+    /* The LCD asks during the chunk and goes before the next SD chunk. */
+    TEST_ASSERT_FALSE(spi_arbiter_policy_lcd_try(&policy, 5200));
+    TEST_ASSERT_FALSE(spi_arbiter_policy_sd_try(&policy, 5300));
+    spi_arbiter_policy_release(&policy, 5500, 0);
+    TEST_ASSERT_EQUAL(SPI_ARBITER_OWNER_LCD, spi_arbiter_policy_next(&policy, 5500));
+    TEST_ASSERT_TRUE(spi_arbiter_policy_lcd_try(&policy, 5500));
+
+    /* Pipelined frames nest; the bus frees on the last end. */
+    TEST_ASSERT_TRUE(spi_arbiter_policy_lcd_try(&policy, 8000));
+    spi_arbiter_policy_release(&policy, 9000, 20000);
+    TEST_ASSERT_EQUAL(SPI_ARBITER_OWNER_LCD, policy.owner);
+    spi_arbiter_policy_release(&policy, 10000, 20000);
+
+    /* 500 us chunk + 100 us guard: fits at 19400, not at 19401. */
+    TEST_ASSERT_TRUE(spi_arbiter_policy_sd_try(&policy, 10000));
+    spi_arbiter_policy_release(&policy, 10500, 0);
+    TEST_ASSERT_FALSE(spi_arbiter_policy_sd_try(&policy, 19401));
+    TEST_ASSERT_EQUAL_UINT32(599U, spi_arbiter_policy_sd_retry_us(&policy, 19401));
+    TEST_ASSERT_TRUE(spi_arbiter_policy_sd_try(&policy, 20000));
+    spi_arbiter_policy_release(&policy, 20500, 0);
+
+    spi_arbiter_policy_stats_t stats;
+    spi_arbiter_policy_get_stats(&policy, 21000, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3U, stats.lcd_frames);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.lcd_waits);
+    TEST_ASSERT_EQUAL_UINT32(300U, stats.lcd_max_wait_us);
+    TEST_ASSERT_EQUAL_UINT32(3U, stats.sd_chunks);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.sd_deferrals);
+    TEST_ASSERT_EQUAL_UINT64(4000U + 4500U, stats.busy_us[SPI_ARBITER_OWNER_LCD]);
+    TEST_ASSERT_EQUAL_UINT64(1500U, stats.busy_us[SPI_ARBITER_OWNER_SD]);
+}
+
+TEST_CASE("spi_arbiter_policy forces a starved SD chunk after sd_max_wait_us", "[spi_arbiter]")
+{
+    spi_arbiter_policy_t policy;
+    policy_setup(&policy);
+
+    /* Frames back to back with 300 us gaps: a 500 us chunk never fits. */
+    int64_t now = 1000;
+    bool sd_done = false;
+    for (int frame = 0; frame < 10 && !sd_done; ++frame) {
+        TEST_ASSERT_TRUE(spi_arbiter_policy_lcd_try(&policy, now));
+        now += 3000;
+        spi_arbiter_policy_release(&policy, now, now + 300);
+        sd_done = spi_arbiter_policy_sd_try(&policy, now);
+        now += 300;
+    }
+
+    TEST_ASSERT_TRUE(sd_done);
+    spi_arbiter_policy_stats_t stats;
+    spi_arbiter_policy_get_stats(&policy, now, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats.sd_forced);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(20000U, stats.sd_max_wait_us);
+    TEST_ASSERT_EQUAL(SPI_ARBITER_OWNER_SD, policy.owner);
+}
@@ -0,0 +1,136 @@
+/*
+ * test_snapshot_latch.c
+ *
+ * Host test: pthread writers and readers hammer the system_snapshot groups.
+ * Every field in a group is derived from one counter, so a reader that mixes
+ * two writes (a torn read) is detectable. Built plain and under TSan/ASan.
+ */
+
+#include "system_snapshot.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LATCH_WRITES_PER_WRITER 200000
+#define LATCH_READERS 3
+#define LATCH_WRITERS 3
+
+static int s_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            s_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+static atomic_int s_writers_finished;
+
+static void *time_writer_thread(void *arg)
+{
+    const int64_t base = (int64_t)(intptr_t)arg;
+    char iso[SYSTEM_SNAPSHOT_ISO8601_LEN];
+
+    for (int64_t i = 0; i < LATCH_WRITES_PER_WRITER; ++i) {
+        const int64_t epoch = base + i;
+        (void)snprintf(iso, sizeof(iso), "T%lld", (long long)epoch);
+        system_snapshot_update_time(epoch, iso);
+    }
+
+    atomic_fetch_add(&s_writers_finished, 1);
+    return NULL;
+}
+
+static void *metrics_writer_thread(void *arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 1; i <= LATCH_WRITES_PER_WRITER; ++i) {
+        system_snapshot_update_metrics(i, ~i, (int8_t)(i & 0x3FU), (i & 1U) != 0U);
+    }
+
+    atomic_fetch_add(&s_writers_finished, 1);
+    return NULL;
+}
+
+typedef struct {
+    uint32_t reads;
+    uint32_t torn;
+} reader_result_t;
+
+static void *reader_thread(void *arg)
+{
+    reader_result_t *result = (reader_result_t *)arg;
+    system_snapshot_t snapshot;
+    char expected_iso[SYSTEM_SNAPSHOT_ISO8601_LEN];
+
+    while (atomic_load(&s_writers_finished) < LATCH_WRITERS) {
+        system_snapshot_read(&snapshot);
+        result->reads++;
+
+        (void)snprintf(expected_iso, sizeof(expected_iso), "T%lld", (long long)snapshot.epoch_seconds);
+        if (strcmp(expected_iso, snapshot.iso8601) != 0 ||
+            snapshot.free_heap_bytes != ~snapshot.uptime_ms ||
+            snapshot.wifi_rssi_dbm != (int8_t)(snapshot.uptime_ms & 0x3FU) ||
+            snapshot.wifi_connected != ((snapshot.uptime_ms & 1U) != 0U)) {
+            result->torn++;
+        }
+    }
+
+    return NULL;
+}
+
+static void test_concurrent_readers_never_see_torn_groups(void)
+{
+    pthread_t writers[LATCH_WRITERS];
+    pthread_t readers[LATCH_READERS];
+    reader_result_t results[LATCH_READERS];
+
+    memset(results, 0, sizeof(results));
+    system_snapshot_update_time(0, "T0");
+    system_snapshot_update_metrics(0U, ~0U, 0, false);
+    atomic_store(&s_writers_finished, 0);
+
+    for (int i = 0; i < LATCH_READERS; ++i) {
+        CHECK(pthread_create(&readers[i], NULL, reader_thread, &results[i]) == 0);
+    }
+
+    /* Two time writers exercise same-group writer serialisation. */
+    CHECK(pthread_create(&writers[0], NULL, time_writer_thread, (void *)(intptr_t)0) == 0);
+    CHECK(pthread_create(&writers[1], NULL, time_writer_thread, (void *)(intptr_t)1000000) == 0);
+    CHECK(pthread_create(&writers[2], NULL, metrics_writer_thread, NULL) == 0);
+
+    for (int i = 0; i < LATCH_WRITERS; ++i) {
+        CHECK(pthread_join(writers[i], NULL) == 0);
+    }
+    for (int i = 0; i < LATCH_READERS; ++i) {
+        CHECK(pthread_join(readers[i], NULL) == 0);
+        CHECK(results[i].reads > 0U);
+        CHECK(results[i].torn == 0U);
+    }
+
+    /* The last write of each group is what a quiet reader sees. */
+    system_snapshot_t snapshot;
+    system_snapshot_read(&snapshot);
+    CHECK(snapshot.uptime_ms == LATCH_WRITES_PER_WRITER);
+    CHECK(snapshot.epoch_seconds == LATCH_WRITES_PER_WRITER - 1 ||
+          snapshot.epoch_seconds == 1000000 + LATCH_WRITES_PER_WRITER - 1);
+}
+
+int main(void)
+{
+    system_snapshot_init();
+    test_concurrent_readers_never_see_torn_groups();
+
+    if (s_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_snapshot_latch: ok\n");
+    return EXIT_SUCCESS;
+}
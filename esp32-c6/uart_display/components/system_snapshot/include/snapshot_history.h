@@ -0,0 +1,83 @@
+#pragma once
+
+/*
+ * snapshot_history.h
+ *
+ * Fixed-size trend history for a few snapshot metrics. Every sample is
+ * folded into three independent tiers (2 s, 1 min, 1 h buckets); each tier
+ * keeps min/max/avg per bucket in a ring sized at compile time. All storage
+ * is static: recording and reading never allocate. The finest tier matches
+ * the 2 s sampling period of the metrics and temperature jobs, so it has no
+ * built-in gaps.
+ *
+ * Bucket times are uptime seconds (bucket start). The newest bucket is still
+ * open and reflects the samples seen so far. Buckets without samples are
+ * kept as gaps (min > max) so a missing RSSI reading stays visible.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SNAPSHOT_HISTORY_FREE_HEAP = 0, /* bytes */
+    SNAPSHOT_HISTORY_WIFI_RSSI,     /* dBm, only while connected */
+    SNAPSHOT_HISTORY_TEMPERATURE,   /* centi-degrees Celsius */
+    SNAPSHOT_HISTORY_METRIC_COUNT
+} snapshot_history_metric_t;
+
+typedef enum {
+    SNAPSHOT_HISTORY_TIER_2S = 0,
+    SNAPSHOT_HISTORY_TIER_1M,
+    SNAPSHOT_HISTORY_TIER_1H,
+    SNAPSHOT_HISTORY_TIER_COUNT
+} snapshot_history_tier_t;
+
+#define SNAPSHOT_HISTORY_2S_PERIOD_S 2U
+#define SNAPSHOT_HISTORY_2S_POINTS 120U /* 4 minutes */
+#define SNAPSHOT_HISTORY_1M_POINTS 60U  /* 1 hour */
+#define SNAPSHOT_HISTORY_1H_POINTS 48U  /* 2 days */
+#define SNAPSHOT_HISTORY_MAX_POINTS SNAPSHOT_HISTORY_2S_POINTS
+
+typedef struct {
+    int32_t min;
+    int32_t max;
+    int32_t avg;
+} snapshot_history_point_t;
+
+#define SNAPSHOT_HISTORY_POINT_EMPTY(point) ((point)->min > (point)->max)
+
+/* Clears all tiers; safe to call again (tests). */
+bool snapshot_history_init(void);
+
+/* Records at the current uptime. */
+void snapshot_history_record(snapshot_history_metric_t metric, int32_t value);
+void snapshot_history_record_at(snapshot_history_metric_t metric, uint32_t uptime_s, int32_t value);
+
+/*
+ * Copies up to max_points buckets, oldest first, ending with the open bucket.
+ * Returns the number copied; out_newest_s (optional) gets the newest bucket's
+ * start time. One consistent copy: take it once per response or redraw.
+ */
+size_t snapshot_history_read(snapshot_history_metric_t metric,
+                             snapshot_history_tier_t tier,
+                             snapshot_history_point_t *out_points,
+                             size_t max_points,
+                             uint32_t *out_newest_s);
+
+uint32_t snapshot_history_tier_period_s(snapshot_history_tier_t tier);
+size_t snapshot_history_tier_capacity(snapshot_history_tier_t tier);
+
+/* Short names used by the REST API ("heap", "rssi", "temp"; "2s", "1m", "1h"). */
+const char *snapshot_history_metric_name(snapshot_history_metric_t metric);
+const char *snapshot_history_tier_name(snapshot_history_tier_t tier);
+bool snapshot_history_metric_from_name(const char *name, snapshot_history_metric_t *out_metric);
+bool snapshot_history_tier_from_name(const char *name, snapshot_history_tier_t *out_tier);
+
+#ifdef __cplusplus
+}
+#endif
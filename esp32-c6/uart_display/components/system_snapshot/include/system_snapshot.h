@@ -5,9 +5,19 @@
  *
  * Owns the system snapshot used by REST handlers and other consumers.
  * Producers update this snapshot; consumers read it lock-free.
+ * Each update call publishes its fields as one group without interrupt
+ * masking; a read never sees a half-written group, but fields from different
+ * update calls (e.g. time vs. metrics) may come from different moments.
+ *
+ * Every update that changes at least one field bumps a generation counter and
+ * marks the changed fields dirty for each subscriber whose mask covers them.
+ * Subscribers are woken (callback or queue) only on the clean->dirty edge and
+ * then collect the changed fields with system_snapshot_take_changes(), so a
+ * slow consumer sees one wake-up and the latest values, never a backlog.
  */
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -18,6 +28,31 @@ extern "C" {
 
 #define SYSTEM_SNAPSHOT_ISO8601_LEN 32
 #define SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID (-127)
+#define SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS 8
+
+typedef enum {
+    SYSTEM_SNAPSHOT_FIELD_TIME = 1U << 0, /* epoch_seconds and iso8601 */
+    SYSTEM_SNAPSHOT_FIELD_TEMPERATURE = 1U << 1,
+    SYSTEM_SNAPSHOT_FIELD_UPTIME = 1U << 2,
+    SYSTEM_SNAPSHOT_FIELD_FREE_HEAP = 1U << 3,
+    SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI = 1U << 4,
+    SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED = 1U << 5,
+    SYSTEM_SNAPSHOT_FIELD_WIFI_LINK = 1U << 6, /* wifi_link reconnect metrics */
+    SYSTEM_SNAPSHOT_FIELD_ALL = (1U << 7) - 1U,
+} system_snapshot_field_t;
+
+#define SYSTEM_SNAPSHOT_FIELD_COUNT 7
+
+/* Published by wifi_manager on every link change. */
+typedef struct {
+    uint32_t disconnects;        /* link drops after a successful connect */
+    uint32_t reconnects;         /* drops that ended with an IP again */
+    uint32_t last_reconnect_ms;  /* drop -> got IP, most recent */
+    uint32_t avg_reconnect_ms;
+    uint32_t max_reconnect_ms;
+    uint32_t attempts;           /* esp_wifi_connect() calls */
+    uint8_t last_reason;         /* wifi_err_reason_t of the last disconnect */
+} system_snapshot_wifi_link_t;
 
 typedef struct {
     int64_t epoch_seconds;
@@ -27,14 +62,23 @@ typedef struct {
     uint32_t free_heap_bytes;
     int8_t wifi_rssi_dbm;
     bool wifi_connected;
+    system_snapshot_wifi_link_t wifi_link;
+    uint32_t generation; /* set by system_snapshot_read() */
 } system_snapshot_t;
 
 typedef struct {
-    uint32_t interval_ms;
-    uint32_t stack_size;
-    UBaseType_t task_priority;
-    BaseType_t core_id;
-} system_snapshot_metrics_task_config_t;
+    uint32_t generation; /* values are at least this new */
+    uint32_t changed;    /* system_snapshot_field_t bits valid in values */
+    system_snapshot_t values; /* fields outside `changed` are zeroed */
+} system_snapshot_delta_t;
+
+typedef int8_t system_snapshot_subscriber_id_t;
+
+/*
+ * Runs in the producer's task with the newly dirtied fields. Keep it short
+ * (give a semaphore, notify a task); do not read or update the snapshot here.
+ */
+typedef void (*system_snapshot_notify_cb_t)(uint32_t changed_fields, void *ctx);
 
 void system_snapshot_init(void);
 
@@ -44,11 +88,55 @@ void system_snapshot_update_metrics(uint32_t uptime_ms,
                                     uint32_t free_heap_bytes,
                                     int8_t wifi_rssi_dbm,
                                     bool wifi_connected);
+void system_snapshot_update_wifi_link(const system_snapshot_wifi_link_t *link);
 
 void system_snapshot_read(system_snapshot_t *out_snapshot);
 
-void system_snapshot_metrics_task_get_default_config(system_snapshot_metrics_task_config_t *config);
-bool system_snapshot_start_metrics_task(const system_snapshot_metrics_task_config_t *config);
+/* Current generation; changes whenever any field changes. */
+uint32_t system_snapshot_generation(void);
+
+/*
+ * Newest generation among `fields`: changes only when one of them changes,
+ * so it can serve as a cache validator for a subset. Read values after it.
+ */
+uint32_t system_snapshot_fields_generation(uint32_t fields);
+
+/*
+ * Fields changed after `since_generation` (0 = everything). Returns the
+ * changed mask, also stored in out_delta->changed.
+ */
+uint32_t system_snapshot_read_since(uint32_t since_generation, system_snapshot_delta_t *out_delta);
+
+/*
+ * callback may be NULL for consumers that call system_snapshot_take_changes()
+ * from a loop they already run (e.g. an LVGL timer); it is then a single
+ * atomic exchange that returns 0 until something they watch changes.
+ */
+bool system_snapshot_subscribe(uint32_t fields,
+                               system_snapshot_notify_cb_t callback,
+                               void *ctx,
+                               system_snapshot_subscriber_id_t *out_id);
+
+/* Sends the newly dirtied mask (uint32_t item) without blocking; a full queue is fine. */
+bool system_snapshot_subscribe_queue(uint32_t fields,
+                                     QueueHandle_t queue,
+                                     system_snapshot_subscriber_id_t *out_id);
+
+/* A producer already notifying may still invoke the callback once. */
+void system_snapshot_unsubscribe(system_snapshot_subscriber_id_t id);
+
+/*
+ * Clears the subscriber's dirty bits and returns the fields that changed since
+ * its last call (0 if none); only those fields are filled in out_delta.
+ */
+uint32_t system_snapshot_take_changes(system_snapshot_subscriber_id_t id, system_snapshot_delta_t *out_delta);
+
+/*
+ * One uptime / free heap / RSSI sample into the snapshot and its history.
+ * Run every SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS from a periodic job.
+ */
+#define SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS 2000U
+void system_snapshot_sample_metrics(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,252 @@
+/*
+ * snapshot_history.c
+ *
+ * Fixed-size min/max/avg trend history for snapshot metrics.
+ *
+ * Each tier folds raw samples into its own open bucket (exact min/max/avg
+ * per tier, no error from re-aggregating a coarser tier) and pushes it into
+ * the tier's ring when a sample lands in a later bucket. Skipped buckets are
+ * pushed as gaps. A static mutex guards each metric; writers are the
+ * metrics and temperature tasks, readers REST handlers and the LVGL feed.
+ */
+
+#include "snapshot_history.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <limits.h>
+#include <string.h>
+
+typedef struct {
+    snapshot_history_point_t *points;
+    uint32_t period_s;
+    uint16_t capacity;
+    uint16_t head;  /* next slot to write */
+    uint16_t count; /* closed buckets in the ring */
+    bool open;
+    uint32_t bucket; /* index (uptime_s / period_s) of the open bucket */
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint32_t samples;
+} history_tier_t;
+
+typedef struct {
+    SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutex_buf;
+    history_tier_t tiers[SNAPSHOT_HISTORY_TIER_COUNT];
+} history_metric_t;
+
+static snapshot_history_point_t s_points_2s[SNAPSHOT_HISTORY_METRIC_COUNT][SNAPSHOT_HISTORY_2S_POINTS];
+static snapshot_history_point_t s_points_1m[SNAPSHOT_HISTORY_METRIC_COUNT][SNAPSHOT_HISTORY_1M_POINTS];
+static snapshot_history_point_t s_points_1h[SNAPSHOT_HISTORY_METRIC_COUNT][SNAPSHOT_HISTORY_1H_POINTS];
+static history_metric_t s_metrics[SNAPSHOT_HISTORY_METRIC_COUNT];
+
+static const uint32_t s_tier_period_s[SNAPSHOT_HISTORY_TIER_COUNT] = { SNAPSHOT_HISTORY_2S_PERIOD_S, 60U, 3600U };
+static const uint16_t s_tier_capacity[SNAPSHOT_HISTORY_TIER_COUNT] = {
+    SNAPSHOT_HISTORY_2S_POINTS,
+    SNAPSHOT_HISTORY_1M_POINTS,
+    SNAPSHOT_HISTORY_1H_POINTS,
+};
+static const char *const s_metric_names[SNAPSHOT_HISTORY_METRIC_COUNT] = { "heap", "rssi", "temp" };
+static const char *const s_tier_names[SNAPSHOT_HISTORY_TIER_COUNT] = { "2s", "1m", "1h" };
+
+static const snapshot_history_point_t s_gap = { .min = INT32_MAX, .max = INT32_MIN, .avg = 0 };
+
+static void history_tier_push(history_tier_t *tier, const snapshot_history_point_t *point)
+{
+    tier->points[tier->head] = *point;
+    tier->head = (uint16_t)((tier->head + 1U) % tier->capacity);
+    if (tier->count < tier->capacity) {
+        tier->count++;
+    }
+}
+
+static void history_tier_open_point(const history_tier_t *tier, snapshot_history_point_t *out_point)
+{
+    out_point->min = tier->min;
+    out_point->max = tier->max;
+    out_point->avg = (int32_t)(tier->sum / (int64_t)tier->samples);
+}
+
+static void history_tier_add(history_tier_t *tier, uint32_t uptime_s, int32_t value)
+{
+    const uint32_t bucket = uptime_s / tier->period_s;
+
+    if (tier->open && bucket < tier->bucket) {
+        return; /* clock went backwards; keep the ring ordered */
+    }
+
+    if (tier->open && bucket > tier->bucket) {
+        snapshot_history_point_t closed;
+        history_tier_open_point(tier, &closed);
+        history_tier_push(tier, &closed);
+
+        uint32_t gaps = bucket - tier->bucket - 1U;
+        if (gaps > tier->capacity) {
+            gaps = tier->capacity;
+        }
+        while (gaps-- > 0U) {
+            history_tier_push(tier, &s_gap);
+        }
+        tier->open = false;
+    }
+
+    if (!tier->open) {
+        tier->open = true;
+        tier->bucket = bucket;
+        tier->min = value;
+        tier->max = value;
+        tier->sum = 0;
+        tier->samples = 0U;
+    }
+
+    if (value < tier->min) {
+        tier->min = value;
+    }
+    if (value > tier->max) {
+        tier->max = value;
+    }
+    tier->sum += value;
+    tier->samples++;
+}
+
+bool snapshot_history_init(void)
+{
+    for (uint32_t m = 0; m < SNAPSHOT_HISTORY_METRIC_COUNT; ++m) {
+        history_metric_t *metric = &s_metrics[m];
+        if (metric->mutex == NULL) {
+            metric->mutex = xSemaphoreCreateMutexStatic(&metric->mutex_buf);
+            if (metric->mutex == NULL) {
+                return false;
+            }
+        }
+
+        (void)xSemaphoreTake(metric->mutex, portMAX_DELAY);
+        snapshot_history_point_t *storage[SNAPSHOT_HISTORY_TIER_COUNT] = {
+            s_points_2s[m],
+            s_points_1m[m],
+            s_points_1h[m],
+        };
+        for (uint32_t t = 0; t < SNAPSHOT_HISTORY_TIER_COUNT; ++t) {
+            history_tier_t *tier = &metric->tiers[t];
+            memset(tier, 0, sizeof(*tier));
+            tier->points = storage[t];
+            tier->period_s = s_tier_period_s[t];
+            tier->capacity = s_tier_capacity[t];
+        }
+        (void)xSemaphoreGive(metric->mutex);
+    }
+
+    return true;
+}
+
+void snapshot_history_record(snapshot_history_metric_t metric, int32_t value)
+{
+    snapshot_history_record_at(metric, (uint32_t)(esp_timer_get_time() / 1000000), value);
+}
+
+void snapshot_history_record_at(snapshot_history_metric_t metric, uint32_t uptime_s, int32_t value)
+{
+    if ((uint32_t)metric >= SNAPSHOT_HISTORY_METRIC_COUNT || s_metrics[metric].mutex == NULL) {
+        return;
+    }
+
+    history_metric_t *entry = &s_metrics[metric];
+    (void)xSemaphoreTake(entry->mutex, portMAX_DELAY);
+    for (uint32_t t = 0; t < SNAPSHOT_HISTORY_TIER_COUNT; ++t) {
+        history_tier_add(&entry->tiers[t], uptime_s, value);
+    }
+    (void)xSemaphoreGive(entry->mutex);
+}
+
+size_t snapshot_history_read(snapshot_history_metric_t metric,
+                             snapshot_history_tier_t tier,
+                             snapshot_history_point_t *out_points,
+                             size_t max_points,
+                             uint32_t *out_newest_s)
+{
+    if ((uint32_t)metric >= SNAPSHOT_HISTORY_METRIC_COUNT || (uint32_t)tier >= SNAPSHOT_HISTORY_TIER_COUNT ||
+        out_points == NULL || s_metrics[metric].mutex == NULL) {
+        return 0U;
+    }
+
+    history_metric_t *entry = &s_metrics[metric];
+    (void)xSemaphoreTake(entry->mutex, portMAX_DELAY);
+
+    const history_tier_t *state = &entry->tiers[tier];
+    const size_t closed = state->count;
+    const size_t total = closed + (state->open ? 1U : 0U);
+    const size_t take = (total < max_points) ? total : max_points;
+    const size_t take_closed = (state->open && take > 0U) ? take - 1U : take;
+
+    /* Oldest closed bucket we return, skipping what does not fit. */
+    size_t index = (state->head + state->capacity - closed) % state->capacity;
+    index = (index + (closed - take_closed)) % state->capacity;
+    for (size_t i = 0; i < take_closed; ++i) {
+        out_points[i] = state->points[index];
+        index = (index + 1U) % state->capacity;
+    }
+    if (state->open && take > 0U) {
+        history_tier_open_point(state, &out_points[take_closed]);
+    }
+
+    if (out_newest_s != NULL) {
+        *out_newest_s = state->open ? state->bucket * state->period_s : 0U;
+    }
+
+    (void)xSemaphoreGive(entry->mutex);
+    return take;
+}
+
+uint32_t snapshot_history_tier_period_s(snapshot_history_tier_t tier)
+{
+    return ((uint32_t)tier < SNAPSHOT_HISTORY_TIER_COUNT) ? s_tier_period_s[tier] : 0U;
+}
+
+size_t snapshot_history_tier_capacity(snapshot_history_tier_t tier)
+{
+    return ((uint32_t)tier < SNAPSHOT_HISTORY_TIER_COUNT) ? s_tier_capacity[tier] : 0U;
+}
+
+const char *snapshot_history_metric_name(snapshot_history_metric_t metric)
+{
+    return ((uint32_t)metric < SNAPSHOT_HISTORY_METRIC_COUNT) ? s_metric_names[metric] : "unknown";
+}
+
+const char *snapshot_history_tier_name(snapshot_history_tier_t tier)
+{
+    return ((uint32_t)tier < SNAPSHOT_HISTORY_TIER_COUNT) ? s_tier_names[tier] : "unknown";
+}
+
+bool snapshot_history_metric_from_name(const char *name, snapshot_history_metric_t *out_metric)
+{
+    if (name == NULL || out_metric == NULL) {
+        return false;
+    }
+
+    for (uint32_t m = 0; m < SNAPSHOT_HISTORY_METRIC_COUNT; ++m) {
+        if (strcmp(name, s_metric_names[m]) == 0) {
+            *out_metric = (snapshot_history_metric_t)m;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool snapshot_history_tier_from_name(const char *name, snapshot_history_tier_t *out_tier)
+{
+    if (name == NULL || out_tier == NULL) {
+        return false;
+    }
+
+    for (uint32_t t = 0; t < SNAPSHOT_HISTORY_TIER_COUNT; ++t) {
+        if (strcmp(name, s_tier_names[t]) == 0) {
+            *out_tier = (snapshot_history_tier_t)t;
+            return true;
+        }
+    }
+    return false;
+}
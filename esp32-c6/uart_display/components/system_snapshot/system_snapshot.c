@@ -3,9 +3,23 @@
  *
  * Owns the system snapshot used by REST handlers and other consumers.
  * Producers update this snapshot; consumers read it lock-free.
+ *
+ * The snapshot is split into groups that are always written together (time,
+ * temperature, metrics, wifi link). Each group is a sequence latch: two copies plus a
+ * sequence counter. A writer bumps the counter to odd, rewrites copy 0, bumps
+ * it to even, rewrites copy 1; readers copy the side selected by the counter's
+ * low bit (the one not being written) and retry only if the counter moved
+ * meanwhile. Readers never mask interrupts or wait on a preempted writer.
+ *
+ * Writes that leave a group unchanged are dropped before touching the latch.
+ * Otherwise the changed fields get a new generation (per-field and global)
+ * and are OR-ed into the dirty mask of every interested subscriber; only the
+ * subscriber's first dirty bit triggers its callback/queue, later changes
+ * just accumulate until system_snapshot_take_changes() clears them.
  */
 
 #include "system_snapshot.h"
+#include "snapshot_history.h"
 
 #include "esp_log.h"
 #include "esp_timer.h"
@@ -13,18 +27,172 @@
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdatomic.h>
 #include <string.h>
 
 static const char *TAG = "SYSTEM_SNAPSHOT";
 
-static system_snapshot_t s_snapshot;
-static portMUX_TYPE s_snapshot_mux = portMUX_INITIALIZER_UNLOCKED;
-static TaskHandle_t s_metrics_task_handle = NULL;
-static system_snapshot_metrics_task_config_t s_metrics_task_config;
+_Static_assert(SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS == SNAPSHOT_HISTORY_2S_PERIOD_S * 1000U,
+               "one metrics sample per finest history bucket");
+
+#define SNAPSHOT_LATCH_MAX_WORDS 10U
+
+typedef struct {
+    int64_t epoch_seconds;
+    char iso8601[SYSTEM_SNAPSHOT_ISO8601_LEN];
+} snapshot_time_t;
+
+typedef struct {
+    float temperature_c;
+} snapshot_temperature_t;
+
+typedef struct {
+    uint32_t uptime_ms;
+    uint32_t free_heap_bytes;
+    int8_t wifi_rssi_dbm;
+    bool wifi_connected;
+} snapshot_metrics_t;
+
+typedef struct {
+    atomic_uint_least32_t seq;
+    atomic_uint_least32_t writer; /* serialises writers of the same group */
+    atomic_uint_least32_t words[2][SNAPSHOT_LATCH_MAX_WORDS];
+} snapshot_latch_t;
+
+typedef struct {
+    atomic_uint_least32_t fields;  /* 0 while the slot is free */
+    atomic_uint_least32_t pending; /* dirty bits not yet taken */
+    system_snapshot_notify_cb_t callback;
+    void *ctx;
+    QueueHandle_t queue;
+} snapshot_subscriber_t;
+
+_Static_assert(sizeof(snapshot_time_t) <= SNAPSHOT_LATCH_MAX_WORDS * sizeof(uint32_t), "time group too large");
+_Static_assert(sizeof(snapshot_metrics_t) <= SNAPSHOT_LATCH_MAX_WORDS * sizeof(uint32_t), "metrics group too large");
+_Static_assert(sizeof(system_snapshot_wifi_link_t) <= SNAPSHOT_LATCH_MAX_WORDS * sizeof(uint32_t), "wifi link group too large");
+
+static snapshot_latch_t s_time_latch;
+static snapshot_latch_t s_temperature_latch;
+static snapshot_latch_t s_metrics_latch;
+static snapshot_latch_t s_wifi_link_latch;
+static atomic_uint_least32_t s_generation;
+static atomic_uint_least32_t s_field_generation[SYSTEM_SNAPSHOT_FIELD_COUNT];
+static atomic_uint_least32_t s_publish_lock;
+static atomic_uint_least32_t s_subscribe_lock;
+static snapshot_subscriber_t s_subscribers[SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS];
+
+/*
+ * Writer-side flags (same-group writers, publish, subscribe) are held for a
+ * few instructions by tasks; if the holder is preempted, give it a tick
+ * rather than spinning on it.
+ */
+static void snapshot_writer_lock(atomic_uint_least32_t *lock)
+{
+    uint_least32_t expected = 0U;
+    while (!atomic_compare_exchange_weak_explicit(lock, &expected, 1U,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+        expected = 0U;
+        vTaskDelay(1);
+    }
+}
+
+static void snapshot_writer_unlock(atomic_uint_least32_t *lock)
+{
+    atomic_store_explicit(lock, 0U, memory_order_release);
+}
+
+/* Returns false (latch untouched) if src equals the current value; old gets the previous value. */
+static bool snapshot_latch_write(snapshot_latch_t *latch, const void *src, void *old, size_t size)
+{
+    uint32_t words[SNAPSHOT_LATCH_MAX_WORDS] = {0};
+    uint32_t old_words[SNAPSHOT_LATCH_MAX_WORDS];
+    const size_t count = (size + sizeof(uint32_t) - 1U) / sizeof(uint32_t);
+    memcpy(words, src, size);
+
+    snapshot_writer_lock(&latch->writer);
+
+    /* Both copies are equal and stable while we hold the writer flag. */
+    for (size_t i = 0; i < count; ++i) {
+        old_words[i] = atomic_load_explicit(&latch->words[0][i], memory_order_relaxed);
+    }
+    memcpy(old, old_words, size);
+    if (memcmp(old_words, words, count * sizeof(uint32_t)) == 0) {
+        snapshot_writer_unlock(&latch->writer);
+        return false;
+    }
+
+    uint_least32_t seq = atomic_load_explicit(&latch->seq, memory_order_relaxed);
+    for (size_t copy = 0; copy < 2U; ++copy) {
+        /* Odd: readers move to copy 1 while copy 0 changes; even: back to copy 0. */
+        atomic_store_explicit(&latch->seq, ++seq, memory_order_release);
+        atomic_thread_fence(memory_order_release);
+        for (size_t i = 0; i < count; ++i) {
+            atomic_store_explicit(&latch->words[copy][i], words[i], memory_order_relaxed);
+        }
+    }
+
+    snapshot_writer_unlock(&latch->writer);
+    return true;
+}
+
+static void snapshot_latch_read(snapshot_latch_t *latch, void *dst, size_t size)
+{
+    uint32_t words[SNAPSHOT_LATCH_MAX_WORDS];
+    const size_t count = (size + sizeof(uint32_t) - 1U) / sizeof(uint32_t);
+    uint_least32_t seq;
+
+    do {
+        seq = atomic_load_explicit(&latch->seq, memory_order_acquire);
+        const size_t copy = seq & 1U;
+        for (size_t i = 0; i < count; ++i) {
+            words[i] = atomic_load_explicit(&latch->words[copy][i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while (atomic_load_explicit(&latch->seq, memory_order_relaxed) != seq);
+
+    memcpy(dst, words, size);
+}
+
+static void snapshot_publish(uint32_t changed)
+{
+    if (changed == 0U) {
+        return;
+    }
+
+    /*
+     * Field generations are stored before the global one is released, so a
+     * reader that loaded generation G sees every field change up to G.
+     */
+    snapshot_writer_lock(&s_publish_lock);
+    const uint_least32_t generation = atomic_load_explicit(&s_generation, memory_order_relaxed) + 1U;
+    for (uint32_t i = 0; i < SYSTEM_SNAPSHOT_FIELD_COUNT; ++i) {
+        if ((changed & (1U << i)) != 0U) {
+            atomic_store_explicit(&s_field_generation[i], generation, memory_order_release);
+        }
+    }
+    atomic_store_explicit(&s_generation, generation, memory_order_release);
+    snapshot_writer_unlock(&s_publish_lock);
 
-#define SYSTEM_SNAPSHOT_METRICS_STACK_SIZE 3072U
-#define SYSTEM_SNAPSHOT_METRICS_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
-#define SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS 2000U
+    for (uint32_t i = 0; i < SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS; ++i) {
+        snapshot_subscriber_t *sub = &s_subscribers[i];
+        const uint32_t interest = atomic_load_explicit(&sub->fields, memory_order_acquire) & changed;
+        if (interest == 0U) {
+            continue;
+        }
+
+        const uint32_t was_pending = atomic_fetch_or_explicit(&sub->pending, interest, memory_order_acq_rel);
+        if (was_pending != 0U) {
+            continue; /* already woken; the consumer will take these too */
+        }
+
+        if (sub->callback != NULL) {
+            sub->callback(interest, sub->ctx);
+        }
+        if (sub->queue != NULL) {
+            (void)xQueueSend(sub->queue, &interest, 0);
+        }
+    }
+}
 
 static void system_snapshot_copy_default_iso(char *dest, size_t len)
 {
@@ -33,15 +201,22 @@ static void system_snapshot_copy_default_iso(char *dest, size_t len)
 
 void system_snapshot_init(void)
 {
-    portENTER_CRITICAL(&s_snapshot_mux);
-    s_snapshot.epoch_seconds = 0;
-    system_snapshot_copy_default_iso(s_snapshot.iso8601, sizeof(s_snapshot.iso8601));
-    s_snapshot.temperature_c = 0.0f;
-    s_snapshot.uptime_ms = 0U;
-    s_snapshot.free_heap_bytes = 0U;
-    s_snapshot.wifi_rssi_dbm = SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID;
-    s_snapshot.wifi_connected = false;
-    portEXIT_CRITICAL(&s_snapshot_mux);
+    snapshot_time_t time_group = { .epoch_seconds = 0 };
+    snapshot_time_t old_time;
+    system_snapshot_copy_default_iso(time_group.iso8601, sizeof(time_group.iso8601));
+    (void)snapshot_latch_write(&s_time_latch, &time_group, &old_time, sizeof(time_group));
+
+    system_snapshot_update_temperature(0.0f);
+    system_snapshot_update_metrics(0U, 0U, SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID, false);
+    const system_snapshot_wifi_link_t wifi_link = { 0 };
+    system_snapshot_update_wifi_link(&wifi_link);
+
+    /* Initial values count as a change so every field has a generation. */
+    snapshot_publish(SYSTEM_SNAPSHOT_FIELD_ALL);
+
+    if (!snapshot_history_init()) {
+        ESP_LOGE(TAG, "History init failed");
+    }
 }
 
 void system_snapshot_update_time(int64_t epoch_seconds, const char *iso8601)
@@ -50,17 +225,22 @@ void system_snapshot_update_time(int64_t epoch_seconds, const char *iso8601)
         return;
     }
 
-    portENTER_CRITICAL(&s_snapshot_mux);
-    s_snapshot.epoch_seconds = epoch_seconds;
-    (void)strlcpy(s_snapshot.iso8601, iso8601, sizeof(s_snapshot.iso8601));
-    portEXIT_CRITICAL(&s_snapshot_mux);
+    snapshot_time_t time_group = { .epoch_seconds = epoch_seconds };
+    snapshot_time_t old_time;
+    (void)strlcpy(time_group.iso8601, iso8601, sizeof(time_group.iso8601));
+    if (snapshot_latch_write(&s_time_latch, &time_group, &old_time, sizeof(time_group))) {
+        snapshot_publish(SYSTEM_SNAPSHOT_FIELD_TIME);
+    }
 }
 
 void system_snapshot_update_temperature(float temperature_c)
 {
-    portENTER_CRITICAL(&s_snapshot_mux);
-    s_snapshot.temperature_c = temperature_c;
-    portEXIT_CRITICAL(&s_snapshot_mux);
+    const snapshot_temperature_t temperature_group = { .temperature_c = temperature_c };
+    snapshot_temperature_t old_temperature;
+    if (snapshot_latch_write(&s_temperature_latch, &temperature_group, &old_temperature,
+                             sizeof(temperature_group))) {
+        snapshot_publish(SYSTEM_SNAPSHOT_FIELD_TEMPERATURE);
+    }
 }
 
 void system_snapshot_update_metrics(uint32_t uptime_ms,
@@ -68,12 +248,54 @@ void system_snapshot_update_metrics(uint32_t uptime_ms,
                                     int8_t wifi_rssi_dbm,
                                     bool wifi_connected)
 {
-    portENTER_CRITICAL(&s_snapshot_mux);
-    s_snapshot.uptime_ms = uptime_ms;
-    s_snapshot.free_heap_bytes = free_heap_bytes;
-    s_snapshot.wifi_rssi_dbm = wifi_rssi_dbm;
-    s_snapshot.wifi_connected = wifi_connected;
-    portEXIT_CRITICAL(&s_snapshot_mux);
+    const snapshot_metrics_t metrics_group = {
+        .uptime_ms = uptime_ms,
+        .free_heap_bytes = free_heap_bytes,
+        .wifi_rssi_dbm = wifi_rssi_dbm,
+        .wifi_connected = wifi_connected,
+    };
+    snapshot_metrics_t old;
+    if (!snapshot_latch_write(&s_metrics_latch, &metrics_group, &old, sizeof(metrics_group))) {
+        return;
+    }
+
+    uint32_t changed = 0U;
+    if (old.uptime_ms != uptime_ms) {
+        changed |= SYSTEM_SNAPSHOT_FIELD_UPTIME;
+    }
+    if (old.free_heap_bytes != free_heap_bytes) {
+        changed |= SYSTEM_SNAPSHOT_FIELD_FREE_HEAP;
+    }
+    if (old.wifi_rssi_dbm != wifi_rssi_dbm) {
+        changed |= SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI;
+    }
+    if (old.wifi_connected != wifi_connected) {
+        changed |= SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED;
+    }
+    snapshot_publish(changed);
+}
+
+void system_snapshot_update_wifi_link(const system_snapshot_wifi_link_t *link)
+{
+    if (link == NULL) {
+        return;
+    }
+
+    /* Copied into a zeroed group so padding never makes equal values differ. */
+    system_snapshot_wifi_link_t link_group;
+    memset(&link_group, 0, sizeof(link_group));
+    link_group.disconnects = link->disconnects;
+    link_group.reconnects = link->reconnects;
+    link_group.last_reconnect_ms = link->last_reconnect_ms;
+    link_group.avg_reconnect_ms = link->avg_reconnect_ms;
+    link_group.max_reconnect_ms = link->max_reconnect_ms;
+    link_group.attempts = link->attempts;
+    link_group.last_reason = link->last_reason;
+
+    system_snapshot_wifi_link_t old_link;
+    if (snapshot_latch_write(&s_wifi_link_latch, &link_group, &old_link, sizeof(link_group))) {
+        snapshot_publish(SYSTEM_SNAPSHOT_FIELD_WIFI_LINK);
+    }
 }
 
 void system_snapshot_read(system_snapshot_t *out_snapshot)
@@ -82,81 +304,207 @@ void system_snapshot_read(system_snapshot_t *out_snapshot)
         return;
     }
 
-    portENTER_CRITICAL(&s_snapshot_mux);
-    memcpy(out_snapshot, &s_snapshot, sizeof(*out_snapshot));
-    portEXIT_CRITICAL(&s_snapshot_mux);
+    /* Loaded first: the values read below are at least this new. */
+    out_snapshot->generation = atomic_load_explicit(&s_generation, memory_order_acquire);
+
+    snapshot_time_t time_group;
+    snapshot_temperature_t temperature_group;
+    snapshot_metrics_t metrics_group;
+
+    snapshot_latch_read(&s_time_latch, &time_group, sizeof(time_group));
+    snapshot_latch_read(&s_temperature_latch, &temperature_group, sizeof(temperature_group));
+    snapshot_latch_read(&s_metrics_latch, &metrics_group, sizeof(metrics_group));
+    snapshot_latch_read(&s_wifi_link_latch, &out_snapshot->wifi_link, sizeof(out_snapshot->wifi_link));
+
+    out_snapshot->epoch_seconds = time_group.epoch_seconds;
+    memcpy(out_snapshot->iso8601, time_group.iso8601, sizeof(out_snapshot->iso8601));
+    out_snapshot->temperature_c = temperature_group.temperature_c;
+    out_snapshot->uptime_ms = metrics_group.uptime_ms;
+    out_snapshot->free_heap_bytes = metrics_group.free_heap_bytes;
+    out_snapshot->wifi_rssi_dbm = metrics_group.wifi_rssi_dbm;
+    out_snapshot->wifi_connected = metrics_group.wifi_connected;
 }
 
-void system_snapshot_metrics_task_get_default_config(system_snapshot_metrics_task_config_t *config)
+uint32_t system_snapshot_generation(void)
 {
-    if (config == NULL) {
-        return;
+    return atomic_load_explicit(&s_generation, memory_order_acquire);
+}
+
+uint32_t system_snapshot_fields_generation(uint32_t fields)
+{
+    uint32_t newest = 0U;
+    for (uint32_t i = 0; i < SYSTEM_SNAPSHOT_FIELD_COUNT; ++i) {
+        if ((fields & (1U << i)) == 0U) {
+            continue;
+        }
+        /* Acquire: a read after this sees at least this field's value. */
+        const uint32_t field_generation = atomic_load_explicit(&s_field_generation[i], memory_order_acquire);
+        if ((int32_t)(field_generation - newest) > 0) {
+            newest = field_generation;
+        }
     }
+    return newest;
+}
+
+static void snapshot_fill_delta(uint32_t changed, system_snapshot_delta_t *out_delta)
+{
+    system_snapshot_t current;
+    system_snapshot_read(&current);
 
-    config->interval_ms = SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS;
-    config->stack_size = SYSTEM_SNAPSHOT_METRICS_STACK_SIZE;
-    config->task_priority = SYSTEM_SNAPSHOT_METRICS_TASK_PRIORITY;
-    config->core_id = tskNO_AFFINITY;
+    memset(out_delta, 0, sizeof(*out_delta));
+    out_delta->generation = current.generation;
+    out_delta->changed = changed;
+    out_delta->values.generation = current.generation;
+
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_TIME) != 0U) {
+        out_delta->values.epoch_seconds = current.epoch_seconds;
+        memcpy(out_delta->values.iso8601, current.iso8601, sizeof(current.iso8601));
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_TEMPERATURE) != 0U) {
+        out_delta->values.temperature_c = current.temperature_c;
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_UPTIME) != 0U) {
+        out_delta->values.uptime_ms = current.uptime_ms;
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_FREE_HEAP) != 0U) {
+        out_delta->values.free_heap_bytes = current.free_heap_bytes;
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI) != 0U) {
+        out_delta->values.wifi_rssi_dbm = current.wifi_rssi_dbm;
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED) != 0U) {
+        out_delta->values.wifi_connected = current.wifi_connected;
+    }
+    if ((changed & SYSTEM_SNAPSHOT_FIELD_WIFI_LINK) != 0U) {
+        out_delta->values.wifi_link = current.wifi_link;
+    }
 }
 
-static void system_snapshot_metrics_task(void *arg)
+uint32_t system_snapshot_read_since(uint32_t since_generation, system_snapshot_delta_t *out_delta)
 {
-    const system_snapshot_metrics_task_config_t *config = (const system_snapshot_metrics_task_config_t *)arg;
-    const TickType_t delay_ticks = pdMS_TO_TICKS(config->interval_ms);
+    if (out_delta == NULL) {
+        return 0U;
+    }
+
+    const uint_least32_t generation = atomic_load_explicit(&s_generation, memory_order_acquire);
+    uint32_t changed = 0U;
+    for (uint32_t i = 0; i < SYSTEM_SNAPSHOT_FIELD_COUNT; ++i) {
+        const uint_least32_t field_generation = atomic_load_explicit(&s_field_generation[i], memory_order_acquire);
+        if (since_generation == 0U || (int32_t)(field_generation - since_generation) > 0) {
+            changed |= 1U << i;
+        }
+    }
 
-    while (1) {
-        uint32_t uptime_ms = (uint32_t)(esp_timer_get_time() / 1000);
-        uint32_t free_heap = esp_get_free_heap_size();
-        int8_t rssi = SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID;
-        bool connected = false;
+    snapshot_fill_delta(changed, out_delta);
+    /*
+     * Report the generation loaded before the field scan: a change published
+     * after it may be missing from `changed`, so the next call must include it.
+     */
+    out_delta->generation = generation;
+    return changed;
+}
 
-        wifi_ap_record_t ap_info;
-        if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
-            rssi = (int8_t)ap_info.rssi;
-            connected = true;
+static bool snapshot_subscribe(uint32_t fields,
+                               system_snapshot_notify_cb_t callback,
+                               void *ctx,
+                               QueueHandle_t queue,
+                               system_snapshot_subscriber_id_t *out_id)
+{
+    fields &= SYSTEM_SNAPSHOT_FIELD_ALL;
+    if (fields == 0U) {
+        return false;
+    }
+
+    bool ok = false;
+    snapshot_writer_lock(&s_subscribe_lock);
+    for (uint32_t i = 0; i < SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS; ++i) {
+        snapshot_subscriber_t *sub = &s_subscribers[i];
+        if (atomic_load_explicit(&sub->fields, memory_order_relaxed) != 0U) {
+            continue;
         }
 
-        system_snapshot_update_metrics(uptime_ms, free_heap, rssi, connected);
-        vTaskDelay(delay_ticks);
+        sub->callback = callback;
+        sub->ctx = ctx;
+        sub->queue = queue;
+        atomic_store_explicit(&sub->pending, 0U, memory_order_relaxed);
+        /* Publishes callback/ctx/queue to producers (acquire in snapshot_publish). */
+        atomic_store_explicit(&sub->fields, fields, memory_order_release);
+        if (out_id != NULL) {
+            *out_id = (system_snapshot_subscriber_id_t)i;
+        }
+        ok = true;
+        break;
     }
+    snapshot_writer_unlock(&s_subscribe_lock);
+
+    if (!ok) {
+        ESP_LOGW(TAG, "No free subscriber slot");
+    }
+    return ok;
+}
+
+bool system_snapshot_subscribe(uint32_t fields,
+                               system_snapshot_notify_cb_t callback,
+                               void *ctx,
+                               system_snapshot_subscriber_id_t *out_id)
+{
+    return snapshot_subscribe(fields, callback, ctx, NULL, out_id);
 }
 
-bool system_snapshot_start_metrics_task(const system_snapshot_metrics_task_config_t *config)
+bool system_snapshot_subscribe_queue(uint32_t fields,
+                                     QueueHandle_t queue,
+                                     system_snapshot_subscriber_id_t *out_id)
 {
-    if (config == NULL) {
+    if (queue == NULL) {
         return false;
     }
+    return snapshot_subscribe(fields, NULL, NULL, queue, out_id);
+}
 
-    if (s_metrics_task_handle != NULL) {
-        return true;
+void system_snapshot_unsubscribe(system_snapshot_subscriber_id_t id)
+{
+    if (id < 0 || id >= (system_snapshot_subscriber_id_t)SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS) {
+        return;
     }
 
-    s_metrics_task_config = *config;
+    snapshot_writer_lock(&s_subscribe_lock);
+    atomic_store_explicit(&s_subscribers[id].fields, 0U, memory_order_release);
+    snapshot_writer_unlock(&s_subscribe_lock);
+}
 
-    BaseType_t ret;
-    if (s_metrics_task_config.core_id == tskNO_AFFINITY) {
-        ret = xTaskCreate(system_snapshot_metrics_task,
-                          "snapshot_metrics",
-                          s_metrics_task_config.stack_size,
-                          (void *)&s_metrics_task_config,
-                          s_metrics_task_config.task_priority,
-                          &s_metrics_task_handle);
-    } else {
-        ret = xTaskCreatePinnedToCore(system_snapshot_metrics_task,
-                                      "snapshot_metrics",
-                                      s_metrics_task_config.stack_size,
-                                      (void *)&s_metrics_task_config,
-                                      s_metrics_task_config.task_priority,
-                                      &s_metrics_task_handle,
-                                      s_metrics_task_config.core_id);
+uint32_t system_snapshot_take_changes(system_snapshot_subscriber_id_t id, system_snapshot_delta_t *out_delta)
+{
+    if (out_delta == NULL || id < 0 || id >= (system_snapshot_subscriber_id_t)SYSTEM_SNAPSHOT_MAX_SUBSCRIBERS) {
+        return 0U;
     }
 
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to start metrics task");
-        s_metrics_task_handle = NULL;
-        return false;
+    /* Cleared before reading, so a change racing with us re-arms the wake-up. */
+    const uint32_t changed = atomic_exchange_explicit(&s_subscribers[id].pending, 0U, memory_order_acq_rel);
+    if (changed == 0U) {
+        memset(out_delta, 0, sizeof(*out_delta));
+        return 0U;
     }
 
-    ESP_LOGI(TAG, "Metrics task started");
-    return true;
+    snapshot_fill_delta(changed, out_delta);
+    return changed;
+}
+
+void system_snapshot_sample_metrics(void)
+{
+    uint32_t uptime_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    uint32_t free_heap = esp_get_free_heap_size();
+    int8_t rssi = SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID;
+    bool connected = false;
+
+    wifi_ap_record_t ap_info;
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+        rssi = (int8_t)ap_info.rssi;
+        connected = true;
+    }
+
+    system_snapshot_update_metrics(uptime_ms, free_heap, rssi, connected);
+    snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, uptime_ms / 1000U, (int32_t)free_heap);
+    if (connected) {
+        snapshot_history_record_at(SNAPSHOT_HISTORY_WIFI_RSSI, uptime_ms / 1000U, rssi);
+    }
 }
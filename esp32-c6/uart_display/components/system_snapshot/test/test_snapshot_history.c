@@ -0,0 +1,54 @@
+#include "snapshot_history.h"
+
+#include "unity.h"
+
+#include <stdint.h>
+
+TEST_CASE("snapshot_history tiers downsample min/max/avg", "[system_snapshot][history]")
+{
+    snapshot_history_point_t points[SNAPSHOT_HISTORY_MAX_POINTS];
+    uint32_t newest_s = 0U;
+
+    TEST_ASSERT_TRUE(snapshot_history_init());
+
+    /* Two samples in the 10 s bucket, one at 12, nothing at 14..17, one at 18. */
+    snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, 10U, 100);
+    snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, 11U, 200);
+    snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, 12U, 50);
+    snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, 18U, 80);
+
+    size_t count = snapshot_history_read(SNAPSHOT_HISTORY_FREE_HEAP, SNAPSHOT_HISTORY_TIER_2S,
+                                         points, SNAPSHOT_HISTORY_MAX_POINTS, &newest_s);
+    TEST_ASSERT_EQUAL(5, count);
+    TEST_ASSERT_EQUAL_UINT32(18U, newest_s);
+    TEST_ASSERT_EQUAL_INT32(100, points[0].min);
+    TEST_ASSERT_EQUAL_INT32(200, points[0].max);
+    TEST_ASSERT_EQUAL_INT32(150, points[0].avg);
+    TEST_ASSERT_EQUAL_INT32(50, points[1].avg);
+    TEST_ASSERT_TRUE(SNAPSHOT_HISTORY_POINT_EMPTY(&points[2]));
+    TEST_ASSERT_TRUE(SNAPSHOT_HISTORY_POINT_EMPTY(&points[3]));
+    TEST_ASSERT_EQUAL_INT32(80, points[4].avg); /* open bucket */
+
+    /* The minute tier still has everything in one open bucket. */
+    count = snapshot_history_read(SNAPSHOT_HISTORY_FREE_HEAP, SNAPSHOT_HISTORY_TIER_1M,
+                                  points, SNAPSHOT_HISTORY_MAX_POINTS, &newest_s);
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL_UINT32(0U, newest_s);
+    TEST_ASSERT_EQUAL_INT32(50, points[0].min);
+    TEST_ASSERT_EQUAL_INT32(200, points[0].max);
+    TEST_ASSERT_EQUAL_INT32(107, points[0].avg);
+
+    /* Overflowing the 2 s ring keeps the newest buckets, oldest first. */
+    for (uint32_t t = 100U; t < 100U + 4U * SNAPSHOT_HISTORY_2S_POINTS; t += SNAPSHOT_HISTORY_2S_PERIOD_S) {
+        snapshot_history_record_at(SNAPSHOT_HISTORY_FREE_HEAP, t, (int32_t)t);
+    }
+    count = snapshot_history_read(SNAPSHOT_HISTORY_FREE_HEAP, SNAPSHOT_HISTORY_TIER_2S,
+                                  points, SNAPSHOT_HISTORY_MAX_POINTS, &newest_s);
+    TEST_ASSERT_EQUAL(SNAPSHOT_HISTORY_2S_POINTS, count);
+    TEST_ASSERT_EQUAL_INT32(100 + 2 * SNAPSHOT_HISTORY_2S_POINTS, points[0].avg);
+    TEST_ASSERT_EQUAL_INT32(newest_s, points[count - 1U].avg);
+
+    /* Other metrics are independent. */
+    TEST_ASSERT_EQUAL(0, snapshot_history_read(SNAPSHOT_HISTORY_WIFI_RSSI, SNAPSHOT_HISTORY_TIER_2S,
+                                               points, SNAPSHOT_HISTORY_MAX_POINTS, NULL));
+}
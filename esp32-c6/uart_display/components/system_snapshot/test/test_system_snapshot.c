@@ -1,7 +1,14 @@
 #include "system_snapshot.h"
 
+#include "esp_timer.h"
 #include "unity.h"
 
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
 TEST_CASE("system_snapshot roundtrip", "[system_snapshot]")
 {
     system_snapshot_t snapshot;
@@ -10,6 +17,11 @@ TEST_CASE("system_snapshot roundtrip", "[system_snapshot]")
     system_snapshot_update_time(1726000000, "2024-09-11T08:12:00Z");
     system_snapshot_update_temperature(23.5f);
     system_snapshot_update_metrics(1234U, 5678U, -42, true);
+    const system_snapshot_wifi_link_t link = {
+        .disconnects = 3U, .reconnects = 2U, .last_reconnect_ms = 850U, .avg_reconnect_ms = 1200U,
+        .max_reconnect_ms = 1550U, .attempts = 6U, .last_reason = 8U,
+    };
+    system_snapshot_update_wifi_link(&link);
 
     system_snapshot_read(&snapshot);
 
@@ -20,4 +32,147 @@ TEST_CASE("system_snapshot roundtrip", "[system_snapshot]")
     TEST_ASSERT_EQUAL_UINT32(5678U, snapshot.free_heap_bytes);
     TEST_ASSERT_EQUAL_INT8(-42, snapshot.wifi_rssi_dbm);
     TEST_ASSERT_TRUE(snapshot.wifi_connected);
+    TEST_ASSERT_EQUAL_UINT32(2U, snapshot.wifi_link.reconnects);
+    TEST_ASSERT_EQUAL_UINT32(850U, snapshot.wifi_link.last_reconnect_ms);
+    TEST_ASSERT_EQUAL_UINT32(1550U, snapshot.wifi_link.max_reconnect_ms);
+    TEST_ASSERT_EQUAL_UINT8(8U, snapshot.wifi_link.last_reason);
+}
+
+static uint32_t s_notified_fields;
+static uint32_t s_notify_count;
+
+static void count_notify_cb(uint32_t changed_fields, void *ctx)
+{
+    (void)ctx;
+    s_notified_fields |= changed_fields;
+    s_notify_count++;
+}
+
+TEST_CASE("system_snapshot subscribers get only changed fields", "[system_snapshot]")
+{
+    system_snapshot_subscriber_id_t id;
+    system_snapshot_delta_t delta;
+
+    system_snapshot_init();
+    system_snapshot_update_metrics(100U, 5000U, -50, true);
+    s_notified_fields = 0U;
+    s_notify_count = 0U;
+    TEST_ASSERT_TRUE(system_snapshot_subscribe(SYSTEM_SNAPSHOT_FIELD_TEMPERATURE | SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI,
+                                               count_notify_cb, NULL, &id));
+
+    /* Outside the mask, or unchanged: no wake-up. */
+    const uint32_t generation = system_snapshot_generation();
+    system_snapshot_update_time(1726000001, "2024-09-11T08:12:01Z");
+    system_snapshot_update_metrics(100U, 5000U, -50, true);
+    TEST_ASSERT_EQUAL_UINT32(0U, s_notify_count);
+    TEST_ASSERT_EQUAL_UINT32(0U, system_snapshot_take_changes(id, &delta));
+    TEST_ASSERT_EQUAL_UINT32(generation + 1U, system_snapshot_generation());
+
+    /* Two changes before the consumer runs: one wake-up, both fields. */
+    system_snapshot_update_temperature(30.5f);
+    system_snapshot_update_metrics(200U, 5000U, -61, true);
+    TEST_ASSERT_EQUAL_UINT32(1U, s_notify_count);
+    TEST_ASSERT_EQUAL_UINT32(SYSTEM_SNAPSHOT_FIELD_TEMPERATURE, s_notified_fields);
+
+    TEST_ASSERT_EQUAL_UINT32(SYSTEM_SNAPSHOT_FIELD_TEMPERATURE | SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI,
+                             system_snapshot_take_changes(id, &delta));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.5f, delta.values.temperature_c);
+    TEST_ASSERT_EQUAL_INT8(-61, delta.values.wifi_rssi_dbm);
+    TEST_ASSERT_EQUAL_UINT32(0U, delta.values.uptime_ms); /* changed, but not subscribed */
+    TEST_ASSERT_EQUAL_UINT32(0U, system_snapshot_take_changes(id, &delta));
+
+    /* read_since reports everything that moved after a generation. */
+    TEST_ASSERT_EQUAL_UINT32(SYSTEM_SNAPSHOT_FIELD_TIME | SYSTEM_SNAPSHOT_FIELD_TEMPERATURE |
+                             SYSTEM_SNAPSHOT_FIELD_UPTIME | SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI,
+                             system_snapshot_read_since(generation, &delta));
+    TEST_ASSERT_EQUAL_UINT32(0U, system_snapshot_read_since(delta.generation, &delta));
+
+    system_snapshot_unsubscribe(id);
+    system_snapshot_update_temperature(31.0f);
+    TEST_ASSERT_EQUAL_UINT32(1U, s_notify_count);
+}
+
+/* Time-bound so threads overlap across many scheduler slices, even on one core. */
+#define SNAPSHOT_STRESS_DURATION_US 500000
+#define SNAPSHOT_STRESS_READERS 3
+
+static atomic_int s_writers_finished;
+static int64_t s_stress_deadline_us;
+
+/* Every field in a group is derived from one counter so a mix is detectable. */
+static void *time_writer_thread(void *arg)
+{
+    const int64_t base = (int64_t)(intptr_t)arg;
+    char iso[SYSTEM_SNAPSHOT_ISO8601_LEN];
+
+    for (int64_t i = 0; esp_timer_get_time() < s_stress_deadline_us; ++i) {
+        const int64_t epoch = base + i;
+        (void)snprintf(iso, sizeof(iso), "T%lld", (long long)epoch);
+        system_snapshot_update_time(epoch, iso);
+    }
+
+    atomic_fetch_add(&s_writers_finished, 1);
+    return NULL;
+}
+
+static void *metrics_writer_thread(void *arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 0; esp_timer_get_time() < s_stress_deadline_us; ++i) {
+        system_snapshot_update_metrics(i, ~i, (int8_t)(i & 0x3FU), (i & 1U) != 0U);
+    }
+
+    atomic_fetch_add(&s_writers_finished, 1);
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    uint32_t *torn = (uint32_t *)arg;
+    system_snapshot_t snapshot;
+    char expected_iso[SYSTEM_SNAPSHOT_ISO8601_LEN];
+
+    while (atomic_load(&s_writers_finished) < 3) {
+        system_snapshot_read(&snapshot);
+
+        (void)snprintf(expected_iso, sizeof(expected_iso), "T%lld", (long long)snapshot.epoch_seconds);
+        if (strcmp(expected_iso, snapshot.iso8601) != 0 ||
+            snapshot.free_heap_bytes != ~snapshot.uptime_ms ||
+            snapshot.wifi_rssi_dbm != (int8_t)(snapshot.uptime_ms & 0x3FU) ||
+            snapshot.wifi_connected != ((snapshot.uptime_ms & 1U) != 0U)) {
+            (*torn)++;
+        }
+    }
+
+    return NULL;
+}
+
+TEST_CASE("system_snapshot concurrent readers never see torn groups", "[system_snapshot][stress]")
+{
+    pthread_t writers[3];
+    pthread_t readers[SNAPSHOT_STRESS_READERS];
+    uint32_t torn[SNAPSHOT_STRESS_READERS] = {0};
+
+    system_snapshot_update_time(0, "T0");
+    system_snapshot_update_metrics(0U, ~0U, 0, false);
+    atomic_store(&s_writers_finished, 0);
+    s_stress_deadline_us = esp_timer_get_time() + SNAPSHOT_STRESS_DURATION_US;
+
+    for (int i = 0; i < SNAPSHOT_STRESS_READERS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, reader_thread, &torn[i]));
+    }
+
+    /* Two time writers exercise same-group writer serialisation. */
+    TEST_ASSERT_EQUAL(0, pthread_create(&writers[0], NULL, time_writer_thread, (void *)(intptr_t)0));
+    TEST_ASSERT_EQUAL(0, pthread_create(&writers[1], NULL, time_writer_thread, (void *)(intptr_t)1000000));
+    TEST_ASSERT_EQUAL(0, pthread_create(&writers[2], NULL, metrics_writer_thread, NULL));
+
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_join(writers[i], NULL));
+    }
+    for (int i = 0; i < SNAPSHOT_STRESS_READERS; ++i) {
+        TEST_ASSERT_EQUAL(0, pthread_join(readers[i], NULL));
+        TEST_ASSERT_EQUAL_UINT32(0U, torn[i]);
+    }
 }
@@ -1,36 +1,315 @@
 #include "wifi_manager.h"
+#include "wifi_reconnect.h"
 
 #include <string.h>
 
-#include "esp_event.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_netif.h"
+#include "esp_random.h"
+#include "esp_timer.h"
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "nvs_flash.h"
+#include "sdkconfig.h"
+#include "system_snapshot.h"
+
+#ifdef CONFIG_WIFI_MANAGER_BACKOFF_BASE_MS
+#define WIFI_MANAGER_BACKOFF_BASE_MS CONFIG_WIFI_MANAGER_BACKOFF_BASE_MS
+#else
+#define WIFI_MANAGER_BACKOFF_BASE_MS 500
+#endif
+
+#ifdef CONFIG_WIFI_MANAGER_BACKOFF_MAX_MS
+#define WIFI_MANAGER_BACKOFF_MAX_MS CONFIG_WIFI_MANAGER_BACKOFF_MAX_MS
+#else
+#define WIFI_MANAGER_BACKOFF_MAX_MS 30000
+#endif
+
+#ifdef CONFIG_WIFI_MANAGER_FAST_ATTEMPTS
+#define WIFI_MANAGER_FAST_ATTEMPTS CONFIG_WIFI_MANAGER_FAST_ATTEMPTS
+#else
+#define WIFI_MANAGER_FAST_ATTEMPTS 2
+#endif
 
 #define WIFI_CONNECTED_BIT BIT0
 
+#define WIFI_SSID_LEN 32
+#define WIFI_PASS_LEN 64
+
+/* Private ids on WIFI_MANAGER_EVENT, so every transition runs on the event loop task. */
+#define WIFI_MANAGER_EVENT_CONNECT_REQUEST 100
+#define WIFI_MANAGER_EVENT_RETRY 101
+
+/* Delay before the retry timer re-posts a RETRY the full event queue refused. */
+#define WIFI_MANAGER_RETRY_REPOST_MS 100U
+
+ESP_EVENT_DEFINE_BASE(WIFI_MANAGER_EVENT);
+
+typedef struct {
+    char ssid[WIFI_SSID_LEN + 1];
+    char pass[WIFI_PASS_LEN + 1];
+} wifi_credentials_t;
+
 static const char *WIFI_MANAGER_TAG = "WiFi_Manager";
 static EventGroupHandle_t s_wifi_event_group = NULL;
 static bool s_wifi_started = false;
+static esp_timer_handle_t s_retry_timer = NULL;
 
-static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+static const wifi_backoff_t s_backoff = {
+    .base_ms = WIFI_MANAGER_BACKOFF_BASE_MS,
+    .max_ms = WIFI_MANAGER_BACKOFF_MAX_MS,
+};
+
+/* Event loop task only. */
+static wifi_credentials_t s_credentials;
+static bool s_have_credentials = false;
+static bool s_sta_started = false;
+static bool s_ap_cached = false;
+static uint8_t s_ap_bssid[6];
+static uint8_t s_ap_channel;
+static uint32_t s_failed_attempts;   /* since the link was last up */
+static int64_t s_down_since_us;      /* drop or connect request; start of the latency measure */
+static bool s_was_connected = false;
+static bool s_restart_pending = false; /* dropped on purpose for new credentials */
+static wifi_latency_stats_t s_reconnect_latency;
+
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static wifi_manager_stats_t s_stats;
+
+static void wifi_set_state(wifi_manager_state_t state)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.state = state;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+static void wifi_post_status(const wifi_status_event_t *status)
+{
+    (void)esp_event_post(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_STATUS, status, sizeof(*status), 0);
+}
+
+static void wifi_publish_link_stats(void)
+{
+    system_snapshot_wifi_link_t link;
+
+    portENTER_CRITICAL(&s_stats_lock);
+    link.disconnects = s_stats.disconnects;
+    link.reconnects = s_stats.reconnects;
+    link.last_reconnect_ms = s_stats.last_reconnect_ms;
+    link.avg_reconnect_ms = s_stats.avg_reconnect_ms;
+    link.max_reconnect_ms = s_stats.max_reconnect_ms;
+    link.attempts = s_stats.attempts;
+    link.last_reason = s_stats.last_reason;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    system_snapshot_update_wifi_link(&link);
+}
+
+static void wifi_schedule_retry(uint8_t reason);
+
+static void wifi_start_attempt(void)
+{
+    wifi_config_t wifi_config;
+    memset(&wifi_config, 0, sizeof(wifi_config));
+    strlcpy((char *)wifi_config.sta.ssid, s_credentials.ssid, sizeof(wifi_config.sta.ssid));
+    strlcpy((char *)wifi_config.sta.password, s_credentials.pass, sizeof(wifi_config.sta.password));
+    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+
+    /* The first attempts after a drop skip the scan: same AP, same channel. */
+    const bool fast = s_ap_cached && s_failed_attempts < WIFI_MANAGER_FAST_ATTEMPTS;
+    if (fast) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, s_ap_bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = s_ap_channel;
+    }
+
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_connect();
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.attempts++;
+    if (fast) {
+        s_stats.fast_attempts++;
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(WIFI_MANAGER_TAG, "wifi connect failed: %s", esp_err_to_name(ret));
+        s_failed_attempts++;
+        wifi_schedule_retry(WIFI_REASON_UNSPECIFIED);
+        return;
+    }
+
+    wifi_set_state(WIFI_MANAGER_STATE_CONNECTING);
+    const wifi_status_event_t status = {
+        .status = WIFI_STATUS_CONNECTING,
+        .fast = fast,
+        .attempt = (uint16_t)(s_failed_attempts + 1U),
+    };
+    wifi_post_status(&status);
+}
+
+static void wifi_schedule_retry(uint8_t reason)
+{
+    const uint32_t delay_ms = wifi_backoff_delay_ms(&s_backoff, s_failed_attempts, esp_random());
+
+    const wifi_status_event_t status = {
+        .status = WIFI_STATUS_DISCONNECTED,
+        .reason = reason,
+        .attempt = (uint16_t)s_failed_attempts,
+        .retry_in_ms = delay_ms,
+    };
+    wifi_post_status(&status);
+
+    if (delay_ms == 0U) {
+        wifi_start_attempt();
+        return;
+    }
+    wifi_set_state(WIFI_MANAGER_STATE_BACKOFF);
+    (void)esp_timer_stop(s_retry_timer);
+    if (esp_timer_start_once(s_retry_timer, (uint64_t)delay_ms * 1000U) != ESP_OK) {
+        wifi_start_attempt();
+    }
+}
+
+static void wifi_retry_timer_cb(void *arg)
 {
     (void)arg;
-    (void)event_data;
+    /* Hand the attempt to the event loop task, which owns the state. Never
+     * block the esp_timer task: if the queue is full, try again shortly,
+     * otherwise BACKOFF would have no timer left to leave it. */
+    if (esp_event_post(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_RETRY, NULL, 0, 0) != ESP_OK) {
+        (void)esp_timer_start_once(s_retry_timer, (uint64_t)WIFI_MANAGER_RETRY_REPOST_MS * 1000U);
+    }
+}
+
+static void wifi_on_disconnected(const wifi_event_sta_disconnected_t *event)
+{
+    const uint8_t reason = (event != NULL) ? event->reason : WIFI_REASON_UNSPECIFIED;
+
+    xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+    portENTER_CRITICAL(&s_stats_lock);
+    const bool was_up = (s_stats.state == WIFI_MANAGER_STATE_CONNECTED);
+    s_stats.last_reason = reason;
+    if (was_up) {
+        s_stats.disconnects++;
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
 
-    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_wifi_event_group) {
-            xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+    if (!s_have_credentials) {
+        wifi_set_state(WIFI_MANAGER_STATE_IDLE);
+        return;
+    }
+    if (s_restart_pending) {
+        s_restart_pending = false;
+        wifi_start_attempt();
+        return;
+    }
+
+    if (was_up) {
+        s_down_since_us = esp_timer_get_time();
+        s_failed_attempts = 0U;
+    } else {
+        s_failed_attempts++;
+        /* The AP moved channel or went away: scan instead of retrying it. */
+        if (reason == WIFI_REASON_NO_AP_FOUND || s_failed_attempts >= WIFI_MANAGER_FAST_ATTEMPTS) {
+            s_ap_cached = false;
         }
     }
+    ESP_LOGI(WIFI_MANAGER_TAG, "disconnected (reason %u, %u failed attempts)", (unsigned)reason,
+             (unsigned)s_failed_attempts);
+
+    wifi_schedule_retry(reason);
+    wifi_publish_link_stats();
+}
+
+static void wifi_on_got_ip(void)
+{
+    const uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - s_down_since_us) / 1000);
+
+    (void)esp_timer_stop(s_retry_timer);
+    xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.state = WIFI_MANAGER_STATE_CONNECTED;
+    if (s_was_connected) {
+        wifi_latency_record(&s_reconnect_latency, latency_ms);
+        s_stats.reconnects = s_reconnect_latency.count;
+        s_stats.last_reconnect_ms = s_reconnect_latency.last_ms;
+        s_stats.max_reconnect_ms = s_reconnect_latency.max_ms;
+        s_stats.avg_reconnect_ms = wifi_latency_avg_ms(&s_reconnect_latency);
+    } else {
+        s_stats.first_connect_ms = latency_ms;
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    ESP_LOGI(WIFI_MANAGER_TAG, "%s in %u ms after %u failed attempts", s_was_connected ? "reconnected" : "connected",
+             (unsigned)latency_ms, (unsigned)s_failed_attempts);
+
+    const wifi_status_event_t status = {
+        .status = WIFI_STATUS_CONNECTED,
+        .attempt = (uint16_t)(s_failed_attempts + 1U),
+        .latency_ms = latency_ms,
+    };
+    s_was_connected = true;
+    s_failed_attempts = 0U;
+    wifi_post_status(&status);
+    wifi_publish_link_stats();
+}
+
+static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    (void)arg;
 
-    if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        if (s_wifi_event_group) {
-            xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+    if (event_base == WIFI_EVENT) {
+        switch (event_id) {
+        case WIFI_EVENT_STA_START:
+            s_sta_started = true;
+            if (s_have_credentials) {
+                wifi_start_attempt();
+            }
+            break;
+        case WIFI_EVENT_STA_CONNECTED: {
+            const wifi_event_sta_connected_t *event = (const wifi_event_sta_connected_t *)event_data;
+            memcpy(s_ap_bssid, event->bssid, sizeof(s_ap_bssid));
+            s_ap_channel = event->channel;
+            s_ap_cached = true;
+            break;
+        }
+        case WIFI_EVENT_STA_DISCONNECTED:
+            wifi_on_disconnected((const wifi_event_sta_disconnected_t *)event_data);
+            break;
+        default:
+            break;
+        }
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        wifi_on_got_ip();
+    } else if (event_base == WIFI_MANAGER_EVENT) {
+        if (event_id == WIFI_MANAGER_EVENT_CONNECT_REQUEST) {
+            /* New network: forget the cached AP and measure from now. */
+            memcpy(&s_credentials, event_data, sizeof(s_credentials));
+            s_have_credentials = true;
+            s_ap_cached = false;
+            s_failed_attempts = 0U;
+            s_was_connected = false;
+            s_down_since_us = esp_timer_get_time();
+            (void)esp_timer_stop(s_retry_timer);
+            if (WiFi_GetState() == WIFI_MANAGER_STATE_CONNECTED || WiFi_GetState() == WIFI_MANAGER_STATE_CONNECTING) {
+                /* The resulting STA_DISCONNECTED event starts the new attempt. */
+                s_restart_pending = true;
+                wifi_set_state(WIFI_MANAGER_STATE_BACKOFF);
+                (void)esp_wifi_disconnect();
+            } else if (s_sta_started) {
+                wifi_start_attempt();
+            }
+        } else if (event_id == WIFI_MANAGER_EVENT_RETRY) {
+            if (WiFi_GetState() == WIFI_MANAGER_STATE_BACKOFF) {
+                wifi_start_attempt();
+            }
         }
     }
 }
@@ -78,8 +357,22 @@ bool WiFi_Init(void)
         return false;
     }
 
+    const esp_timer_create_args_t retry_timer_args = {
+        .callback = wifi_retry_timer_cb,
+        .name = "wifi_retry",
+    };
+    ret = esp_timer_create(&retry_timer_args, &s_retry_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(WIFI_MANAGER_TAG, "retry timer create failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
     ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_CONNECT_REQUEST,
+                                               &wifi_event_handler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_RETRY,
+                                               &wifi_event_handler, NULL));
 
     ret = esp_wifi_set_mode(WIFI_MODE_STA);
     if (ret != ESP_OK) {
@@ -103,25 +396,17 @@ bool WiFi_Connect(const char *ssid, const char *pass)
         return false;
     }
 
-    wifi_config_t wifi_config;
-    memset(&wifi_config, 0, sizeof(wifi_config));
-    strlcpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid));
+    wifi_credentials_t credentials;
+    memset(&credentials, 0, sizeof(credentials));
+    strlcpy(credentials.ssid, ssid, sizeof(credentials.ssid));
     if (pass) {
-        strlcpy((char *)wifi_config.sta.password, pass, sizeof(wifi_config.sta.password));
-    } else {
-        wifi_config.sta.password[0] = '\0';
-    }
-    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
-
-    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
-    if (ret != ESP_OK) {
-        ESP_LOGE(WIFI_MANAGER_TAG, "wifi set config failed: %s", esp_err_to_name(ret));
-        return false;
+        strlcpy(credentials.pass, pass, sizeof(credentials.pass));
     }
 
-    ret = esp_wifi_connect();
+    const esp_err_t ret = esp_event_post(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_CONNECT_REQUEST, &credentials,
+                                         sizeof(credentials), portMAX_DELAY);
     if (ret != ESP_OK) {
-        ESP_LOGE(WIFI_MANAGER_TAG, "wifi connect failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(WIFI_MANAGER_TAG, "connect request failed: %s", esp_err_to_name(ret));
         return false;
     }
 
@@ -137,3 +422,21 @@ bool WiFi_IsConnected(void)
     EventBits_t bits = xEventGroupGetBits(s_wifi_event_group);
     return (bits & WIFI_CONNECTED_BIT) != 0;
 }
+
+wifi_manager_state_t WiFi_GetState(void)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    const wifi_manager_state_t state = s_stats.state;
+    portEXIT_CRITICAL(&s_stats_lock);
+    return state;
+}
+
+void WiFi_GetStats(wifi_manager_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_stats_lock);
+    memcpy(out_stats, &s_stats, sizeof(*out_stats));
+    portEXIT_CRITICAL(&s_stats_lock);
+}
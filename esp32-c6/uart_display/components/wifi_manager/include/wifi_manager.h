@@ -1,6 +1,26 @@
 #pragma once
 
+/*
+ * wifi_manager.h
+ *
+ * Station link state machine driven by WIFI_EVENT / IP_EVENT on the default
+ * event loop; no task polls the link. After a drop the manager reconnects at
+ * once to the cached BSSID and channel (no full scan), then falls back to a
+ * full scan with exponential backoff (wifi_reconnect.h) until it gets an IP.
+ *
+ * Link changes are posted as WIFI_MANAGER_EVENT_STATUS on the default event
+ * loop with a wifi_status_event_t payload, and reconnect metrics are
+ * published to system_snapshot (SYSTEM_SNAPSHOT_FIELD_WIFI_LINK).
+ */
+
+#include "esp_event.h"
+
 #include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #ifndef WIFI_DEFAULT_SSID
 #define WIFI_DEFAULT_SSID "SSID"
@@ -10,6 +30,60 @@
 #define WIFI_DEFAULT_PASS "password"
 #endif
 
+ESP_EVENT_DECLARE_BASE(WIFI_MANAGER_EVENT);
+
+typedef enum {
+    WIFI_MANAGER_EVENT_STATUS = 0, /* data: wifi_status_event_t */
+} wifi_manager_event_id_t;
+
+typedef enum {
+    WIFI_STATUS_LOADED_FROM_SD = 0,
+    WIFI_STATUS_LOADED_FROM_NVS,
+    WIFI_STATUS_USING_DEFAULTS,
+    WIFI_STATUS_CONNECTING,
+    WIFI_STATUS_CONNECTED,
+    WIFI_STATUS_DISCONNECTED,
+    WIFI_STATUS_RSSI_UPDATE,
+} wifi_status_t;
+
+typedef struct {
+    wifi_status_t status;
+    uint8_t reason;        /* DISCONNECTED: wifi_err_reason_t */
+    bool fast;             /* CONNECTING: cached BSSID/channel, no scan */
+    uint16_t attempt;      /* attempts since the link was last up */
+    uint32_t retry_in_ms;  /* DISCONNECTED: delay before the next attempt */
+    uint32_t latency_ms;   /* CONNECTED: link lost (or connect requested) -> got IP */
+} wifi_status_event_t;
+
+typedef enum {
+    WIFI_MANAGER_STATE_IDLE = 0,   /* no credentials yet */
+    WIFI_MANAGER_STATE_CONNECTING,
+    WIFI_MANAGER_STATE_CONNECTED,  /* has an IP */
+    WIFI_MANAGER_STATE_BACKOFF,    /* waiting for the retry timer */
+} wifi_manager_state_t;
+
+typedef struct {
+    wifi_manager_state_t state;
+    uint32_t attempts;          /* esp_wifi_connect() calls */
+    uint32_t fast_attempts;     /* of which to the cached BSSID/channel */
+    uint32_t disconnects;       /* drops of an established link */
+    uint32_t reconnects;        /* drops that got an IP back */
+    uint32_t last_reconnect_ms;
+    uint32_t avg_reconnect_ms;
+    uint32_t max_reconnect_ms;
+    uint32_t first_connect_ms;  /* WiFi_Connect() -> first IP */
+    uint8_t last_reason;
+} wifi_manager_stats_t;
+
 bool WiFi_Init(void);
+
+/* Stores the credentials and starts connecting; returns at once. Any task. */
 bool WiFi_Connect(const char *ssid, const char *pass);
 bool WiFi_IsConnected(void);
+
+wifi_manager_state_t WiFi_GetState(void);
+void WiFi_GetStats(wifi_manager_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+/*
+ * wifi_reconnect.h
+ *
+ * Pure helpers behind the WiFi manager's reconnect policy, kept free of
+ * esp_wifi so they can be unit tested: the delay before each attempt and the
+ * reconnect latency statistics.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t base_ms;  /* delay after the first failed attempt */
+    uint32_t max_ms;   /* cap for the doubling delay */
+} wifi_backoff_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t last_ms;
+    uint32_t max_ms;
+    uint64_t total_ms;
+} wifi_latency_stats_t;
+
+/*
+ * Delay before the next attempt after failed_attempts consecutive failures:
+ * 0 right after a drop (fast reconnect), then base_ms doubling up to max_ms,
+ * plus up to 25% jitter taken from random so several devices on one AP do
+ * not retry in lockstep. The result never exceeds max_ms.
+ */
+uint32_t wifi_backoff_delay_ms(const wifi_backoff_t *backoff, uint32_t failed_attempts, uint32_t random);
+
+void wifi_latency_record(wifi_latency_stats_t *stats, uint32_t latency_ms);
+uint32_t wifi_latency_avg_ms(const wifi_latency_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,15 +2,14 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "wifi_manager.h"
 
-#define WIFI_STATUS_MSG_LEN 32
-
-typedef struct {
-    char text[WIFI_STATUS_MSG_LEN];
-} wifi_status_msg_t;
+/* WIFI_MANAGER_EVENT_STATUS payloads plus the task's own credential / RSSI notices. */
+typedef wifi_status_event_t wifi_status_msg_t;
 
 extern QueueHandle_t wifiStatusQueue;
 
+/* Reads the stored credentials (app_config) and hands them to the WiFi manager. After WiFi_Init(). */
 void wifi_task_start(void);
 void wifi_ui_timer_init(void);
 const char *wifi_get_ssid(void);
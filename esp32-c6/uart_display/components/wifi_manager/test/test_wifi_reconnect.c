@@ -0,0 +1,43 @@
+#include "wifi_reconnect.h"
+
+#include "unity.h"
+
+TEST_CASE("wifi backoff is immediate after a drop, then doubles to the cap", "[wifi_manager]")
+{
+    const wifi_backoff_t backoff = { .base_ms = 500U, .max_ms = 30000U };
+
+    TEST_ASSERT_EQUAL_UINT32(0U, wifi_backoff_delay_ms(&backoff, 0U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(500U, wifi_backoff_delay_ms(&backoff, 1U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(1000U, wifi_backoff_delay_ms(&backoff, 2U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(2000U, wifi_backoff_delay_ms(&backoff, 3U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(16000U, wifi_backoff_delay_ms(&backoff, 6U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(30000U, wifi_backoff_delay_ms(&backoff, 7U, 0U));
+    TEST_ASSERT_EQUAL_UINT32(30000U, wifi_backoff_delay_ms(&backoff, 1000U, 0U));
+}
+
+TEST_CASE("wifi backoff jitter stays within 25% and under the cap", "[wifi_manager]")
+{
+    const wifi_backoff_t backoff = { .base_ms = 500U, .max_ms = 30000U };
+
+    for (uint32_t random = 0U; random < 2000U; random += 7U) {
+        const uint32_t delay = wifi_backoff_delay_ms(&backoff, 2U, random);
+        TEST_ASSERT_TRUE(delay >= 1000U && delay <= 1250U);
+        TEST_ASSERT_TRUE(wifi_backoff_delay_ms(&backoff, 20U, random) <= 30000U);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1250U, wifi_backoff_delay_ms(&backoff, 2U, 250U));
+}
+
+TEST_CASE("wifi reconnect latency keeps last, max and average", "[wifi_manager]")
+{
+    wifi_latency_stats_t stats = { 0 };
+
+    TEST_ASSERT_EQUAL_UINT32(0U, wifi_latency_avg_ms(&stats));
+    wifi_latency_record(&stats, 800U);
+    wifi_latency_record(&stats, 2400U);
+    wifi_latency_record(&stats, 400U);
+
+    TEST_ASSERT_EQUAL_UINT32(3U, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(400U, stats.last_ms);
+    TEST_ASSERT_EQUAL_UINT32(2400U, stats.max_ms);
+    TEST_ASSERT_EQUAL_UINT32(1200U, wifi_latency_avg_ms(&stats));
+}
@@ -0,0 +1,45 @@
+#include "wifi_reconnect.h"
+
+#include <stddef.h>
+
+uint32_t wifi_backoff_delay_ms(const wifi_backoff_t *backoff, uint32_t failed_attempts, uint32_t random)
+{
+    if (backoff == NULL || failed_attempts == 0U || backoff->base_ms == 0U) {
+        return 0U;
+    }
+
+    uint32_t delay = backoff->base_ms;
+    for (uint32_t i = 1U; i < failed_attempts && delay < backoff->max_ms; ++i) {
+        delay = (delay > UINT32_MAX / 2U) ? UINT32_MAX : delay * 2U;
+    }
+    if (delay > backoff->max_ms) {
+        delay = backoff->max_ms;
+    }
+
+    const uint32_t jitter_span = delay / 4U;
+    if (jitter_span != 0U) {
+        delay += random % (jitter_span + 1U);
+    }
+    return (delay > backoff->max_ms) ? backoff->max_ms : delay;
+}
+
+void wifi_latency_record(wifi_latency_stats_t *stats, uint32_t latency_ms)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->count++;
+    stats->last_ms = latency_ms;
+    if (latency_ms > stats->max_ms) {
+        stats->max_ms = latency_ms;
+    }
+    stats->total_ms += latency_ms;
+}
+
+uint32_t wifi_latency_avg_ms(const wifi_latency_stats_t *stats)
+{
+    if (stats == NULL || stats->count == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(stats->total_ms / stats->count);
+}
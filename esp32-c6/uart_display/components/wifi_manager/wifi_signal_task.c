@@ -2,8 +2,7 @@
 
 #include <string.h>
 
-#include "wifi_manager.h"
-#include "esp_wifi.h"
+#include "system_snapshot.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lvgl.h"
@@ -35,19 +34,41 @@ static void wifi_signal_bar_update_cb(void *arg)
     }
 }
 
+static void wifi_signal_changed_cb(uint32_t changed_fields, void *ctx)
+{
+    (void)changed_fields;
+    xTaskNotifyGive((TaskHandle_t)ctx);
+}
+
+/*
+ * RSSI is sampled once, by the snapshot metrics task; this task sleeps until
+ * that sample (or the link state) actually changes.
+ */
 static void wifi_signal_task(void *arg)
 {
     (void)arg;
 
+    system_snapshot_subscriber_id_t subscriber;
+    if (!system_snapshot_subscribe(SYSTEM_SNAPSHOT_FIELD_WIFI_RSSI | SYSTEM_SNAPSHOT_FIELD_WIFI_CONNECTED,
+                                   wifi_signal_changed_cb, xTaskGetCurrentTaskHandle(), &subscriber)) {
+        vTaskDelete(NULL);
+        return;
+    }
+
     int last_strength = -1;
+    system_snapshot_t snapshot;
+    system_snapshot_read(&snapshot);
 
     while (1) {
+        system_snapshot_delta_t delta;
+        if (system_snapshot_take_changes(subscriber, &delta) != 0U) {
+            /* Re-read both: the delta only carries the field that moved. */
+            system_snapshot_read(&snapshot);
+        }
+
         int strength = 0;
-        if (WiFi_IsConnected()) {
-            wifi_ap_record_t ap_info;
-            if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
-                strength = wifi_rssi_to_percent(ap_info.rssi);
-            }
+        if (snapshot.wifi_connected && snapshot.wifi_rssi_dbm != SYSTEM_SNAPSHOT_WIFI_RSSI_INVALID) {
+            strength = wifi_rssi_to_percent(snapshot.wifi_rssi_dbm);
         }
 
         if (strength != last_strength) {
@@ -60,12 +81,12 @@ static void wifi_signal_task(void *arg)
             if (wifiStatusQueue) {
                 wifi_status_msg_t msg;
                 memset(&msg, 0, sizeof(msg));
-                strlcpy(msg.text, "WIFI:RSSI_UPDATE", sizeof(msg.text));
+                msg.status = WIFI_STATUS_RSSI_UPDATE;
                 xQueueSend(wifiStatusQueue, &msg, 0);
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(2000));
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
 }
 
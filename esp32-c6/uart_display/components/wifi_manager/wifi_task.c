@@ -3,21 +3,16 @@
 #include <string.h>
 #include <arpa/inet.h>
 
-#include "sd_storage.h"
+#include "app_config.h"
 #include "wifi_manager.h"
 #include "app_log.h"
 #include "esp_log.h"
 #include "esp_netif.h"
-#include "freertos/task.h"
 #include "lvgl.h"
 
-#define WIFI_TASK_STACK_SIZE 4096
-#define WIFI_TASK_PRIORITY 2
 #define WIFI_STATUS_QUEUE_LEN 8
-#define WIFI_CRED_PATH "/sdcard/WIFI.TXT"
-#define WIFI_SSID_MAX_LEN 32
-#define WIFI_PASS_MAX_LEN 64
-#define WIFI_FILE_BUF_LEN 256
+#define WIFI_SSID_MAX_LEN APP_CONFIG_SSID_LEN
+#define WIFI_PASS_MAX_LEN APP_CONFIG_PASS_LEN
 
 static const char *WIFI_TASK_TAG = "wifiTask";
 
@@ -31,95 +26,41 @@ extern lv_obj_t *ui_LabelSSID __attribute__((weak));
 extern lv_obj_t *ui_LabelWiFiStatus __attribute__((weak));
 extern lv_obj_t *ui_LabelWiFiIP __attribute__((weak));
 
-static void wifi_send_status(const char *status)
+static void wifi_send_status(wifi_status_t status)
 {
-    if (!wifiStatusQueue || !status) {
+    if (!wifiStatusQueue) {
         return;
     }
 
     wifi_status_msg_t msg;
     memset(&msg, 0, sizeof(msg));
-    strlcpy(msg.text, status, sizeof(msg.text));
+    msg.status = status;
     xQueueSend(wifiStatusQueue, &msg, 0);
 }
 
-static void wifi_trim_whitespace(char *str)
-{
-    if (!str) {
-        return;
-    }
-
-    char *end = str + strlen(str);
-    while (end > str && (*(end - 1) == '\r' || *(end - 1) == '\n' || *(end - 1) == ' ' || *(end - 1) == '\t')) {
-        *(end - 1) = '\0';
-        end--;
-    }
-
-    while (*str == ' ' || *str == '\t') {
-        memmove(str, str + 1, strlen(str));
-    }
-}
-
-static bool wifi_load_from_sd(char *ssid_out, size_t ssid_len, char *pass_out, size_t pass_len)
+/* Runs on the default event loop task: forward to the UI queue, never block. */
+static void wifi_status_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
 {
-    char file_buf[WIFI_FILE_BUF_LEN];
-    if (!SD_ReadFile(WIFI_CRED_PATH, file_buf, sizeof(file_buf))) {
-        ESP_LOGE(WIFI_TASK_TAG, "Failed to read WIFI credentials from SD card: %s", WIFI_CRED_PATH);
-        app_log_write(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_WARN, "failed to read credentials from SD");
-        return false;
-    }
-
-    ESP_LOGI(WIFI_TASK_TAG, "Successfully read WIFI file, parsing contents");
-
-    bool has_ssid = false;
-    bool has_pass = false;
-
-    char *saveptr = NULL;
-    char *line = strtok_r(file_buf, "\n", &saveptr);
-    while (line) {
-        char *cr = strchr(line, '\r');
-        if (cr) {
-            *cr = '\0';
-        }
-        if (strncmp(line, "SSID:", 5) == 0) {
-            const char *value = line + 5;
-            while (*value == ' ' || *value == '\t') {
-                value++;
-            }
-            strlcpy(ssid_out, value, ssid_len);
-            wifi_trim_whitespace(ssid_out);
-            has_ssid = ssid_out[0] != '\0';
-            if (has_ssid) {
-                ESP_LOGI(WIFI_TASK_TAG, "Loaded SSID: %s", ssid_out);
-            }
-        } else if (strncmp(line, "PASS:", 5) == 0) {
-            const char *value = line + 5;
-            while (*value == ' ' || *value == '\t') {
-                value++;
-            }
-            strlcpy(pass_out, value, pass_len);
-            wifi_trim_whitespace(pass_out);
-            has_pass = pass_out[0] != '\0';
-            if (has_pass) {
-                ESP_LOGI(WIFI_TASK_TAG, "Loaded password (length: %zu)", strlen(pass_out));
-            }
-        }
-        line = strtok_r(NULL, "\n", &saveptr);
+    (void)arg;
+    (void)event_base;
+    (void)event_id;
+
+    const wifi_status_event_t *event = (const wifi_status_event_t *)event_data;
+    switch (event->status) {
+    case WIFI_STATUS_CONNECTED:
+        APP_LOGI(WIFI, "connected to %s in %u ms", s_wifi_ssid, (unsigned)event->latency_ms);
+        break;
+    case WIFI_STATUS_DISCONNECTED:
+        APP_LOGI(WIFI, "disconnected (reason %u), retry in %u ms", (unsigned)event->reason,
+                 (unsigned)event->retry_in_ms);
+        break;
+    default:
+        break;
     }
 
-    if (has_ssid) {
-        if (!has_pass) {
-            pass_out[0] = '\0';
-        }
-        // SD_DeleteFile(WIFI_CRED_PATH);
-        ESP_LOGI(WIFI_TASK_TAG, "Loaded Wi-Fi SSID from SD");
-        app_log_write(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_INFO, "loaded credentials from SD");
-        return true;
+    if (wifiStatusQueue) {
+        xQueueSend(wifiStatusQueue, event, 0);
     }
-
-    ESP_LOGE(WIFI_TASK_TAG, "No valid SSID found in WIFI.TXT file");
-    app_log_write(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_WARN, "no valid SSID in WIFI.TXT");
-    return false;
 }
 
 static void wifi_get_ip_address(void)
@@ -159,73 +100,64 @@ static void wifi_ui_timer_cb(lv_timer_t *timer)
 
     wifi_status_msg_t msg;
     while (xQueueReceive(wifiStatusQueue, &msg, 0) == pdTRUE) {
-        if (strcmp(msg.text, "WIFI:USING_DEFAULTS") == 0) {
+        switch (msg.status) {
+        case WIFI_STATUS_USING_DEFAULTS:
             lv_label_set_text(ui_LabelWiFiStatus, "USING_DEFAULTS");
-        } else if (strcmp(msg.text, "WIFI:CONNECTED") == 0) {
+            break;
+        case WIFI_STATUS_CONNECTING:
+            lv_label_set_text(ui_LabelWiFiStatus, "CONNECTING");
+            break;
+        case WIFI_STATUS_CONNECTED:
             lv_label_set_text(ui_LabelWiFiStatus, "CONNECTED");
             wifi_get_ip_address();
             if (ui_LabelWiFiIP && s_wifi_ip[0] != '\0') {
                 lv_label_set_text(ui_LabelWiFiIP, s_wifi_ip);
             }
-        } else if (strcmp(msg.text, "WIFI:DISCONNECTED") == 0) {
+            break;
+        case WIFI_STATUS_DISCONNECTED:
             lv_label_set_text(ui_LabelWiFiStatus, "DISCONNECTED");
             if (ui_LabelWiFiIP) {
                 lv_label_set_text(ui_LabelWiFiIP, "Not Connected");
             }
             memset(s_wifi_ip, 0, sizeof(s_wifi_ip));
+            break;
+        default:
+            break;
         }
     }
 }
 
-static void wifi_task(void *arg)
+void wifi_task_start(void)
 {
-    (void)arg;
-
-    memset(s_wifi_ssid, 0, sizeof(s_wifi_ssid));
-    memset(s_wifi_pass, 0, sizeof(s_wifi_pass));
-
-    ESP_LOGI(WIFI_TASK_TAG, "WiFi task starting - attempting to load credentials from SD card");
+    if (!wifiStatusQueue) {
+        wifiStatusQueue = xQueueCreate(WIFI_STATUS_QUEUE_LEN, sizeof(wifi_status_msg_t));
+        if (esp_event_handler_register(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_STATUS,
+                                       &wifi_status_event_handler, NULL) != ESP_OK) {
+            ESP_LOGE(WIFI_TASK_TAG, "status handler not registered");
+        }
+    }
 
-    if (wifi_load_from_sd(s_wifi_ssid, sizeof(s_wifi_ssid), s_wifi_pass, sizeof(s_wifi_pass))) {
-        wifi_send_status("WIFI:LOADED_FROM_SD");
-        ESP_LOGI(WIFI_TASK_TAG, "Successfully loaded WiFi credentials from SD card");
+    /* Credentials come from the NVS config store; no SD access at boot. */
+    app_config_t config;
+    app_config_get(&config);
+    if (config.wifi_ssid[0] != '\0') {
+        strlcpy(s_wifi_ssid, config.wifi_ssid, sizeof(s_wifi_ssid));
+        strlcpy(s_wifi_pass, config.wifi_pass, sizeof(s_wifi_pass));
+        wifi_send_status((app_config_get_source() == APP_CONFIG_SOURCE_SD) ? WIFI_STATUS_LOADED_FROM_SD
+                                                                          : WIFI_STATUS_LOADED_FROM_NVS);
+        ESP_LOGI(WIFI_TASK_TAG, "Using stored credentials for SSID: %s", s_wifi_ssid);
     } else {
         strlcpy(s_wifi_ssid, WIFI_DEFAULT_SSID, sizeof(s_wifi_ssid));
         strlcpy(s_wifi_pass, WIFI_DEFAULT_PASS, sizeof(s_wifi_pass));
-        wifi_send_status("WIFI:USING_DEFAULTS");
-        ESP_LOGW(WIFI_TASK_TAG, "Failed to load from SD, using default credentials: %s", WIFI_DEFAULT_SSID);
-        app_log_write(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_WARN, "using default Wi-Fi credentials");
-    }
-
-    bool last_connected = !WiFi_IsConnected();
-
-    while (1) {
-        bool connected = WiFi_IsConnected();
-        if (!connected && s_wifi_ssid[0] != '\0') {
-            WiFi_Connect(s_wifi_ssid, s_wifi_pass);
-        }
-
-        if (connected != last_connected) {
-            wifi_send_status(connected ? "WIFI:CONNECTED" : "WIFI:DISCONNECTED");
-            if (connected) {
-                app_log_write_fmt(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_INFO, "connected to %s", s_wifi_ssid);
-            } else {
-                app_log_write(APP_LOG_SUBSYS_WIFI, APP_LOG_LEVEL_INFO, "disconnected");
-            }
-            last_connected = connected;
-        }
-
-        vTaskDelay(pdMS_TO_TICKS(10000));
+        wifi_send_status(WIFI_STATUS_USING_DEFAULTS);
+        ESP_LOGW(WIFI_TASK_TAG, "No stored credentials, using default: %s", WIFI_DEFAULT_SSID);
+        APP_LOGW(WIFI, "using default Wi-Fi credentials");
     }
-}
 
-void wifi_task_start(void)
-{
-    if (!wifiStatusQueue) {
-        wifiStatusQueue = xQueueCreate(WIFI_STATUS_QUEUE_LEN, sizeof(wifi_status_msg_t));
+    /* From here the WiFi manager owns the link, reconnects included. */
+    if (!WiFi_Connect(s_wifi_ssid, s_wifi_pass)) {
+        APP_LOGW(WIFI, "connect request rejected");
     }
-
-    xTaskCreate(wifi_task, "wifiTask", WIFI_TASK_STACK_SIZE, NULL, WIFI_TASK_PRIORITY, NULL);
 }
 
 void wifi_ui_timer_init(void)
@@ -63,41 +63,23 @@ void LCD_Init(void)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Backlight program
-static ledc_channel_config_t ledc_channel;
 void BK_Init(void)
 {
     ESP_LOGI(TAG_LCD, "Turn off LCD backlight");
-    gpio_config_t bk_gpio_config = {
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = 1ULL << EXAMPLE_PIN_NUM_BK_LIGHT
-    };
-    ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
-    
-    // 配置LEDC
-    ledc_timer_config_t ledc_timer = {
-        .duty_resolution = LEDC_TIMER_13_BIT,
-        .freq_hz = 5000,
-        .speed_mode = LEDC_LS_MODE,
-        .timer_num = LEDC_HS_TIMER,
-        .clk_cfg = LEDC_AUTO_CLK
-    };
-    ledc_timer_config(&ledc_timer);
-
-    ledc_channel.channel    = LEDC_HS_CH0_CHANNEL;
-    ledc_channel.duty       = 0;
-    ledc_channel.gpio_num   = EXAMPLE_PIN_NUM_BK_LIGHT;
-    ledc_channel.speed_mode = LEDC_LS_MODE;
-    ledc_channel.timer_sel  = LEDC_HS_TIMER;
-    ledc_channel_config(&ledc_channel);
-    ledc_fade_func_install(0);
+    // LEDC PWM with a gamma curve and hardware fades (components/backlight)
+    backlight_config_t bk_config;
+    backlight_get_default_config(&bk_config);
+    bk_config.gpio_num = EXAMPLE_PIN_NUM_BK_LIGHT;
+    bk_config.speed_mode = LEDC_LS_MODE;
+    bk_config.timer = LEDC_HS_TIMER;
+    bk_config.channel = LEDC_HS_CH0_CHANNEL;
+    bk_config.resolution = LEDC_ResolutionRatio;
+    bk_config.brightness = 0;
+    ESP_ERROR_CHECK(backlight_init(&bk_config) ? ESP_OK : ESP_FAIL);
 }
 void BK_Light(uint8_t Light)
 {   
-    if(Light > 100) Light = 100;
-    uint16_t Duty = LEDC_MAX_Duty-(81*(100-Light));
-    if(Light == 0) Duty = 0;
-    // 设置PWM占空比
-    ledc_set_duty(ledc_channel.speed_mode, ledc_channel.channel, Duty);
-    ledc_update_duty(ledc_channel.speed_mode, ledc_channel.channel);
+    // Applied at once; backlight_set() with a fade time does not block either
+    (void)backlight_set(Light, 0);
 }
 // end Backlight program
\ No newline at end of file
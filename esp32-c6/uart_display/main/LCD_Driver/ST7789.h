@@ -12,6 +12,7 @@
 #include "esp_log.h"
 #include "lvgl.h"
 #include "driver/ledc.h"
+#include "backlight.h"
 
 #include "Vernon_ST7789T.h"
 #include "LVGL_Driver.h"
@@ -53,6 +54,6 @@
 extern esp_lcd_panel_handle_t panel_handle;
 
 void BK_Init(void);                             // Initialize the LCD backlight, which has been called in the LCD_Init function, ignore it                                                         
-void BK_Light(uint8_t Light);                   // Call this function to adjust the brightness of the backlight. The value of the parameter Light ranges from 0 to 100
+void BK_Light(uint8_t Light);                   // Call this function to adjust the brightness of the backlight. The value of the parameter Light ranges from 0 to 100 (perceptual)
 
 void LCD_Init(void);                     // Call this function to initialize the screen (must be called in the main function) !!!!!
\ No newline at end of file
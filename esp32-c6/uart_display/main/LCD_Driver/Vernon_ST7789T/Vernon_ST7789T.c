@@ -47,8 +47,19 @@ typedef struct {
     uint8_t fb_bits_per_pixel;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     uint8_t colmod_cal; // save surrent value of LCD_CMD_COLMOD register
+    // last CASET/RASET window sent, in panel coordinates (end exclusive)
+    bool window_valid;
+    int window_x_start;
+    int window_x_end;
+    int window_y_start;
+    int window_y_end;
 } st7789t_panel_t;
 
+static inline void panel_st7789t_invalidate_window(st7789t_panel_t *st7789t)
+{
+    st7789t->window_valid = false;
+}
+
 esp_err_t esp_lcd_new_panel_st7789t(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_st7789t_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel)
 {
 #if CONFIG_LCD_ENABLE_DEBUG_LOG
@@ -141,6 +152,7 @@ static esp_err_t panel_st7789t_reset(esp_lcd_panel_t *panel)
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
 
+    panel_st7789t_invalidate_window(st7789t);
     // perform hardware reset
     if (st7789t->reset_gpio_num >= 0) {
         gpio_set_level(st7789t->reset_gpio_num, st7789t->reset_level);
@@ -159,6 +171,7 @@ static esp_err_t panel_st7789t_init(esp_lcd_panel_t *panel)
 {
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    panel_st7789t_invalidate_window(st7789t);
     // LCD goes into sleep mode and display will be turned off after power on reset, exit sleep mode first
     // printf("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\r\n");
     esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
@@ -209,30 +222,55 @@ static esp_err_t panel_st7789t_draw_bitmap(esp_lcd_panel_t *panel, int x_start,
     st7789t_panel_t *st7789t = __containerof(panel, st7789t_panel_t, base);
     assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
     esp_lcd_panel_io_handle_t io = st7789t->io;
+    esp_err_t ret = ESP_OK;
 
     x_start += st7789t->x_gap;
     x_end += st7789t->x_gap;
     y_start += st7789t->y_gap;
     y_end += st7789t->y_gap;
 
-    // define an area of frame memory where MCU can access
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
-        (x_start >> 8) & 0xFF,
-        x_start & 0xFF,
-        ((x_end - 1) >> 8) & 0xFF,
-        (x_end - 1) & 0xFF,
-    }, 4);
-    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
-        (y_start >> 8) & 0xFF,
-        y_start & 0xFF,
-        ((y_end - 1) >> 8) & 0xFF,
-        (y_end - 1) & 0xFF,
-    }, 4);
+    // define an area of frame memory where MCU can access; RAMWR restarts at the
+    // window origin, so a CASET/RASET matching the last one sent can be skipped.
+    // LVGL flushes an area as bands of equal width, so CASET usually repeats.
+    const bool same_cols = st7789t->window_valid &&
+                           st7789t->window_x_start == x_start && st7789t->window_x_end == x_end;
+    const bool same_rows = st7789t->window_valid &&
+                           st7789t->window_y_start == y_start && st7789t->window_y_end == y_end;
+    if (!same_cols) {
+        const uint8_t cols[] = {
+            (x_start >> 8) & 0xFF,
+            x_start & 0xFF,
+            ((x_end - 1) >> 8) & 0xFF,
+            (x_end - 1) & 0xFF,
+        };
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, cols, sizeof(cols)), err, TAG, "send CASET failed");
+    }
+    if (!same_rows) {
+        const uint8_t rows[] = {
+            (y_start >> 8) & 0xFF,
+            y_start & 0xFF,
+            ((y_end - 1) >> 8) & 0xFF,
+            (y_end - 1) & 0xFF,
+        };
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, rows, sizeof(rows)), err, TAG, "send RASET failed");
+    }
+    // only cache a window the panel actually received
+    st7789t->window_valid = true;
+    st7789t->window_x_start = x_start;
+    st7789t->window_x_end = x_end;
+    st7789t->window_y_start = y_start;
+    st7789t->window_y_end = y_end;
     // transfer frame buffer
     size_t len = (x_end - x_start) * (y_end - y_start) * st7789t->fb_bits_per_pixel / 8;
-    esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len), err, TAG, "send RAMWR failed");
 
     return ESP_OK;
+
+err:
+    // a window command may be half sent, and an aborted RAMWR leaves the
+    // window state unknown: resend CASET/RASET on the next band
+    panel_st7789t_invalidate_window(st7789t);
+    return ret;
 }
 
 static esp_err_t panel_st7789t_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
@@ -263,6 +301,7 @@ static esp_err_t panel_st7789t_mirror(esp_lcd_panel_t *panel, bool mirror_x, boo
     } else {
         st7789t->madctl_val &= ~LCD_CMD_MY_BIT;
     }
+    panel_st7789t_invalidate_window(st7789t);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         st7789t->madctl_val
     }, 1);
@@ -278,6 +317,7 @@ static esp_err_t panel_st7789t_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
     } else {
         st7789t->madctl_val &= ~LCD_CMD_MV_BIT;
     }
+    panel_st7789t_invalidate_window(st7789t);
     esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         st7789t->madctl_val
     }, 1);
@@ -3,37 +3,13 @@
 
 static const char *TAG_LVGL = "WS_LVGL";
 
-static lv_color_t buf1[ LVGL_BUF_LEN ];
-static lv_color_t buf2[ LVGL_BUF_LEN];
-// static lv_color_t* buf1 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN , MALLOC_CAP_SPIRAM);
-// static lv_color_t* buf2 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN , MALLOC_CAP_SPIRAM);
-    
-
 lv_disp_draw_buf_t disp_buf;                                                 // contains internal graphic buffer(s) called draw buffer(s)
 lv_disp_drv_t disp_drv;                                                      // contains callback functions
     
-void example_increase_lvgl_tick(void *arg)
-{
-    /* Tell LVGL how many milliseconds has elapsed */
-    lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
-}
-
 bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
-    lv_disp_drv_t *disp_driver = (lv_disp_drv_t *)user_ctx;
-    lv_disp_flush_ready(disp_driver);
-    return false;
-}
-
-void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
-{
-    esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) drv->user_data;
-    int offsetx1 = area->x1;
-    int offsetx2 = area->x2;
-    int offsety1 = area->y1;
-    int offsety2 = area->y2;
-    // copy a buffer's content to a specific area of the display
-    esp_lcd_panel_draw_bitmap(panel_handle, offsetx1 + Offset_X, offsety1 + Offset_Y, offsetx2 + Offset_X + 1, offsety2 + Offset_Y + 1, color_map);
+    // A band's DMA finished: hand its buffer back to the flush engine
+    return LVGL_Flush_OnTransDone();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -43,32 +19,40 @@ void LVGL_Init(void)
     ESP_LOGI(TAG_LVGL, "Initialize LVGL library");
     lv_init();
     
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, LVGL_BUF_LEN );                              // initialize LVGL draw buffers
-
     ESP_LOGI(TAG_LVGL, "Register display driver to LVGL");
     lv_disp_drv_init(&disp_drv);                                                                        // Initialize display driver                                                                        // Create a new screen object and initialize the associated device
     disp_drv.hor_res = 320;            
     disp_drv.ver_res = 172;                                                     // Landscape resolution
-    disp_drv.flush_cb = example_lvgl_flush_cb;                                                          // Function : copy a buffer's content to a specific area of the display
-    disp_drv.draw_buf = &disp_buf;                                                                      // LVGL will use this buffer(s) to draw the screens contents
     disp_drv.user_data = panel_handle;                
+
+    // Draw buffers, flush_cb and render_start_cb come from the flush engine
+    lvgl_flush_config_t flush_config;
+    LVGL_Flush_GetDefaultConfig(&flush_config);
+    ESP_ERROR_CHECK(LVGL_Flush_Init(&flush_config, &disp_drv, &disp_buf) ? ESP_OK : ESP_ERR_NO_MEM);
     ESP_LOGI(TAG_LVGL,"Register display indev to LVGL");                                                  // Custom display driver user data
     disp = lv_disp_drv_register(&disp_drv);                                                  // Create screen objects
 
     // Panel is already configured for landscape via esp_lcd_panel_swap_xy/mirror.
     // Keep LVGL in native (unrotated) coordinate system for 320x172.
     lv_disp_set_rotation(disp, LV_DISP_ROT_NONE);
+
+#if CONFIG_LVGL_AREA_MERGE
+    // Rewrite each frame's dirty areas for the SPI cost of this panel
+    area_merge_cost_t merge_cost;
+    area_merge_get_default_cost(EXAMPLE_LCD_PIXEL_CLOCK_HZ, disp_buf.size, &merge_cost);
+#if CONFIG_LVGL_AREA_MERGE_TRACE
+    area_merge_lvgl_set_trace(true);
+#endif
+    if (!area_merge_lvgl_install(disp, &merge_cost)) {
+        ESP_LOGW(TAG_LVGL, "Dirty area merging not installed");
+    }
+#endif
     
     /********************* LVGL *********************/
-    ESP_LOGI(TAG_LVGL, "Install LVGL tick timer");
-    // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
-    const esp_timer_create_args_t lvgl_tick_timer_args = {
-        .callback = &example_increase_lvgl_tick,
-        .name = "lvgl_tick"
-    };
-    
-    esp_timer_handle_t lvgl_tick_timer = NULL;
-    ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000));
+    // No periodic tick interrupt: the scheduler advances lv_tick from esp_timer whenever the LVGL loop runs
+    ESP_LOGI(TAG_LVGL, "Install LVGL scheduler");
+    lvgl_scheduler_config_t sched_config;
+    LVGL_Scheduler_GetDefaultConfig(&sched_config);
+    ESP_ERROR_CHECK(LVGL_Scheduler_Init(&sched_config, disp) ? ESP_OK : ESP_ERR_INVALID_STATE);
 
 }
@@ -9,18 +9,16 @@
 #include "demos/lv_demos.h"
 
 #include "ST7789.h"
-
-#define LVGL_BUF_LEN  (EXAMPLE_LCD_H_RES * 20)
-#define EXAMPLE_LVGL_TICK_PERIOD_MS    2
+#include "LVGL_Flush.h"
+#include "area_merge_lvgl.h"
+#include "LVGL_Scheduler.h"
 
 extern lv_disp_draw_buf_t disp_buf;                                                 // contains internal graphic buffer(s) called draw buffer(s)
 extern lv_disp_drv_t disp_drv;                                                      // contains callback functions
 extern lv_disp_t *disp;    
 
 bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
-void example_lvgl_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
 /* Rotate display and touch, when rotated screen in LVGL. Called when driver parameters are updated. */
 void example_lvgl_port_update_callback(lv_disp_drv_t *drv);
-void example_increase_lvgl_tick(void *arg);
 
 void LVGL_Init(void);                     // Call this function to initialize the screen (must be called in the main function) !!!!!
\ No newline at end of file
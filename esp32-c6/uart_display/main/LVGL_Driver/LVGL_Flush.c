@@ -0,0 +1,401 @@
+#include "LVGL_Flush.h"
+#include "LVGL_Scheduler.h"
+
+#include "ST7789.h"
+#include "demos/lv_demos.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "spi_arbiter.h"
+
+#include <string.h>
+
+#ifdef CONFIG_LVGL_FLUSH_SLOTS
+#define LVGL_FLUSH_DEFAULT_SLOTS CONFIG_LVGL_FLUSH_SLOTS
+#else
+#define LVGL_FLUSH_DEFAULT_SLOTS 3
+#endif
+
+#ifdef CONFIG_LVGL_FLUSH_BAND_LINES
+#define LVGL_FLUSH_DEFAULT_BAND_LINES CONFIG_LVGL_FLUSH_BAND_LINES
+#else
+#define LVGL_FLUSH_DEFAULT_BAND_LINES 20
+#endif
+
+#ifdef CONFIG_LVGL_FLUSH_SWAP_BYTES
+#define LVGL_FLUSH_DEFAULT_SWAP_BYTES true
+#else
+#define LVGL_FLUSH_DEFAULT_SWAP_BYTES false
+#endif
+
+static const char *TAG_FLUSH = "WS_FLUSH";
+
+typedef struct {
+    uint8_t slot;
+    bool first;           /* first band of the frame */
+    bool last;            /* last band of the frame */
+    lv_area_t area;
+    /* Frame timing, filled on the last band only. */
+    int64_t frame_start_us;
+    int64_t first_submit_us;
+    int64_t next_frame_us;  /* earliest start of the next frame, for the SPI arbiter */
+    uint32_t render_us;
+    uint32_t wait_us;
+} flush_job_t;
+
+static lvgl_flush_config_t s_config;
+static lv_color_t *s_slot_buf[LVGL_FLUSH_MAX_SLOTS];
+
+/* LVGL -> flush task, flush task -> DMA done ISR, ISR -> LVGL. Each holds at most `slots` entries. */
+static StaticQueue_t s_job_queue_buf;
+static StaticQueue_t s_inflight_queue_buf;
+static StaticQueue_t s_free_queue_buf;
+static uint8_t s_job_storage[LVGL_FLUSH_MAX_SLOTS * sizeof(flush_job_t)];
+static uint8_t s_inflight_storage[LVGL_FLUSH_MAX_SLOTS * sizeof(flush_job_t)];
+static uint8_t s_free_storage[LVGL_FLUSH_MAX_SLOTS * sizeof(uint8_t)];
+static QueueHandle_t s_job_queue = NULL;
+static QueueHandle_t s_inflight_queue = NULL;
+static QueueHandle_t s_free_queue = NULL;
+
+/* Frame bookkeeping; LVGL thread only. */
+static int64_t s_frame_start_us;
+static int64_t s_first_submit_us;
+static int64_t s_render_resume_us;
+static uint32_t s_frame_render_us;
+static uint32_t s_frame_wait_us;
+
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static lvgl_flush_stats_t s_stats;
+static lvgl_flush_frame_hook_t s_frame_hook; /* one-shot, under s_stats_lock */
+
+void LVGL_Flush_GetDefaultConfig(lvgl_flush_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->slots = LVGL_FLUSH_DEFAULT_SLOTS;
+    config->band_lines = LVGL_FLUSH_DEFAULT_BAND_LINES;
+    config->swap_bytes = LVGL_FLUSH_DEFAULT_SWAP_BYTES;
+    config->stack_size = 3072;
+    config->task_priority = tskIDLE_PRIORITY + 3;
+}
+
+static uint8_t flush_slot_index(const lv_color_t *buf)
+{
+    for (uint8_t i = 0; i < s_config.slots; ++i) {
+        if (s_slot_buf[i] == buf) {
+            return i;
+        }
+    }
+    return UINT8_MAX;
+}
+
+/* RGB565 to panel (big-endian) byte order, two pixels per word. */
+static void flush_swap_rgb565(lv_color_t *buf, uint32_t px)
+{
+    uint32_t *words = (uint32_t *)buf;
+    for (uint32_t i = 0; i < px / 2U; ++i) {
+        const uint32_t w = words[i];
+        words[i] = ((w & 0x00FF00FFU) << 8) | ((w >> 8) & 0x00FF00FFU);
+    }
+    if ((px & 1U) != 0U) {
+        uint16_t *tail = (uint16_t *)&buf[px - 1U];
+        *tail = (uint16_t)((*tail << 8) | (*tail >> 8));
+    }
+}
+
+/*
+ * The band never reached the bus, so no done interrupt will retire it. Jobs
+ * ahead of it in the in-flight queue still complete in order; wait until it
+ * is at the head, then do what LVGL_Flush_OnTransDone() would have done.
+ */
+static void flush_drop_job(const flush_job_t *job, esp_err_t err)
+{
+    flush_job_t head;
+    while (xQueuePeek(s_inflight_queue, &head, portMAX_DELAY) == pdTRUE && head.slot != job->slot) {
+        vTaskDelay(1);
+    }
+    (void)xQueueReceive(s_inflight_queue, &head, 0);
+    (void)xQueueSend(s_free_queue, &job->slot, 0);
+    if (job->last) {
+        spi_arbiter_lcd_frame_end(job->next_frame_us);
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.draw_errors++;
+    portEXIT_CRITICAL(&s_stats_lock);
+    ESP_LOGE(TAG_FLUSH, "band (%d,%d)-(%d,%d) not drawn: %s", (int)job->area.x1, (int)job->area.y1,
+             (int)job->area.x2, (int)job->area.y2, esp_err_to_name(err));
+}
+
+static void lvgl_flush_task(void *param)
+{
+    (void)param;
+
+    flush_job_t job;
+    while (1) {
+        if (xQueueReceive(s_job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        const lv_area_t *area = &job.area;
+        lv_color_t *pixels = s_slot_buf[job.slot];
+        if (s_config.swap_bytes) {
+            flush_swap_rgb565(pixels, (uint32_t)lv_area_get_size(area));
+        }
+
+        /* The frame keeps SPI2 from its first band to the last band's DMA done. */
+        if (job.first) {
+            spi_arbiter_lcd_frame_begin();
+        }
+        /* Queued before the transfer: the done interrupt may fire first. */
+        (void)xQueueSend(s_inflight_queue, &job, portMAX_DELAY);
+        // The window-set commands wait for the previous band's DMA; LVGL keeps rendering meanwhile.
+        const esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, area->x1 + Offset_X, area->y1 + Offset_Y,
+                                                        area->x2 + Offset_X + 1, area->y2 + Offset_Y + 1, pixels);
+        if (ret != ESP_OK) {
+            flush_drop_job(&job, ret);
+        }
+    }
+}
+
+static void flush_render_start_cb(lv_disp_drv_t *drv)
+{
+    (void)drv;
+
+    const int64_t now = esp_timer_get_time();
+    s_frame_start_us = now;
+    s_render_resume_us = now;
+    s_first_submit_us = 0;
+    s_frame_render_us = 0;
+    s_frame_wait_us = 0;
+}
+
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    const int64_t submitted = esp_timer_get_time();
+    // The scheduler only advances lv_tick when LVGL runs; keep it current mid-frame
+    LVGL_Scheduler_SyncTick();
+    flush_job_t job = {
+        .slot = flush_slot_index(color_p),
+        .first = s_first_submit_us == 0,
+        .last = lv_disp_flush_is_last(drv),
+        .area = *area,
+    };
+
+    if (job.slot == UINT8_MAX) {
+        ESP_LOGE(TAG_FLUSH, "flush from unknown buffer %p", (void *)color_p);
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    s_frame_render_us += (uint32_t)(submitted - s_render_resume_us);
+    if (s_first_submit_us == 0) {
+        s_first_submit_us = submitted;
+    }
+    if (job.last) {
+        job.frame_start_us = s_frame_start_us;
+        job.first_submit_us = s_first_submit_us;
+        job.render_us = s_frame_render_us;
+        job.wait_us = s_frame_wait_us;
+        const lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+        if (disp != NULL && disp->refr_timer != NULL) {
+            job.next_frame_us = s_frame_start_us + (int64_t)disp->refr_timer->period * 1000;
+        }
+    }
+    (void)xQueueSend(s_job_queue, &job, portMAX_DELAY);
+
+    uint8_t next;
+    if (xQueueReceive(s_free_queue, &next, 0) != pdTRUE) {
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.slot_stalls++;
+        portEXIT_CRITICAL(&s_stats_lock);
+        (void)xQueueReceive(s_free_queue, &next, portMAX_DELAY);
+    }
+
+    /* LVGL swaps buf_act to the other pointer after we return: aim it at the free slot. */
+    lv_disp_draw_buf_t *draw_buf = drv->draw_buf;
+    if (draw_buf->buf_act == draw_buf->buf1) {
+        draw_buf->buf2 = s_slot_buf[next];
+    } else {
+        draw_buf->buf1 = s_slot_buf[next];
+    }
+
+    s_render_resume_us = esp_timer_get_time();
+    s_frame_wait_us += (uint32_t)(s_render_resume_us - submitted);
+    lv_disp_flush_ready(drv);
+}
+
+bool LVGL_Flush_OnTransDone(void)
+{
+    BaseType_t woken = pdFALSE;
+    flush_job_t job;
+
+    if (s_inflight_queue == NULL || xQueueReceiveFromISR(s_inflight_queue, &job, &woken) != pdTRUE) {
+        return false;
+    }
+    (void)xQueueSendFromISR(s_free_queue, &job.slot, &woken);
+    if (job.last && spi_arbiter_lcd_frame_end_from_isr(job.next_frame_us)) {
+        woken = pdTRUE;
+    }
+
+    const int64_t now = esp_timer_get_time();
+    lvgl_flush_frame_hook_t hook = NULL;
+    portENTER_CRITICAL_ISR(&s_stats_lock);
+    s_stats.bands++;
+    if (job.last) {
+        hook = s_frame_hook;
+        s_frame_hook = NULL;
+        const uint32_t flush_us = (uint32_t)(now - job.first_submit_us);
+        s_stats.frames++;
+        s_stats.last_render_us = job.render_us;
+        s_stats.last_flush_us = flush_us;
+        s_stats.last_frame_us = (uint32_t)(now - job.frame_start_us);
+        s_stats.last_wait_us = job.wait_us;
+        s_stats.total_render_us += job.render_us;
+        s_stats.total_flush_us += flush_us;
+    }
+    portEXIT_CRITICAL_ISR(&s_stats_lock);
+
+    if (hook != NULL) {
+        hook();
+    }
+    return woken == pdTRUE;
+}
+
+bool LVGL_Flush_Init(const lvgl_flush_config_t *config, lv_disp_drv_t *drv, lv_disp_draw_buf_t *draw_buf)
+{
+    if (config == NULL || drv == NULL || draw_buf == NULL || s_job_queue != NULL) {
+        return false;
+    }
+    if (config->slots < 2U || config->slots > LVGL_FLUSH_MAX_SLOTS || config->band_lines == 0U ||
+        drv->hor_res <= 0) {
+        ESP_LOGE(TAG_FLUSH, "invalid flush config (%u slots, %u lines)",
+                 (unsigned)config->slots, (unsigned)config->band_lines);
+        return false;
+    }
+    if (config->swap_bytes && LV_COLOR_DEPTH != 16) {
+        ESP_LOGE(TAG_FLUSH, "byte swap needs LV_COLOR_DEPTH 16");
+        return false;
+    }
+
+    s_config = *config;
+    const uint32_t slot_px = (uint32_t)drv->hor_res * config->band_lines;
+
+    /* Fewer slots beat no display: keep what fits, down to double buffering. */
+    uint8_t allocated = 0;
+    for (; allocated < config->slots; ++allocated) {
+        s_slot_buf[allocated] = heap_caps_malloc(slot_px * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (s_slot_buf[allocated] == NULL) {
+            break;
+        }
+    }
+    if (allocated < 2U) {
+        ESP_LOGE(TAG_FLUSH, "no DMA memory for flush slots");
+        for (uint8_t i = 0; i < allocated; ++i) {
+            heap_caps_free(s_slot_buf[i]);
+            s_slot_buf[i] = NULL;
+        }
+        return false;
+    }
+    if (allocated < config->slots) {
+        ESP_LOGW(TAG_FLUSH, "only %u of %u flush slots fit in DMA memory", (unsigned)allocated, (unsigned)config->slots);
+    }
+    s_config.slots = allocated;
+
+    s_job_queue = xQueueCreateStatic(LVGL_FLUSH_MAX_SLOTS, sizeof(flush_job_t), s_job_storage, &s_job_queue_buf);
+    s_inflight_queue = xQueueCreateStatic(LVGL_FLUSH_MAX_SLOTS, sizeof(flush_job_t),
+                                          s_inflight_storage, &s_inflight_queue_buf);
+    s_free_queue = xQueueCreateStatic(LVGL_FLUSH_MAX_SLOTS, sizeof(uint8_t), s_free_storage, &s_free_queue_buf);
+
+    /* LVGL starts in slot 0; every other slot is free. */
+    for (uint8_t i = 1; i < s_config.slots; ++i) {
+        (void)xQueueSend(s_free_queue, &i, 0);
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.slots = s_config.slots;
+
+    if (xTaskCreate(lvgl_flush_task, "lvglFlush", s_config.stack_size, NULL,
+                    s_config.task_priority, NULL) != pdPASS) {
+        ESP_LOGE(TAG_FLUSH, "Failed to create flush task");
+        return false;
+    }
+
+    lv_disp_draw_buf_init(draw_buf, s_slot_buf[0], s_slot_buf[1], slot_px);
+    drv->draw_buf = draw_buf;
+    drv->flush_cb = flush_cb;
+    drv->render_start_cb = flush_render_start_cb;
+
+    ESP_LOGI(TAG_FLUSH, "%u flush slots of %u lines (%u bytes each)%s",
+             (unsigned)s_config.slots, (unsigned)s_config.band_lines,
+             (unsigned)(slot_px * sizeof(lv_color_t)), s_config.swap_bytes ? ", byte swap" : "");
+    return true;
+}
+
+void LVGL_Flush_GetStats(lvgl_flush_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *out_stats = s_stats;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+void LVGL_Flush_OnNextFrameSent(lvgl_flush_frame_hook_t hook)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    s_frame_hook = hook;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+#if LV_USE_DEMO_BENCHMARK
+static void flush_benchmark_log_cb(lv_timer_t *timer)
+{
+    static lvgl_flush_stats_t prev;
+    lvgl_flush_stats_t now;
+    (void)timer;
+
+    LVGL_Flush_GetStats(&now);
+    const uint32_t frames = now.frames - prev.frames;
+    if (frames > 0U) {
+        ESP_LOGI(TAG_FLUSH, "%u fps, render %u us, flush %u us avg, %u stalls",
+                 (unsigned)frames,
+                 (unsigned)((now.total_render_us - prev.total_render_us) / frames),
+                 (unsigned)((now.total_flush_us - prev.total_flush_us) / frames),
+                 (unsigned)(now.slot_stalls - prev.slot_stalls));
+    }
+    prev = now;
+}
+
+static void flush_benchmark_finished(void)
+{
+    lvgl_flush_stats_t stats;
+    LVGL_Flush_GetStats(&stats);
+    if (stats.frames == 0U) {
+        return;
+    }
+    ESP_LOGI(TAG_FLUSH, "benchmark: %u frames, %u bands, %u slots, render %u us, flush %u us avg, %u stalls, %u errors",
+             (unsigned)stats.frames, (unsigned)stats.bands, (unsigned)stats.slots,
+             (unsigned)(stats.total_render_us / stats.frames),
+             (unsigned)(stats.total_flush_us / stats.frames),
+             (unsigned)stats.slot_stalls, (unsigned)stats.draw_errors);
+}
+#endif
+
+void LVGL_Flush_StartBenchmark(void)
+{
+#if LV_USE_DEMO_BENCHMARK
+    lv_demo_benchmark_set_finished_cb(flush_benchmark_finished);
+    lv_demo_benchmark();
+    (void)lv_timer_create(flush_benchmark_log_cb, 1000, NULL);
+#else
+    ESP_LOGW(TAG_FLUSH, "LV_USE_DEMO_BENCHMARK is off; benchmark not started");
+#endif
+}
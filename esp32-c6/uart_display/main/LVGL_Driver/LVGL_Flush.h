@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * LVGL_Flush.h
+ *
+ * Pipelined flush engine between LVGL and the SPI panel.
+ *
+ * LVGL renders bands of band_lines rows into one of `slots` DMA-capable
+ * buffers in internal RAM. flush_cb hands the finished band to the flush
+ * task and immediately gives LVGL the next free slot, so LVGL draws band k+1
+ * (and k+2 with three slots) while band k is still on the wire. The panel IO
+ * "color transfer done" interrupt returns a slot to the free list. LVGL only
+ * waits when every slot is queued or in flight.
+ *
+ * Per-frame render time (LVGL drawing, excluding slot waits) and flush time
+ * (first band submitted to last band's DMA done) are kept in the stats.
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "lvgl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LVGL_FLUSH_MAX_SLOTS 4U
+
+typedef struct {
+    uint8_t slots;        /* 2..LVGL_FLUSH_MAX_SLOTS */
+    uint16_t band_lines;  /* rows per slot */
+    bool swap_bytes;      /* send RGB565 big-endian (swap in the flush task) */
+    uint32_t stack_size;
+    UBaseType_t task_priority;
+} lvgl_flush_config_t;
+
+typedef struct {
+    uint8_t slots;
+    uint32_t frames;
+    uint32_t bands;
+    uint32_t slot_stalls;     /* flushes that waited for a free slot */
+    uint32_t draw_errors;     /* bands the panel refused (not drawn) */
+    uint32_t last_render_us;  /* LVGL drawing time of the last frame */
+    uint32_t last_flush_us;   /* first band submitted -> last band sent */
+    uint32_t last_frame_us;   /* render start -> last band sent */
+    uint32_t last_wait_us;    /* LVGL blocked on slots in the last frame */
+    uint64_t total_render_us;
+    uint64_t total_flush_us;
+} lvgl_flush_stats_t;
+
+typedef void (*lvgl_flush_frame_hook_t)(void);
+
+void LVGL_Flush_GetDefaultConfig(lvgl_flush_config_t *config);
+
+/*
+ * Allocates the slots, initialises draw_buf with them and installs the
+ * engine's flush_cb/render_start_cb on drv. drv->hor_res must be set.
+ */
+bool LVGL_Flush_Init(const lvgl_flush_config_t *config, lv_disp_drv_t *drv, lv_disp_draw_buf_t *draw_buf);
+
+/* Panel IO on_color_trans_done hook (ISR); returns true if a task woke. */
+bool LVGL_Flush_OnTransDone(void);
+
+void LVGL_Flush_GetStats(lvgl_flush_stats_t *out_stats);
+
+/*
+ * Calls hook once, from the DMA-done ISR, when the last band of the next
+ * frame has been sent to the panel (flush_cb only queues it).
+ */
+void LVGL_Flush_OnNextFrameSent(lvgl_flush_frame_hook_t hook);
+
+/* Runs lv_demo_benchmark() and logs flush stats every second (LVGL thread). */
+void LVGL_Flush_StartBenchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
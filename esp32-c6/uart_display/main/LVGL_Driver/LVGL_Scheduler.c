@@ -0,0 +1,269 @@
+#include "LVGL_Scheduler.h"
+
+#include "backlight.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include <string.h>
+
+#ifdef CONFIG_LVGL_SCHED_IDLE_PERIOD_MS
+#define LVGL_SCHED_DEFAULT_IDLE_PERIOD_MS CONFIG_LVGL_SCHED_IDLE_PERIOD_MS
+#else
+#define LVGL_SCHED_DEFAULT_IDLE_PERIOD_MS 100
+#endif
+
+#ifdef CONFIG_LVGL_SCHED_IDLE_AFTER_MS
+#define LVGL_SCHED_DEFAULT_IDLE_AFTER_MS CONFIG_LVGL_SCHED_IDLE_AFTER_MS
+#else
+#define LVGL_SCHED_DEFAULT_IDLE_AFTER_MS 3000
+#endif
+
+#ifdef CONFIG_LVGL_SCHED_STATS_LOG_S
+#define LVGL_SCHED_DEFAULT_STATS_LOG_S CONFIG_LVGL_SCHED_STATS_LOG_S
+#else
+#define LVGL_SCHED_DEFAULT_STATS_LOG_S 0
+#endif
+
+#define LVGL_SCHED_STATS_WINDOW_US 1000000LL
+
+static const char *TAG_SCHED = "WS_SCHED";
+
+static lvgl_scheduler_config_t s_config;
+static lv_disp_t *s_disp = NULL;
+static TaskHandle_t s_task = NULL;
+static void (*s_prev_rounder_cb)(lv_disp_drv_t *drv, lv_area_t *area) = NULL;
+static volatile bool s_activity = false;
+
+/* LVGL thread only. */
+static int64_t s_tick_last_us;
+static bool s_suspended = false;
+
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static lvgl_scheduler_stats_t s_stats;
+
+void LVGL_Scheduler_GetDefaultConfig(lvgl_scheduler_config_t *config)
+{
+    if (config == NULL) {
+        return;
+    }
+
+    config->active_period_ms = LV_DISP_DEF_REFR_PERIOD;
+    config->idle_period_ms = LVGL_SCHED_DEFAULT_IDLE_PERIOD_MS;
+    config->idle_after_ms = LVGL_SCHED_DEFAULT_IDLE_AFTER_MS;
+    config->max_sleep_ms = 1000;
+    config->stats_log_interval_s = LVGL_SCHED_DEFAULT_STATS_LOG_S;
+}
+
+void LVGL_Scheduler_SyncTick(void)
+{
+    const int64_t now_us = esp_timer_get_time();
+    const int64_t elapsed_ms = (now_us - s_tick_last_us) / 1000;
+    if (elapsed_ms > 0) {
+        lv_tick_inc((uint32_t)elapsed_ms);
+        s_tick_last_us += elapsed_ms * 1000;
+    }
+}
+
+void LVGL_Scheduler_Wake(void)
+{
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void LVGL_Scheduler_NotifyActivity(void)
+{
+    s_activity = true;
+    LVGL_Scheduler_Wake();
+}
+
+/*
+ * LVGL 8.3 has no invalidation callback, but _lv_inv_area() passes every new
+ * area through rounder_cb. The area is left untouched; a call from another
+ * task means the loop may be asleep with a paused refresh timer.
+ */
+static void sched_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (s_prev_rounder_cb != NULL) {
+        s_prev_rounder_cb(drv, area);
+    }
+    if (s_task != NULL && xTaskGetCurrentTaskHandle() != s_task) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+bool LVGL_Scheduler_Init(const lvgl_scheduler_config_t *config, lv_disp_t *disp)
+{
+    if (config == NULL || disp == NULL || disp->driver == NULL || disp->refr_timer == NULL ||
+        config->active_period_ms == 0U || config->idle_period_ms < config->active_period_ms ||
+        config->max_sleep_ms == 0U) {
+        return false;
+    }
+
+    s_config = *config;
+    s_disp = disp;
+    s_tick_last_us = esp_timer_get_time();
+    if (disp->driver->rounder_cb != sched_rounder_cb) {
+        s_prev_rounder_cb = disp->driver->rounder_cb;
+        disp->driver->rounder_cb = sched_rounder_cb;
+    }
+    lv_timer_set_period(disp->refr_timer, s_config.active_period_ms);
+    return true;
+}
+
+/* Backlight off: stop invalidation (and so rendering) until the screen lights up again. */
+static void sched_set_suspended(bool suspend)
+{
+    if (suspend == s_suspended) {
+        return;
+    }
+    s_suspended = suspend;
+    if (suspend) {
+        lv_disp_enable_invalidation(s_disp, false);
+        s_disp->inv_p = 0;
+        lv_timer_pause(s_disp->refr_timer);
+    } else {
+        lv_disp_enable_invalidation(s_disp, true);
+        lv_obj_invalidate(lv_disp_get_scr_act(s_disp));
+    }
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.suspended = suspend;
+    if (suspend) {
+        s_stats.suspends++;
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+static bool sched_update_period(void)
+{
+    const bool active = (lv_anim_count_running() > 0U) ||
+                        (lv_disp_get_inactive_time(s_disp) < s_config.idle_after_ms);
+    const uint32_t period = active ? s_config.active_period_ms : s_config.idle_period_ms;
+
+    if (s_disp->refr_timer->period != period) {
+        lv_timer_set_period(s_disp->refr_timer, period);
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.period_switches++;
+        s_stats.idle = !active;
+        portEXIT_CRITICAL(&s_stats_lock);
+    }
+    return !active;
+}
+
+static uint32_t sched_sleep_ms(uint32_t till_next_ms)
+{
+    uint32_t sleep_ms = (till_next_ms == LV_NO_TIMER_READY) ? s_config.max_sleep_ms : till_next_ms;
+
+    /*
+     * An area invalidated by a timer that ran after the refresh timer was
+     * checked is not in the handler's estimate; keep the refresh on time.
+     */
+    const lv_timer_t *refr = s_disp->refr_timer;
+    if (s_disp->inv_p > 0U && !refr->paused) {
+        const uint32_t elapsed = lv_tick_elaps(refr->last_run);
+        const uint32_t refr_ms = (elapsed < refr->period) ? (refr->period - elapsed) : 0U;
+        if (refr_ms < sleep_ms) {
+            sleep_ms = refr_ms;
+        }
+    }
+    if (sleep_ms > s_config.max_sleep_ms) {
+        sleep_ms = s_config.max_sleep_ms;
+    }
+    return sleep_ms;
+}
+
+static TickType_t sched_ms_to_ticks(uint32_t ms)
+{
+    /* Round up, and always block at least one tick so lower priorities run. */
+    const TickType_t ticks = (TickType_t)(((uint64_t)ms * configTICK_RATE_HZ + 999U) / 1000U);
+    return (ticks > 0U) ? ticks : 1U;
+}
+
+static void sched_log_stats(void)
+{
+    lvgl_scheduler_stats_t stats;
+    LVGL_Scheduler_GetStats(&stats);
+    ESP_LOGI(TAG_SCHED, "cpu %u%%, %u wakeups/s (%u deadline, %u event total), %s period, idle mode %llu ms, suspended %llu ms",
+             (unsigned)stats.cpu_load_pct, (unsigned)stats.wakeups_per_s,
+             (unsigned)stats.deadline_wakeups, (unsigned)stats.event_wakeups,
+             stats.suspended ? "suspended" : (stats.idle ? "idle" : "active"),
+             (unsigned long long)(stats.idle_mode_us / 1000U), (unsigned long long)(stats.suspended_us / 1000U));
+}
+
+void LVGL_Scheduler_Run(void)
+{
+    if (s_disp == NULL) {
+        ESP_LOGE(TAG_SCHED, "LVGL_Scheduler_Init() not called");
+        vTaskDelete(NULL);
+        return;
+    }
+    s_task = xTaskGetCurrentTaskHandle();
+
+    int64_t window_start_us = esp_timer_get_time();
+    uint64_t window_busy_us = 0;
+    uint32_t window_wakeups = 0;
+    int64_t next_log_us = window_start_us + (int64_t)s_config.stats_log_interval_s * 1000000LL;
+
+    while (1) {
+        const int64_t start_us = esp_timer_get_time();
+        LVGL_Scheduler_SyncTick();
+        if (s_activity) {
+            s_activity = false;
+            lv_disp_trig_activity(s_disp);
+        }
+        sched_set_suspended(backlight_update(lv_disp_get_inactive_time(s_disp)) == BACKLIGHT_STATE_OFF);
+        const uint32_t till_next_ms = lv_timer_handler();
+        const bool idle = sched_update_period();
+        const uint32_t sleep_ms = sched_sleep_ms(till_next_ms);
+        const int64_t busy_end_us = esp_timer_get_time();
+
+        const uint32_t notified = ulTaskNotifyTake(pdTRUE, sched_ms_to_ticks(sleep_ms));
+        const int64_t end_us = esp_timer_get_time();
+
+        const uint64_t busy_us = (uint64_t)(busy_end_us - start_us);
+        window_busy_us += busy_us;
+        window_wakeups++;
+
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.wakeups++;
+        if (notified != 0U) {
+            s_stats.event_wakeups++;
+        } else {
+            s_stats.deadline_wakeups++;
+        }
+        s_stats.busy_us += busy_us;
+        s_stats.sleep_us += (uint64_t)(end_us - busy_end_us);
+        if (idle) {
+            s_stats.idle_mode_us += (uint64_t)(end_us - start_us);
+        }
+        if (s_suspended) {
+            s_stats.suspended_us += (uint64_t)(end_us - start_us);
+        }
+        const int64_t window_us = end_us - window_start_us;
+        if (window_us >= LVGL_SCHED_STATS_WINDOW_US) {
+            s_stats.cpu_load_pct = (uint8_t)((window_busy_us * 100U) / (uint64_t)window_us);
+            s_stats.wakeups_per_s = (uint16_t)(((uint64_t)window_wakeups * 1000000U) / (uint64_t)window_us);
+            window_start_us = end_us;
+            window_busy_us = 0;
+            window_wakeups = 0;
+        }
+        portEXIT_CRITICAL(&s_stats_lock);
+
+        if (s_config.stats_log_interval_s != 0U && end_us >= next_log_us) {
+            sched_log_stats();
+            next_log_us = end_us + (int64_t)s_config.stats_log_interval_s * 1000000LL;
+        }
+    }
+}
+
+void LVGL_Scheduler_GetStats(lvgl_scheduler_stats_t *out_stats)
+{
+    if (out_stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_stats_lock);
+    memcpy(out_stats, &s_stats, sizeof(*out_stats));
+    portEXIT_CRITICAL(&s_stats_lock);
+}
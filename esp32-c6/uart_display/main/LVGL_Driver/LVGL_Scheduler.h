@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ * LVGL_Scheduler.h
+ *
+ * Main loop for the LVGL thread. Instead of polling lv_timer_handler() every
+ * 10 ms, the loop sleeps until the next LVGL timer deadline (the handler's
+ * return value), or until another task invalidates an area or calls
+ * LVGL_Scheduler_Wake().
+ *
+ * The display refresh period follows activity: active_period_ms while an
+ * animation runs or the display saw input in the last idle_after_ms
+ * (lv_disp_get_inactive_time), idle_period_ms otherwise, so invalidations
+ * of a static screen are batched into fewer frames.
+ *
+ * Each iteration also feeds the display inactivity time to backlight_update()
+ * (auto-dim); while the backlight is off, invalidation is disabled so nothing
+ * is rendered or sent, and the whole screen is redrawn when it lights up.
+ *
+ * LVGL's tick is advanced from esp_timer_get_time() whenever the loop runs
+ * (LVGL_Scheduler_SyncTick), so there is no periodic tick interrupt and the
+ * CPU can stay idle (or in automatic light sleep) between deadlines.
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "lvgl.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t active_period_ms;    /* refresh period while animating / after input */
+    uint16_t idle_period_ms;      /* refresh period on a static screen */
+    uint32_t idle_after_ms;       /* input inactivity before switching to idle */
+    uint32_t max_sleep_ms;        /* upper bound on one sleep */
+    uint32_t stats_log_interval_s; /* 0: never log */
+} lvgl_scheduler_config_t;
+
+typedef struct {
+    uint32_t wakeups;             /* loop iterations */
+    uint32_t deadline_wakeups;    /* slept until the next timer deadline */
+    uint32_t event_wakeups;       /* woken early by an invalidation or LVGL_Scheduler_Wake() */
+    uint32_t period_switches;     /* active <-> idle refresh period changes */
+    bool idle;                    /* refresh period currently idle_period_ms */
+    uint64_t busy_us;             /* in lv_timer_handler() */
+    uint64_t sleep_us;            /* blocked between iterations */
+    uint64_t idle_mode_us;        /* time spent with the idle refresh period */
+    bool suspended;               /* backlight off, rendering stopped */
+    uint32_t suspends;
+    uint64_t suspended_us;
+    uint8_t cpu_load_pct;         /* busy share over the last stats window (~1 s) */
+    uint16_t wakeups_per_s;       /* over the last stats window */
+} lvgl_scheduler_stats_t;
+
+void LVGL_Scheduler_GetDefaultConfig(lvgl_scheduler_config_t *config);
+
+/* Hooks invalidation on disp and starts tick bookkeeping. Call after LVGL_Init(). */
+bool LVGL_Scheduler_Init(const lvgl_scheduler_config_t *config, lv_disp_t *disp);
+
+/* Runs the LVGL loop on the calling task; never returns. */
+void LVGL_Scheduler_Run(void);
+
+/* Wakes the loop early; safe from any task. */
+void LVGL_Scheduler_Wake(void);
+
+/* User activity without an LVGL input device (buttons, remote): resets the dim timer. Any task. */
+void LVGL_Scheduler_NotifyActivity(void);
+
+/* Brings lv_tick up to date with esp_timer (LVGL thread only). */
+void LVGL_Scheduler_SyncTick(void);
+
+void LVGL_Scheduler_GetStats(lvgl_scheduler_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
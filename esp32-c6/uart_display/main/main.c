@@ -5,9 +5,11 @@
  */
 
 #include "ST7789.h"
+#include "sd_log_sink.h"
 #include "sd_storage.h"
 #include "rgb_led.h"
 #include "lvgl_ui.h"
+#include "history_chart.h"
 #include "wifi_manager.h"
 #include "wifi_signal_task.h"
 #include "wifi_task.h"
@@ -23,39 +25,134 @@
 #include "debug_console.h"
 #include "system_snapshot.h"
 #include "app_log.h"
+#include "app_config.h"
+#include "boot_graph.h"
+#include "boot_report.h"
+#include "job_scheduler.h"
+#include "spi_arbiter.h"
+#include "LVGL_Scheduler.h"
+#include "LVGL_Flush.h"
 #include "debug_console_backends.h"
+#include "esp_event.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+/*
+ * Boot runs as a dependency graph (boot_graph.h). LCD, LVGL and UI stages
+ * stay on this task, which renders the splash while WORKER stages bring up
+ * WiFi, the sensors and the REST server next to it. Dependencies only order
+ * the stages; the SD card comes before the LCD because it initializes the
+ * shared SPI2 bus, and before WiFi/REST because it may import their config.
+ */
+enum {
+    APP_BOOT_RGB = 0,
+    APP_BOOT_SD,
+    APP_BOOT_LCD,
+    APP_BOOT_LVGL,
+    APP_BOOT_UI,
+    APP_BOOT_JOBS,
+    APP_BOOT_SNAPSHOT,
+    APP_BOOT_WIFI_INIT,
+    APP_BOOT_WIFI,
+    APP_BOOT_CLOCK,
+    APP_BOOT_REST,
+    APP_BOOT_WIFI_UI,
+    APP_BOOT_CLOCK_UI,
+    APP_BOOT_COUNT,
+};
+
+/* Longest the splash goes without an LVGL pass while workers are busy. */
+#define BOOT_IDLE_MAX_MS 50U
+
+static bool s_lvgl_ready;
+static bool s_network_logged; /* event loop task only */
+static history_chart_feed_t s_temp_feed; /* LVGL task only */
+
 static void rtc_ui_timer_cb(lv_timer_t *timer)
 {
     (void)timer;
     rtc_ui_clock_update();
+    history_chart_feed_update(&s_temp_feed);
 }
 
-void app_main(void)
+static bool boot_rgb(void *ctx)
 {
-    // Initialize DebugConsole early (for display-based output)
-    DebugConsole_Init();
-
-    // Initialize logging with composite backend (both display and UART)
-    (void)app_log_init(app_log_backend_composite());
-    app_log_set_output_level(APP_LOG_SUBSYS_ALL, APP_LOG_LEVEL_DEBUG);
-    app_log_write(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, "Boot started");
-
+    (void)ctx;
     Flash_Searching();
     RGB_Init();
-    RGB_Example();
-    
-    // Initialize SD card BEFORE LCD to set up shared SPI2 bus first
-    // SD needs smaller max_transfer_sz which works for both devices
-    SD_Mount();
-    
+    (void)RGB_Example();
+    return true;
+}
+
+static bool boot_sd(void *ctx)
+{
+    (void)ctx;
+    // LCD frames go first on SPI2; the log sink's writes are chunked into the gaps between them
+    spi_arbiter_config_t spi_arbiter_config;
+    spi_arbiter_get_default_config(&spi_arbiter_config);
+    (void)spi_arbiter_init(&spi_arbiter_config);
+
+    // SD sets up the shared SPI2 bus before the LCD: its smaller max_transfer_sz works for both devices.
+    // With a stored config nothing at boot needs the card: probe it once, no retries.
+    const bool sd_mounted = (app_config_get_source() == APP_CONFIG_SOURCE_NVS) ? SD_MountAttempts(1) : SD_Mount();
+    if (!sd_mounted) {
+        return true;
+    }
+
+    if (app_config_import_sd(APP_CONFIG_SD_PATH)) {
+        app_config_t app_config;
+        app_config_get(&app_config);
+        app_config_apply_log_levels(&app_config);
+    }
+
+    // Persist logs to rotating block files; callers only copy into RAM
+    sd_log_sink_config_t sd_log_config;
+    sd_log_sink_get_default_config(&sd_log_config);
+#ifdef CONFIG_APP_LOG_UART_BINARY
+    sd_log_config.binary = true;
+#endif
+    if (sd_log_sink_start(&sd_log_config)) {
+        app_log_backend_config_t log_backend_config;
+        app_log_backend_get_default_config(&log_backend_config);
+        log_backend_config.name = "sd";
+        log_backend_config.backend = app_log_backend_sd();
+        log_backend_config.queue_len = 0U;
+        (void)app_log_add_backend(&log_backend_config, NULL);
+    }
+    return true;
+}
+
+static bool boot_lcd(void *ctx)
+{
+    (void)ctx;
+    app_config_t app_config;
+    app_config_get(&app_config);
+
     LCD_Init();
-    BK_Light(50);
-    LVGL_Init();                            // returns the screen object
+    BK_Light(app_config.brightness);
+    return true;
+}
+
+static bool boot_lvgl(void *ctx)
+{
+    (void)ctx;
+    LVGL_Init();
+    s_lvgl_ready = true;
+    return true;
+}
+
+// DMA-done ISR of the splash frame's last band
+static void boot_first_frame_sent(void)
+{
+    boot_report_mark_from_isr(BOOT_MILESTONE_FIRST_FRAME);
+}
 
+static bool boot_ui(void *ctx)
+{
+    (void)ctx;
     ui_init();
+    (void)DebugConsole_StartUi();
 
     /* app_log now routes all messages to both DebugConsole display and UART */
 
@@ -68,38 +165,206 @@ void app_main(void)
     uic_Label6 = ui_Label1;    // Time
     uic_LabelDate = ui_Label2; // Date
     uic_LabelTemp = ui_Label3; // Temperature
-    
-    WiFi_Init();
+
+    // Temperature trend under the clock: the last 4 minutes at the 2 s sampling period
+    extern lv_obj_t *ui_Container2;
+    lv_obj_t *temp_chart = history_chart_create(ui_Container2, &s_temp_feed, SNAPSHOT_HISTORY_TEMPERATURE,
+                                                SNAPSHOT_HISTORY_TIER_2S, lv_color_hex(0xE0DDF3));
+    if (temp_chart != NULL) {
+        lv_obj_set_size(temp_chart, lv_pct(90), 36);
+    }
+
+    // lv_refr_now() only queues the bands; the milestone is the frame on the panel
+    LVGL_Flush_OnNextFrameSent(boot_first_frame_sent);
+    LVGL_Scheduler_SyncTick();
+    lv_refr_now(NULL);
+    return true;
+}
+
+static void boot_metrics_job(void *ctx)
+{
+    (void)ctx;
+    system_snapshot_sample_metrics();
+}
+
+static bool boot_jobs(void *ctx)
+{
+    (void)ctx;
+    // One task runs every periodic job (clock, temperature, metrics) instead of a task each
+    job_scheduler_config_t job_config;
+    job_scheduler_get_default_config(&job_config);
+    return job_scheduler_start(&job_config);
+}
+
+static bool boot_snapshot(void *ctx)
+{
+    (void)ctx;
+    system_snapshot_init();
+    return job_scheduler_add("metrics", SYSTEM_SNAPSHOT_METRICS_INTERVAL_MS, boot_metrics_job, NULL, NULL);
+}
+
+static void boot_network_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    (void)arg;
+    (void)event_base;
+    (void)event_id;
+    const wifi_status_event_t *event = (const wifi_status_event_t *)event_data;
+    if (event->status != WIFI_STATUS_CONNECTED) {
+        return;
+    }
+
+    boot_report_mark(BOOT_MILESTONE_NETWORK);
+    if (!s_network_logged) {
+        s_network_logged = true;
+        app_log_write_fmt(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, "Network up %u ms after reset",
+                          (unsigned)(esp_timer_get_time() / 1000));
+    }
+}
+
+static bool boot_wifi_init(void *ctx)
+{
+    (void)ctx;
+    if (!WiFi_Init()) {
+        return false;
+    }
+    (void)esp_event_handler_register(WIFI_MANAGER_EVENT, WIFI_MANAGER_EVENT_STATUS, boot_network_event_handler, NULL);
+    return true;
+}
+
+static bool boot_wifi(void *ctx)
+{
+    (void)ctx;
     // (void)network_status_init();  // Not available
     // network_status_task_config_t net_status_config;
     // network_status_task_get_default_config(&net_status_config);
     // (void)network_status_start_task(&net_status_config);
     wifi_task_start();
     // wifi_signal_task_start();  // Commented out - causes crash when accessing WiFi AP info
-    wifi_ui_timer_init();
+    return true;
+}
 
-    RTC_Clock_Init();
-    TempSensor_Init();
-    system_snapshot_init();
-    system_snapshot_metrics_task_config_t metrics_config;
-    system_snapshot_metrics_task_get_default_config(&metrics_config);
-    (void)system_snapshot_start_metrics_task(&metrics_config);
+static bool boot_clock(void *ctx)
+{
+    (void)ctx;
+    const bool rtc_ok = RTC_Clock_Init();
+    const bool temp_ok = TempSensor_Init();
+
+    if (!rtc_task_init() || !rtc_task_start_jobs()) {
+        return false;
+    }
+    return rtc_ok && temp_ok;
+}
+
+static bool boot_rest(void *ctx)
+{
+    (void)ctx;
+    app_config_t app_config;
+    app_config_get(&app_config);
 
     rest_api_config_t rest_config;
     rest_api_get_default_config(&rest_config);
-    (void)rest_api_start(&rest_config);
+    rest_config.server_port = app_config.rest_port;
 
     // network_debug_task_config_t debug_config;  // Uses network_status
     // network_debug_task_get_default_config(&debug_config);
     // (void)network_debug_task_start(&debug_config);
+    return rest_api_start(&rest_config);
+}
 
-    if (rtc_task_init()) {
-        start_rtc_task();
-        start_date_task();
-        start_temp_task();
-    }
+static bool boot_wifi_ui(void *ctx)
+{
+    (void)ctx;
+    wifi_ui_timer_init();
+    return true;
+}
 
+static bool boot_clock_ui(void *ctx)
+{
+    (void)ctx;
     lv_timer_create(rtc_ui_timer_cb, 1000, NULL);
+    return true;
+}
+
+/* Keeps the splash rendering while the main task waits for workers. */
+static uint32_t boot_main_idle(void *ctx)
+{
+    (void)ctx;
+    if (!s_lvgl_ready) {
+        return BOOT_GRAPH_IDLE_FOREVER;
+    }
+
+    LVGL_Scheduler_SyncTick();
+    const uint32_t next_ms = lv_timer_handler();
+    return (next_ms < BOOT_IDLE_MAX_MS) ? next_ms : BOOT_IDLE_MAX_MS;
+}
+
+static const boot_stage_t s_boot_stages[APP_BOOT_COUNT] = {
+    [APP_BOOT_RGB] = { "rgb", boot_rgb, NULL, BOOT_DEP(APP_BOOT_JOBS), BOOT_STAGE_WORKER },
+    [APP_BOOT_SD] = { "sd", boot_sd, NULL, 0U, BOOT_STAGE_MAIN },
+    [APP_BOOT_LCD] = { "lcd", boot_lcd, NULL, BOOT_DEP(APP_BOOT_SD), BOOT_STAGE_MAIN },
+    [APP_BOOT_LVGL] = { "lvgl", boot_lvgl, NULL, BOOT_DEP(APP_BOOT_LCD), BOOT_STAGE_MAIN },
+    [APP_BOOT_UI] = { "ui", boot_ui, NULL, BOOT_DEP(APP_BOOT_LVGL), BOOT_STAGE_MAIN },
+    [APP_BOOT_JOBS] = { "jobs", boot_jobs, NULL, 0U, BOOT_STAGE_WORKER },
+    [APP_BOOT_SNAPSHOT] = { "snapshot", boot_snapshot, NULL, 0U, BOOT_STAGE_WORKER },
+    [APP_BOOT_WIFI_INIT] = { "wifi_init", boot_wifi_init, NULL, 0U, BOOT_STAGE_WORKER },
+    [APP_BOOT_WIFI] = { "wifi", boot_wifi, NULL,
+                          BOOT_DEP(APP_BOOT_WIFI_INIT) | BOOT_DEP(APP_BOOT_SD) | BOOT_DEP(APP_BOOT_SNAPSHOT),
+                          BOOT_STAGE_WORKER },
+    [APP_BOOT_CLOCK] = { "clock", boot_clock, NULL, BOOT_DEP(APP_BOOT_SNAPSHOT), BOOT_STAGE_WORKER },
+    [APP_BOOT_REST] = { "rest", boot_rest, NULL,
+                          BOOT_DEP(APP_BOOT_WIFI_INIT) | BOOT_DEP(APP_BOOT_SD) | BOOT_DEP(APP_BOOT_SNAPSHOT),
+                          BOOT_STAGE_WORKER },
+    [APP_BOOT_WIFI_UI] = { "wifi_ui", boot_wifi_ui, NULL, BOOT_DEP(APP_BOOT_UI) | BOOT_DEP(APP_BOOT_WIFI),
+                             BOOT_STAGE_MAIN },
+    [APP_BOOT_CLOCK_UI] = { "clock_ui", boot_clock_ui, NULL, BOOT_DEP(APP_BOOT_UI) | BOOT_DEP(APP_BOOT_CLOCK),
+                              BOOT_STAGE_MAIN },
+};
+
+void app_main(void)
+{
+    // Initialize DebugConsole early (for display-based output)
+    DebugConsole_Init();
+
+    // Initialize logging: UART and LCD debug screen both inline on the drain task
+    (void)app_log_init(NULL);
+
+    // Typed config from NVS (defaults on first boot); the SD card is only an import source
+    app_config_t app_config;
+    (void)app_config_init();
+    app_config_get(&app_config);
+    app_config_apply_log_levels(&app_config);
+
+    app_log_backend_config_t log_backend_config;
+    app_log_backend_get_default_config(&log_backend_config);
+    log_backend_config.name = "uart";
+#ifdef CONFIG_APP_LOG_UART_BINARY
+    log_backend_config.backend = app_log_backend_uart_binary();
+#else
+    log_backend_config.backend = app_log_backend_uart();
+#endif
+    log_backend_config.queue_len = 0U;
+    (void)app_log_add_backend(&log_backend_config, NULL);
+
+    app_log_backend_get_default_config(&log_backend_config);
+    log_backend_config.name = "lcd";
+    log_backend_config.backend = app_log_backend_debug_console();
+    // PostLine only copies into the scrollback; the LVGL timer renders it
+    log_backend_config.queue_len = 0U;
+    (void)app_log_add_backend(&log_backend_config, NULL);
+
+    // Defer formatting/backend I/O to a drain task so producers never block
+    app_log_drain_task_config_t log_drain_config;
+    app_log_drain_task_get_default_config(&log_drain_config);
+    (void)app_log_start_drain_task(&log_drain_config);
+    app_log_write(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_INFO, "Boot started");
+
+    boot_graph_config_t boot_config;
+    boot_graph_get_default_config(&boot_config);
+    boot_config.main_idle_cb = boot_main_idle;
+    if (!boot_graph_run(s_boot_stages, APP_BOOT_COUNT, &boot_config)) {
+        app_log_write(APP_LOG_SUBSYS_SYSTEM, APP_LOG_LEVEL_WARN, "Boot finished with failed stages");
+    }
+    boot_report_log();
 
 /********************* Demo *********************/
     // Lvgl_Example1();
@@ -107,13 +372,12 @@ void app_main(void)
     // lv_demo_widgets();
     // lv_demo_keypad_encoder();
     // lv_demo_benchmark();
+#if CONFIG_LVGL_FLUSH_BENCHMARK
+    LVGL_Flush_StartBenchmark();
+#endif
     // lv_demo_stress();
     // lv_demo_music();
 
-    while (1) {
-        // raise the task priority of LVGL and/or reduce the handler period can improve the performance
-        lv_timer_handler();
-        vTaskDelay(pdMS_TO_TICKS(10));
-        // The task running lv_timer_handler should have lower priority than that running `lv_tick_inc`
-    }
+    // Sleeps until the next LVGL deadline or invalidation; never returns
+    LVGL_Scheduler_Run();
 }